@@ -32,6 +32,7 @@
 #include "base/mmPlatform.h"
 #include "util/mmPath.h"
 #include "util/mmDateRange2.h"
+#include "util/mmSortKey.h"
 #include "util/_util.h"
 #include "util/_simple.h"
 #include "model/SettingModel.h"
@@ -91,6 +92,7 @@ bool mmApp::setGUILanguage(wxLanguage lang)
     ) {
         wxTranslations::Set(trans);
         this->m_lang = lang;
+        mmSortKey::reset();
         PrefModel::instance().saveLanguage(lang);
         return true;
     }
@@ -25,9 +25,12 @@
 #include "mmFrame.h"
 
 #include "base/_defs.h"
+#include <algorithm>
+#include <chrono>
 #include <stack>
 #include <unordered_set>
 #include <wx/fs_mem.h>
+#include <wx/stopwatch.h>
 #include <wx/busyinfo.h>
 
 #include "base/_constants.h"
@@ -36,6 +39,7 @@
 #include "util/mmTreeItemData.h"
 #include "util/mmFileHistory.h"
 #include "util/mmSingleChoice.h"
+#include "util/mmSortKey.h"
 #include "util/mmNavigatorList.h"
 #include "util/mmToolbarList.h"
 #include "util/mmMultiChoice.h"
@@ -266,6 +270,9 @@ EVT_MENU_RANGE(MENU_LANG + 1, MENU_LANG_MAX,   mmFrame::OnChangeGUILanguage)
 /*Automatic processing of repeat transactions*/
 EVT_TIMER(AUTO_REPEAT_TRANSACTIONS_TIMER_ID,   mmFrame::OnAutoRepeatTransactionsTimer)
 
+/* Results of background tasks */
+EVT_THREAD(BACKGROUND_TASK_ID,                 mmFrame::OnBackgroundTask)
+
 /* Recent Files */
 EVT_MENU_RANGE(wxID_FILE1, wxID_FILE9,         mmFrame::OnRecentFiles)
 EVT_MENU(MENU_RECENT_FILES_CLEAR,              mmFrame::OnClearRecentFiles)
@@ -297,6 +304,8 @@ mmFrame::mmFrame(
     // code is a noop for all other systems
     EnableFullScreenView(true);
 #endif
+    wxStopWatch sw;
+
     // decide if we need to show app start dialog
     bool from_scratch = false;
     wxFileName dbpath = m_app->GetOptParam();
@@ -308,13 +317,35 @@ mmFrame::mmFrame(
             dbpath = SettingModel::instance().getLastDbPath();
     }
 
-    // Read news, if checking enabled
-    if (PrefModel::instance().getCheckNews())
-        getNewsRSS(websiteNewsArray_);
+    // The background requests take their options from http_config, which is
+    // read here from the settings; they are aborted when the frame is closed.
+    const mmHttpConfig http_config = mmHttpConfig::from_settings();
+
+    // Read news, if checking enabled.
+    // The request runs in background; the toolbar is updated when it completes.
+    if (PrefModel::instance().getCheckNews()) {
+        runInBackground([this, http_config]() -> std::function<void()> {
+            wxStopWatch news_sw;
+            wxString rssContent;
+            CURLcode err_code = http_get_data(
+                mmex::weblink::NewsRSS, rssContent, http_config, &m_is_closing
+            );
+            long msec = news_sw.Time();
+            return [this, err_code, rssContent, msec]() {
+                UsageModel::instance().append_phase("news", msec);
+                if (err_code == CURLE_OK && parseNewsRSS(rssContent, websiteNewsArray_))
+                    PopulateToolBar();
+            };
+        });
+    }
 
     /* Create the Controls for the frame */
     mmFontSize(this);
+    wxStopWatch theme_sw;
     mmImage::loadTheme();
+    UsageModel::instance().append_phase(
+        mmImage::isCacheHit() ? "theme_warm" : "theme_cold", theme_sw.Time()
+    );
     createMenu();
     createControls();
     createToolBar();
@@ -370,25 +401,15 @@ mmFrame::mmFrame(
     }
 
     //Check for new version at startup
-    if (SettingModel::instance().getBool("UPDATECHECK", true))
-        mmUpdate::checkUpdates(this, true);
-
-    //Show appstart
-    if (from_scratch || !dbpath.IsOk()) {
-        menuEnableItems(false);
-        showBeginAppDialog(dbpath.GetFullName().IsEmpty());
-    }
-    else {
-        if (openFile(dbpath.GetFullPath(), false)) {
-            DoRecreateNavTreeControl(true);
-            //setHomePageActive(false);
-            mmLoadColorsFromDatabase();
-        }
-        else {
-            resetNavTreeControl();
-            cleanupHomePanel();
-            showBeginAppDialog(true);
-        }
+    if (SettingModel::instance().getBool("UPDATECHECK", true)) {
+        const wxString url = mmUpdate::getUpdatesUrl();
+        runInBackground([this, url, http_config]() -> std::function<void()> {
+            wxString resp;
+            CURLcode err_code = http_get_data(url, resp, http_config, &m_is_closing);
+            return [this, err_code, resp]() {
+                mmUpdate::checkUpdatesResponse(this, true, err_code, resp);
+            };
+        });
     }
 
     const wxAcceleratorEntry entries[] = {
@@ -400,25 +421,26 @@ mmFrame::mmFrame(
     wxAcceleratorTable tab(sizeof(entries) / sizeof(*entries), entries);
     SetAcceleratorTable(tab);
 
-    if (m_db) {
-        // Clean up deleted transactions
-        autocleanDeletedTransactions();
-
-        // Refresh stock quotes
-        if (SettingModel::instance().getBool("REFRESH_STOCK_QUOTES_ON_OPEN", false) &&
-            StockModel::instance().find_count() > 0
-        ) {
-            wxCommandEvent evt(wxEVT_COMMAND_MENU_SELECTED, MENU_RATES);
-            this->GetEventHandler()->AddPendingEvent(evt);
-        }
-    }
     wxColour c = mmImage::themeMetaColour(mmImage::COLOR_LISTPANEL);
     mmImage::themeMetaColour(this, isDark(c) ? c.ChangeLightness(140) : c.ChangeLightness(70));
+
+    m_change_handle = TableChangeBus::instance().subscribe(
+        [this](const TableChangeM& change_m) { onTableChange(change_m); }
+    );
+
+    // The database is opened after the frame is shown
+    CallAfter(&mmFrame::openStartupFile, dbpath, from_scratch);
+    UsageModel::instance().append_phase("icons", mmImage::rasterTime());
+    UsageModel::instance().append_phase("frame", sw.Time());
 }
 //----------------------------------------------------------------------------
 
 mmFrame::~mmFrame()
 {
+    // m_is_closing aborts the pending HTTP requests and the start backup
+    m_is_closing = true;
+    TableChangeBus::instance().unsubscribe(m_change_handle);
+
     try {
         cleanup();
     }
@@ -426,6 +448,10 @@ mmFrame::~mmFrame()
         wxASSERT(false);
     }
 
+    // wait for the background tasks (including the close backups started by
+    // cleanup() or by the open of another file); their results are discarded
+    m_background_task_a.clear();
+
     // Report database statistics
     for (const auto & model : this->m_all_models) {
         model->debug_stat();
@@ -454,18 +480,219 @@ void mmFrame::cleanup()
     ShutdownDatabase();
     mmImage::closeTheme();
 
-    // Backup the database according to user requirements
+    // Backup the database according to user requirements.
+    // MMEX is closing; the window is hidden, and the destructor waits for
+    // the backup to complete.
     if (PrefModel::instance().getDatabaseUpdated() &&
         SettingModel::instance().getBool("BACKUPDB_UPDATE", false)
     ) {
-        dbUpgrade::BackupDB(
-            m_filename,
-            dbUpgrade::BACKUPTYPE::CLOSE,
-            SettingModel::instance().getInt("MAX_BACKUP_FILES", 4)
-        );
+        Hide();
+        backupInBackground(m_filename, m_password, dbUpgrade::BACKUPTYPE::CLOSE);
     }
 }
 
+// Backup fileName on a worker thread; the progress is shown in the status bar.
+// done(ok) is called on the GUI thread when the backup has completed.
+// Closing MMEX cancels a start backup; a close backup is completed, and the
+// destructor waits for it.
+void mmFrame::backupInBackground(
+    const wxString& fileName,
+    const wxString& password,
+    int backupType,
+    std::function<void(bool)> done
+) {
+    const int files_to_keep = SettingModel::instance().getInt("MAX_BACKUP_FILES", 4);
+    dbUpgrade::BackupParam param;
+    param.m_password = password;
+    param.m_compress = SettingModel::instance().getBool("BACKUPDB_COMPRESS", false);
+    param.m_progress = [this, backupType, last_percent = -1](int percent) mutable {
+        if (m_is_closing && backupType != dbUpgrade::BACKUPTYPE::CLOSE)
+            return false;
+#if wxUSE_STATUSBAR
+        if (percent != last_percent) {
+            last_percent = percent;
+            CallAfter([this, percent]() {
+                SetStatusText(wxString::Format(_t("Backup: %i%%"), percent));
+            });
+        }
+#endif
+        return true;
+    };
+
+    runInBackground([this, fileName, backupType, files_to_keep, param, done]() -> std::function<void()> {
+        wxStopWatch sw;
+        bool ok = dbUpgrade::BackupDB(fileName, backupType, files_to_keep, 0, param);
+        long msec = sw.Time();
+        return [this, ok, msec, done]() {
+            UsageModel::instance().append_phase("backup", msec);
+#if wxUSE_STATUSBAR
+            SetStatusText(ok ? wxString() : _t("Backup failed"));
+#endif
+            if (done)
+                done(ok);
+        };
+    });
+}
+
+// Open the database given on the command line (or the last used database),
+// or show the start dialog. Called after the frame is shown.
+void mmFrame::openStartupFile(const wxFileName& dbpath, bool from_scratch)
+{
+    if (from_scratch || !dbpath.IsOk()) {
+        menuEnableItems(false);
+        showBeginAppDialog(dbpath.GetFullName().IsEmpty());
+        return;
+    }
+
+    wxStopWatch open_sw;
+    openFile(dbpath.GetFullPath(), false, "", [this, open_sw](bool ok) {
+        if (!ok) {
+            resetNavTreeControl();
+            cleanupHomePanel();
+            showBeginAppDialog(true);
+            return;
+        }
+        UsageModel::instance().append_phase("open", open_sw.Time());
+
+        wxStopWatch sw;
+        DoRecreateNavTreeControl(true);
+        mmLoadColorsFromDatabase();
+        UsageModel::instance().append_phase("home", sw.Time());
+
+        // Clean up deleted transactions, after the home page is painted
+        CallAfter([this]() {
+            if (!m_db)
+                return;
+            wxStopWatch autoclean_sw;
+            autocleanDeletedTransactions();
+            UsageModel::instance().append_phase("autoclean", autoclean_sw.Time());
+        });
+
+        // Refresh stock quotes
+        if (SettingModel::instance().getBool("REFRESH_STOCK_QUOTES_ON_OPEN", false) &&
+            StockModel::instance().find_count() > 0
+        ) {
+            wxCommandEvent evt(wxEVT_COMMAND_MENU_SELECTED, MENU_RATES);
+            this->GetEventHandler()->AddPendingEvent(evt);
+        }
+
+        warmupCaches();
+    });
+}
+
+// Fill the caches of tables which are not preloaded, but which are used soon
+// after startup. The records are read on a separate read-only connection;
+// they are added into the caches on the GUI thread, unless a table has been
+// modified in the meantime.
+void mmFrame::warmupCaches()
+{
+    if (!m_db || m_filename.empty())
+        return;
+
+    const wxString filename = m_filename;
+    const wxString password = m_password;
+    const std::vector<std::size_t> version_a = {
+        StockModel::instance().data_version(),
+        AssetModel::instance().data_version(),
+        SchedModel::instance().data_version(),
+        SchedSplitModel::instance().data_version(),
+        TrxLinkModel::instance().data_version(),
+        TrxShareModel::instance().data_version(),
+        FieldModel::instance().data_version(),
+    };
+
+    runInBackground([this, filename, password, version_a]() -> std::function<void()> {
+        wxStopWatch sw;
+        wxSharedPtr<wxSQLite3Database> db = mmDBWrapper::OpenReadOnly(filename, password);
+        if (!db)
+            return nullptr;
+
+        auto stock_a      = StockModel::instance().find_db_data_a(db.get(), TableClause::EMPTY());
+        auto asset_a      = AssetModel::instance().find_db_data_a(db.get(), TableClause::EMPTY());
+        auto sched_a      = SchedModel::instance().find_db_data_a(db.get(), TableClause::EMPTY());
+        auto schedSplit_a = SchedSplitModel::instance().find_db_data_a(db.get(), TableClause::EMPTY());
+        auto trxLink_a    = TrxLinkModel::instance().find_db_data_a(db.get(), TableClause::EMPTY());
+        auto trxShare_a   = TrxShareModel::instance().find_db_data_a(db.get(), TableClause::EMPTY());
+        auto field_a      = FieldModel::instance().find_db_data_a(db.get(), TableClause::EMPTY());
+        db->Close();
+        long msec = sw.Time();
+
+        return [=]() {
+            // the database may have been closed or replaced
+            if (!m_db || m_filename != filename)
+                return;
+            std::size_t i = 0;
+            if (StockModel::instance().data_version() == version_a[i++])
+                StockModel::instance().preload_cache(stock_a);
+            if (AssetModel::instance().data_version() == version_a[i++])
+                AssetModel::instance().preload_cache(asset_a);
+            if (SchedModel::instance().data_version() == version_a[i++])
+                SchedModel::instance().preload_cache(sched_a);
+            if (SchedSplitModel::instance().data_version() == version_a[i++])
+                SchedSplitModel::instance().preload_cache(schedSplit_a);
+            if (TrxLinkModel::instance().data_version() == version_a[i++])
+                TrxLinkModel::instance().preload_cache(trxLink_a);
+            if (TrxShareModel::instance().data_version() == version_a[i++])
+                TrxShareModel::instance().preload_cache(trxShare_a);
+            if (FieldModel::instance().data_version() == version_a[i++])
+                FieldModel::instance().preload_cache(field_a);
+            UsageModel::instance().append_phase("warmup", msec);
+        };
+    });
+}
+
+// Run the integrity checks on separate read-only connections, and report
+// the findings when they are available. Findings which can be repaired are
+// repaired on the main connection, if the user agrees.
+void mmFrame::checkIntegrity()
+{
+    if (!m_db || m_filename.empty())
+        return;
+
+    const wxString filename = m_filename;
+    const wxString password = m_password;
+    auto check_a = dbCheck::get_check_a();
+
+    runInBackground([this, filename, password, check_a]() -> std::function<void()> {
+        wxStopWatch sw;
+        auto finding_a = dbCheck::run(check_a, filename, password);
+        long msec = sw.Time();
+
+        return [=]() {
+            // the database may have been closed or replaced
+            if (!m_db || m_filename != filename)
+                return;
+            UsageModel::instance().append_phase("dbcheck", msec);
+            if (finding_a.empty())
+                return;
+
+            const wxString msg = dbCheck::format(check_a, finding_a);
+            wxLogDebug("Database check:\n%s", msg);
+            if (!dbCheck::is_repairable(check_a, finding_a)) {
+                wxMessageBox(msg, _t("Database check"), wxOK | wxICON_WARNING);
+                return;
+            }
+
+            if (wxMessageBox(
+                msg + "\n" + _t("Do you want to repair the database?"),
+                _t("Database check"),
+                wxYES_NO | wxNO_DEFAULT | wxICON_WARNING
+            ) != wxYES)
+                return;
+
+            if (dbCheck::repair(m_db.get(), check_a, finding_a)) {
+                TableChangeBus::instance().publish();
+                refreshPanelData();
+            }
+            else {
+                wxMessageBox(_t("The database could not be repaired."),
+                    _t("Database check"), wxOK | wxICON_ERROR
+                );
+            }
+        };
+    });
+}
+
 void mmFrame::ShutdownDatabase()
 {
     if (!m_db)
@@ -477,10 +704,12 @@ void mmFrame::ShutdownDatabase()
             InfoModel::instance().saveBool("ISUSED", false);
     }
     m_db->SetCommitHook(nullptr);
-    m_db->Close();
+    mmDBWrapper::Close(m_db.get());
     m_db.reset();
     for (auto& model : m_all_models)
         model->reset_cache();
+    mmHTMLBuilder::reset_size_hint();
+    mmSortKey::reset();
 }
 
 void mmFrame::resetNavTreeControl()
@@ -2411,39 +2640,18 @@ void mmFrame::InitializeModelTables()
     ModelAll::instance(m_db.get());
 }
 
-bool mmFrame::createDataStore(const wxString& fileName, const wxString& pwd, bool openingNew)
-{
-    if (m_db) {
-        ShutdownDatabase();
-        // Backup the database according to user requirements
-        if (PrefModel::instance().getDatabaseUpdated() &&
-            SettingModel::instance().getBool("BACKUPDB_UPDATE", false)
-        ) {
-            dbUpgrade::BackupDB(
-                m_filename,
-                dbUpgrade::BACKUPTYPE::CLOSE,
-                SettingModel::instance().getInt("MAX_BACKUP_FILES", 4)
-            );
-            PrefModel::instance().setDatabaseUpdated(false);
-        }
-    }
-
-    wxFileName checkExt(fileName);
-    wxString password;
-    bool passwordCheckPassed = true;
-    if ((checkExt.GetExt().Lower() == "emb" ||
-        (checkExt.GetExt().Lower() == "bak" && (checkExt.GetName().Lower().Contains(".emb_update_") || checkExt.GetName().Lower().Contains(".emb_start_"))))
-        && wxFileName::FileExists(fileName)) {
-        wxString password_message = wxString::Format(
-            _t("Please enter password for Database\n\n%s"),
-            fileName
-        );
-        password = !pwd.empty() ? pwd :
-            wxGetPasswordFromUser(password_message, _t("MMEX: Encrypted Database")
-        );
-        if (password.IsEmpty())
-            passwordCheckPassed = false;
-    }
+// Open fileName, which is closed; the backups are done by openFile().
+bool mmFrame::createDataStore(
+    const wxString& fileName,
+    const wxString& password,
+    bool passwordCheckPassed,
+    bool openingNew
+) {
+    mmDBWrapper::Profile profile;
+    profile.m_wal = PrefModel::instance().getDbWal();
+    profile.m_cache_size = PrefModel::instance().getDbCacheSize();
+    profile.m_mmap_size = PrefModel::instance().getDbMmapSize();
+    mmDBWrapper::SetProfile(profile);
 
     const wxString dialogErrorMessageHeading = _t("Opening MMEX Database – Error");
 
@@ -2453,14 +2661,7 @@ bool mmFrame::createDataStore(const wxString& fileName, const wxString& pwd, boo
         && wxFileName::FileExists(fileName)
         && passwordCheckPassed
     ) {
-        /* Do a backup before opening */
-        if (SettingModel::instance().getBool("BACKUPDB", false)) {
-            dbUpgrade::BackupDB(
-                fileName,
-                dbUpgrade::BACKUPTYPE::START,
-                SettingModel::instance().getInt("MAX_BACKUP_FILES", 4)
-            );
-        }
+        wxStopWatch sw;
 
         m_db = mmDBWrapper::Open(fileName, password);
         // if the database pointer has been reset, the password is possibly incorrect
@@ -2469,16 +2670,18 @@ bool mmFrame::createDataStore(const wxString& fileName, const wxString& pwd, boo
 
         m_commit_callback_hook = new CommitCallbackHook();
         m_db->SetCommitHook(m_commit_callback_hook.get());
+        m_db->SetRollbackHook(m_commit_callback_hook.get());
         m_update_callback_hook = new UpdateCallbackHook();
         m_db->SetUpdateHook(m_update_callback_hook.get());
 
         //Check if DB upgrade needed
         if (dbUpgrade::isUpgradeDBrequired(m_db.get())) {
+            sw.Start();
             // close & reopen database in debug mode for upgrade (bypassing SQLITE_CorruptRdOnly flag)
             ShutdownDatabase();
             m_db = mmDBWrapper::Open(fileName, password, true);
             //DB backup is handled inside UpgradeDB
-            if (!dbUpgrade::UpgradeDB(m_db.get(), fileName)) {
+            if (!dbUpgrade::UpgradeDB(m_db.get(), fileName, password)) {
                 int response = wxMessageBox(_t("Have MMEX support provided a debug/patch file?"), _t("MMEX upgrade"), wxYES_NO);
                 if (response == wxYES) {
                     // upgrade failure turns CorruptRdOnly flag back on, so reopen again in debug mode
@@ -2489,9 +2692,12 @@ bool mmFrame::createDataStore(const wxString& fileName, const wxString& pwd, boo
                 ShutdownDatabase();
                 return false;
             }
+            UsageModel::instance().append_phase("upgrade", sw.Time());
         }
 
+        sw.Start();
         InitializeModelTables();
+        UsageModel::instance().append_phase("models", sw.Time());
 
         wxString UID = InfoModel::instance().getString("UID", wxEmptyString);
         if (UID.IsEmpty()) {
@@ -2554,6 +2760,7 @@ bool mmFrame::createDataStore(const wxString& fileName, const wxString& pwd, boo
         m_db = mmDBWrapper::Open(fileName, password);
         m_commit_callback_hook = new CommitCallbackHook();
         m_db->SetCommitHook(m_commit_callback_hook.get());
+        m_db->SetRollbackHook(m_commit_callback_hook.get());
         m_update_callback_hook = new UpdateCallbackHook();
         m_db->SetUpdateHook(m_update_callback_hook.get());
 
@@ -2626,10 +2833,108 @@ void mmFrame::SetDataBaseParameters(const wxString& fileName)
 }
 //----------------------------------------------------------------------------
 
-bool mmFrame::openFile(const wxString& fileName, bool openingNew, const wxString &password)
-{
+// Close the current database and open fileName; done(ok) is called on the
+// GUI thread when fileName is open, or when opening has failed.
+// The backups which must be complete before fileName is opened run on a
+// worker thread, and the open continues when they complete: the start
+// backup (which must not include the changes made by the upgrade or by the
+// cleanup after opening), and the close backup of the current database if
+// the same file is opened again. The close backup of another file runs in
+// background meanwhile.
+void mmFrame::openFile(
+    const wxString& fileName,
+    bool openingNew,
+    const wxString& password,
+    std::function<void(bool)> done
+) {
+    if (m_is_opening)
+        return;
+
     menuBar_->FindItem(MENU_CHANGE_ENCRYPT_PASSWORD)->Enable(false);
-    if (createDataStore(fileName, password, openingNew)) {
+
+    bool is_close_backup = false;
+    const wxString close_filename = m_filename;
+    const wxString close_password = m_password;
+    if (m_db) {
+        ShutdownDatabase();
+        // Backup the database according to user requirements.
+        if (PrefModel::instance().getDatabaseUpdated() &&
+            SettingModel::instance().getBool("BACKUPDB_UPDATE", false)
+        ) {
+            is_close_backup = true;
+            PrefModel::instance().setDatabaseUpdated(false);
+        }
+    }
+
+    wxFileName checkExt(fileName);
+    wxString db_password;
+    bool passwordCheckPassed = true;
+    if ((checkExt.GetExt().Lower() == "emb" ||
+        (checkExt.GetExt().Lower() == "bak" && (checkExt.GetName().Lower().Contains(".emb_update_") || checkExt.GetName().Lower().Contains(".emb_start_"))))
+        && wxFileName::FileExists(fileName)) {
+        wxString password_message = wxString::Format(
+            _t("Please enter password for Database\n\n%s"),
+            fileName
+        );
+        db_password = !password.empty() ? password :
+            wxGetPasswordFromUser(password_message, _t("MMEX: Encrypted Database")
+        );
+        if (db_password.IsEmpty())
+            passwordCheckPassed = false;
+    }
+
+    const bool is_start_backup = !openingNew &&
+        passwordCheckPassed &&
+        !fileName.IsEmpty() &&
+        wxFileName::FileExists(fileName) &&
+        SettingModel::instance().getBool("BACKUPDB", false);
+    const bool is_close_wait = is_close_backup && close_filename == fileName;
+    if (is_close_backup && !is_close_wait)
+        backupInBackground(close_filename, close_password, dbUpgrade::BACKUPTYPE::CLOSE);
+
+    auto open_fn = [this, fileName, openingNew, db_password, passwordCheckPassed, done]() {
+        m_is_opening = false;
+        bool ok = openDataStore(fileName, openingNew, db_password, passwordCheckPassed);
+        if (done)
+            done(ok);
+    };
+    auto start_fn = [this, fileName, db_password, is_start_backup, open_fn]() {
+        if (!is_start_backup) {
+            open_fn();
+            return;
+        }
+        backupInBackground(fileName, db_password, dbUpgrade::BACKUPTYPE::START,
+            [open_fn](bool) { open_fn(); }
+        );
+    };
+
+    if (!is_start_backup && !is_close_wait) {
+        open_fn();
+        return;
+    }
+
+    // no database is open while the backups run
+    m_is_opening = true;
+    menuEnableItems(false);
+    resetNavTreeControl();
+    cleanupHomePanel();
+    if (is_close_wait) {
+        backupInBackground(close_filename, close_password, dbUpgrade::BACKUPTYPE::CLOSE,
+            [start_fn](bool) { start_fn(); }
+        );
+    }
+    else
+        start_fn();
+}
+
+// Open fileName and prepare the frame for it; called by openFile().
+bool mmFrame::openDataStore(
+    const wxString& fileName,
+    bool openingNew,
+    const wxString& password,
+    bool passwordCheckPassed
+) {
+    if (createDataStore(fileName, password, passwordCheckPassed, openingNew)) {
         wxFileName fname(fileName);
         if (fname.GetExt().Upper() != "BAK") {
             m_recentFiles->AddFileToHistory(fileName);
@@ -2661,6 +2966,7 @@ bool mmFrame::openFile(const wxString& fileName, bool openingNew, const wxString
         mmNavigatorList::instance().LoadFromDB();
         loadGrmIconMapping();
         autoRepeatTransactionsTimer_.Start(REPEAT_FREQ_TRANS_DELAY_TIME, wxTIMER_ONE_SHOT);
+        checkIntegrity();
     }
     else
         return false;
@@ -2689,9 +2995,10 @@ void mmFrame::OnNew(wxCommandEvent& /*event*/)
         fileName += ".mmb";
 
     mmNavigatorList::instance().SetToDefault();
-    SetDatabaseFile(fileName, true);
-    SettingModel::instance().saveString("LASTFILENAME", fileName);
-    loadGrmIconMapping();
+    SetDatabaseFile(fileName, true, [this, fileName]() {
+        SettingModel::instance().saveString("LASTFILENAME", fileName);
+        loadGrmIconMapping();
+    });
 }
 //----------------------------------------------------------------------------
 
@@ -2710,10 +3017,9 @@ void mmFrame::OnOpen(wxCommandEvent& WXUNUSED(event))
     );
 
     if (!fileName.empty()) {
-        SetDatabaseFile(fileName);
-        saveSettings();
-        SettingModel::instance().saveString("LAST_FILE_OPEN_PATH", wxFileName(fileName).GetPath());
-        if (m_db) {
+        SetDatabaseFile(fileName, false, [this, fileName]() {
+            saveSettings();
+            SettingModel::instance().saveString("LAST_FILE_OPEN_PATH", wxFileName(fileName).GetPath());
             autocleanDeletedTransactions();
             if (SettingModel::instance().getBool("REFRESH_STOCK_QUOTES_ON_OPEN", false) &&
                 StockModel::instance().find_count() > 0
@@ -2721,7 +3027,7 @@ void mmFrame::OnOpen(wxCommandEvent& WXUNUSED(event))
                 wxCommandEvent evt(wxEVT_COMMAND_MENU_SELECTED, MENU_RATES);
                 this->GetEventHandler()->AddPendingEvent(evt);
             }
-        }
+        });
     }
 }
 //----------------------------------------------------------------------------
@@ -2809,7 +3115,11 @@ void mmFrame::OnChangeEncryptPassword(wxCommandEvent& /*event*/)
                     cipher.InitializeVersionDefault(4);
                     cipher.SetLegacy(true);
 
+                    // the cipher cannot rekey a database in WAL mode
+                    m_db->ExecuteQuery("PRAGMA journal_mode = DELETE;");
                     m_db->ReKey(cipher, confirm_password);
+                    // read-only connections are opened with m_password
+                    m_password = confirm_password;
                     wxMessageBox(_t("Password change completed"), password_change_heading);
                 }
                 else {
@@ -2871,6 +3181,11 @@ void mmFrame::OnDebugDB(wxCommandEvent& /*event*/)
         }
     }
 
+    // verify the usage counters of payees, categories, tags, accounts and currencies
+    std::size_t diff_c = ModelAll::instance().rebuild_ref_count();
+    resultMessage << wxString::Format(_t("Usage counters rebuilt: %d differences"), static_cast<int>(diff_c))
+        << wxTextFile::GetEOL();
+
     if (!resultMessage.IsEmpty()) {
         wxTextEntryDialog checkDlg(this, _t("Result of database integrity check:"), _t("Database Check"), resultMessage.Trim(), wxOK | wxTE_MULTILINE);
         checkDlg.SetIcon(mmPath::getProgramIcon());
@@ -2997,9 +3312,10 @@ void mmFrame::OnSaveAs(wxCommandEvent& /*event*/)
     }
 
     m_password.clear();
-    if (openFile(newFileName.GetFullPath(), false, new_password)) {
-        DoRecreateNavTreeControl(true);
-    }
+    openFile(newFileName.GetFullPath(), false, new_password, [this](bool ok) {
+        if (ok)
+            DoRecreateNavTreeControl(true);
+    });
 }
 //----------------------------------------------------------------------------
 
@@ -3219,6 +3535,32 @@ void mmFrame::refreshPanelData()
     }
 }
 
+// The models have already removed from their caches the rows changed with
+// raw SQL (e.g., by a general report); the journal, the home page and the
+// reports refresh themselves. The navigation tree is rebuilt if the tables
+// which it shows have been changed with raw SQL; changes made through the
+// models are followed by an explicit refresh, and they are ignored here.
+void mmFrame::onTableChange(const TableChangeM& change_m)
+{
+    if (m_is_closing || !m_db)
+        return;
+
+    for (const wxString& table_name : {
+        AccountModel::instance().table_name(),
+        StockModel::instance().table_name(),
+        BudgetPeriodModel::instance().table_name(),
+        ReportModel::instance().table_name(),
+        // the section of deleted transactions
+        TrxModel::instance().table_name(),
+    }) {
+        auto it = change_m.find(table_name);
+        if (it != change_m.end() && it->second.m_is_external) {
+            RefreshNavigationTree();
+            return;
+        }
+    }
+}
+
 void mmFrame::SetNavTreeSelection(wxTreeItemId id) {
     if (id.IsOk()) {
         wxTreeEvent evt(wxEVT_TREE_SEL_CHANGED, m_nav_tree_ctrl, id);
@@ -3358,7 +3700,9 @@ void mmFrame::OnGeneralReportManager(wxCommandEvent& WXUNUSED(event))
 {
     if (m_db) {
         wxTreeItemId selectedItem = m_nav_tree_ctrl->GetSelection();
-        GeneralReportManager dlg(this, m_db.get(), selectedItem.IsOk() ? m_nav_tree_ctrl->GetItemText(selectedItem) : "");
+        GeneralReportManager dlg(this, m_db.get(), m_filename, m_password,
+            selectedItem.IsOk() ? m_nav_tree_ctrl->GetItemText(selectedItem) : ""
+        );
         dlg.ShowModal();
         loadGrmIconMapping();
         RefreshNavigationTree();
@@ -3532,7 +3876,7 @@ void mmFrame::OnReportBug(wxCommandEvent& WXUNUSED(event))
 
 void mmFrame::OnDiagnostics(wxCommandEvent& /*event*/)
 {
-    DiagnosticsDialog dlg(this, this->IsMaximized());
+    DiagnosticsDialog dlg(this, this->IsMaximized(), m_db.get());
     dlg.ShowModal();
 }
 
@@ -3976,76 +4320,94 @@ void mmFrame::OnCurrency(wxCommandEvent& /*event*/)
 
 void mmFrame::OnRates(wxCommandEvent& WXUNUSED(event))
 {
-    wxBusyInfo info
-#if (wxMAJOR_VERSION == 3 && wxMINOR_VERSION >= 1)
-    (
-        wxBusyInfoFlags()
-        .Parent(this)
-        .Title(_t("Downloading stock prices from Yahoo"))
-        .Text(_tu("Please wait…"))
-        .Foreground(*wxWHITE)
-        .Background(wxColour(0, 102, 51))
-        .Transparency(4 * wxALPHA_OPAQUE / 5)
-    );
-#else
-    (_t("Downloading stock prices from Yahoo"), this);
-#endif
+    // The quotes are downloaded in background, and they are written to the
+    // database in a single batch when the download completes.
+    if (m_is_updating_rates)
+        return;
+
     wxString msg;
-    getOnlineCurrencyRates(msg);
+    CurrencyRateUpdate rate_update;
+    bool has_rates = rate_update.prepare(msg);
+    rate_update.m_config.m_abort_n = &m_is_closing;
 
-    StockModel::DataA stock_a = StockModel::instance().find_data_a(
-        TableClause::ORDERBY(StockCol::s_primary_name)
-    );
-    if (!stock_a.empty()) {
+    std::vector<wxString> symbol_a;
+    for (const auto& stock_d : StockModel::instance().find_data_a()) {
+        const wxString symbol = stock_d.m_symbol.Upper();
+        if (!symbol.IsEmpty())
+            symbol_a.push_back(symbol);
+    }
+    std::sort(symbol_a.begin(), symbol_a.end());
+    symbol_a.erase(std::unique(symbol_a.begin(), symbol_a.end()), symbol_a.end());
 
-        std::map<wxString, double> symbols;
-        for (const auto& stock_d : stock_a) {
-            const wxString symbol = stock_d.m_symbol.Upper();
-            if (symbol.IsEmpty()) continue;
-            symbols[symbol] = stock_d.m_current_price;
-        }
+    if (!has_rates && symbol_a.empty()) {
+        wxLogDebug("%s", msg);
+        return;
+    }
 
-        std::map<wxString, double> stocks_data;
-        if (get_yahoo_prices(symbols, stocks_data, "", msg, yahoo_price_type::SHARES)) {
-            StockHistoryModel::instance().db_savepoint();
-            for (auto& stock_d : stock_a) {
-                std::map<wxString, double>::const_iterator it = stocks_data.find(
-                    stock_d.m_symbol.Upper()
-                );
-                if (it == stocks_data.end())
-                    continue;
+    m_is_updating_rates = true;
+#if wxUSE_STATUSBAR
+    SetStatusText(_t("Downloading stock prices from Yahoo"));
+#endif
+    const wxString filename = m_filename;
+    mmQuote::Config config = mmQuote::Config::from_settings();
+    config.m_abort_n = &m_is_closing;
+
+    runInBackground([this, filename, config, has_rates, rate_update, symbol_a]() -> std::function<void()> {
+        mmQuote::Result rate_result;
+        if (has_rates)
+            rate_result = rate_update.fetch();
+
+        // reuse the Yahoo session if it has been renewed
+        mmQuote::Config share_config = config;
+        if (rate_result.m_is_session_new) {
+            share_config.m_cookie = rate_result.m_cookie;
+            share_config.m_crumb  = rate_result.m_crumb;
+        }
+        mmQuote::Result share_result;
+        if (!symbol_a.empty())
+            share_result = mmQuote::fetch_shares(share_config, symbol_a);
 
-                double dPrice = it->second;
+        return [=]() mutable {
+            m_is_updating_rates = false;
+#if wxUSE_STATUSBAR
+            SetStatusText("");
+#endif
+            // the database may have been closed or replaced
+            if (!isOpenDb(filename))
+                return;
 
-                if (dPrice != 0) {
-                    msg += wxString::Format("%s\t: %0.6f -> %0.6f\n",
-                        stock_d.m_symbol, stock_d.m_current_price, dPrice
-                    );
-                    stock_d.m_current_price = dPrice;
-                    if (stock_d.m_name.empty())
-                        stock_d.m_name = stock_d.m_symbol;
-                    StockModel::instance().save_data_n(stock_d);
-                    StockHistoryModel::instance().save_record(
-                        stock_d.m_symbol,
-                        mmDate::today(),
-                        dPrice,
-                        UpdateType(UpdateType::e_online)
-                    );
-                }
+            wxString msg;
+            TableWork work;
+            if (has_rates)
+                rate_update.work_apply(work, rate_result, msg);
+            if (share_result.m_ok) {
+                mmQuote::save_session(share_result);
+                StockModel::instance().work_update_symbol_price_m(work,
+                    share_result.m_price_m, mmDate::today(), msg
+                );
+            }
+            else if (!symbol_a.empty()) {
+                msg << share_result.m_msg;
+            }
+            if (!work.flush()) {
+                mmErrorDialogs::MessageSaveFailed(this);
+                return;
             }
-            StockHistoryModel::instance().db_release_savepoint();
-            wxString strLastUpdate;
-            strLastUpdate.Printf(_t("%1$s on %2$s"),
-                wxDateTime::Now().FormatTime(),
-                mmGetDateTimeForDisplay(wxDateTime::Now().FormatISODate())
-            );
-            InfoModel::instance().saveString("STOCKS_LAST_REFRESH_DATETIME", strLastUpdate);
-        }
 
-        wxLogDebug("%s", msg);
-    }
+            if (share_result.m_ok) {
+                wxString strLastUpdate;
+                strLastUpdate.Printf(_t("%1$s on %2$s"),
+                    wxDateTime::Now().FormatTime(),
+                    mmGetDateTimeForDisplay(wxDateTime::Now().FormatISODate())
+                );
+                InfoModel::instance().saveString("STOCKS_LAST_REFRESH_DATETIME", strLastUpdate);
+            }
+            UsageModel::instance().append_phase("quotes", rate_result.m_msec + share_result.m_msec);
 
-    refreshPanelData();
+            wxLogDebug("%s", msg);
+            refreshPanelData();
+        };
+    });
 }
 //----------------------------------------------------------------------------
 
@@ -4386,20 +4748,28 @@ void mmFrame::autocleanDeletedTransactions() {
     TrxModel::instance().db_release_savepoint();
 }
 
-void mmFrame::SetDatabaseFile(const wxString& dbFileName, bool newDatabase)
-{
+// Open dbFileName; opened() is called when it is open.
+void mmFrame::SetDatabaseFile(
+    const wxString& dbFileName,
+    bool newDatabase,
+    std::function<void()> opened
+) {
     autoRepeatTransactionsTimer_.Stop();
 
-    if (openFile(dbFileName, newDatabase)) {
-        DoRecreateNavTreeControl(true);
-        mmLoadColorsFromDatabase();
-    }
-    else {
-        mmNavigatorList::instance().SetToDefault();
-        resetNavTreeControl();
-        cleanupHomePanel();
-        showBeginAppDialog(true);
-    }
+    openFile(dbFileName, newDatabase, "", [this, opened](bool ok) {
+        if (ok) {
+            DoRecreateNavTreeControl(true);
+            mmLoadColorsFromDatabase();
+            if (opened)
+                opened();
+        }
+        else {
+            mmNavigatorList::instance().SetToDefault();
+            resetNavTreeControl();
+            cleanupHomePanel();
+            showBeginAppDialog(true);
+        }
+    });
 }
 //----------------------------------------------------------------------------
 
@@ -4411,8 +4781,7 @@ void mmFrame::OnRecentFiles(wxCommandEvent& event)
     const wxString file_name = m_recentFiles->GetHistoryFile(fileNum);
     wxFileName file(file_name);
     if (file.FileExists()) {
-        SetDatabaseFile(file_name);
-        saveSettings();
+        SetDatabaseFile(file_name, false, [this]() { saveSettings(); });
     }
     else {
         wxMessageBox(
@@ -4437,6 +4806,44 @@ void mmFrame::setGotoAccountID(int64 account_id, JournalKey journal_key)
     gotoTransID_ = journal_key;
 }
 
+// Return a new read-only connection to the current database, or a nullptr
+// database pointer if the database cannot be opened a second time.
+// The connection can be passed to a worker thread.
+wxSharedPtr<wxSQLite3Database> mmFrame::openReadOnlyDb() const
+{
+    if (!m_db || m_filename.empty())
+        return wxSharedPtr<wxSQLite3Database>();
+    return mmDBWrapper::OpenReadOnly(m_filename, m_password);
+}
+
+void mmFrame::runInBackground(std::function<std::function<void()>()> work)
+{
+    m_background_task_a.push_back(std::async(std::launch::async, [this, work]() {
+        std::function<void()> apply = work();
+        if (!apply)
+            return;
+        wxThreadEvent* evt = new wxThreadEvent(wxEVT_THREAD, BACKGROUND_TASK_ID);
+        evt->SetPayload(apply);
+        wxQueueEvent(this, evt);
+    }));
+}
+
+void mmFrame::OnBackgroundTask(wxThreadEvent& event)
+{
+    std::function<void()> apply = event.GetPayload<std::function<void()>>();
+    apply();
+
+    // forget the tasks which have completed
+    m_background_task_a.erase(
+        std::remove_if(m_background_task_a.begin(), m_background_task_a.end(),
+            [](const std::future<void>& task) {
+                return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }
+        ),
+        m_background_task_a.end()
+    );
+}
+
 void mmFrame::OnToggleFullScreen(wxCommandEvent& WXUNUSED(event))
 {
 #if (wxMAJOR_VERSION >= 3 && wxMINOR_VERSION >= 0)
@@ -28,6 +28,9 @@ Copyright (C) 2025, 2026 Klaus Wich
 #include <wx/aui/aui.h>
 #include <wx/toolbar.h>
 #include <vector>
+#include <atomic>
+#include <functional>
+#include <future>
 
 #include "base/_constants.h"
 #include "util/mmPath.h"
@@ -192,6 +195,7 @@ public:
         MENU_TREEPOPUP_ACCOUNT_VIEWOPEN,
         MENU_TREEPOPUP_ACCOUNT_VIEWCLOSED,
         AUTO_REPEAT_TRANSACTIONS_TIMER_ID,
+        BACKGROUND_TASK_ID,
     };
 
 private:
@@ -231,6 +235,16 @@ private:
     // Repeat Transactions automatic processing delay
     wxTimer autoRepeatTransactionsTimer_;
 
+    // Tasks started by runInBackground() which have not finished yet
+    std::vector<std::future<void>> m_background_task_a;
+    std::atomic<bool> m_is_closing{false};
+    // a download of quotes started by OnRates() has not completed yet
+    bool m_is_updating_rates = false;
+    // openFile() waits for a backup before the database is opened
+    bool m_is_opening = false;
+    // subscription to TableChangeBus
+    int m_change_handle = 0;
+
     // wxAUI
     wxAuiManager m_mgr;
 
@@ -275,6 +289,19 @@ public:
     /// return the index (mmPath::EDocFile) to return the correct file.
     int getHelpFileIndex() const;
     void setHelpFileIndex();
+    auto getFilename() const -> const wxString& { return m_filename; }
+    // becomes true when the frame is closing; aborts the HTTP requests
+    auto getClosingFlag() const -> const std::atomic<bool>* { return &m_is_closing; }
+    // true if the frame is not closing and filename is the open database;
+    // checked by the GUI part of background tasks
+    bool isOpenDb(const wxString& filename) const {
+        return !m_is_closing && m_db && m_filename == filename;
+    }
+    // open an additional read-only connection to the current database
+    auto openReadOnlyDb() const -> wxSharedPtr<wxSQLite3Database>;
+    // Run work on a worker thread. work must not use the models or the GUI;
+    // the function it returns is called on the GUI thread.
+    void runInBackground(std::function<std::function<void()>()> work);
 
     void setNavTreeSection(const wxString &sectionName);
     void setNavTreeSectionById(int sectionid);
@@ -282,6 +309,7 @@ public:
     void menuPrintingEnable(bool enable);
 
     void RefreshNavigationTree();
+    void onTableChange(const TableChangeM& change_m);
     void SetNavTreeSelection(wxTreeItemId id);
     wxTreeItemId GetNavTreeSelection() const;
 
@@ -298,11 +326,27 @@ private:
     void cleanupNavTreeControl(wxTreeItemId& item);
     wxSizer* cleanupHomePanel(bool new_sizer = true);
     void updateHomePagePanel(PanelBase* panel);
-    bool openFile(const wxString& fileName, bool openingNew, const wxString &password = "");
+    void openFile(
+        const wxString& fileName,
+        bool openingNew,
+        const wxString& password = "",
+        std::function<void(bool)> done = nullptr
+    );
+    bool openDataStore(
+        const wxString& fileName,
+        bool openingNew,
+        const wxString& password,
+        bool passwordCheckPassed
+    );
     void loadGrmIconMapping();
     void applyGrmIconMapping(wxTreeItemId& parent_item);
     void InitializeModelTables();
-    bool createDataStore(const wxString& fileName, const wxString &passwd, bool openingNew);
+    bool createDataStore(
+        const wxString& fileName,
+        const wxString& password,
+        bool passwordCheckPassed,
+        bool openingNew
+    );
     void createMenu();
     void createToolBar();
     void createReportsPage(ReportBase* rb, bool cleanup);
@@ -350,6 +394,16 @@ private:
     void AppendImportMenu(wxMenu& menu);
     void showBeginAppDialog(bool fromScratch = false);
     void SetDataBaseParameters(const wxString& fileName);
+    void openStartupFile(const wxFileName& dbpath, bool from_scratch);
+    void warmupCaches();
+    void checkIntegrity();
+
+    void backupInBackground(
+        const wxString& fileName,
+        const wxString& password,
+        int backupType,
+        std::function<void(bool)> done = nullptr
+    );
 
     void navTreeStateToJson();
     void collectNavTreeExpanded(
@@ -368,7 +422,11 @@ private:
     void navTreeSelection(wxTreeItemId selectedItem);
 
     // Sets the database to the new database selected by the user
-    void SetDatabaseFile(const wxString& dbFileName, bool newDatabase = false);
+    void SetDatabaseFile(
+        const wxString& dbFileName,
+        bool newDatabase = false,
+        std::function<void()> opened = nullptr
+    );
     void ShutdownDatabase();
 
 // -- event handlers
@@ -380,6 +438,7 @@ public:
 
 private:
     void OnAutoRepeatTransactionsTimer(wxTimerEvent& event);
+    void OnBackgroundTask(wxThreadEvent& event);
     void OnLaunchAccountWebsite(wxCommandEvent& event);
     void OnAccountAttachments(wxCommandEvent& event);
     void OnReconcileAccount(wxCommandEvent& event);
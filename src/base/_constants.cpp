@@ -185,6 +185,10 @@ const wxString mmex::weblink::YahooQuotes = "https://query1.finance.yahoo.com/v7
 /*"ValidRanges":["1d","5d","1mo","3mo","6mo","1y","2y","5y","10y","ytd","max"]
    Valid intervals: [1m, 2m, 5m, 15m, 30m, 60m, 90m, 1h, 1d, 5d, 1wk, 1mo, 3mo]*/
 const wxString mmex::weblink::YahooQuotesHistory = "https://query1.finance.yahoo.com/v8/finance/chart/%s?%s&fields=currency";
+// session cookie, consent (%s: session id) and crumb required by the quote API
+const wxString mmex::weblink::YahooCookie = "https://finance.yahoo.com";
+const wxString mmex::weblink::YahooConsent = "https://consent.yahoo.com/v2/collectConsent?sessionId=%s";
+const wxString mmex::weblink::YahooCrumb = "https://query1.finance.yahoo.com/v1/test/getcrumb";
 
 // coincap asset search by symbol and id
 const wxString mmex::weblink::CoinCapSearch = "http://api.coincap.io/v2/assets?search=%s";
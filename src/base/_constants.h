@@ -89,6 +89,9 @@ namespace weblink
     extern const wxString Crowdin;
     extern const wxString YahooQuotes;
     extern const wxString YahooQuotesHistory;
+    extern const wxString YahooCookie;
+    extern const wxString YahooConsent;
+    extern const wxString YahooCrumb;
     extern const wxString CoinCapSearch;
     extern const wxString CoinCapHistory;
     extern const wxString GeneralReport;
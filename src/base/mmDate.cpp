@@ -75,8 +75,48 @@ mmDateN::mmDateN(wxDateTime dateTimeN)
     cache_dateTimeN(dateTimeN);
 }
 
+mmDate mmDate::fromYyyymmdd(int yyyymmdd)
+{
+    return mmDate(wxString::Format("%04d-%02d-%02d",
+        yyyymmdd / 10000, (yyyymmdd / 100) % 100, yyyymmdd % 100
+    ));
+}
+
 // -- methods
 
+// Return the date as an integer of the form YYYYMMDD.
+// The integer order is the same as the date order; it is used as a compact
+// key in sorted arrays of dates.
+int mmDate::yyyymmdd() const
+{
+    if (m_isoDate.length() < 10)
+        return 0;
+
+    int value = 0;
+    for (std::size_t i : { 0, 1, 2, 3, 5, 6, 8, 9 })
+        value = value * 10 + static_cast<int>(m_isoDate[i].GetValue()) - '0';
+    return value;
+}
+
+// Return the number of days since 1970-01-01.
+// The calculation is done on the ISO date string, without wxDateTime;
+// the difference of two day numbers is the same as daysSince().
+int mmDate::dayNumber() const
+{
+    const int ymd = yyyymmdd();
+    int y = ymd / 10000;
+    const int m = (ymd / 100) % 100;
+    const int d = ymd % 100;
+
+    // proleptic Gregorian calendar, with the year starting on March 1st
+    y -= (m <= 2) ? 1 : 0;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
 wxDateTime mmDate::cache_dateTime()
 {
     const wxDateTime* dateTime_n = mmDate::c_isoDate_dateTime.get(m_isoDate);
@@ -94,6 +94,7 @@ public:
     static mmDate today() { return mmDate(wxDateTime(12, 0, 0, 0)); }
     static mmDate min() { return mmDate("1970-01-01"); }
     static mmDate max() { return mmDate("2999-12-31"); }
+    static mmDate fromYyyymmdd(int yyyymmdd);
 
 // -- methods
 
@@ -101,6 +102,8 @@ public:
     auto isoDate() const -> const wxString { return m_isoDate; }
     auto isoStart() const -> const wxString { return m_isoDate; }
     auto isoEnd() const -> const wxString { return m_isoDate + "~"; }
+    int  yyyymmdd() const;
+    int  dayNumber() const;
 
 private:
     auto cache_dateTime() -> wxDateTime;
@@ -16,102 +16,266 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 ********************************************************/
 
+#include <algorithm>
+#include <future>
+#include <thread>
+
 #include "dbcheck.h"
+#include "dbwrapper.h"
 
 #include "util/mmNavigatorList.h"
 #include "model/AccountModel.h"
-#include "model/AttachmentModel.h"
-#include "model/SchedModel.h"
-#include "model/CategoryModel.h"
-#include "model/PayeeModel.h"
-#include "model/StockModel.h"
+#include "model/TrxModel.h"
 
-bool dbCheck::checkDB()
+// Return the list of checks. The queries depend on the account types, which
+// are known only on the GUI thread.
+std::vector<dbCheck::Check> dbCheck::get_check_a()
 {
-    bool result = true;
-    result = checkAccounts();
+    // stocks shall be held in an investment account
+    wxString investment_id_s;
+    for (const auto& account_d : AccountModel::instance().find_data_a()) {
+        if (AccountModel::type_id(account_d) == mmNavigatorItem::TYPE_ID_INVESTMENT)
+            investment_id_s << (investment_id_s.IsEmpty() ? "" : ", ") << account_d.m_id.ToString();
+    }
+    if (investment_id_s.IsEmpty())
+        investment_id_s = "-1";
+
+    const wxString transfer = TrxType(TrxType::e_transfer).key();
 
-    return result;
+    return {
+        {
+            _t("Transactions with a missing account"),
+            wxString::Format(
+                "SELECT COUNT(*) FROM CHECKINGACCOUNT_V1 t "
+                "WHERE NOT EXISTS (SELECT 1 FROM ACCOUNTLIST_V1 a WHERE a.ACCOUNTID = t.ACCOUNTID) "
+                "OR (t.TRANSCODE = '%s' AND NOT EXISTS (SELECT 1 FROM ACCOUNTLIST_V1 a WHERE a.ACCOUNTID = t.TOACCOUNTID))",
+                transfer
+            ),
+            "", ""
+        },
+        {
+            _t("Scheduled transactions with a missing account"),
+            wxString::Format(
+                "SELECT COUNT(*) FROM BILLSDEPOSITS_V1 t "
+                "WHERE NOT EXISTS (SELECT 1 FROM ACCOUNTLIST_V1 a WHERE a.ACCOUNTID = t.ACCOUNTID) "
+                "OR (t.TRANSCODE = '%s' AND NOT EXISTS (SELECT 1 FROM ACCOUNTLIST_V1 a WHERE a.ACCOUNTID = t.TOACCOUNTID))",
+                transfer
+            ),
+            "", ""
+        },
+        {
+            _t("Stocks not held in an investment account"),
+            wxString::Format(
+                "SELECT COUNT(*) FROM STOCK_V1 WHERE HELDAT IS NULL OR HELDAT NOT IN (%s)",
+                investment_id_s
+            ),
+            "", ""
+        },
+        {
+            _t("Accounts with a missing currency"),
+            "SELECT COUNT(*) FROM ACCOUNTLIST_V1 a "
+            "WHERE NOT EXISTS (SELECT 1 FROM CURRENCYFORMATS_V1 c WHERE c.CURRENCYID = a.CURRENCYID)",
+            "", ""
+        },
+        {
+            _t("Transactions with a missing payee"),
+            wxString::Format(
+                "SELECT COUNT(*) FROM CHECKINGACCOUNT_V1 t WHERE t.TRANSCODE <> '%s' "
+                "AND NOT EXISTS (SELECT 1 FROM PAYEE_V1 p WHERE p.PAYEEID = t.PAYEEID)",
+                transfer
+            ),
+            "", ""
+        },
+        {
+            _t("Split transactions with a missing transaction"),
+            "SELECT COUNT(*) FROM SPLITTRANSACTIONS_V1 s "
+            "WHERE NOT EXISTS (SELECT 1 FROM CHECKINGACCOUNT_V1 t WHERE t.TRANSID = s.TRANSID)",
+            _t("Delete the split transactions"),
+            "DELETE FROM SPLITTRANSACTIONS_V1 "
+            "WHERE NOT EXISTS (SELECT 1 FROM CHECKINGACCOUNT_V1 t WHERE t.TRANSID = SPLITTRANSACTIONS_V1.TRANSID)"
+        },
+        {
+            _t("Scheduled split transactions with a missing scheduled transaction"),
+            "SELECT COUNT(*) FROM BUDGETSPLITTRANSACTIONS_V1 s "
+            "WHERE NOT EXISTS (SELECT 1 FROM BILLSDEPOSITS_V1 t WHERE t.BDID = s.TRANSID)",
+            _t("Delete the scheduled split transactions"),
+            "DELETE FROM BUDGETSPLITTRANSACTIONS_V1 "
+            "WHERE NOT EXISTS (SELECT 1 FROM BILLSDEPOSITS_V1 t WHERE t.BDID = BUDGETSPLITTRANSACTIONS_V1.TRANSID)"
+        },
+        {
+            _t("Share details with a missing transaction"),
+            "SELECT COUNT(*) FROM SHAREINFO_V1 s "
+            "WHERE NOT EXISTS (SELECT 1 FROM CHECKINGACCOUNT_V1 t WHERE t.TRANSID = s.CHECKINGACCOUNTID)",
+            _t("Delete the share details"),
+            "DELETE FROM SHAREINFO_V1 "
+            "WHERE NOT EXISTS (SELECT 1 FROM CHECKINGACCOUNT_V1 t WHERE t.TRANSID = SHAREINFO_V1.CHECKINGACCOUNTID)"
+        },
+        {
+            _t("Transaction links with a missing transaction"),
+            "SELECT COUNT(*) FROM TRANSLINK_V1 l "
+            "WHERE NOT EXISTS (SELECT 1 FROM CHECKINGACCOUNT_V1 t WHERE t.TRANSID = l.CHECKINGACCOUNTID)",
+            _t("Delete the transaction links"),
+            "DELETE FROM TRANSLINK_V1 "
+            "WHERE NOT EXISTS (SELECT 1 FROM CHECKINGACCOUNT_V1 t WHERE t.TRANSID = TRANSLINK_V1.CHECKINGACCOUNTID)"
+        },
+        {
+            _t("Categories with a missing parent category"),
+            "SELECT COUNT(*) FROM CATEGORY_V1 c WHERE c.PARENTID IS NOT NULL AND c.PARENTID <> -1 "
+            "AND NOT EXISTS (SELECT 1 FROM CATEGORY_V1 p WHERE p.CATEGID = c.PARENTID)",
+            _t("Move the categories to the top level"),
+            "UPDATE CATEGORY_V1 SET PARENTID = -1 WHERE PARENTID IS NOT NULL AND PARENTID <> -1 "
+            "AND NOT EXISTS (SELECT 1 FROM CATEGORY_V1 p WHERE p.CATEGID = CATEGORY_V1.PARENTID)"
+        },
+        {
+            _t("Payees with a missing default category"),
+            "SELECT COUNT(*) FROM PAYEE_V1 p WHERE p.CATEGID IS NOT NULL AND p.CATEGID <> -1 "
+            "AND NOT EXISTS (SELECT 1 FROM CATEGORY_V1 c WHERE c.CATEGID = p.CATEGID)",
+            _t("Remove the default category"),
+            "UPDATE PAYEE_V1 SET CATEGID = -1 WHERE CATEGID IS NOT NULL AND CATEGID <> -1 "
+            "AND NOT EXISTS (SELECT 1 FROM CATEGORY_V1 c WHERE c.CATEGID = PAYEE_V1.CATEGID)"
+        },
+        {
+            _t("Budget entries with a missing budget or category"),
+            "SELECT COUNT(*) FROM BUDGETTABLE_V1 b "
+            "WHERE NOT EXISTS (SELECT 1 FROM BUDGETYEAR_V1 y WHERE y.BUDGETYEARID = b.BUDGETYEARID) "
+            "OR NOT EXISTS (SELECT 1 FROM CATEGORY_V1 c WHERE c.CATEGID = b.CATEGID)",
+            _t("Delete the budget entries"),
+            "DELETE FROM BUDGETTABLE_V1 "
+            "WHERE NOT EXISTS (SELECT 1 FROM BUDGETYEAR_V1 y WHERE y.BUDGETYEARID = BUDGETTABLE_V1.BUDGETYEARID) "
+            "OR NOT EXISTS (SELECT 1 FROM CATEGORY_V1 c WHERE c.CATEGID = BUDGETTABLE_V1.CATEGID)"
+        },
+        {
+            _t("Attachments of a missing transaction"),
+            wxString::Format(
+                "SELECT COUNT(*) FROM ATTACHMENT_V1 f WHERE f.REFTYPE = '%s' "
+                "AND NOT EXISTS (SELECT 1 FROM CHECKINGACCOUNT_V1 t WHERE t.TRANSID = f.REFID)",
+                TrxModel::s_ref_type.key_n()
+            ),
+            "", ""
+        },
+    };
 }
 
-bool dbCheck::checkAccounts()
-{
-    bool result = true;
-
-    // Transactions
-    for (const auto& trx_d : TrxModel::instance().find_data_a()) {
-        if (!AccountModel::instance().get_idN_data_n(trx_d.m_account_id) || (
-            trx_d.is_transfer() &&
-            !AccountModel::instance().get_idN_data_n(trx_d.m_to_account_id_n)
-        )) {
-            result = false;
-        }
-    }
+// Run the checks in parallel, and return the findings (checks with a
+// positive count), in the order of check_a.
+// The checks are distributed round-robin to a few groups; each group opens
+// its own read-only connection. A check which fails is skipped.
+std::vector<dbCheck::Finding> dbCheck::run(
+    const std::vector<Check>& check_a,
+    const wxString& dbpath,
+    const wxString& key
+) {
+    std::size_t group_c = std::max<std::size_t>(1, std::min<std::size_t>(
+        check_a.size(), std::min(4u, std::thread::hardware_concurrency())
+    ));
+    std::vector<std::vector<std::size_t>> group_a(group_c);
+    for (std::size_t i = 0; i < check_a.size(); ++i)
+        group_a[i % group_c].push_back(i);
 
-    // BillsDeposits
-    for (const auto& sched_d : SchedModel::instance().find_data_a()) {
-        if (!AccountModel::instance().get_idN_data_n(sched_d.m_account_id) || (
-            sched_d.is_transfer() &&
-            !AccountModel::instance().get_idN_data_n(sched_d.m_to_account_id_n)
-        )) {
-            result = false;
-        }
+    std::vector<std::future<std::vector<Finding>>> task_a;
+    for (const auto& check_i_a : group_a) {
+        task_a.push_back(std::async(std::launch::async,
+            [&check_a, check_i_a, &dbpath, &key]() {
+                return run_group(check_a, check_i_a, dbpath, key);
+            }
+        ));
     }
 
-    // Stocks
-    for (const auto& stock_d : StockModel::instance().find_data_a()) {
-        const auto& account_n = AccountModel::instance().get_idN_data_n(stock_d.m_account_id_n);
-        if (!account_n ||
-            AccountModel::type_id(*account_n) != mmNavigatorItem::TYPE_ID_INVESTMENT
-        ) {
-            result = false;
-        }
+    std::vector<Finding> finding_a;
+    for (auto& task : task_a) {
+        for (const Finding& finding : task.get())
+            finding_a.push_back(finding);
     }
-
-    return result;
-}
-
-bool dbCheck::checkAttachments()
-{
-    return true;
+    std::sort(finding_a.begin(), finding_a.end(),
+        [](const Finding& x, const Finding& y) { return x.m_check_i < y.m_check_i; }
+    );
+    return finding_a;
 }
 
-bool dbCheck::checkBudgets()
-{
-    return true;
-}
+std::vector<dbCheck::Finding> dbCheck::run_group(
+    const std::vector<Check>& check_a,
+    const std::vector<std::size_t>& check_i_a,
+    const wxString& dbpath,
+    const wxString& key
+) {
+    std::vector<Finding> finding_a;
+    wxSharedPtr<wxSQLite3Database> db = mmDBWrapper::OpenReadOnly(dbpath, key);
+    if (!db)
+        return finding_a;
 
-bool dbCheck::checkBudgetYears()
-{
-    return true;
-}
-
-bool dbCheck::checkCategories()
-{
-    return true;
-}
+    for (std::size_t check_i : check_i_a) {
+        try {
+            long count = db->ExecuteScalar(check_a[check_i].m_count_query);
+            if (count > 0)
+                finding_a.push_back({check_i, count});
+        }
+        catch (const wxSQLite3Exception& e) {
+            wxLogDebug("dbCheck: %s: %s", check_a[check_i].m_label, e.GetMessage());
+        }
+    }
 
-bool dbCheck::checkCurrencies()
-{
-    return true;
+    db->Close();
+    return finding_a;
 }
 
-bool dbCheck::checkPayees()
-{
-    return true;
+// Return a description of the findings, one per line, with the count and
+// the repair (if any).
+wxString dbCheck::format(
+    const std::vector<Check>& check_a,
+    const std::vector<Finding>& finding_a
+) {
+    wxString msg;
+    for (const Finding& finding : finding_a) {
+        const Check& check = check_a[finding.m_check_i];
+        msg << wxString::Format("%s: %ld", check.m_label, finding.m_count);
+        if (!check.m_repair_query.IsEmpty())
+            msg << " (" << check.m_repair_label << ")";
+        msg << "\n";
+    }
+    return msg;
 }
 
-bool dbCheck::checkStocks()
-{
-    return true;
+bool dbCheck::is_repairable(
+    const std::vector<Check>& check_a,
+    const std::vector<Finding>& finding_a
+) {
+    return std::any_of(finding_a.begin(), finding_a.end(),
+        [&check_a](const Finding& finding) {
+            return !check_a[finding.m_check_i].m_repair_query.IsEmpty();
+        }
+    );
 }
 
-bool dbCheck::checkSubcategories()
-{
-    return true;
-}
+// Repair the findings which have a repair query, in a single savepoint.
+// The changes are reported by the update hook, such that the caches of the
+// models are updated.
+bool dbCheck::repair(
+    wxSQLite3Database* db,
+    const std::vector<Check>& check_a,
+    const std::vector<Finding>& finding_a
+) {
+    db->Savepoint("DBCHECK");
+    try {
+        for (const Finding& finding : finding_a) {
+            const Check& check = check_a[finding.m_check_i];
+            if (check.m_repair_query.IsEmpty())
+                continue;
+            int row_c = db->ExecuteUpdate(check.m_repair_query);
+            wxLogDebug("dbCheck: %s: %d rows repaired", check.m_label, row_c);
+        }
+        db->ReleaseSavepoint("DBCHECK");
+    }
+    catch (const wxSQLite3Exception& e) {
+        wxLogError("dbCheck: Exception %s", e.GetMessage().utf8_str());
+        try {
+            db->Rollback("DBCHECK");
+            db->ReleaseSavepoint("DBCHECK");
+        }
+        catch (const wxSQLite3Exception& e) {
+            wxLogError("dbCheck: Exception %s", e.GetMessage().utf8_str());
+        }
+        return false;
+    }
 
-bool dbCheck::checkTransactions()
-{
     return true;
 }
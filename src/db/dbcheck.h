@@ -18,20 +18,66 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #pragma once
 
+#include <vector>
+#include <wx/string.h>
+
+class wxSQLite3Database;
+
+// dbCheck finds records which refer to missing (or invalid) records.
+// Each check is a single anti-join query, which counts the offending rows
+// with the indexes of the referenced tables; no table is loaded in memory.
+// The checks are independent: run() executes them in parallel, each group
+// on its own read-only connection, such that it can be called on a worker
+// thread. Some findings can be repaired with a single statement; repair()
+// is called on the GUI thread, on the main connection.
 class dbCheck
 {
-    static bool  checkAccounts();
-    static bool  checkAttachments();
-    static bool  checkBudgets();
-    static bool  checkBudgetYears();
-    static bool  checkCategories();
-    static bool  checkCurrencies();
-    static bool  checkPayees();
-    static bool  checkStocks();
-    static bool  checkSubcategories();
-    static bool  checkTransactions();
+public:
+    struct Check
+    {
+        wxString m_label;         // description of a finding
+        wxString m_count_query;   // SELECT COUNT(*) ...
+        wxString m_repair_label;  // description of the repair, if any
+        wxString m_repair_query;  // empty if the finding is not repaired automatically
+    };
+
+    struct Finding
+    {
+        std::size_t m_check_i;    // index in the list of checks
+        long m_count;
+    };
+
+// -- methods
 
 public:
-    static bool checkDB();
-};
+    // GUI thread
+    static auto get_check_a() -> std::vector<Check>;
+    // any thread
+    static auto run(
+        const std::vector<Check>& check_a,
+        const wxString& dbpath,
+        const wxString& key
+    ) -> std::vector<Finding>;
+    // GUI thread
+    static auto format(
+        const std::vector<Check>& check_a,
+        const std::vector<Finding>& finding_a
+    ) -> wxString;
+    static bool is_repairable(
+        const std::vector<Check>& check_a,
+        const std::vector<Finding>& finding_a
+    );
+    static bool repair(
+        wxSQLite3Database* db,
+        const std::vector<Check>& check_a,
+        const std::vector<Finding>& finding_a
+    );
 
+private:
+    static auto run_group(
+        const std::vector<Check>& check_a,
+        const std::vector<std::size_t>& check_i_a,
+        const wxString& dbpath,
+        const wxString& key
+    ) -> std::vector<Finding>;
+};
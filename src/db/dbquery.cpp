@@ -0,0 +1,176 @@
+/*******************************************************
+ Copyright (C) 2026 George Ef (george.a.ef@gmail.com)
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "base/_defs.h"
+#include <wx/stopwatch.h>
+
+#include "dbquery.h"
+#include "dbwrapper.h"
+
+dbQuery::~dbQuery()
+{
+    cancel();
+    join();
+}
+
+// Cancel the running query (if any), and start config.m_sql.
+// Return the id of the query, which is copied into each page.
+int dbQuery::start(const Config& config, PageFn page_fn)
+{
+    cancel();
+    join();
+
+    m_is_cancelled = false;
+    m_is_timeout = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_done = false;
+    }
+
+    int query_id = ++m_query_id;
+    bool is_snapshot = !mmDBWrapper::GetProfile().m_wal;
+    m_thread = std::thread([this, config, query_id, is_snapshot, page_fn]() {
+        run(config, query_id, is_snapshot, page_fn);
+    });
+
+    // interrupt the query if it is still running after m_time_max_msec
+    long time_max_msec = config.m_time_max_msec;
+    m_watch_thread = std::thread([this, time_max_msec]() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_cv.wait_for(lock, std::chrono::milliseconds(time_max_msec),
+            [this]() { return m_is_done; }
+        )) {
+            m_is_timeout = true;
+            if (m_db_n)
+                m_db_n->Interrupt();
+        }
+    });
+
+    return query_id;
+}
+
+void dbQuery::cancel()
+{
+    m_is_cancelled = true;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_db_n)
+        m_db_n->Interrupt();
+}
+
+bool dbQuery::is_running()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_is_done;
+}
+
+void dbQuery::join()
+{
+    if (m_thread.joinable())
+        m_thread.join();
+    if (m_watch_thread.joinable())
+        m_watch_thread.join();
+}
+
+void dbQuery::run(const Config& config, int query_id, bool is_snapshot, const PageFn& page_fn)
+{
+    wxStopWatch sw;
+    Page page;
+    page.m_query_id = query_id;
+    Page::STATUS status = Page::e_done;
+
+    wxSharedPtr<wxSQLite3Database> db;
+    if (is_snapshot) {
+        db = mmDBWrapper::OpenSnapshot(config.m_dbpath, config.m_key,
+            [this]() { return is_stopped(); }
+        );
+    }
+    // if the snapshot cannot be made, query the file directly
+    if (!db && !is_stopped())
+        db = mmDBWrapper::OpenReadOnly(config.m_dbpath, config.m_key);
+    if (db) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_db_n = db.get();
+    }
+    else {
+        status = Page::e_error;
+        page.m_error_code = Page::e_open;
+    }
+
+    try {
+        if (db && !is_stopped()) {
+            wxSQLite3Statement stmt = db->PrepareStatement(config.m_sql);
+            if (!stmt.IsReadOnly()) {
+                status = Page::e_error;
+                page.m_error_code = Page::e_not_read_only;
+            }
+            else {
+                wxSQLite3ResultSet q = stmt.ExecuteQuery();
+                int column_c = q.GetColumnCount();
+                for (int i = 0; i < column_c; ++i)
+                    page.m_column_a.push_back({q.GetColumnName(i), q.GetColumnType(i)});
+
+                std::size_t row_c = 0;
+                while (q.NextRow()) {
+                    if (is_stopped())
+                        break;
+                    if (row_c >= config.m_row_max) {
+                        status = Page::e_row_max;
+                        break;
+                    }
+                    Row row;
+                    row.reserve(column_c);
+                    for (int i = 0; i < column_c; ++i)
+                        row.push_back(q.GetAsString(i));
+                    page.m_row_a.push_back(std::move(row));
+                    ++row_c;
+
+                    if (page.m_row_a.size() >= config.m_page_size) {
+                        page.m_msec = sw.Time();
+                        page_fn(page);
+                        page.m_column_a.clear();
+                        page.m_row_a.clear();
+                    }
+                }
+            }
+        }
+    }
+    catch (const wxSQLite3Exception& e) {
+        status = Page::e_error;
+        page.m_error_code = Page::e_sqlite;
+        page.m_error = e.GetMessage();
+        page.m_error.Replace(" or missing database[1]:", "");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_db_n = nullptr;
+        m_is_done = true;
+    }
+    m_cv.notify_all();
+    if (db)
+        db->Close();
+
+    if (m_is_timeout)
+        status = Page::e_timeout;
+    else if (m_is_cancelled)
+        status = Page::e_cancelled;
+
+    page.m_status = status;
+    page.m_msec = sw.Time();
+    page_fn(page);
+}
@@ -0,0 +1,128 @@
+/*******************************************************
+ Copyright (C) 2026 George Ef (george.a.ef@gmail.com)
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <wx/string.h>
+
+class wxSQLite3Database;
+
+// dbQuery executes a user query on a worker thread, on its own read-only
+// connection, and delivers the result rows in pages.
+// The query can be cancelled at any time; it is interrupted (with
+// sqlite3_interrupt) if it runs longer than m_time_max_msec. At most
+// m_row_max rows are fetched.
+// While the query runs, its connection holds a SHARED lock. With the rollback
+// journal (mmDBWrapper::Profile::m_wal is false), a commit on the main
+// connection would wait for that lock only for its busy timeout (2 s); thus
+// the worker copies the database into an in-memory snapshot and queries the
+// snapshot instead.
+// page_fn is called on the worker thread; it shall post the page to the GUI
+// thread. start(), cancel() and is_running() are called on the GUI thread.
+// Pages carry error codes, not messages; the GUI translates them.
+class dbQuery
+{
+public:
+    struct Config
+    {
+        wxString    m_dbpath;
+        wxString    m_key;
+        wxString    m_sql;
+        std::size_t m_page_size = 500;
+        std::size_t m_row_max = 100000;
+        long        m_time_max_msec = 30000;
+    };
+
+    struct Column
+    {
+        wxString m_name;
+        int      m_type;         // WXSQLITE_INTEGER, WXSQLITE_FLOAT, ...
+    };
+
+    using Row = std::vector<wxString>;
+
+    struct Page
+    {
+        enum STATUS
+        {
+            e_running = 0,
+            e_done,
+            e_row_max,           // the result is truncated
+            e_cancelled,
+            e_timeout,
+            e_error,
+        };
+
+        enum ERROR_CODE
+        {
+            e_no_error = 0,
+            e_open,              // the database cannot be opened
+            e_not_read_only,     // the statement may write to the database
+            e_sqlite,            // m_error is the message of SQLite
+        };
+
+        int m_query_id = 0;
+        std::vector<Column> m_column_a;  // in the first page only
+        std::vector<Row> m_row_a;
+        STATUS m_status = e_running;     // e_running, except in the last page
+        ERROR_CODE m_error_code = e_no_error; // if m_status is e_error
+        wxString m_error;
+        long m_msec = 0;                 // since the query has started
+
+        bool is_last() const { return m_status != e_running; }
+    };
+
+    using PageFn = std::function<void(const Page&)>;
+
+// -- state
+
+private:
+    std::thread m_thread;
+    std::thread m_watch_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    wxSQLite3Database* m_db_n = nullptr;  // worker connection; guarded by m_mutex
+    bool m_is_done = true;                // guarded by m_mutex
+    std::atomic<bool> m_is_cancelled{false};
+    std::atomic<bool> m_is_timeout{false};
+    int m_query_id = 0;
+
+// -- constructor
+
+public:
+    dbQuery() {}
+    ~dbQuery();
+
+// -- methods
+
+public:
+    auto start(const Config& config, PageFn page_fn) -> int;
+    void cancel();
+    bool is_running();
+
+private:
+    void join();
+    void run(const Config& config, int query_id, bool is_snapshot, const PageFn& page_fn);
+    bool is_stopped() const { return m_is_cancelled || m_is_timeout; }
+};
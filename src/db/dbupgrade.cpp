@@ -18,16 +18,20 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 ********************************************************/
 
 #include "base/_defs.h"
+#include <wx/dir.h>
 #include <wx/filedlg.h>
 #include <wx/filename.h>
 #include <wx/msgdlg.h>
 #include <wx/textdlg.h>
 #include <wx/textfile.h>
 #include <wx/tokenzr.h>
+#include <wx/wfstream.h>
+#include <wx/zipstrm.h>
 
 #include "base/_constants.h"
 #include "util/_util.h"
 #include "dbupgrade.h"
+#include "dbwrapper.h"
 
 int dbUpgrade::GetCurrentVersion(wxSQLite3Database * db)
 {
@@ -98,7 +102,7 @@ bool dbUpgrade::InitializeVersion(wxSQLite3Database* db, int version)
     }
 }
 
-bool dbUpgrade::UpgradeDB(wxSQLite3Database * db, const wxString& DbFileName)
+bool dbUpgrade::UpgradeDB(wxSQLite3Database * db, const wxString& DbFileName, const wxString& password)
 {
     int ver = GetCurrentVersion(db);
 
@@ -112,7 +116,10 @@ bool dbUpgrade::UpgradeDB(wxSQLite3Database * db, const wxString& DbFileName)
 
     for (; ver < dbLatestVersion; ver++)
     {
-        BackupDB(DbFileName, dbUpgrade::BACKUPTYPE::VERSION_UPGRADE, 999, ver);
+        BackupParam param;
+        param.m_password = password;
+        param.m_db = db;
+        BackupDB(DbFileName, dbUpgrade::BACKUPTYPE::VERSION_UPGRADE, 999, ver, param);
         if (!UpgradeToVersion(db, ver + 1))
             return false;
     }
@@ -124,46 +131,159 @@ bool dbUpgrade::UpgradeDB(wxSQLite3Database * db, const wxString& DbFileName)
     return true;
 }
 
-void dbUpgrade::BackupDB(const wxString& FileName, int BackupType, int FilesToKeep, int UpgradeVersion)
+namespace
 {
+
+class BackupProgressCallback : public wxSQLite3BackupProgress
+{
+public:
+    explicit BackupProgressCallback(const dbUpgrade::BackupProgress& progress) :
+        m_progress(progress) {}
+
+    virtual bool Progress(int totalPages, int remainingPages)
+    {
+        m_cancelled = m_progress && !m_progress(
+            totalPages > 0 ? (totalPages - remainingPages) * 100 / totalPages : 100
+        );
+        return !m_cancelled;
+    }
+
+    bool m_cancelled = false;
+
+private:
+    const dbUpgrade::BackupProgress& m_progress;
+};
+
+bool CompressFile(const wxString& FileName, const wxString& ZipFileName, const wxString& EntryName)
+{
+    wxFileInputStream in(FileName);
+    wxFileOutputStream out(ZipFileName);
+    if (!in.IsOk() || !out.IsOk())
+        return false;
+
+    wxZipOutputStream zip(out);
+    zip.PutNextEntry(EntryName);
+    zip.Write(in);
+    return zip.Close() && out.Close();
+}
+
+} // namespace
+
+/*
+    Copy the database FileName into BackupFileName (or BackupFileName.zip),
+    with the SQLite online backup API. The copy is a consistent snapshot, even
+    if the database is modified during the backup; it is encrypted with the
+    same password as the database.
+    The copy is written into a temporary file, which is renamed when it is
+    complete. If the backup API cannot be used, the file is copied instead.
+*/
+bool dbUpgrade::CopyDB(const wxString& FileName, const wxString& BackupFileName, const BackupParam& param)
+{
+    const wxString tmpFileName = BackupFileName.BeforeLast('.') + ".tmp";
+    if (wxFileName::FileExists(tmpFileName))
+        wxRemoveFile(tmpFileName);
+
+    wxSharedPtr<wxSQLite3Database> ro_db;
+    wxSQLite3Database* db = param.m_db;
+    if (!db) {
+        ro_db = mmDBWrapper::OpenReadOnly(FileName, param.m_password);
+        db = ro_db.get();
+    }
+
+    bool ok = false;
+    // never write an unencrypted copy of an encrypted database
+    if (db && (!db->IsEncrypted() || !param.m_password.empty())) {
+        BackupProgressCallback callback(param.m_progress);
+        wxSQLite3CipherSQLCipher cipher;
+        cipher.InitializeVersionDefault(4);
+        cipher.SetLegacy(true);
+        try {
+            db->SetBackupRestorePageCount(256);
+            db->Backup(&callback, tmpFileName, cipher, param.m_password);
+            ok = !callback.m_cancelled;
+        }
+        catch (const wxSQLite3Exception& e) {
+            wxLogDebug("dbUpgrade::CopyDB: %s", e.GetMessage());
+        }
+        if (callback.m_cancelled) {
+            wxRemoveFile(tmpFileName);
+            return false;
+        }
+    }
+    if (ro_db)
+        ro_db->Close();
+
+    if (!ok)
+        ok = wxCopyFile(FileName, tmpFileName, true);
+
+    if (ok && param.m_compress) {
+        const wxString tmpZipFileName = tmpFileName + ".zip";
+        ok = CompressFile(tmpFileName, tmpZipFileName, wxFileName(BackupFileName).GetFullName());
+        wxRemoveFile(tmpFileName);
+        if (ok)
+            ok = wxRenameFile(tmpZipFileName, BackupFileName + ".zip", true);
+        else
+            wxRemoveFile(tmpZipFileName);
+        // only one backup per day and type
+        if (ok && wxFileName::FileExists(BackupFileName))
+            wxRemoveFile(BackupFileName);
+    }
+    else if (ok) {
+        ok = wxRenameFile(tmpFileName, BackupFileName, true);
+        if (ok && wxFileName::FileExists(BackupFileName + ".zip"))
+            wxRemoveFile(BackupFileName + ".zip");
+    }
+    else {
+        wxRemoveFile(tmpFileName);
+    }
+
+    return ok;
+}
+
+/*
+    Backup FileName according to BackupType, and remove the oldest backups
+    of the same type, keeping FilesToKeep of them.
+    The backup file name is FileName followed by _start_, _update_ or
+    _upgrade_vN_, and the current date. A compressed backup has the
+    additional extension .zip.
+    BackupDB() can run on a worker thread, if param.m_db is nullptr.
+    Return false if the backup has failed or it has been cancelled.
+*/
+bool dbUpgrade::BackupDB(const wxString& FileName, int BackupType, int FilesToKeep, int UpgradeVersion,
+    const BackupParam& param
+) {
     wxFileName fn(FileName);
-    if (!fn.IsOk()) return;
+    if (!fn.IsOk()) return false;
 
     const wxString BackupName[3] = { "_start_", "_update_", wxString::Format("_upgrade_v%i_", UpgradeVersion) };
     const auto backupFileName = wxString::Format("%s%s%s.bak", FileName, BackupName[BackupType], wxDateTime().Today().FormatISODate());
-    wxFileName fnBak(backupFileName);
+    const bool backupExists = wxFileName::FileExists(backupFileName) ||
+        wxFileName::FileExists(backupFileName + ".zip");
 
     // process backup
+    bool ok = true;
     switch (BackupType)
     {
     case BACKUPTYPE::START:
-        if (!fnBak.FileExists()) {
-            wxCopyFile(FileName, backupFileName, true);
+    case BACKUPTYPE::VERSION_UPGRADE:
+        if (!backupExists) {
+            ok = CopyDB(FileName, backupFileName, param);
         }
         break;
     case BACKUPTYPE::CLOSE:
-        wxCopyFile(FileName, backupFileName, true);
-        break;
-    case BACKUPTYPE::VERSION_UPGRADE:
-        if (!fnBak.FileExists()) {
-            wxCopyFile(FileName, backupFileName, true);
-        }
+        ok = CopyDB(FileName, backupFileName, param);
         break;
     default:
         break;
     }
 
     // Cleanup old backups
-    if (BackupType != BACKUPTYPE::VERSION_UPGRADE)
+    if (ok && BackupType != BACKUPTYPE::VERSION_UPGRADE)
     {
-        wxSortedArrayString backupFileArray;
-        const auto fileSearch = wxString::Format(R"(%s%s????-??-??.bak)", FileName, BackupName[BackupType]);
-        wxString backupFile = wxFindFirstFile(fileSearch);
-        while (!backupFile.empty())
-        {
-            backupFileArray.Add(backupFile);
-            backupFile = wxFindNextFile();
-        }
+        wxArrayString backupFileArray;
+        const auto fileSearch = wxString::Format(R"(%s%s????-??-??.bak*)", fn.GetFullName(), BackupName[BackupType]);
+        wxDir::GetAllFiles(fn.GetPath().empty() ? "." : fn.GetPath(), &backupFileArray, fileSearch, wxDIR_FILES);
+        backupFileArray.Sort();
 
         while (backupFileArray.GetCount() > static_cast<size_t>(FilesToKeep))
         {
@@ -176,6 +296,8 @@ void dbUpgrade::BackupDB(const wxString& FileName, int BackupType, int FilesToKe
             backupFileArray.erase(backupFileArray.begin());
         }
     }
+
+    return ok;
 }
 
 void dbUpgrade::SqlFileDebug(wxSQLite3Database * db)
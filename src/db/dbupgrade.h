@@ -19,19 +19,35 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #pragma once
 
 #include "base/_defs.h"
+#include <functional>
 #include "table/_TableBase.h"
 #include "table/_TableUpgrade.h"
 
 class dbUpgrade
 {
+public:
+    // Receives the percentage copied; returns false to cancel the backup.
+    // It is called on the thread which runs BackupDB().
+    using BackupProgress = std::function<bool(int)>;
+    struct BackupParam
+    {
+        wxString m_password;                // key of an encrypted database
+        wxSQLite3Database* m_db = nullptr;  // connection to copy from; if nullptr, a read-only connection is opened
+        bool m_compress = false;            // store the backup in a zip archive (.bak.zip)
+        BackupProgress m_progress = nullptr;
+    };
+
+private:
     static int GetCurrentVersion(wxSQLite3Database * db);
     static std::vector<wxString> SplitQueries(const wxString& statement);
     static bool UpgradeToVersion(wxSQLite3Database * db, int version);
+    static bool CopyDB(const wxString& FileName, const wxString& BackupFileName, const BackupParam& param);
 public:
     static bool InitializeVersion(wxSQLite3Database* db, int version = dbLatestVersion);
     static bool isUpgradeDBrequired(wxSQLite3Database* db);
-    static bool UpgradeDB(wxSQLite3Database* db, const wxString& DbFileName);
-    static void BackupDB(const wxString& Filename, int BackupType, int FilesToKeep, int UpgradeVersion = 0);
+    static bool UpgradeDB(wxSQLite3Database* db, const wxString& DbFileName, const wxString& password = "");
+    static bool BackupDB(const wxString& Filename, int BackupType, int FilesToKeep, int UpgradeVersion = 0,
+        const BackupParam& param = BackupParam());
     enum BACKUPTYPE { START = 0, CLOSE, VERSION_UPGRADE };
     static void SqlFileDebug(wxSQLite3Database * db);
 };
@@ -24,22 +24,90 @@
 #include "util/_util.h"
 #include "dbwrapper.h"
 
+namespace
+{
+
+mmDBWrapper::Profile s_profile;
+
+// Set a pragma and return its new value (empty if the pragma returns nothing)
+wxString SetPragma(wxSQLite3Database* db, const wxString& name, const wxString& value)
+{
+    wxSQLite3ResultSet q = db->ExecuteQuery(wxString::Format("PRAGMA %s = %s;", name, value));
+    return q.NextRow() ? q.GetAsString(0) : wxString();
+}
+
+class SnapshotProgressCallback : public wxSQLite3BackupProgress
+{
+public:
+    explicit SnapshotProgressCallback(const std::function<bool()>& is_cancelled_n) :
+        m_is_cancelled_n(is_cancelled_n) {}
+
+    virtual bool Progress(int WXUNUSED(totalPages), int WXUNUSED(remainingPages))
+    {
+        m_cancelled = m_is_cancelled_n && m_is_cancelled_n();
+        return !m_cancelled;
+    }
+
+    bool m_cancelled = false;
+
+private:
+    const std::function<bool()>& m_is_cancelled_n;
+};
+
 /*
-    SQLITE_OPEN_READWRITE
-    The database is opened for reading and writing if possible, or reading
-    only if the file is write protected by the operating system.  In either
-    case the database must already exist, otherwise an error is returned.
+    Apply s_profile to a newly opened connection.
+    The journal mode can be changed only on a read-write connection; the
+    mode set here is persistent, therefore it is set in both directions.
+    Memory-mapped I/O bypasses the cipher codec and is not used for
+    encrypted databases.
+    Errors are not fatal; the connection keeps the SQLite defaults.
 */
-wxSharedPtr<wxSQLite3Database> static_db_ptr()
+void ApplyProfile(wxSQLite3Database* db, bool read_only)
 {
-    static wxSharedPtr<wxSQLite3Database> db(new wxSQLite3Database);
+    try
+    {
+        if (s_profile.m_cache_size > 0)
+            SetPragma(db, "cache_size", wxString::Format("-%d", s_profile.m_cache_size));
+        SetPragma(db, "temp_store", "MEMORY");
+        if (!db->IsEncrypted())
+            SetPragma(db, "mmap_size", wxString::Format("%lld",
+                static_cast<wxLongLong_t>(s_profile.m_mmap_size) * 1024 * 1024
+            ));
 
-    return db;
+        if (read_only)
+            return;
+
+        const wxString journal_mode = SetPragma(db, "journal_mode", s_profile.m_wal ? "WAL" : "DELETE");
+        if (journal_mode.Lower() == "wal")
+            SetPragma(db, "synchronous", "NORMAL");
+    }
+    catch (const wxSQLite3Exception& e)
+    {
+        wxLogDebug("mmDBWrapper::ApplyProfile: %s", e.GetMessage());
+    }
 }
 
+} // namespace
+
+void mmDBWrapper::SetProfile(const Profile& profile)
+{
+    s_profile = profile;
+}
+
+const mmDBWrapper::Profile& mmDBWrapper::GetProfile()
+{
+    return s_profile;
+}
+
+/*
+    SQLITE_OPEN_READWRITE
+    The database is opened for reading and writing if possible, or reading
+    only if the file is write protected by the operating system.  In either
+    case the database must already exist, otherwise an error is returned.
+*/
 wxSharedPtr<wxSQLite3Database> mmDBWrapper::Open(const wxString &dbpath, const wxString &password, const bool debug)
 {
-    wxSharedPtr<wxSQLite3Database> db = static_db_ptr();
+    wxSharedPtr<wxSQLite3Database> db(new wxSQLite3Database);
 
     int err = SQLITE_OK;
     wxString errStr=wxEmptyString;
@@ -102,6 +170,7 @@ wxSharedPtr<wxSQLite3Database> mmDBWrapper::Open(const wxString &dbpath, const w
     {
         //timeout 2 sec
         db->SetBusyTimeout(2000);
+        ApplyProfile(db.get(), false);
 
         return (db);
     }
@@ -129,5 +198,127 @@ wxSharedPtr<wxSQLite3Database> mmDBWrapper::Open(const wxString &dbpath, const w
     return db; // return a nullptr database pointer
 }
 
-//----------------------------------------------------------------------------
+/*
+    Open an additional read-only connection to dbpath, which is independent
+    of the main connection returned by Open(). It is meant for worker threads,
+    which read the database while the main connection stays on the UI thread.
+    No message is shown on failure; a nullptr database pointer is returned and
+    the caller is expected to fall back to the main connection.
+*/
+wxSharedPtr<wxSQLite3Database> mmDBWrapper::OpenReadOnly(const wxString &dbpath, const wxString &password)
+{
+    wxSharedPtr<wxSQLite3Database> db(new wxSQLite3Database);
+
+    wxSQLite3CipherSQLCipher cipher;
+    cipher.InitializeVersionDefault(4);
+    cipher.SetLegacy(true);
+
+    try
+    {
+        db->Open(dbpath, cipher, password, WXSQLITE_OPEN_READONLY);
+        db->ExecuteQuery("select * from INFOTABLE_V1;");
+        db->SetBusyTimeout(2000);
+        ApplyProfile(db.get(), true);
+    }
+    catch (const wxSQLite3Exception& e)
+    {
+        wxLogDebug("mmDBWrapper::OpenReadOnly: %s", e.GetMessage());
+        db->Close();
+        db.reset();
+    }
+
+    return db;
+}
+
+/*
+    Copy the database into a new in-memory database, with the SQLite online
+    backup API. The source file is locked (SHARED) only during each step of
+    the copy, so that a query on the snapshot does not block the commits of
+    another connection. Return a null pointer if the copy fails or is
+    cancelled.
+*/
+wxSharedPtr<wxSQLite3Database> mmDBWrapper::OpenSnapshot(
+    const wxString &dbpath, const wxString &password,
+    const std::function<bool()>& is_cancelled_n
+) {
+    wxSharedPtr<wxSQLite3Database> db(new wxSQLite3Database);
+
+    wxSQLite3CipherSQLCipher cipher;
+    cipher.InitializeVersionDefault(4);
+    cipher.SetLegacy(true);
 
+    SnapshotProgressCallback callback(is_cancelled_n);
+    try
+    {
+        db->Open(":memory:");
+        db->SetBackupRestorePageCount(256);
+        db->Restore(&callback, dbpath, cipher, password);
+        if (callback.m_cancelled)
+        {
+            db->Close();
+            db.reset();
+        }
+    }
+    catch (const wxSQLite3Exception& e)
+    {
+        wxLogDebug("mmDBWrapper::OpenSnapshot: %s", e.GetMessage());
+        db->Close();
+        db.reset();
+    }
+
+    return db;
+}
+
+/*
+    Close a connection returned by Open().
+    The query planner statistics are refreshed, and a write-ahead log is
+    checkpointed and removed, so that the closed database is a single file
+    (it can be copied, backed up, or opened by older versions and by the
+    mobile apps). If another connection is still open, the journal mode
+    stays WAL and it is reset by the next Open().
+*/
+void mmDBWrapper::Close(wxSQLite3Database* db)
+{
+    if (!db || !db->IsOpen())
+        return;
+
+    try
+    {
+        db->ExecuteQuery("PRAGMA optimize;");
+        if (db->ExecuteQuery("PRAGMA journal_mode;").GetAsString(0).Lower() == "wal")
+        {
+            db->ExecuteQuery("PRAGMA wal_checkpoint(TRUNCATE);");
+            SetPragma(db, "journal_mode", "DELETE");
+        }
+    }
+    catch (const wxSQLite3Exception& e)
+    {
+        wxLogDebug("mmDBWrapper::Close: %s", e.GetMessage());
+    }
+
+    db->Close();
+}
+
+std::vector<std::pair<wxString, wxString>> mmDBWrapper::GetPragmaValues(wxSQLite3Database* db)
+{
+    std::vector<std::pair<wxString, wxString>> pragma_a;
+    if (!db || !db->IsOpen())
+        return pragma_a;
+
+    for (const wxString name : {
+        "journal_mode", "synchronous", "cache_size", "mmap_size", "temp_store",
+        "page_size", "page_count", "freelist_count"
+    }) {
+        try
+        {
+            wxSQLite3ResultSet q = db->ExecuteQuery(wxString::Format("PRAGMA %s;", name));
+            pragma_a.emplace_back(name, q.NextRow() ? q.GetAsString(0) : wxString());
+        }
+        catch (const wxSQLite3Exception& e)
+        {
+            pragma_a.emplace_back(name, e.GetMessage());
+        }
+    }
+
+    return pragma_a;
+}
@@ -21,13 +21,37 @@
 #include "base/_defs.h"
 #include <wx/arrstr.h>
 #include <wx/sharedptr.h>
+#include <functional>
+#include <vector>
 
 class wxSQLite3Database;
 
 namespace mmDBWrapper
 {
 
+    // Connection settings applied by Open() and OpenReadOnly()
+    struct Profile
+    {
+        bool m_wal = false;         // write-ahead log while the database is open
+        int m_cache_size = 16384;   // page cache size (KiB); 0 keeps the default
+        int m_mmap_size = 256;      // memory-mapped I/O size (MiB); 0 disables it
+    };
+
+    void SetProfile(const Profile& profile);
+    const Profile& GetProfile();
+
     wxSharedPtr<wxSQLite3Database> Open(const wxString &dbpath, const wxString &key = "", const bool debug = false);
+    wxSharedPtr<wxSQLite3Database> OpenReadOnly(const wxString &dbpath, const wxString &key = "");
+    // Copy the database into a new in-memory database; is_cancelled_n is
+    // polled between the steps of the copy
+    wxSharedPtr<wxSQLite3Database> OpenSnapshot(
+        const wxString &dbpath, const wxString &key = "",
+        const std::function<bool()>& is_cancelled_n = nullptr
+    );
+    void Close(wxSQLite3Database* db);
+
+    // Return the name and value of the pragmas set by the profile (and a few others)
+    std::vector<std::pair<wxString, wxString>> GetPragmaValues(wxSQLite3Database* db);
 
 } // namespace mmDBWrapper
 
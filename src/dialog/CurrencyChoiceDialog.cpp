@@ -500,7 +500,7 @@ void CurrencyChoiceDialog::OnListItemActivated(wxDataViewEvent& /* event */)
 bool CurrencyChoiceDialog::OnlineUpdateCurRate(int64 curr_id, bool hide)
 {
     wxString msg = wxEmptyString;
-    bool ok = getOnlineCurrencyRates(msg, curr_id, w_show_all_cb->IsChecked());
+    bool ok = getOnlineCurrencyRates(msg, curr_id, w_show_all_cb->IsChecked(), this);
     if (ok)
     {
         if (!hide)
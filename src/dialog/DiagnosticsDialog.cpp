@@ -24,6 +24,7 @@ Copyright (C) 2021 Mark Whalley (mark@ipx.co.uk)
 #include "util/mmImage.h"
 #include "util/_util.h"
 
+#include "db/dbwrapper.h"
 #include "model/AccountModel.h"
 #include "model/CategoryModel.h"
 #include "model/PayeeModel.h"
@@ -51,9 +52,10 @@ const char HTMLPANEL[] = R"(<!DOCTYPE html>
 </body>
 </html>)";
 
-DiagnosticsDialog::DiagnosticsDialog(wxWindow* parent, bool is_maximized)
+DiagnosticsDialog::DiagnosticsDialog(wxWindow* parent, bool is_maximized, wxSQLite3Database* db)
     : m_parent(parent)
     , m_is_max(is_maximized)
+    , m_db(db)
 {
 
     createWindow(parent, _t("Diagnostics"));
@@ -139,6 +141,25 @@ void DiagnosticsDialog::RefreshView()
          << "</td></tr>";
     html << "</table>";
     html << "</p>";
+
+    // Connection settings
+    if (m_db) {
+        const mmDBWrapper::Profile& profile = mmDBWrapper::GetProfile();
+        html << "<p>";
+        html << "<h1>Database Connection</h1>";
+        html << "<br>";
+        html << wxString::Format("profile : wal:%s, cache_size:%i KiB, mmap_size:%i MiB, encrypted:%s"
+            , profile.m_wal ? "true" : "false"
+            , profile.m_cache_size, profile.m_mmap_size
+            , m_db->IsEncrypted() ? "true" : "false");
+        html << "<table>";
+        for (const auto& [name, value] : mmDBWrapper::GetPragmaValues(m_db)) {
+            html << "<tr><td><b>" << name << "</b></td><td>" << value
+                 << "</td></tr>";
+        }
+        html << "</table>";
+        html << "</p>";
+    }
     
     html << "<p>";  
     html << "<h1>Screen geometry</h1>";
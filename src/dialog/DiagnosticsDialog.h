@@ -27,7 +27,7 @@ class DiagnosticsDialog : public wxDialog
     wxDECLARE_EVENT_TABLE();
 
 public:
-    DiagnosticsDialog(wxWindow* parent, bool is_maximized);
+    DiagnosticsDialog(wxWindow* parent, bool is_maximized, wxSQLite3Database* db = nullptr);
     ~DiagnosticsDialog() {};
 private:
     bool createWindow(wxWindow* parent
@@ -38,6 +38,7 @@ private:
     wxWindow* m_parent = nullptr;
     wxButton* m_okButton = nullptr;
     bool m_is_max = false;
+    wxSQLite3Database* m_db = nullptr;
 
 private:
 
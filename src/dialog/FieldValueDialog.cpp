@@ -507,10 +507,25 @@ const wxString FieldValueDialog::GetWidgetData(wxWindowID win_id) const
 }
 
 bool FieldValueDialog::SaveCustomValues(RefTypeN ref_type, int64 ref_id)
+{
+    TableWork work;
+    bool changed = SaveCustomValues(work, ref_type, ref_id);
+    if (!work.flush())
+        return false;
+
+    if (ref_type == TrxModel::s_ref_type && changed)
+        TrxModel::instance().save_timestamp(ref_id);
+
+    return true;
+}
+
+// Queue in work the values of the changed widgets.
+// Return true if the values of ref_id are changed; in that case the caller
+// shall update the timestamp of the referenced record.
+bool FieldValueDialog::SaveCustomValues(TableWork& work, RefTypeN ref_type, int64 ref_id)
 {
     bool changed = false;
 
-    FieldValueModel::instance().db_savepoint();
     int field_index = 0;
     for (const auto& field_d : m_field_a) {
         const FieldValueData* fv_n = FieldValueModel::instance().get_key_data_n(
@@ -534,26 +549,24 @@ bool FieldValueDialog::SaveCustomValues(RefTypeN ref_type, int64 ref_id)
             if (!fv_n || !fv_d.equals(fv_n))
                 changed = true;
 
-            FieldValueModel::instance().save_data_n(fv_d);
+            FieldValueModel::instance().work_save(work, fv_d);
         }
         else if (fv_n) {
-            FieldValueModel::instance().purge_id(fv_n->m_id);
+            FieldValueModel::instance().work_remove(work, fv_n->m_id);
             changed = true;
         }
     }
-    FieldValueModel::instance().db_release_savepoint();
-
-    if (ref_type == TrxModel::s_ref_type && changed)
-        TrxModel::instance().save_timestamp(ref_id);
 
-    return true;
+    return changed;
 }
 
-void FieldValueDialog::UpdateCustomValues(RefTypeN ref_type, int64 ref_id)
+// Queue in work the values of the checked fields of ref_id.
+// Return true if the values are changed; in that case the caller shall
+// update the timestamp of the referenced record.
+bool FieldValueDialog::UpdateCustomValues(TableWork& work, RefTypeN ref_type, int64 ref_id)
 {
     bool changed = false;
 
-    FieldValueModel::instance().db_savepoint();
     int field_index = 0;
     for (const auto& field_d : m_field_a) {
         const FieldValueData* fv_n = FieldValueModel::instance().get_key_data_n(
@@ -578,17 +591,15 @@ void FieldValueDialog::UpdateCustomValues(RefTypeN ref_type, int64 ref_id)
             if (!fv_n || !fv_d.equals(fv_n))
                 changed = true;
 
-            FieldValueModel::instance().save_data_n(fv_d);
+            FieldValueModel::instance().work_save(work, fv_d);
         }
         else if (fv_n) {
-            FieldValueModel::instance().purge_id(fv_n->m_id);
+            FieldValueModel::instance().work_remove(work, fv_n->m_id);
             changed = true;
         }
     }
-    FieldValueModel::instance().db_release_savepoint();
 
-    if (ref_type == TrxModel::s_ref_type && changed)
-        TrxModel::instance().save_timestamp(ref_id);
+    return changed;
 }
 
 void FieldValueDialog::OnStringChanged(wxCommandEvent& event)
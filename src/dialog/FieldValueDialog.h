@@ -64,7 +64,8 @@ public:
 public:
     bool FillCustomFields(wxBoxSizer* box_sizer);
     bool SaveCustomValues(RefTypeN ref_type, int64 ref_id);
-    void UpdateCustomValues(RefTypeN ref_type, int64 ref_id);
+    bool SaveCustomValues(TableWork& work, RefTypeN ref_type, int64 ref_id);
+    bool UpdateCustomValues(TableWork& work, RefTypeN ref_type, int64 ref_id);
     void SetStringValue(int fieldIndex, const wxString& value, bool hasChanged = false);
     bool ValidateCustomValues();
     auto GetWidgetData(wxWindowID controlID) const -> const wxString;
@@ -16,6 +16,9 @@
  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ********************************************************/
 
+#include <algorithm>
+#include <cmath>
+
 #include "ReconcileDialog.h"
 
 #include "base/_constants.h"
@@ -35,6 +38,26 @@
 
 wxIMPLEMENT_DYNAMIC_CLASS(ReconcileDialog, wxDialog);
 
+ReconcileList::ReconcileList(ReconcileDialog* dialog, int side, wxWindow* parent) :
+    wxListCtrl(parent, wxID_ANY,
+        wxDefaultPosition, wxDefaultSize,
+        wxLC_REPORT | wxLC_SINGLE_SEL | wxLC_VIRTUAL
+    ),
+    m_dialog(dialog),
+    m_side(side)
+{
+}
+
+wxString ReconcileList::OnGetItemText(long item, long col_nr) const
+{
+    return m_dialog->getRowText(m_side, item, col_nr);
+}
+
+int ReconcileList::OnGetItemImage(long item) const
+{
+    return m_dialog->m_row_a[m_side][item].m_is_checked ? 1 : 0;
+}
+
 ReconcileDialog::ReconcileDialog()
 {
 }
@@ -49,6 +72,9 @@ ReconcileDialog::ReconcileDialog(
     m_reconciledBalance = journal_panel_n->todayReconciledBalance();
     m_currency_n = CurrencyModel::instance().get_idN_data_n(account_n->m_currency_id);
     m_ignore  = false;
+    m_scale = m_currency_n ? static_cast<double>(m_currency_n->m_scale.GetValue()) : 100.0;
+    m_cleared_units = 0;
+    m_checked_c = 0;
     this->SetFont(parent_win->GetFont());
 
     Create(
@@ -193,10 +219,7 @@ void ReconcileDialog::CreateControls()
     wxStaticText* leftLabel = new wxStaticText(leftlistPanel, wxID_ANY,
         _t("Withdrawals")
     );
-    w_left_list = new wxListCtrl(leftlistPanel, wxID_ANY,
-        wxDefaultPosition, wxDefaultSize,
-        wxLC_REPORT | wxLC_SINGLE_SEL
-    );
+    w_left_list = new ReconcileList(this, SIDE_WITHDRAWAL, leftlistPanel);
     addColumns(w_left_list);
     w_left_list->SetMinSize(wxSize(250,100));
 
@@ -220,10 +243,7 @@ void ReconcileDialog::CreateControls()
     wxBoxSizer* rightSizer = new wxBoxSizer(wxVERTICAL);
 
     wxStaticText* rightLabel = new wxStaticText(rightlistPanel, wxID_ANY, _t("Deposits"));
-    w_right_list = new wxListCtrl(rightlistPanel, wxID_ANY,
-        wxDefaultPosition, wxDefaultSize,
-        wxLC_REPORT | wxLC_SINGLE_SEL
-    );
+    w_right_list = new ReconcileList(this, SIDE_DEPOSIT, rightlistPanel);
     addColumns(w_right_list);
     w_right_list->SetMinSize(wxSize(250,100));
 
@@ -378,15 +398,10 @@ void ReconcileDialog::FillControls(bool init)
         TableClause::ORDERBY(TrxCol::NAME_TRANSDATE)
     );
 
-    long ritemIndex = -1;
-    long litemIndex = -1;
-    m_itemDataMap.clear();
-    long mapidx = 0;
-
-    wxListCtrl* list;
-    w_left_list->DeleteAllItems();
-    w_right_list->DeleteAllItems();
-    long item;
+    for (int side = 0; side < SIDE_size; ++side)
+        m_row_a[side].clear();
+    m_cleared_units = 0;
+    m_checked_c = 0;
     m_hiddenDuplicatedBalance = 0.0;
     for (const auto& trx_d : trx_a) {
         if (!m_settings[SETTING_INCLUDE_VOID] && trx_d.is_void()) {
@@ -398,43 +413,26 @@ void ReconcileDialog::FillControls(bool init)
             m_hiddenDuplicatedBalance += trx_d.m_amount;
             continue;
         }
-        if (trx_d.is_deposit() ||
-            (trx_d.is_transfer() && trx_d.m_to_account_id_n == m_account_n->m_id)
-        ) {
-            list = w_right_list;
-            item = w_right_list->InsertItem(++ritemIndex, "");
+        // the rows are ordered by date
+        Row row = makeRow(&trx_d, trx_d.m_status.id() == TrxStatus::e_followup);
+        if (row.m_is_checked) {
+            m_cleared_units += row.m_units;
+            ++m_checked_c;
         }
-        else {
-            list = w_left_list;
-            item = w_left_list->InsertItem(++litemIndex, "");
-        }
-        setListItemData(&trx_d, list, item);
-        m_itemDataMap.push_back(trx_d.m_id);
-        list->SetItemData(item, mapidx++);
+        m_row_a[getTrxSide(&trx_d)].push_back(std::move(row));
+    }
+
+    for (int side = 0; side < SIDE_size; ++side) {
+        ReconcileList* list = getSideList(side);
+        list->SetItemCount(static_cast<long>(m_row_a[side].size()));
+        list->Refresh();
     }
 }
 
 void ReconcileDialog::UpdateAll()
 {
-    double clearedbalance = m_reconciledBalance;
-    for (long i = 0; i < w_left_list->GetItemCount(); ++i) {
-        if (isListItemChecked(w_left_list, i)) {
-            wxString itext = w_left_list->GetItemText(i, 4);
-            double value;
-            if (CurrencyModel::instance().fromString(itext, value, m_currency_n)) {
-               clearedbalance -= value;
-            }
-        }
-    }
-    for (long i = 0; i < w_right_list->GetItemCount(); ++i) {
-        if (isListItemChecked(w_right_list, i)) {
-            wxString itext = w_right_list->GetItemText(i, 4);
-            double value;
-            if (CurrencyModel::instance().fromString(itext, value, m_currency_n)) {
-               clearedbalance += value;
-            }
-        }
-    }
+    double clearedbalance = m_reconciledBalance +
+        static_cast<double>(m_cleared_units.GetValue()) / m_scale;
 
     double endbalance;
     if (!w_amount_text->GetDouble(endbalance)) {
@@ -522,11 +520,8 @@ void ReconcileDialog::processLeftClick(wxListCtrl* list, wxPoint pt)
     int flags = 0;
     long idx = list->HitTest(pt, flags);
     if (idx != -1) {
-        wxListItem item;
-        item.SetId(idx);
-        if (list->GetItem(item)) {
-            list->SetItemImage(item, item.GetImage() == 0 ? 1 : 0);
-        }
+        int side = getListSide(list);
+        setRowChecked(side, idx, !m_row_a[side][idx].m_is_checked);
         UpdateAll();
     }
 }
@@ -583,17 +578,14 @@ void ReconcileDialog::OnListKeyDown(wxKeyEvent& event)
             case WXK_SPACE:
                 long idx = list->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
                 if (idx > -1) {
-                    wxListItem item;
-                    item.SetId(idx);
-                    if (list->GetItem(item)) {
-                        list->SetItemImage(item, item.GetImage() == 0 ? 1 : 0);
-                        if (idx < list->GetItemCount() - 1) {
-                            list->SetItemState(idx + 1,
-                                wxLIST_STATE_SELECTED, wxLIST_STATE_SELECTED
-                            );
-                        }
-                        UpdateAll();
+                    int side = getListSide(list);
+                    setRowChecked(side, idx, !m_row_a[side][idx].m_is_checked);
+                    if (idx < list->GetItemCount() - 1) {
+                        list->SetItemState(idx + 1,
+                            wxLIST_STATE_SELECTED, wxLIST_STATE_SELECTED
+                        );
                     }
+                    UpdateAll();
                 }
                 break;
         }
@@ -714,17 +706,13 @@ void ReconcileDialog::newTransaction()
 
 void ReconcileDialog::addTransaction2List(const TrxData* trx_n)
 {
-    wxListCtrl* list = (trx_n->is_deposit() ||
-        (trx_n->is_transfer() && trx_n->m_to_account_id_n == m_account_n->m_id)
-    ) ? w_right_list : w_left_list;
-    long idx = getListIndexByDate(trx_n, list);
-    if (idx == -1) {
-        idx = list->GetItemCount();
-    }
-    long item = list->InsertItem(idx, "");
-    setListItemData(trx_n, list, item);
-    list->SetItemData(item, m_itemDataMap.size());
-    m_itemDataMap.push_back(trx_n->m_id);
+    if (!trx_n)
+        return;
+
+    insertRow(
+        getTrxSide(trx_n),
+        makeRow(trx_n, trx_n->m_status.id() == TrxStatus::e_followup)
+    );
 }
 
 void ReconcileDialog::OnEdit(wxCommandEvent& WXUNUSED(event))
@@ -745,64 +733,44 @@ void ReconcileDialog::OnEdit(wxCommandEvent& WXUNUSED(event))
 
 void ReconcileDialog::editTransaction(wxListCtrl* list, long item)
 {
-    int64 trx_id = m_itemDataMap[list->GetItemData(item)];
+    int side = getListSide(list);
+    int64 trx_id = m_row_a[side][item].m_trx_id;
     TrxDialog dlg(this, JournalKey(-1, trx_id));
     if (dlg.ShowModal() == wxID_OK) {
         w_journal->refreshList();
         const TrxData* trx_n = TrxModel::instance().get_idN_data_n(trx_id);
-        setListItemData(trx_n, list, item);
-        long idx = getListIndexByDate(trx_n, list);
-        if (idx != item) {
-            moveItemData(list, item, idx);
-        }
+        list->SetItemState(item, 0, wxLIST_STATE_SELECTED);
+        removeRow(side, item);
+        if (!trx_n)
+            return;
+
+        // the row stays on its side; it is moved if its date has changed
+        Row row = makeRow(trx_n, trx_n->m_status.id() == TrxStatus::e_followup);
+        long i = static_cast<long>(getRowIndexByDate(side, row.m_date));
+        insertRow(side, std::move(row));
+        list->SetItemState(i, wxLIST_STATE_SELECTED, wxLIST_STATE_SELECTED);
+        list->EnsureVisible(i);
     }
 }
 
-long ReconcileDialog::getListIndexByDate(const TrxData* trx_n, wxListCtrl* list)
+int ReconcileDialog::getTrxSide(const TrxData* trx_n) const
 {
-    long idx = -1;
-    for (long i = 0; i < list->GetItemCount(); ++i) {
-        int64 other_id = m_itemDataMap[list->GetItemData(i)];
-        const TrxData* other_trx_n = TrxModel::instance().get_idN_data_n(other_id);
-        if (trx_n->m_date() < other_trx_n->m_date()) {
-            idx = i;
-            break;
-        }
-    }
-    return idx;
+    return (trx_n->is_deposit() ||
+        (trx_n->is_transfer() && trx_n->m_to_account_id_n == m_account_n->m_id)
+    ) ? SIDE_DEPOSIT : SIDE_WITHDRAWAL;
 }
 
-void ReconcileDialog::moveItemData(wxListCtrl* list, int row1, int row2)
+int ReconcileDialog::getListSide(const wxListCtrl* list) const
 {
-    std::vector<wxString> coldata;
-    for (int i = 0; i < list->GetColumnCount(); i++) {
-        coldata.push_back(list->GetItemText(row1, i));
-    }
-    long rowData = list->GetItemData(row1);
-    bool rowischecked = isListItemChecked(list, row1);
-    list->SetItemState(row1, 0, wxLIST_STATE_SELECTED);
-
-    list->DeleteItem(row1);
-
-    if (row2 == -1) {
-        row2 = list->GetItemCount() + 1;
-    }
-    long item = list->InsertItem(
-        row2 > row1
-            ? (row2 > list->GetItemCount() ? list->GetItemCount() : row2 - 1)
-            : row2,
-        ""
-    );
+    return list == w_right_list ? SIDE_DEPOSIT : SIDE_WITHDRAWAL;
+}
 
-    for (int i = 0; i < list->GetColumnCount(); i++) {
-        list->SetItem(item, i , coldata[i]);
-    }
-    list->SetItemData(item, rowData);
-    list->SetItemImage(item, rowischecked ? 1 : 0);
-    list->SetItemState(item, wxLIST_STATE_SELECTED, wxLIST_STATE_SELECTED);
+ReconcileList* ReconcileDialog::getSideList(int side) const
+{
+    return side == SIDE_DEPOSIT ? w_right_list : w_left_list;
 }
 
-void ReconcileDialog::setListItemData(const TrxData* trx_n, wxListCtrl* list, long item)
+ReconcileDialog::Row ReconcileDialog::makeRow(const TrxData* trx_n, bool is_checked) const
 {
     wxString prefix = trx_n->is_transfer()
         ? (trx_n->m_to_account_id_n == m_account_n->m_id ? "< " : "> ")
@@ -813,37 +781,108 @@ void ReconcileDialog::setListItemData(const TrxData* trx_n, wxListCtrl* list, lo
             : trx_n->m_to_account_id_n
         )
         : PayeeModel::instance().get_id_name(trx_n->m_payee_id_n);
-    list->SetItem(item, 1, mmGetDateTimeForDisplay(trx_n->m_isoDateTime()));
-    list->SetItem(item, 2, trx_n->m_number);
-    list->SetItem(item, 3, prefix + payeeName);
-    list->SetItem(item, 4, CurrencyModel::instance().toString(trx_n->m_amount,m_currency_n));
-    list->SetItem(item, 5, trx_n->m_status.key());
-    list->SetItemImage(item, (trx_n->m_status.id() == TrxStatus::e_followup) ? 1 : 0);
+
+    // round to the currency precision, as displayed
+    int64 units = static_cast<wxLongLong_t>(std::llround(trx_n->m_amount * m_scale));
+
+    Row row;
+    row.m_trx_id      = trx_n->m_id;
+    row.m_date        = trx_n->m_date().yyyymmdd();
+    row.m_date_text   = mmGetDateTimeForDisplay(trx_n->m_isoDateTime());
+    row.m_number      = trx_n->m_number;
+    row.m_payee       = prefix + payeeName;
+    row.m_amount_text = CurrencyModel::instance().toString(trx_n->m_amount, m_currency_n);
+    row.m_status      = trx_n->m_status.key();
+    row.m_units       = getTrxSide(trx_n) == SIDE_DEPOSIT ? units : -units;
+    row.m_is_checked  = is_checked;
+    return row;
+}
+
+wxString ReconcileDialog::getRowText(int side, long item, long col_nr) const
+{
+    const Row& row = m_row_a[side][item];
+    switch (col_nr) {
+    case 1: return row.m_date_text;
+    case 2: return row.m_number;
+    case 3: return row.m_payee;
+    case 4: return row.m_amount_text;
+    case 5: return row.m_status;
+    default: return "";
+    }
+}
+
+// Insert row after the rows with the same or earlier date.
+void ReconcileDialog::insertRow(int side, Row&& row)
+{
+    if (row.m_is_checked) {
+        m_cleared_units += row.m_units;
+        ++m_checked_c;
+    }
+    std::size_t i = getRowIndexByDate(side, row.m_date);
+    m_row_a[side].insert(m_row_a[side].begin() + i, std::move(row));
+
+    ReconcileList* list = getSideList(side);
+    list->SetItemCount(static_cast<long>(m_row_a[side].size()));
+    list->Refresh();
+}
+
+void ReconcileDialog::removeRow(int side, std::size_t i)
+{
+    const Row& row = m_row_a[side][i];
+    if (row.m_is_checked) {
+        m_cleared_units -= row.m_units;
+        --m_checked_c;
+    }
+    m_row_a[side].erase(m_row_a[side].begin() + i);
+
+    ReconcileList* list = getSideList(side);
+    list->SetItemCount(static_cast<long>(m_row_a[side].size()));
+    list->Refresh();
+}
+
+void ReconcileDialog::setRowChecked(int side, std::size_t i, bool is_checked)
+{
+    Row& row = m_row_a[side][i];
+    if (row.m_is_checked == is_checked)
+        return;
+
+    row.m_is_checked = is_checked;
+    if (is_checked) {
+        m_cleared_units += row.m_units;
+        ++m_checked_c;
+    }
+    else {
+        m_cleared_units -= row.m_units;
+        --m_checked_c;
+    }
+    getSideList(side)->RefreshItem(static_cast<long>(i));
+}
+
+// Return the index of the first row with a later date.
+std::size_t ReconcileDialog::getRowIndexByDate(int side, int date) const
+{
+    const std::vector<Row>& row_a = m_row_a[side];
+    auto it = std::upper_bound(row_a.begin(), row_a.end(), date,
+        [](int date, const Row& row) { return date < row.m_date; }
+    );
+    return static_cast<std::size_t>(it - row_a.begin());
 }
 
 void ReconcileDialog::OnToggle(wxCommandEvent& WXUNUSED(event))
 {
     DoWindowsFreezeThaw(this);
-    bool isChecked = true;
-    for (long i = 0; i < w_left_list->GetItemCount(); ++i) {
-        if (!isListItemChecked(w_left_list, i)) {
-            isChecked = false;
-            break;
-        }
-    }
-    if (isChecked) {
-        for (long i = 0; i < w_right_list->GetItemCount(); ++i) {
-            if (!isListItemChecked(w_right_list, i)) {
-                isChecked = false;
-                break;
+    bool isChecked = (m_checked_c == m_row_a[SIDE_WITHDRAWAL].size() + m_row_a[SIDE_DEPOSIT].size());
+    m_cleared_units = 0;
+    m_checked_c = 0;
+    for (int side = 0; side < SIDE_size; ++side) {
+        for (Row& row : m_row_a[side]) {
+            row.m_is_checked = !isChecked;
+            if (row.m_is_checked) {
+                m_cleared_units += row.m_units;
+                ++m_checked_c;
             }
         }
-    }
-    for (long i = 0; i < w_left_list->GetItemCount(); ++i) {
-        w_left_list->SetItemImage(i, isChecked ? 0 : 1);
-    }
-    for (long i = 0; i < w_right_list->GetItemCount(); ++i) {
-        w_right_list->SetItemImage(i, isChecked ? 0 : 1);
+        getSideList(side)->Refresh();
     }
     UpdateAll();
     resetListSelections(w_left_list);
@@ -861,17 +900,6 @@ void ReconcileDialog::resetListSelections(wxListCtrl* list)
     }
 }
 
-bool ReconcileDialog::isListItemChecked(wxListCtrl* list, long item)
-{
-    bool checked = false;
-    wxListItem litem;
-    litem.SetId(item);
-    if (list->GetItem(litem)) {
-        checked = litem.GetImage() == 1;
-    }
-    return checked;
-}
-
 void ReconcileDialog::OnSize(wxSizeEvent& event)
 {
     resizeColumns();
@@ -942,19 +970,10 @@ void ReconcileDialog::OnClose(wxCommandEvent& event)
         );
 
         // Save state:
-        for (long i = 0; i < w_left_list->GetItemCount(); ++i) {
-            saveItem(
-                m_itemDataMap[w_left_list->GetItemData(i)],
-                isListItemChecked(w_left_list, i),
-                event.GetId() == wxID_OK
-            );
-        }
-        for (long i = 0; i < w_right_list->GetItemCount(); ++i) {
-            saveItem(
-                m_itemDataMap[w_right_list->GetItemData(i)],
-                isListItemChecked(w_right_list, i),
-                event.GetId() == wxID_OK
-            );
+        for (int side = 0; side < SIDE_size; ++side) {
+            for (const Row& row : m_row_a[side]) {
+                saveItem(row.m_trx_id, row.m_is_checked, event.GetId() == wxID_OK);
+            }
         }
     }
 
@@ -24,9 +24,54 @@
 #include "model/TrxModel.h"
 #include "panel/JournalPanel.h"
 
+class ReconcileDialog;
+
+// Virtual list of one side (withdrawals or deposits) of ReconcileDialog.
+// The rows are kept in the dialog.
+class ReconcileList : public wxListCtrl
+{
+    wxDECLARE_NO_COPY_CLASS(ReconcileList);
+
+private:
+    ReconcileDialog* m_dialog;
+    int              m_side;
+
+public:
+    ReconcileList(ReconcileDialog* dialog, int side, wxWindow* parent);
+
+public:
+    virtual auto OnGetItemText(long item, long col_nr) const -> wxString override;
+    virtual int  OnGetItemImage(long item) const override;
+};
+
 class ReconcileDialog: public wxDialog
 {
+    friend class ReconcileList;
+
 private:
+    enum
+    {
+        SIDE_WITHDRAWAL,
+        SIDE_DEPOSIT,
+        SIDE_size
+    };
+
+    // One row of a list. The text is formatted when the row is loaded;
+    // the amount is kept in the smallest currency unit, signed by side,
+    // such that the cleared balance is updated exactly on each toggle.
+    struct Row
+    {
+        int64    m_trx_id;
+        int      m_date;
+        wxString m_date_text;
+        wxString m_number;
+        wxString m_payee;
+        wxString m_amount_text;
+        wxString m_status;
+        int64    m_units;
+        bool     m_is_checked;
+    };
+
     enum
     {
         SETTING_SHOW_STATE_COL,
@@ -55,7 +100,10 @@ private:
     bool                m_ignore;
     bool                m_settings[SETTING_size];
     int                 m_colwidth[2]; // Store width for hidable columns
-    std::vector<int64>  m_itemDataMap;
+    double              m_scale;
+    std::vector<Row>    m_row_a[SIDE_size];
+    int64               m_cleared_units;   // sum of checked rows
+    std::size_t         m_checked_c;       // number of checked rows
 
     wxVector<wxBitmapBundle> w_images;
     JournalPanel*      w_journal;
@@ -65,8 +113,8 @@ private:
     wxStaticText*      w_ending_bal_text;
     wxStaticText*      w_diff_label;
     wxStaticText*      w_diff_text;
-    wxListCtrl*        w_left_list;
-    wxListCtrl*        w_right_list;
+    ReconcileList*     w_left_list;
+    ReconcileList*     w_right_list;
     wxButton*          w_cancel_btn;
     wxButton*          w_reconcile_btn;
     wxButton*          w_later_btn;
@@ -117,19 +165,24 @@ private:
     void OnRightFocusKill(wxFocusEvent& event);
     void handleListFocusKill(wxListCtrl* list);
 
-    void setListItemData(const TrxData* trx, wxListCtrl* list, long item);
+    int  getTrxSide(const TrxData* trx) const;
+    int  getListSide(const wxListCtrl* list) const;
+    auto getSideList(int side) const -> ReconcileList*;
+    auto makeRow(const TrxData* trx, bool is_checked) const -> Row;
+    auto getRowText(int side, long item, long col_nr) const -> wxString;
+    void insertRow(int side, Row&& row);
+    void removeRow(int side, std::size_t i);
+    void setRowChecked(int side, std::size_t i, bool is_checked);
+    std::size_t getRowIndexByDate(int side, int date) const;
     void processRightClick(wxListCtrl* list, long item);
     void processLeftClick(wxListCtrl* list, wxPoint pt);
     void addTransaction2List(const TrxData* trx);
-    long getListIndexByDate(const TrxData* trx, wxListCtrl* list);
-    void moveItemData(wxListCtrl* list, int row1, int row2);
     void resetListSelections(wxListCtrl* list);
     void newTransaction();
     void editTransaction(wxListCtrl* list, long item);
 
     void OnSize(wxSizeEvent& event);
     void resizeColumns();
-    bool isListItemChecked(wxListCtrl* list, long item);
 
     void applyColumnSettings();
     void showHideColumn(bool show, int col, int cs);
@@ -743,6 +743,7 @@ void StockDialog::onHistoryImportButton(wxCommandEvent& /*event*/)
         // we need to save them to the database.
         for (auto& new_sh_d : new_sh_a)
             StockHistoryModel::instance().add_data_n(new_sh_d);
+        StockHistoryModel::instance().reset_symbol_series(m_stock_n->m_symbol);
         // show the data
         showStockHistory();
     }
@@ -927,6 +928,7 @@ void StockDialog::onHistoryDownloadButton(wxCommandEvent& /*event*/)
             }
         }
         StockHistoryModel::instance().db_release_savepoint();
+        StockHistoryModel::instance().reset_symbol_series(m_stock_n->m_symbol);
         return showStockHistory();
     }
     mmErrorDialogs::MessageError(this, sOutput, _t("Stock History Error"));
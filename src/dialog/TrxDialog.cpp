@@ -1434,17 +1434,16 @@ void TrxDialog::onOk(wxCommandEvent& event)
             return;
     }
 
-    TrxData* trx_n;
-    TrxData trx_d;
-    if (is_edit()) {
-        trx_n = TrxModel::instance().unsafe_get_idN_data_n(m_journal_d.m_id);
-    }
-    else {
-        trx_d = TrxData();
-        trx_n = &trx_d;
-    }
-    TrxModel::copy_from_trx(trx_n, m_journal_d);
-    TrxModel::instance().unsafe_save_trx_n(trx_n);
+    // the transaction, its splits, tags and custom values are saved in a
+    // single work; a new transaction gets its id when it is added to work.
+    TableWork work;
+    TrxData trx_d = is_edit()
+        ? *TrxModel::instance().get_idN_data_n(m_journal_d.m_id)
+        : TrxData();
+    TrxModel::copy_from_trx(&trx_d, m_journal_d);
+    if (!is_edit())
+        TrxModel::instance().work_save_trx(work, trx_d);
+    bool changed = false;
 
     TrxSplitModel::DataA tp_a;
     for (const auto& split_d : m_split_a) {
@@ -1454,7 +1453,7 @@ void TrxDialog::onOk(wxCommandEvent& event)
         tp_d.m_notes       = split_d.m_notes;
         tp_a.push_back(tp_d);
     }
-    TrxSplitModel::instance().update_trx(trx_n->m_id, tp_a);
+    changed = TrxSplitModel::instance().work_update_trx(work, trx_d.m_id, tp_a) || changed;
 
     // Save split tags
     for (unsigned int i = 0; i < m_split_a.size(); i++) {
@@ -1466,19 +1465,13 @@ void TrxDialog::onOk(wxCommandEvent& event)
             new_gl_d.m_ref_id   = tp_a.at(i).m_id;
             new_tp_gl_a.push_back(new_gl_d);
         }
-        TagLinkModel::instance().update(
+        TagLinkModel::instance().work_update(work,
             TrxSplitModel::s_ref_type, tp_a.at(i).m_id,
             new_tp_gl_a
         );
     }
-    if (!is_edit()) {
-        mmAttachment::relocate_ref_all(
-            TrxModel::s_ref_type, 0,
-            TrxModel::s_ref_type, trx_n->m_id
-        );
-    }
 
-    w_fv_dlg->SaveCustomValues(TrxModel::s_ref_type, trx_n->m_id);
+    changed = w_fv_dlg->SaveCustomValues(work, TrxModel::s_ref_type, trx_d.m_id) || changed;
 
     // Save base transaction tags
     TagLinkModel::DataA new_gl_a;
@@ -1486,13 +1479,31 @@ void TrxDialog::onOk(wxCommandEvent& event)
         TagLinkData new_gl_d = TagLinkData();
         new_gl_d.m_tag_id   = tag_id;
         new_gl_d.m_ref_type = TrxModel::s_ref_type;
-        new_gl_d.m_ref_id   = trx_n->m_id;
+        new_gl_d.m_ref_id   = trx_d.m_id;
         new_gl_a.push_back(new_gl_d);
     }
-    TagLinkModel::instance().update(
-        TrxModel::s_ref_type.key_n(), trx_n->m_id,
+    changed = TagLinkModel::instance().work_update(work,
+        TrxModel::s_ref_type, trx_d.m_id,
         new_gl_a
-    );
+    ) || changed;
+
+    if (is_edit()) {
+        if (changed)
+            trx_d.m_updated_utc_n = mmDateTime::now().fromLocalToUtc();
+        TrxModel::instance().work_save_trx(work, trx_d);
+    }
+
+    if (!work.flush()) {
+        mmErrorDialogs::MessageSaveFailed(this);
+        return;
+    }
+
+    if (!is_edit()) {
+        mmAttachment::relocate_ref_all(
+            TrxModel::s_ref_type, 0,
+            TrxModel::s_ref_type, trx_d.m_id
+        );
+    }
 
     //TrxModel::DataExt trx(trx_d);
     //wxLogDebug("%s", trx.to_json());
@@ -1505,7 +1516,7 @@ void TrxDialog::onOk(wxCommandEvent& event)
         TrxDialog::s_previousDate = wxDateTime();
     }
 
-    m_journal_d.m_id        = trx_n->m_id;
+    m_journal_d.m_id        = trx_d.m_id;
     m_journal_d.m_sched_id  = -1;
     m_journal_d.m_repeat_id = -1;
 
@@ -196,7 +196,9 @@ bool TrxFilterDialog::Create(
 
 int TrxFilterDialog::ShowModal()
 {
-    return wxDialog::ShowModal();
+    int result = wxDialog::ShowModal();
+    reset_plan();
+    return result;
 }
 
 void TrxFilterDialog::mmDoDataToControls(const wxString& json)
@@ -505,6 +507,7 @@ void TrxFilterDialog::mmDoDataToControls(const wxString& json)
         m_custom_fields->ShowCustomPanel();
     }
     mmThemeAutoColour(this);
+    reset_plan();
 }
 
 void TrxFilterDialog::mmDoInitSettingNameChoice(wxString sel) const
@@ -1271,7 +1274,7 @@ const wxString TrxFilterDialog::mmGetStatus() const
 
 bool TrxFilterDialog::mmIsStatusMatches(const wxString& itemStatus) const
 {
-    wxString filterStatus = mmGetStatus();
+    const wxString& filterStatus = c_plan.m_status;
     if (itemStatus == filterStatus) {
         return true;
     }
@@ -1288,27 +1291,22 @@ bool TrxFilterDialog::mmIsTypeMaches(
     int64 toaccountid
 ) const
 {
+    const Plan& plan = c_plan;
     bool result = false;
-    if (trx_type.id() == TrxType::e_transfer && w_transferTo_cb->GetValue() && (
-        !mmIsAccountChecked() ||
-        std::find(m_selected_accounts_id.begin(), m_selected_accounts_id.end(),
-            accountid
-        ) != m_selected_accounts_id.end()
+    if (trx_type.id() == TrxType::e_transfer && plan.m_type_transfer_to && (
+        !plan.m_has_account || plan.m_account_id_m.count(accountid) > 0
     )) {
         result = true;
     }
-    else if (trx_type.id() == TrxType::e_transfer && w_transferFrom_cb->GetValue() && (
-        !mmIsAccountChecked() ||
-        std::find(m_selected_accounts_id.begin(), m_selected_accounts_id.end(),
-            toaccountid
-        ) != m_selected_accounts_id.end()
+    else if (trx_type.id() == TrxType::e_transfer && plan.m_type_transfer_from && (
+        !plan.m_has_account || plan.m_account_id_m.count(toaccountid) > 0
     )) {
         result = true;
     }
-    else if (trx_type.id() == TrxType::e_withdrawal && w_withdrawal_cb->IsChecked()) {
+    else if (trx_type.id() == TrxType::e_withdrawal && plan.m_type_withdrawal) {
         result = true;
     }
-    else if (trx_type.id() == TrxType::e_deposit && w_deposit_cb->IsChecked()) {
+    else if (trx_type.id() == TrxType::e_deposit && plan.m_type_deposit) {
         result = true;
     }
 
@@ -1366,41 +1364,104 @@ void TrxFilterDialog::OnButtonClearClick(wxCommandEvent& /*event*/)
     }
 }
 
-bool TrxFilterDialog::mmIsPayeeMatches(int64 payeeID)
+// Compile the filter settings into a plan.
+// Id lists become hash sets, the payee pattern is resolved into the set of
+// matching payees, regular expressions are compiled and patterns are
+// lower-cased once. The plan is rebuilt when the settings are changed
+// (see reset_plan) or when the payee table is written.
+const TrxFilterDialog::Plan& TrxFilterDialog::get_plan()
 {
-    const PayeeData* payee_n = PayeeModel::instance().get_idN_data_n(payeeID);
-    if (payee_n) {
-        const wxString value = cbPayee_->mmGetPattern();
-        if (!value.empty()) {
-            wxRegEx pattern("^(" + value + ")$", wxRE_ICASE | wxRE_ADVANCED);
-            if (pattern.IsValid() && pattern.Matches(payee_n->m_name)) {
-                return true;
+    const std::size_t payee_version = PayeeModel::instance().data_version();
+    if (c_plan.m_is_valid && c_plan.m_payee_version == payee_version)
+        return c_plan;
+
+    c_plan = Plan();
+    c_plan.m_payee_version = payee_version;
+
+    c_plan.m_has_account = mmIsAccountChecked();
+    c_plan.m_account_id_m.insert(m_selected_accounts_id.begin(), m_selected_accounts_id.end());
+
+    c_plan.m_has_date = m_use_date_filter && (mmIsDateRangeChecked() || mmIsRangeChecked());
+    if (c_plan.m_has_date) {
+        c_plan.m_start_date = mmDate(m_start_date);
+        c_plan.m_end_date = mmDate(m_end_date);
+    }
+
+    c_plan.m_has_payee = mmIsPayeeChecked();
+    const wxString payee_pattern = c_plan.m_has_payee ? cbPayee_->mmGetPattern() : "";
+    if (!payee_pattern.empty()) {
+        wxRegEx pattern("^(" + payee_pattern + ")$", wxRE_ICASE | wxRE_ADVANCED);
+        if (pattern.IsValid()) {
+            for (const auto& payee_d : PayeeModel::instance().find_data_a()) {
+                if (pattern.Matches(payee_d.m_name))
+                    c_plan.m_payee_id_m.insert(payee_d.m_id);
             }
         }
     }
-    return false;
+
+    c_plan.m_has_category = mmIsCategoryChecked();
+    c_plan.m_category_id_m.insert(m_selected_categories_id.begin(), m_selected_categories_id.end());
+
+    c_plan.m_has_status = mmIsStatusChecked();
+    if (c_plan.m_has_status)
+        c_plan.m_status = mmGetStatus();
+
+    c_plan.m_has_type = mmIsTypeChecked();
+    c_plan.m_type_withdrawal    = w_withdrawal_cb->IsChecked();
+    c_plan.m_type_deposit       = w_deposit_cb->IsChecked();
+    c_plan.m_type_transfer_to   = w_transferTo_cb->GetValue();
+    c_plan.m_type_transfer_from = w_transferFrom_cb->GetValue();
+
+    c_plan.m_has_amount_min = mmIsAmountRangeMinChecked();
+    if (c_plan.m_has_amount_min)
+        c_plan.m_amount_min = mmGetAmountMin();
+    c_plan.m_has_amount_max = mmIsAmountRangeMaxChecked();
+    if (c_plan.m_has_amount_max)
+        c_plan.m_amount_max = mmGetAmountMax();
+
+    c_plan.m_has_number = mmIsNumberChecked();
+    c_plan.m_number_lower = mmGetNumber().Lower();
+
+    c_plan.m_has_notes = mmIsNotesChecked();
+    const wxString notes = mmGetNotes();
+    c_plan.m_notes_is_regex = notes.StartsWith("regex:");
+    if (c_plan.m_notes_is_regex)
+        c_plan.m_notes_regex_n.reset(new wxRegEx(
+            "^(" + notes.Right(notes.length() - 6).ToStdString() + ")$",
+            wxRE_ICASE | wxRE_EXTENDED
+        ));
+    else
+        c_plan.m_notes_lower = notes.Lower();
+
+    c_plan.m_has_color = mmIsColorChecked();
+    c_plan.m_has_custom_field = mmIsCustomFieldChecked();
+    c_plan.m_has_tags = mmIsTagsChecked();
+    if (c_plan.m_has_tags)
+        c_plan.m_tag_a = w_tag_text->GetTagStrings();
+
+    c_plan.m_is_valid = true;
+    return c_plan;
+}
+
+bool TrxFilterDialog::mmIsPayeeMatches(int64 payeeID)
+{
+    return c_plan.m_payee_id_m.count(payeeID) > 0;
 }
 
 bool TrxFilterDialog::mmIsNoteMatches(const wxString& note)
 {
-    const wxString value = mmGetNotes();
-    if (!value.empty())
-    {
-        if (value.StartsWith("regex:"))
-        {
-            wxRegEx pattern("^(" + value.Right(value.length() - 6).ToStdString() + ")$", wxRE_ICASE | wxRE_EXTENDED);
-            return (pattern.IsValid() && pattern.Matches(note));
-        }
-        else
-            return note.Lower().Matches(value.Lower());
-    }
+    const Plan& plan = c_plan;
+    if (plan.m_notes_is_regex)
+        return plan.m_notes_regex_n->IsValid() && plan.m_notes_regex_n->Matches(note);
+    else if (!plan.m_notes_lower.empty())
+        return note.Lower().Matches(plan.m_notes_lower);
     else
         return note.IsEmpty();
 }
 
 bool TrxFilterDialog::mmIsCategoryMatches(int64 categid)
 {
-    return std::find(m_selected_categories_id.begin(), m_selected_categories_id.end(), categid) != m_selected_categories_id.end();
+    return c_plan.m_category_id_m.count(categid) > 0;
 }
 
 bool TrxFilterDialog::mmIsTagMatches(RefTypeN ref_type, int64 ref_id, bool mergeSplitTags)
@@ -1459,7 +1520,7 @@ bool TrxFilterDialog::mmIsTagMatches(RefTypeN ref_type, int64 ref_id, bool merge
 
     bool match = true;
 
-    wxArrayString tags = w_tag_text->GetTagStrings();
+    const wxArrayString& tags = c_plan.m_tag_a;
     for (int i = 0; i < static_cast<int>(tags.GetCount()); i++) {
         // if the tag is the "OR" operator, fetch the next tag and compare with OR
         if (tags.Item(i) == "|" && i++ < static_cast<int>(tags.GetCount()) - 1)
@@ -1478,47 +1539,42 @@ bool TrxFilterDialog::mmIsTagMatches(RefTypeN ref_type, int64 ref_id, bool merge
 template <class MODEL, class DATA>
 bool TrxFilterDialog::mmIsRecordMatches(const DATA& tran, bool mergeSplitTags)
 {
+    const Plan& plan = get_plan();
     bool ok = true;
 
-    // wxLogDebug("Check date? %i trx date:%s %s %s", getDateRangeCheckBox(), tran.m_date_time.isoDateTime(), getFromDateCtrl().GetDateOnly().FormatISODate(),
-    if (mmIsAccountChecked() &&
-        std::find(m_selected_accounts_id.begin(), m_selected_accounts_id.end(),
-            tran.m_account_id
-        ) == m_selected_accounts_id.end() &&
-        std::find(m_selected_accounts_id.begin(), m_selected_accounts_id.end(),
-            tran.m_to_account_id_n
-        ) == m_selected_accounts_id.end()
+    // cheap scalar checks first; the plan holds the compiled settings
+    if (plan.m_has_account &&
+        plan.m_account_id_m.count(tran.m_account_id) == 0 &&
+        plan.m_account_id_m.count(tran.m_to_account_id_n) == 0
     )
         ok = false;
-    else if (m_use_date_filter &&
-        (mmIsDateRangeChecked() || mmIsRangeChecked()) && (
-            tran.m_date() < mmDate(m_start_date) ||
-            tran.m_date() > mmDate(m_end_date)
-        )
-    )
+    else if (plan.m_has_date && (
+        tran.m_date() < plan.m_start_date ||
+        tran.m_date() > plan.m_end_date
+    ))
         ok = false;
-    else if (mmIsPayeeChecked() && !mmIsPayeeMatches(tran.m_payee_id_n))
+    else if (plan.m_has_payee && !mmIsPayeeMatches(tran.m_payee_id_n))
         ok = false;
-    else if (mmIsCategoryChecked() && !mmIsCategoryMatches(tran.m_category_id_n))
+    else if (plan.m_has_category && !mmIsCategoryMatches(tran.m_category_id_n))
         ok = false;
-    else if (mmIsStatusChecked() && !mmIsStatusMatches(tran.m_status.key()))
+    else if (plan.m_has_status && !mmIsStatusMatches(tran.m_status.key()))
         ok = false;
-    else if (mmIsTypeChecked() && !mmIsTypeMaches(tran.m_type, tran.m_account_id, tran.m_to_account_id_n))
+    else if (plan.m_has_type && !mmIsTypeMaches(tran.m_type, tran.m_account_id, tran.m_to_account_id_n))
         ok = false;
-    else if (mmIsAmountRangeMinChecked() && mmGetAmountMin() > tran.m_amount)
+    else if (plan.m_has_amount_min && plan.m_amount_min > tran.m_amount)
         ok = false;
-    else if (mmIsAmountRangeMaxChecked() && mmGetAmountMax() < tran.m_amount)
+    else if (plan.m_has_amount_max && plan.m_amount_max < tran.m_amount)
         ok = false;
-    else if (mmIsNumberChecked() && (mmGetNumber().empty() ? !tran.m_number.empty()
-                                                           : tran.m_number.empty() || !tran.m_number.Lower().Matches(mmGetNumber().Lower())))
+    else if (plan.m_has_number && (plan.m_number_lower.empty() ? !tran.m_number.empty()
+                                                              : tran.m_number.empty() || !tran.m_number.Lower().Matches(plan.m_number_lower)))
         ok = false;
-    else if (mmIsNotesChecked() && !mmIsNoteMatches(tran.m_notes))
+    else if (plan.m_has_notes && !mmIsNoteMatches(tran.m_notes))
         ok = false;
-    else if (mmIsColorChecked() && (m_color_value != tran.m_color))
+    else if (plan.m_has_color && (m_color_value != tran.m_color))
         ok = false;
-    else if (mmIsCustomFieldChecked() && !mmIsCustomFieldMatches(tran.m_id))
+    else if (plan.m_has_custom_field && !mmIsCustomFieldMatches(tran.m_id))
         ok = false;
-    else if (mmIsTagsChecked()) {
+    else if (plan.m_has_tags) {
         RefTypeN ref_type;
         // Check the Data type to determine the tag RefType
         if (typeid(tran).hash_code() == typeid(TrxData).hash_code())
@@ -1543,7 +1599,7 @@ bool TrxFilterDialog::mmIsSplitRecordMatches(const DATA& split_d)
         ref_type = SchedSplitModel::s_ref_type;
     }
 
-    if (mmIsTagsChecked() && !mmIsTagMatches(ref_type, split_d.m_id))
+    if (get_plan().m_has_tags && !mmIsTagMatches(ref_type, split_d.m_id))
         return false;
 
     return true;
@@ -2045,9 +2101,8 @@ void TrxFilterDialog::OnCategoryChange(wxEvent& event)
                 m_selected_categories_id.push_back(cat_fullname_id.second);
                 if (!mmIsCategorySubCatChecked())
                     continue;
-                const CategoryData* cat_n = CategoryModel::instance().get_idN_data_n(cat_fullname_id.second);
-                for (const auto& sub_d : CategoryModel::instance().find_data_subtree_a(*cat_n))
-                    m_selected_categories_id.push_back(sub_d.m_id);
+                for (int64 sub_id : CategoryModel::instance().find_id_subtree_a(cat_fullname_id.second))
+                    m_selected_categories_id.push_back(sub_id);
             }
         }
     }
@@ -24,7 +24,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #endif
 
 #include "base/_defs.h"
+#include <unordered_set>
 #include <wx/dialog.h>
+#include <wx/regex.h>
 
 #include "util/mmDateRange.h"
 #include "util/mmDatePicker.h"
@@ -103,6 +105,46 @@ private:
     wxArrayInt64 m_selected_categories_id;
     wxArrayInt m_selected_columns_id;
 
+    // Filter settings compiled for evaluation over many records.
+    // The plan is built on first use after the settings are changed.
+    struct Plan
+    {
+        bool m_is_valid = false;
+        std::size_t m_payee_version = 0;
+
+        bool m_has_account = false;
+        std::unordered_set<int64> m_account_id_m;
+        bool m_has_date = false;
+        mmDate m_start_date = mmDate::min();
+        mmDate m_end_date = mmDate::max();
+        bool m_has_payee = false;
+        std::unordered_set<int64> m_payee_id_m;
+        bool m_has_category = false;
+        std::unordered_set<int64> m_category_id_m;
+        bool m_has_status = false;
+        wxString m_status;
+        bool m_has_type = false;
+        bool m_type_withdrawal = false;
+        bool m_type_deposit = false;
+        bool m_type_transfer_to = false;
+        bool m_type_transfer_from = false;
+        bool m_has_amount_min = false;
+        double m_amount_min = 0.0;
+        bool m_has_amount_max = false;
+        double m_amount_max = 0.0;
+        bool m_has_number = false;
+        wxString m_number_lower;
+        bool m_has_notes = false;
+        wxString m_notes_lower;
+        wxSharedPtr<wxRegEx> m_notes_regex_n;
+        bool m_notes_is_regex = false;
+        bool m_has_color = false;
+        bool m_has_custom_field = false;
+        bool m_has_tags = false;
+        wxArrayString m_tag_a;
+    };
+    Plan c_plan;
+
 private:
     wxSharedPtr<FieldValueDialog> m_custom_fields;
     wxCheckBox*         w_account_cb            = nullptr;
@@ -211,6 +253,9 @@ private:
     double mmGetAmountMax() const;
     double mmGetAmountMin() const;
 
+    auto get_plan() -> const Plan&;
+    void reset_plan() { c_plan.m_is_valid = false; }
+
     bool mmIsPayeeMatches(int64 payeeid);
     bool mmIsCategoryMatches(int64 categid);
     bool mmIsNoteMatches(const wxString& note);
@@ -400,46 +400,57 @@ void TrxUpdateDialog::OnOk(wxCommandEvent& WXUNUSED(event))
 
     // const auto split = TrxSplitModel::instance().find_all_mTrxId();
 
+    int color_id = -1;
+    if (w_color_cb->IsChecked()) {
+        color_id = w_color_btn->GetColorId();
+        if (color_id < 0 || color_id > 7) {
+            return mmErrorDialogs::ToolTip4Object(w_color_btn,
+                _t("Color"), _t("Invalid value"), wxICON_ERROR
+            );
+        }
+    }
+
+    // modify copies of the transactions and collect all writes in a single
+    // work, which is flushed at the end; the cache is not modified before.
     std::vector<int64> skip_trx;
-    TrxModel::instance().db_savepoint();
-    TagLinkModel::instance().db_savepoint();
+    TableWork work;
     for (const auto& trx_id : m_trx_id_a) {
-        TrxData* trx_n = TrxModel::instance().unsafe_get_idN_data_n(trx_id);
-        bool is_locked = TrxModel::instance().is_locked(*trx_n);
+        TrxData trx_d = *TrxModel::instance().get_idN_data_n(trx_id);
+        bool is_locked = TrxModel::instance().is_locked(trx_d);
 
         if (is_locked) {
-            skip_trx.push_back(trx_n->m_id);
+            skip_trx.push_back(trx_d.m_id);
             continue;
         }
 
         if (w_status_cb->IsChecked()) {
-            trx_n->m_status = TrxStatus(status);
+            trx_d.m_status = TrxStatus(status);
         }
 
         if (w_payee_cb->IsChecked()) {
-            trx_n->m_payee_id_n = payee_id;
-            trx_n->m_to_account_id_n = -1;
+            trx_d.m_payee_id_n = payee_id;
+            trx_d.m_to_account_id_n = -1;
         }
 
         if (m_transferAcc_checkbox->IsChecked()) {
-            trx_n->m_to_account_id_n = w_account_text->mmGetId();
-            trx_n->m_payee_id_n = -1;
+            trx_d.m_to_account_id_n = w_account_text->mmGetId();
+            trx_d.m_payee_id_n = -1;
         }
 
         if (w_date_cb->IsChecked() || (w_time_picker && w_time_cb->IsChecked())) {
-            wxString date_s = trx_n->m_isoDateTime();
+            wxString date_s = trx_d.m_isoDateTime();
             if (w_date_cb->IsChecked()) {
                 date_s.replace(0, 10, w_date_picker->GetValue().FormatISODate());
                 const AccountData* account = AccountModel::instance().get_idN_data_n(
-                    trx_n->m_account_id
+                    trx_d.m_account_id
                 );
                 const AccountData* to_account = AccountModel::instance().get_idN_data_n(
-                    trx_n->m_to_account_id_n
+                    trx_d.m_to_account_id_n
                 );
                 if ((mmDate(date_s) < account->m_open_date) ||
                     (to_account && (mmDate(date_s) < to_account->m_open_date))
                 ) {
-                    skip_trx.push_back(trx_n->m_id);
+                    skip_trx.push_back(trx_d.m_id);
                     continue;
                 }
             }
@@ -451,27 +462,21 @@ void TrxUpdateDialog::OnOk(wxCommandEvent& WXUNUSED(event))
                     date_s.Append("T" + w_time_picker->GetValue().FormatISOTime());
             }
 
-            trx_n->m_datetime = mmDateTime(date_s);
+            trx_d.m_datetime = mmDateTime(date_s);
         }
 
         if (w_color_cb->IsChecked()) {
-            int color_id = w_color_btn->GetColorId();
-            if (color_id < 0 || color_id > 7) {
-                return mmErrorDialogs::ToolTip4Object(w_color_btn,
-                    _t("Color"), _t("Invalid value"), wxICON_ERROR
-                );
-            }
-            trx_n->m_color = color_id == 0 ? -1 : color_id ; 
+            trx_d.m_color = color_id == 0 ? -1 : color_id ; 
         }
 
         if (w_notes_cb->IsChecked()) {
             if (m_append_checkbox->IsChecked()) {
-                trx_n->m_notes += (trx_n->m_notes.Right(1) == "\n" || trx_n->m_notes.empty()
+                trx_d.m_notes += (trx_d.m_notes.Right(1) == "\n" || trx_d.m_notes.empty()
                     ? "" : "\n")
                     + w_notes_text->GetValue();
             }
             else {
-                trx_n->m_notes = w_notes_text->GetValue();
+                trx_d.m_notes = w_notes_text->GetValue();
             }
         }
 
@@ -484,7 +489,7 @@ void TrxUpdateDialog::OnOk(wxCommandEvent& WXUNUSED(event))
                 // Since we are appending, start with the existing tags
                 gl_a = TagLinkModel::instance().find_data_a(
                     TagLinkCol::WHERE_REFTYPE(OP_EQ, TrxModel::s_ref_type.key_n()),
-                    TagLinkCol::WHERE_REFID(OP_EQ, trx_n->m_id)
+                    TagLinkCol::WHERE_REFID(OP_EQ, trx_d.m_id)
                 );
                 // Remove existing tags from the new list to avoid duplicates
                 for (const auto& gl_d : gl_a) {
@@ -498,67 +503,71 @@ void TrxUpdateDialog::OnOk(wxCommandEvent& WXUNUSED(event))
                 TagLinkData new_gl_d = TagLinkData();
                 new_gl_d.m_tag_id   = tag_id;
                 new_gl_d.m_ref_type = TrxModel::s_ref_type;
-                new_gl_d.m_ref_id   = trx_n->m_id;
+                new_gl_d.m_ref_id   = trx_d.m_id;
                 gl_a.push_back(new_gl_d);
             }
             // Update the links for the transaction
-            TagLinkModel::instance().update(
-                TrxModel::s_ref_type, trx_n->m_id,
+            if (TagLinkModel::instance().work_update(work,
+                TrxModel::s_ref_type, trx_d.m_id,
                 gl_a
-            );
+            ))
+                trx_d.m_updated_utc_n = mmDateTime::now().fromLocalToUtc();
         }
 
         if (w_amount_cb->IsChecked()) {
-            trx_n->m_amount = amount;
+            trx_d.m_amount = amount;
         }
 
         if (w_cat_cb->IsChecked()) {
-            trx_n->m_category_id_n = categ_id;
+            trx_d.m_category_id_n = categ_id;
         }
 
         if (w_type_cb->IsChecked()) {
-            trx_n->m_type = trx_type;
+            trx_d.m_type = trx_type;
         }
 
         // Need to consider m_to_amount if material transaction change
         if (w_amount_cb->IsChecked() || w_type_cb->IsChecked() ||
             m_transferAcc_checkbox->IsChecked()
         ) {
-            if (!trx_n->is_transfer()) {
-                trx_n->m_to_amount = trx_n->m_amount;
+            if (!trx_d.is_transfer()) {
+                trx_d.m_to_amount = trx_d.m_amount;
             }
             else {
-                const auto acc = AccountModel::instance().get_idN_data_n(trx_n->m_account_id);
+                const auto acc = AccountModel::instance().get_idN_data_n(trx_d.m_account_id);
                 const auto curr = CurrencyModel::instance().get_idN_data_n(acc->m_currency_id);
-                const auto to_acc = AccountModel::instance().get_idN_data_n(trx_n->m_to_account_id_n);
+                const auto to_acc = AccountModel::instance().get_idN_data_n(trx_d.m_to_account_id_n);
                 const auto to_curr = CurrencyModel::instance().get_idN_data_n(to_acc->m_currency_id);
                 if (curr == to_curr) {
-                    trx_n->m_to_amount = trx_n->m_amount;
+                    trx_d.m_to_amount = trx_d.m_amount;
                 }
                 else {
                     double exch = 1;
                     const double convRateTo = CurrencyHistoryModel::instance().get_id_date_rate(
                         to_curr->m_id,
-                        trx_n->m_date()
+                        trx_d.m_date()
                     );
                     if (convRateTo > 0) {
                         const double convRate = CurrencyHistoryModel::instance().get_id_date_rate(
                             curr->m_id,
-                            trx_n->m_date()
+                            trx_d.m_date()
                         );
                         exch = convRate / convRateTo;
                     }
-                    trx_n->m_to_amount = trx_n->m_amount * exch;
+                    trx_d.m_to_amount = trx_d.m_amount * exch;
                 }
             }
         }
 
-        m_custom_fields->UpdateCustomValues(TrxModel::s_ref_type, trx_id);
+        if (m_custom_fields->UpdateCustomValues(work, TrxModel::s_ref_type, trx_id))
+            trx_d.m_updated_utc_n = mmDateTime::now().fromLocalToUtc();
 
-        TrxModel::instance().unsafe_save_trx_n(trx_n);
+        TrxModel::instance().work_save_trx(work, trx_d);
+    }
+    if (!work.flush()) {
+        mmErrorDialogs::MessageSaveFailed(this);
+        return;
     }
-    TagLinkModel::instance().db_release_savepoint();
-    TrxModel::instance().db_release_savepoint();
     if (!skip_trx.empty()) {
         const wxString detail = wxString::Format("%s\n%s: %zu\n%s: %zu",
             _t("This is due to some elements of the transaction or account detail not allowing the update"),
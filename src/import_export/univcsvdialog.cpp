@@ -1469,6 +1469,10 @@ void mmUnivCSVDialog::OnImport(wxCommandEvent& WXUNUSED(event))
     TrxModel::instance().db_begin();
     TrxModel::instance().db_savepoint("IMP");
     FieldValueModel::instance().db_savepoint("IMP");
+    // the ids of skipped or cancelled lines are released on return
+    TableBase::IdReserve id_reserve(TrxModel::instance(),
+        linesToImport > 0 ? static_cast<std::size_t>(linesToImport) : 0
+    );
 
     wxProgressDialog progressDlg(
         _t("Universal CSV Import"),
@@ -1481,6 +1485,28 @@ void mmUnivCSVDialog::OnImport(wxCommandEvent& WXUNUSED(event))
     progressDlg.Fit();
 
     m_reverce_sign = m_choiceAmountFieldSign->GetCurrentSelection() == PositiveIsWithdrawal;
+
+    // Parse the date column in one pass, before the rows are processed
+    size_t date_col = csvFieldOrder_.size();
+    for (size_t i = 0; i < csvFieldOrder_.size(); ++i) {
+        if (csvFieldOrder_[i].first == UNIV_CSV_DATE) {
+            date_col = i;
+            break;
+        }
+    }
+    std::vector<wxDateTime> date_a;
+    if (date_col < csvFieldOrder_.size() && firstRow < lastRow) {
+        wxArrayString date_str_a;
+        date_str_a.reserve(lastRow - firstRow);
+        for (long nLines = firstRow; nLines < lastRow; nLines++) {
+            date_str_a.Add(date_col < pParser->GetItemsCount(nLines)
+                ? pParser->GetItem(nLines, date_col).Trim().Trim(false)
+                : wxString()
+            );
+        }
+        mmParseDisplayStringToDate_a(date_a, date_str_a, date_format_);
+    }
+
     // A place to store all rejected rows to display after import
     wxString rejectedRows;
     for (long nLines = firstRow; nLines < lastRow; nLines++) {
@@ -1502,9 +1528,17 @@ void mmUnivCSVDialog::OnImport(wxCommandEvent& WXUNUSED(event))
                 wxString token = pParser->GetItem(nLines, i).Trim(false /*from left*/);
                 // Store the CSV row to display in case the row is rejected
                 rowString << inQuotes(token,",") << ((i < numTokens - 1) ? "," : "");
-                if (!token.IsEmpty())
+                if (token.IsEmpty())
+                    blankTokenCount++; // keep track of blank fields
+                else if (i == date_col) {
+                    const wxDateTime& date = date_a[nLines - firstRow];
+                    if (date.IsValid())
+                        holder.Date = date;
+                    else
+                        holder.valid = false;
+                }
+                else
                     parseToken(csvFieldOrder_[i].first, token, holder);
-                else blankTokenCount++; // keep track of blank fields
             }
         }
         // if the line had no field separators or all fields were blank (",,,,,")
@@ -270,6 +270,7 @@ wxBEGIN_EVENT_TABLE(GeneralReportManager, wxDialog)
     EVT_BUTTON(wxID_EXECUTE, GeneralReportManager::OnRun)
     EVT_BUTTON(wxID_CLOSE, GeneralReportManager::OnClose)
     EVT_BUTTON(ID_TEST, GeneralReportManager::OnSqlTest)
+    EVT_THREAD(ID_SQL_PAGE, GeneralReportManager::OnSqlPage)
     EVT_BUTTON(wxID_NEW, GeneralReportManager::OnNewTemplate)
     #ifdef MMEX_USE_REPORT_SYNC
         EVT_BUTTON(ID_GITHUB_SYNC, GeneralReportManager::OnSyncFromGitHub)
@@ -294,8 +295,16 @@ sqlListCtrl::sqlListCtrl(GeneralReportManager* grm, wxWindow *parent, wxWindowID
 {
 }
 
-GeneralReportManager::GeneralReportManager(wxWindow* parent, wxSQLite3Database* db, wxString itemname)
-    : m_db(db)
+GeneralReportManager::GeneralReportManager(
+    wxWindow* parent,
+    wxSQLite3Database* db,
+    const wxString& dbpath,
+    const wxString& key,
+    wxString itemname
+) :
+    m_db(db),
+    m_dbpath(dbpath),
+    m_key(key)
 {
     this->SetFont(parent->GetFont());
     Create(parent);
@@ -612,47 +621,105 @@ void GeneralReportManager::createEditorTab(wxNotebook* editors_notebook, int typ
     panel->Layout();
 }
 
+// Run the SQL query on a worker connection. The rows are added to the list
+// page by page; a second click on the button cancels the query.
 void GeneralReportManager::OnSqlTest(wxCommandEvent& WXUNUSED(event))
 {
+    wxButton* buttonTest = wxDynamicCast(FindWindow(ID_TEST), wxButton);
+    if (m_sqlQuery.is_running()) {
+        m_sqlQuery.cancel();
+        return;
+    }
+
     mmMiniEditor* sqlText = wxDynamicCast(FindWindow(ID_SQL_CONTENT), mmMiniEditor);
     wxStaticText* info = wxDynamicCast(FindWindow(wxID_INFO), wxStaticText);
 
     wxString sql = sqlText->GetStringSelection().empty() ? sqlText->GetValue() : sqlText->GetStringSelection();
+    std::map <wxString, wxString> rep_params;
+    ReportParam::prepare_sql(sql, rep_params);
 
-    wxString SqlError;
-    wxLongLong interval = wxGetUTCTimeMillis();
-    if (this->getSqlQuery(sql, m_sqlQueryData, SqlError))
-    {
-        m_sqlListBox->DeleteAllColumns();
-        interval = wxGetUTCTimeMillis() - interval;
-        info->SetLabelText(wxString::Format(wxPLURAL("%zu row returned, duration: %lld ms",
-                                                     "%zu rows returned, duration: %lld ms",
-                                                     m_sqlQueryData.size())
-            , m_sqlQueryData.size(), interval));
+    m_sqlQueryData.clear();
+    m_sqlListBox->DeleteAllItems();
+    m_sqlListBox->DeleteAllColumns();
+    wxButton* b = static_cast<wxButton*>(FindWindow(wxID_NEW));
+    b->Enable(false);
+    info->SetLabelText(_tu("Running…"));
+    buttonTest->SetLabel(_t("&Cancel"));
+
+    dbQuery::Config config;
+    config.m_dbpath = m_dbpath;
+    config.m_key = m_key;
+    config.m_sql = sql;
+    m_sqlQueryId = m_sqlQuery.start(config, [this](const dbQuery::Page& page) {
+        wxThreadEvent* evt = new wxThreadEvent(wxEVT_THREAD, ID_SQL_PAGE);
+        evt->SetPayload(page);
+        wxQueueEvent(this, evt);
+    });
+}
+
+void GeneralReportManager::OnSqlPage(wxThreadEvent& event)
+{
+    const dbQuery::Page page = event.GetPayload<dbQuery::Page>();
+    if (page.m_query_id != m_sqlQueryId)
+        return;
 
+    wxStaticText* info = wxDynamicCast(FindWindow(wxID_INFO), wxStaticText);
+
+    if (!page.m_column_a.empty()) {
         mmMiniEditor* templateText = static_cast<mmMiniEditor*>(FindWindow(ID_TEMPLATE));
-        std::vector<std::pair<wxString, int> > colHeaders;
-        bool colsOK = this->getColumns(sql, colHeaders);
         wxButton* b = static_cast<wxButton*>(FindWindow(wxID_NEW));
-        b->Enable(colsOK && templateText->IsEmpty());
+        b->Enable(templateText->IsEmpty());
         int pos = 0;
-        for (const auto& col : colHeaders)
-        {
-            m_sqlListBox->InsertColumn(pos++, col.first
-                , (col.second == WXSQLITE_INTEGER || col.second == WXSQLITE_FLOAT)
+        for (const auto& col : page.m_column_a) {
+            m_sqlListBox->InsertColumn(pos++, col.m_name
+                , (col.m_type == WXSQLITE_INTEGER || col.m_type == WXSQLITE_FLOAT)
                 ? wxLIST_FORMAT_RIGHT : wxLIST_FORMAT_LEFT
-                , col.first.length() * 10 + 20);
+                , col.m_name.length() * 10 + 20);
         }
+    }
 
-        m_sqlListBox->SetItemCount(m_sqlQueryData.size());
-        m_sqlListBox->Refresh();
-        m_sqlListBox->Update();
-        if (m_sqlQueryData.size() > 0)
-            m_sqlListBox->EnsureVisible(0);
+    bool is_first = m_sqlQueryData.empty();
+    for (const auto& row : page.m_row_a)
+        m_sqlQueryData.push_back(row);
+    m_sqlListBox->SetItemCount(m_sqlQueryData.size());
+    m_sqlListBox->Refresh();
+    if (is_first && !m_sqlQueryData.empty())
+        m_sqlListBox->EnsureVisible(0);
+
+    wxString label = wxString::Format(wxPLURAL("%zu row returned, duration: %lld ms",
+                                               "%zu rows returned, duration: %lld ms",
+                                               m_sqlQueryData.size())
+        , m_sqlQueryData.size(), static_cast<long long>(page.m_msec));
+    switch (page.m_status) {
+    case dbQuery::Page::e_running:
+        label << " " << _tu("(running…)");
+        break;
+    case dbQuery::Page::e_row_max:
+        label << " " << _t("(row limit reached)");
+        break;
+    case dbQuery::Page::e_cancelled:
+        label << " " << _t("(cancelled)");
+        break;
+    case dbQuery::Page::e_timeout:
+        label << " " << _t("(time limit reached)");
+        break;
+    case dbQuery::Page::e_error: {
+        wxString error = page.m_error;
+        if (page.m_error_code == dbQuery::Page::e_open)
+            error = _t("Cannot open the database");
+        else if (page.m_error_code == dbQuery::Page::e_not_read_only)
+            error = _t("Only read-only statements are allowed");
+        label = _t("SQL Syntax Error") + " (" + error + ")";
+        break;
     }
-    else
-    {
-        info->SetLabelText(_t("SQL Syntax Error") + " (" + SqlError + ")");
+    default:
+        break;
+    }
+    info->SetLabelText(label);
+
+    if (page.is_last()) {
+        wxButton* buttonTest = wxDynamicCast(FindWindow(ID_TEST), wxButton);
+        buttonTest->SetLabel(_t("&Test"));
     }
 }
 
@@ -963,6 +1030,12 @@ void GeneralReportManager::OnSelChanged(wxTreeEvent& event)
 
     browser_->SetPage(description, "");
 
+    // forget the pages of a running query
+    m_sqlQuery.cancel();
+    m_sqlQueryId = 0;
+    m_sqlQueryData.clear();
+    wxButton* buttonTest = static_cast<wxButton*>(FindWindow(ID_TEST));
+    if (buttonTest) buttonTest->SetLabel(_t("&Test"));
     if (m_sqlListBox) m_sqlListBox->DeleteAllItems();
     if (m_sqlListBox) m_sqlListBox->DeleteAllColumns();
     wxButton* createTemplate = static_cast<wxButton*>(FindWindow(wxID_NEW));
@@ -1311,11 +1384,13 @@ wxString sqlListCtrl::OnGetItemText(long item, long col_nr) const
 
 void GeneralReportManager::OnClose(wxCommandEvent& WXUNUSED(event))
 {
+    m_sqlQuery.cancel();
     CheckAndSaveChanges();
     EndModal(wxID_OK);
 }
 
 void GeneralReportManager::OnCloseWindow(wxCloseEvent& WXUNUSED(event)){
+    m_sqlQuery.cancel();
     CheckAndSaveChanges();
     EndModal(wxID_OK);
 }
@@ -1342,9 +1417,27 @@ bool GeneralReportManager::getColumns(const wxString& sql, std::vector<std::pair
     return true;
 }
 
+// The list of tables and columns is cached. It is reloaded if the database
+// has changed, or if its schema version has changed (after a DDL statement).
 void GeneralReportManager::getSqlTableInfo(
     std::vector<std::pair<wxString, wxArrayString>> &sqlTableInfo
 ) {
+    static std::vector<std::pair<wxString, wxArrayString>> s_sqlTableInfo;
+    static wxString s_dbpath;
+    static int s_schema_version = -1;
+
+    int schema_version = -1;
+    try {
+        schema_version = this->m_db->ExecuteScalar("PRAGMA schema_version;");
+    }
+    catch (const wxSQLite3Exception &e) {
+        wxLogError("SQL Exception: \n%s", e.GetMessage().utf8_str());
+    }
+    if (schema_version >= 0 && schema_version == s_schema_version && m_dbpath == s_dbpath) {
+        sqlTableInfo = s_sqlTableInfo;
+        return;
+    }
+
     const wxString sqlTables = "SELECT type, name FROM sqlite_master WHERE type = 'table' or type = 'view' ORDER BY type, name";
     sqlTableInfo.clear();
 
@@ -1373,39 +1466,12 @@ void GeneralReportManager::getSqlTableInfo(
     }
     catch (const wxSQLite3Exception &e) {
         wxLogError("SQL Exception: \n%s", e.GetMessage().utf8_str());
-    }
-}
-
-bool GeneralReportManager::getSqlQuery(
-    /*in*/ wxString& sql,
-    /*out*/ std::vector <std::vector <wxString>>& sqlQueryData,
-    wxString& SqlError
-) {
-    wxSQLite3ResultSet q;
-    int columnCount = 0;
-    try {
-        std::map <wxString, wxString> rep_params;
-        ReportParam::prepare_sql(sql, rep_params);
-        wxSQLite3Statement stmt = this->m_db->PrepareStatement(sql);
-        if (!stmt.IsReadOnly())
-            return false;
-        q = stmt.ExecuteQuery();
-        columnCount = q.GetColumnCount();
-    }
-    catch (const wxSQLite3Exception& e) {
-        SqlError = e.GetMessage();
-        SqlError.Replace(" or missing database[1]:", "");
-        return false;
+        return;
     }
 
-    sqlQueryData.clear();
-    while (q.NextRow()) {
-        std::vector<wxString> row;
-        for (int i = 0; i < columnCount; ++i)
-            row.emplace_back(q.GetAsString(i));
-        sqlQueryData.emplace_back(row);
-    }
-    return true;
+    s_sqlTableInfo = sqlTableInfo;
+    s_dbpath = m_dbpath;
+    s_schema_version = schema_version;
 }
 
 const wxString GeneralReportManager::getTemplate(wxString& sql)
@@ -30,6 +30,7 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 
+#include "db/dbquery.h"
 #include "panel/_ListBase.h"
 #include "panel/_PanelBase.h"
 
@@ -63,7 +64,13 @@ public:
     GeneralReportManager() {}
     ~GeneralReportManager();
 
-    GeneralReportManager(wxWindow* parent, wxSQLite3Database* db, wxString itemname);
+    GeneralReportManager(
+        wxWindow* parent,
+        wxSQLite3Database* db,
+        const wxString& dbpath,
+        const wxString& key,
+        wxString itemname
+    );
     wxString OnGetItemText(long item, long col_nr) const;
 #ifdef MMEX_USE_REPORT_SYNC
     bool syncReport(int64 id);
@@ -93,6 +100,7 @@ private:
     void OnClose(wxCommandEvent& event);
     void OnCloseWindow(wxCloseEvent& event);
     void OnSqlTest(wxCommandEvent& event);
+    void OnSqlPage(wxThreadEvent& event);
     void OnNewTemplate(wxCommandEvent& event);
     void OnContextMenu(wxContextMenuEvent& event);
     void OnSelChanged(wxTreeEvent& event);
@@ -115,7 +123,6 @@ private:
 
     bool getColumns(const wxString& sql, std::vector<std::pair<wxString, int> > &colHeaders);
     void getSqlTableInfo(std::vector<std::pair<wxString, wxArrayString>> &sqlTableInfo);
-    bool getSqlQuery(/*in*/ wxString& sql, /*out*/ std::vector <std::vector <wxString> > &sqlQueryData, wxString& SqlError);
     const wxString getTemplate(wxString& sql);
     void OnNewWindow(wxWebViewEvent& evt);
     void CheckAndSaveChanges();
@@ -132,9 +139,13 @@ private:
 #endif
 
     std::vector <std::vector <wxString> > m_sqlQueryData;
+    dbQuery m_sqlQuery;
+    int m_sqlQueryId = 0;
     wxVector<wxBitmapBundle> m_images;
 
     wxSQLite3Database* m_db = nullptr;
+    wxString m_dbpath;
+    wxString m_key;
     wxWebView* browser_ = nullptr;
 
     wxButton* m_buttonImport = nullptr;
@@ -187,7 +198,8 @@ private:
         ID_ACTIVE,
         ID_SQL_COPY,
         ID_SQL_COPY_ALL,
-        ID_SQL_COPY_SELECT
+        ID_SQL_COPY_SELECT,
+        ID_SQL_PAGE
     };
 
 };
@@ -23,10 +23,12 @@
 
 #include <unordered_set>
 
+#include "CurrencyHistoryModel.h"
 #include "PrefModel.h"
 #include "StockModel.h"
 #include "TrxLinkModel.h"
 #include "TrxShareModel.h"
+#include "_ModelAll.h"
 
 // -- static
 
@@ -71,6 +73,10 @@ AccountModel& AccountModel::instance()
 
 bool AccountModel::find_id_isUsed(int64 account_id, bool ignore_deleted)
 {
+    ModelAll& all = ModelAll::instance();
+    if (all.has_ref_count())
+        return all.get_ref_count(ModelAll::e_ref_account, account_id).get(ignore_deleted) > 0;
+
     bool is_used = false;
 
     is_used = is_used || StockModel::instance().find_count(
@@ -207,6 +213,19 @@ std::pair<double, double> AccountModel::get_data_investment_balance(const Data&
     return sum;
 }
 
+// Return the balances of account_id from the balance snapshot.
+// The snapshot is computed in one pass over all transactions, stocks and assets,
+// and it is shared by all views until one of its dependencies changes.
+// Notice: unlike get_data_balance(), the snapshot is not suitable for callers
+// which interleave writes and reads (each read after a write rebuilds it).
+const AccountModel::Balance& AccountModel::get_id_balance(int64 account_id)
+{
+    static const Balance s_empty_balance;
+    const Snapshot& snapshot = get_snapshot();
+    const auto it = snapshot.m_id_balance_m.find(account_id);
+    return (it != snapshot.m_id_balance_m.end()) ? it->second : s_empty_balance;
+}
+
 // Get the Data name of a given id
 const wxString AccountModel::get_id_name(int64 account_id)
 {
@@ -247,6 +266,116 @@ const TrxModel::DataA AccountModel::find_id_trx_aBySN(int64 account_id)
     return trx_a;
 }
 
+// Key of the balance snapshot: the data versions of the tables it depends on,
+// today's date, and the preferences which affect the conversion rates.
+std::vector<std::size_t> AccountModel::snapshot_key()
+{
+    return {
+        data_version(),
+        TrxModel::instance().data_version(),
+        TrxLinkModel::instance().data_version(),
+        TrxShareModel::instance().data_version(),
+        StockModel::instance().data_version(),
+        AssetModel::instance().data_version(),
+        CurrencyModel::instance().data_version(),
+        CurrencyHistoryModel::instance().data_version(),
+        static_cast<std::size_t>(mmDate::today().dayNumber()),
+        static_cast<std::size_t>(PrefModel::instance().getBaseCurrencyID().GetValue()),
+        static_cast<std::size_t>(PrefModel::instance().getUseCurrencyHistory()),
+    };
+}
+
+const AccountModel::Snapshot& AccountModel::get_snapshot()
+{
+    std::vector<std::size_t> key_a = snapshot_key();
+    if (c_snapshot.m_is_valid && c_snapshot.m_key_a == key_a)
+        return c_snapshot;
+
+    c_snapshot = Snapshot();
+    c_snapshot.m_key_a = std::move(key_a);
+
+    // ACCOUNTNAME and ASSETNAME are COLLATE NOCASE (ASCII case folding)
+    auto nocase = [](const wxString& name) {
+        wxString key = name;
+        for (auto it = key.begin(); it != key.end(); ++it) {
+            if (*it >= 'A' && *it <= 'Z')
+                *it = static_cast<wchar_t>((*it).GetValue() + ('a' - 'A'));
+        }
+        return key;
+    };
+
+    std::unordered_map<wxString, int64> nocaseName_id_m;
+    std::unordered_map<wxString, int64> name_id_m;
+    for (const auto& account_d : find_data_a()) {
+        Balance& balance = c_snapshot.m_id_balance_m[account_d.m_id];
+        balance.m_base_rate = CurrencyHistoryModel::instance().get_id_date_rate(
+            account_d.m_currency_id
+        );
+        nocaseName_id_m[nocase(account_d.m_name)] = account_d.m_id;
+        name_id_m[account_d.m_name] = account_d.m_id;
+    }
+
+    // same as get_data_balance() and get_data_balance_to_date(today),
+    // for all accounts at once
+    const mmDate today = mmDate::today();
+    for (const auto& trx_d : TrxModel::instance().find_data_a()) {
+        if (!trx_d.is_valid())
+            continue;
+        const bool until_today = (trx_d.m_date() <= today);
+        auto add_flow = [this, &trx_d, until_today](int64 account_id) {
+            auto it = c_snapshot.m_id_balance_m.find(account_id);
+            if (it == c_snapshot.m_id_balance_m.end())
+                return;
+            const double flow = trx_d.account_flow(account_id);
+            const double recflow = trx_d.is_reconciled() ? flow : 0.0;
+            it->second.m_flow    += flow;
+            it->second.m_recflow += recflow;
+            if (until_today) {
+                it->second.m_today_flow    += flow;
+                it->second.m_today_recflow += recflow;
+            }
+        };
+        add_flow(trx_d.m_account_id);
+        if (trx_d.m_to_account_id_n != trx_d.m_account_id)
+            add_flow(trx_d.m_to_account_id_n);
+    }
+
+    // same as get_data_investment_balance(), for all accounts at once
+    for (const auto& stock_d : StockModel::instance().find_data_a()) {
+        auto it = c_snapshot.m_id_balance_m.find(stock_d.m_account_id_n);
+        if (it == c_snapshot.m_id_balance_m.end())
+            continue;
+        it->second.m_market += stock_d.current_value();
+        it->second.m_invest += stock_d.m_purchase_value;
+    }
+
+    for (const auto& asset_d : AssetModel::instance().find_data_a()) {
+        // an asset belongs to the account with the same name (NOCASE),
+        // or with the same name as its type (ASSETTYPE is case sensitive)
+        int64 name_account_id = -1, type_account_id = -1;
+        if (auto it = nocaseName_id_m.find(nocase(asset_d.m_name)); it != nocaseName_id_m.end())
+            name_account_id = it->second;
+        if (auto it = name_id_m.find(asset_d.m_type.key()); it != name_id_m.end())
+            type_account_id = it->second;
+        if (name_account_id == -1 && type_account_id == -1)
+            continue;
+
+        auto asset_bal = AssetModel::instance().get_data_value(asset_d);
+        for (int64 account_id : { name_account_id, type_account_id }) {
+            if (account_id == -1)
+                continue;
+            Balance& balance = c_snapshot.m_id_balance_m[account_id];
+            balance.m_market += asset_bal.second;
+            balance.m_invest += asset_bal.first;
+            if (name_account_id == type_account_id)
+                break;
+        }
+    }
+
+    c_snapshot.m_is_valid = true;
+    return c_snapshot;
+}
+
 const SchedModel::DataA AccountModel::find_id_sched_a(int64 account_id)
 {
     return SchedModel::instance().find_data_a(
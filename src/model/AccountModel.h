@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include "base/_defs.h"
 #include "base/mmDate.h"
 #include "base/mmSingleton.h"
@@ -49,6 +50,34 @@ public:
         );
     }
 
+// -- state
+
+public:
+    // Balances of an account, as seen at the time of the snapshot.
+    // Flows do not include the opening balance.
+    struct Balance
+    {
+        double m_flow = 0.0;            // all valid transactions
+        double m_recflow = 0.0;         // reconciled transactions
+        double m_today_flow = 0.0;      // m_flow until today
+        double m_today_recflow = 0.0;   // m_recflow until today
+        double m_market = 0.0;          // market value of stocks and assets
+        double m_invest = 0.0;          // invested value of stocks and assets
+        double m_base_rate = 1.0;       // today's conversion rate to base currency
+    };
+
+private:
+    // Balances of all accounts; rebuilt when any of the tables they depend on
+    // is written, or when the date or the currency preferences change.
+    struct Snapshot
+    {
+        std::vector<std::size_t> m_key_a;
+        bool m_is_valid = false;
+        std::unordered_map<int64, Balance> m_id_balance_m;
+    };
+
+    Snapshot c_snapshot;
+
 // -- constructor
 
 public:
@@ -78,12 +107,21 @@ public:
     auto get_data_balance_to_date(const Data& account_d, mmDate date) -> double;
     auto get_data_investment_balance(const Data& account_d) -> std::pair<double, double>;
 
+    // balance snapshot
+    void reset_snapshot() { c_snapshot.m_is_valid = false; }
+    auto get_id_balance(int64 account_id) -> const Balance&;
+
     // lookup for given id
     auto get_id_name(int64 account_id) -> const wxString;
     auto get_id_currency_p(int64 account_id) -> const CurrencyData*;
     auto find_id_trx_aBySN(int64 account_id) -> const TrxModel::DataA;
     auto find_id_sched_a(int64 account_id) -> const SchedModel::DataA;
 
+private:
+    auto snapshot_key() -> std::vector<std::size_t>;
+    auto get_snapshot() -> const Snapshot&;
+
+public:
     // lookup for given field
     auto get_name_data_n(const wxString& name) -> const Data*;
     auto find_name_data_a(const wxString& name) -> const DataA;
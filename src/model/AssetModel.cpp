@@ -62,6 +62,7 @@ AssetModel& AssetModel::instance(wxSQLite3Database* db)
 {
     AssetModel& ins = Singleton<AssetModel>::instance();
     ins.reset_cache();
+    ins.reset_timeline_all();
     ins.m_db = db;
     ins.ensure_table();
 
@@ -128,36 +129,34 @@ const wxString AssetModel::get_id_name(int64 asset_id)
         return _t("Asset Error");
 }
 
-// Return the value of an asset at a given date
-const std::pair<double, double> AssetModel::get_data_value_date(
-    const Data& asset_d,
-    const mmDate& date
-) {
-    std::pair<double /*initial*/, double /*market*/> balance;
-
-    if (date < asset_d.m_start_date)
-        return balance;
-
-    mmChoiceId change_id = asset_d.m_change.id();
-    double daily_rate = asset_d.m_change_rate / 36500.0;
-    auto apply_change = [change_id, daily_rate](double& value, mmDate from_date, mmDate to_date) {
-        if (change_id == AssetChange::e_none)
-            return;
+// Return the linked transactions of an asset as a timeline of cash flows.
+// The timeline is built once and reused until one of the tables it depends on
+// (transactions, links, accounts, currency history) is written.
+const AssetModel::Timeline& AssetModel::get_id_timeline(int64 asset_id)
+{
+    std::vector<std::size_t> version_a = {
+        TrxModel::instance().data_version(),
+        TrxLinkModel::instance().data_version(),
+        AccountModel::instance().data_version(),
+        CurrencyHistoryModel::instance().data_version(),
+        static_cast<std::size_t>(PrefModel::instance().getUseTransDateTime())
+    };
+    if (version_a != c_timeline_version_a) {
+        c_assetId_timeline_m.clear();
+        c_timeline_version_a = version_a;
+    }
 
-        double days = static_cast<double>(to_date.daysSince(from_date));
+    auto it = c_assetId_timeline_m.find(asset_id);
+    if (it != c_assetId_timeline_m.end())
+        return it->second;
 
-        if (change_id == AssetChange::e_appreciates) {
-            value *= exp(daily_rate * days);
-        }
-        else if (change_id == AssetChange::e_depreciates) {
-            value *= exp(-daily_rate * days);
-        }
-    };
+    Timeline& timeline = c_assetId_timeline_m[asset_id];
 
     TrxLinkModel::DataA tl_a = TrxLinkModel::instance().find_data_a(
-        TrxLinkCol::WHERE_LINKRECORDID(OP_EQ, asset_d.m_id),
+        TrxLinkCol::WHERE_LINKRECORDID(OP_EQ, asset_id),
         TrxLinkCol::WHERE_LINKTYPE(OP_EQ, s_ref_type.key_n())
     );
+    timeline.m_has_link = !tl_a.empty();
 
     TrxModel::DataA trx_a;
     for (const auto& tl_d : tl_a) {
@@ -165,8 +164,7 @@ const std::pair<double, double> AssetModel::get_data_value_date(
         if (trx_n &&
             // FIXME: ignore Void transactions
             !trx_n->is_deleted() &&
-            trx_n->m_account_id > 0 &&
-            trx_n->m_date() <= date
+            trx_n->m_account_id > 0
         ) {
             trx_a.push_back(*trx_n);
         }
@@ -176,58 +174,123 @@ const std::pair<double, double> AssetModel::get_data_value_date(
     else
         std::sort(trx_a.begin(), trx_a.end(), TrxData::SorterByDateId());
 
-    if (!tl_a.empty()) {
-        mmDateN last_n = mmDateN();
-        for (const auto& trx_d : trx_a) {
-            mmDate trx_date = trx_d.m_date();
-            const AccountData* account_n = AccountModel::instance().get_idN_data_n(
-                trx_d.m_account_id
-            );
-            int64 currency_id_n = account_n ? account_n->m_currency_id : -1;
-            double currency_rate = CurrencyHistoryModel::instance().get_id_date_rate(
-                currency_id_n,
-                trx_date
-            );
-            double account_flow = trx_d.account_flow(trx_d.m_account_id);
-            double base_amount = -(account_flow * currency_rate);
-
-            if (!last_n.has_value())
-                last_n = trx_date;
-            else if (last_n.value() < trx_date) {
-                apply_change(balance.second, last_n.value(), trx_date);
-                last_n = trx_date;
+    timeline.m_flow_a.reserve(trx_a.size());
+    for (const auto& trx_d : trx_a) {
+        mmDate trx_date = trx_d.m_date();
+        const AccountData* account_n = AccountModel::instance().get_idN_data_n(
+            trx_d.m_account_id
+        );
+        int64 currency_id_n = account_n ? account_n->m_currency_id : -1;
+        double currency_rate = CurrencyHistoryModel::instance().get_id_date_rate(
+            currency_id_n,
+            trx_date
+        );
+        double account_flow = trx_d.account_flow(trx_d.m_account_id);
+
+        Flow flow;
+        flow.m_day = trx_date.dayNumber();
+        flow.m_base_amount = -(account_flow * currency_rate);
+        // Self Transfer as Revaluation
+        flow.m_is_revaluation = (
+            trx_d.m_account_id == trx_d.m_to_account_id_n && trx_d.is_transfer()
+        );
+        flow.m_to_amount = trx_d.m_to_amount;
+        timeline.m_flow_a.push_back(flow);
+    }
+
+    return timeline;
+}
+
+// Return the value of an asset at a given date
+const std::pair<double, double> AssetModel::get_data_value_date(
+    const Data& asset_d,
+    const mmDate& date
+) {
+    return get_data_value_date_a(asset_d, { date }).front();
+}
+
+// Return the (initial, market) value of an asset at each date in date_a.
+// date_a shall be sorted in ascending order.
+// The appreciation or depreciation is applied analytically between cash flows,
+// therefore all dates are answered in one sweep over the asset timeline.
+std::vector<std::pair<double, double>> AssetModel::get_data_value_date_a(
+    const Data& asset_d,
+    const std::vector<mmDate>& date_a
+) {
+    std::vector<std::pair<double /*initial*/, double /*market*/>> balance_a(
+        date_a.size(), { 0.0, 0.0 }
+    );
+
+    mmChoiceId change_id = asset_d.m_change.id();
+    double daily_rate = asset_d.m_change_rate / 36500.0;
+    auto change_factor = [change_id, daily_rate](int days) -> double {
+        if (change_id == AssetChange::e_appreciates)
+            return exp(daily_rate * static_cast<double>(days));
+        else if (change_id == AssetChange::e_depreciates)
+            return exp(-daily_rate * static_cast<double>(days));
+        return 1.0;
+    };
+
+    const Timeline& timeline = get_id_timeline(asset_d.m_id);
+    const int start_day = asset_d.m_start_date.dayNumber();
+
+    std::pair<double, double> balance = { 0.0, 0.0 };
+    bool has_last = false;
+    int last_day = 0;
+    std::size_t flow_i = 0;
+
+    for (std::size_t date_i = 0; date_i < date_a.size(); ++date_i) {
+        const mmDate& date = date_a[date_i];
+        if (date < asset_d.m_start_date)
+            continue;
+        const int day = date.dayNumber();
+
+        if (!timeline.m_has_link) {
+            balance_a[date_i] = {
+                asset_d.m_value,
+                asset_d.m_value * change_factor(day - start_day)
+            };
+            continue;
+        }
+
+        for (; flow_i < timeline.m_flow_a.size() && timeline.m_flow_a[flow_i].m_day <= day; ++flow_i) {
+            const Flow& flow = timeline.m_flow_a[flow_i];
+
+            if (!has_last) {
+                has_last = true;
+                last_day = flow.m_day;
+            }
+            else if (last_day < flow.m_day) {
+                balance.second *= change_factor(flow.m_day - last_day);
+                last_day = flow.m_day;
             }
 
             // FIXME: if (base_amount >= 0 || balance.second < balance.first)
-            if (base_amount >= 0) {
+            if (flow.m_base_amount >= 0) {
                 // cash flow from account to asset
-                balance.first += base_amount;
+                balance.first += flow.m_base_amount;
             }
             else {
                 // cash flow from asset to account
                 double unrealized_gl = balance.second - balance.first;
-                balance.first += std::min(unrealized_gl + base_amount, 0.0);
+                balance.first += std::min(unrealized_gl + flow.m_base_amount, 0.0);
             }
 
-            balance.second += base_amount;
+            balance.second += flow.m_base_amount;
 
-            // Self Transfer as Revaluation
             // FIXME: missing currency conversion
-            if (trx_d.m_account_id == trx_d.m_to_account_id_n && trx_d.is_transfer()) {
+            if (flow.m_is_revaluation) {
                 // TODO honor m_amount => m_to_amount
-                balance.second = trx_d.m_to_amount;
+                balance.second = flow.m_to_amount;
             }
         }
 
-        if (last_n.has_value()) {
-            apply_change(balance.second, last_n.value(), date);
-        }
-    }
-    else {
-        balance = {asset_d.m_value, asset_d.m_value};
-        apply_change(balance.second, asset_d.m_start_date, date);
+        balance_a[date_i] = balance;
+        if (has_last)
+            balance_a[date_i].second *= change_factor(day - last_day);
     }
-    return balance;
+
+    return balance_a;
 }
 
 // Return the current value of an asset
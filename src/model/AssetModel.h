@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include "base/_defs.h"
 #include "base/mmSingleton.h"
 #include "table/_TableFactory.h"
@@ -39,6 +40,29 @@ public:
     static auto WHERE_STARTDATE(OP op, const mmDate& date) -> TableClauseV<wxString>;
     static auto WHERE_IGNORE_CLOSED(bool value) -> TableClauseD;
 
+// -- state
+
+private:
+    // Cash flow of a linked transaction, in base currency.
+    struct Flow
+    {
+        int m_day;              // mmDate::dayNumber()
+        double m_base_amount;
+        bool m_is_revaluation;  // self transfer
+        double m_to_amount;
+    };
+
+    // Linked transactions of an asset, sorted by date.
+    struct Timeline
+    {
+        bool m_has_link = false;
+        std::vector<Flow> m_flow_a;
+    };
+
+    // built on demand for each asset; discarded when a table it depends on changes
+    std::unordered_map<int64, Timeline> c_assetId_timeline_m;
+    std::vector<std::size_t> c_timeline_version_a;
+
 // -- constructor
 
 public:
@@ -64,8 +88,17 @@ public:
 
     // lookup for given Data
     auto get_data_value_date(const Data& asset_d, const mmDate& date) -> const std::pair<double, double>;
+    auto get_data_value_date_a(
+        const Data& asset_d,
+        const std::vector<mmDate>& date_a
+    ) -> std::vector<std::pair<double, double>>;
     auto get_data_value(const Data& asset_d) -> const std::pair<double, double>;
+    void reset_timeline_all() { c_assetId_timeline_m.clear(); }
+
+private:
+    auto get_id_timeline(int64 asset_id) -> const Timeline&;
 
+public:
     // lookup for given id
     auto get_id_name(int64 asset_id) -> const wxString;
 
@@ -21,6 +21,7 @@
 #include "base/_defs.h"
 #include <wx/intl.h>
 
+#include <unordered_map>
 #include "table/BudgetTable.h"
 
 #include "BudgetModel.h"
@@ -43,6 +44,7 @@ BudgetModel& BudgetModel::instance(wxSQLite3Database* db)
 {
     BudgetModel& ins = Singleton<BudgetModel>::instance();
     ins.reset_cache();
+    ins.reset_index();
     ins.m_db = db;
     ins.ensure_table();
 
@@ -57,6 +59,45 @@ BudgetModel& BudgetModel::instance()
 
 // -- methods
 
+// Return the index of budget rows by period.
+const BudgetModel::Index& BudgetModel::get_index()
+{
+    std::vector<std::size_t> key_a = {
+        data_version(),
+        BudgetPeriodModel::instance().data_version(),
+    };
+    if (c_index.m_is_valid && c_index.m_key_a == key_a)
+        return c_index;
+
+    c_index = Index();
+    c_index.m_key_a = std::move(key_a);
+    for (const auto& bp_d : BudgetPeriodModel::instance().find_data_a()) {
+        // keep the first id of a name, as in BudgetPeriodModel::get_name_id_n()
+        c_index.m_name_periodId_m.emplace(bp_d.m_name, bp_d.m_id);
+    }
+    for (const auto& budget_d : find_data_a()) {
+        c_index.m_periodId_dataA_m[budget_d.m_period_id].push_back(budget_d);
+    }
+    c_index.m_is_valid = true;
+    return c_index;
+}
+
+const BudgetModel::DataA& BudgetModel::get_period_data_a(int64 bp_id)
+{
+    static const DataA empty_a;
+    const Index& index = get_index();
+    auto it = index.m_periodId_dataA_m.find(bp_id);
+    return (it != index.m_periodId_dataA_m.end()) ? it->second : empty_a;
+}
+
+const BudgetModel::DataA& BudgetModel::get_name_data_a(const wxString& bp_name)
+{
+    static const DataA empty_a;
+    const Index& index = get_index();
+    auto it = index.m_name_periodId_m.find(bp_name);
+    return (it != index.m_name_periodId_m.end()) ? get_period_data_a(it->second) : empty_a;
+}
+
 void BudgetModel::getBudgetEntry(
     int64 bp_id,
     std::map<int64, BudgetFreq>& freq_mCatId,
@@ -64,14 +105,12 @@ void BudgetModel::getBudgetEntry(
     std::map<int64, wxString>& notes_mCatId
 ) {
     // initaialize category maps; set amount to zero
-    for (int64 cat_id : CategoryModel::instance().find_id_a()) {
+    for (int64 cat_id : CategoryModel::instance().get_all_id_a()) {
         freq_mCatId[cat_id]   = BudgetFreq(BudgetFreq::e_none);
         amount_mCatId[cat_id] = 0.0;
     }
 
-    for (const auto& budget_d : find_data_a(
-        BudgetCol::WHERE_BUDGETYEARID(OP_EQ, bp_id)
-    )) {
+    for (const auto& budget_d : get_period_data_a(bp_id)) {
         int64 cat_id = budget_d.m_category_id;
         freq_mCatId[cat_id]   = budget_d.m_freq;
         amount_mCatId[cat_id] = budget_d.m_amount;
@@ -79,96 +118,126 @@ void BudgetModel::getBudgetEntry(
     }
 }
 
+// Fill budgetStats with the estimated amounts of the budget year which contains
+// the start of date_range, per category and month (0-11); the yearly amount of
+// a category with a yearly budget is in column 12.
+// If groupByMonth is false, the sum of months 0-11 is in column 0.
+// The computation works on dense arrays over the budgeted categories.
 void BudgetModel::getBudgetStats(
     std::map<int64, std::map<int, double>>& budgetStats,
     mmDateRange* date_range,
     bool groupByMonth
 ) {
-    // Set std::map with zeros
-    for (int64 cat_id : CategoryModel::instance().find_id_a()) {
-        for (int month = 0; month < 12; month++) {
-            budgetStats[cat_id][month] = 0.0;
-        }
+    const wxString year = wxString::Format("%i", date_range->start_date().GetYear());
+    const DataA& year_a = get_name_data_a(year);
+    std::vector<const DataA*> month_aa;
+    for (int month = 0; month < 12; month++) {
+        month_aa.push_back(&get_name_data_a(
+            wxString::Format("%s-%02d", year, month + 1)
+        ));
     }
 
-    // Calculations
-    const wxDateTime start_date(date_range->start_date());
-    std::map<int64, double> monthlyBudgetValue;
-    std::map<int64, double> yearlyBudgetValue;
-    std::map<int64, double> yearDeduction;
-    std::map<std::pair<int, int64>, bool> isBudgeted;
-    std::map<int64, int> budgetedMonths;
-    const wxString year = wxString::Format("%i", start_date.GetYear());
-    int64 bp_id_n = BudgetPeriodModel::instance().get_name_id_n(year);
-    for (const Data& budget_d : find_data_a(
-        BudgetCol::WHERE_BUDGETYEARID(OP_EQ, bp_id_n)
-    )) {
-        int64 cat_id = budget_d.m_category_id;
+    // row index of each budgeted category
+    std::unordered_map<int64, int> catId_i_m;
+    std::vector<int64> i_catId_a;
+    auto cat_i = [&catId_i_m, &i_catId_a](int64 cat_id) {
+        auto [it, is_new] = catId_i_m.emplace(cat_id, static_cast<int>(i_catId_a.size()));
+        if (is_new)
+            i_catId_a.push_back(cat_id);
+        return it->second;
+    };
+    for (const Data& budget_d : year_a)
+        cat_i(budget_d.m_category_id);
+    for (const DataA* month_a : month_aa) {
+        for (const Data& budget_d : *month_a)
+            cat_i(budget_d.m_category_id);
+    }
+
+    const std::size_t n = i_catId_a.size();
+    std::vector<double> stat_a(n * 12, 0.0);
+    std::vector<double> monthlyValue_a(n, 0.0);
+    std::vector<double> yearlyValue_a(n, 0.0);
+    std::vector<char> hasYearly_a(n, 0);
+    std::vector<double> yearDeduction_a(n, 0.0);
+    std::vector<char> isBudgeted_a(n * 12, 0);
+    std::vector<int> budgetedMonths_a(n, 0);
+
+    for (const Data& budget_d : year_a) {
+        const int i = catId_i_m[budget_d.m_category_id];
         // Determine the monhly budgeted amounts
-        monthlyBudgetValue[cat_id] = budget_d.amount_per_month();
+        monthlyValue_a[i] = budget_d.amount_per_month();
         // Determine the yearly budgeted amounts
-        yearlyBudgetValue[cat_id] = budget_d.amount_per_year();
-        // Store the yearly budget to use in reporting.
-        // Monthly budgets are stored in index 0-11, so use index 12 for year
-        budgetStats[cat_id][12] = yearlyBudgetValue[cat_id];
+        yearlyValue_a[i] = budget_d.amount_per_year();
+        hasYearly_a[i] = 1;
     }
+
     bool budgetOverride = PrefModel::instance().getBudgetOverride();
     bool budgetDeductMonthly = PrefModel::instance().getBudgetDeductMonthly();
     for (int month = 0; month < 12; month++) {
-        const wxString month_name = wxString::Format("%s-%02d", year, month + 1);
-        bp_id_n = BudgetPeriodModel::instance().get_name_id_n(month_name);
-
         //fill with amount from monthly budgets first
-        for (const Data& budget_d : find_data_a(
-            BudgetCol::WHERE_BUDGETYEARID(OP_EQ, bp_id_n)
-        )) {
-            int64 cat_id = budget_d.m_category_id;
-            std::pair<int, int64> month_categ = std::make_pair(month, cat_id);
-            if (!isBudgeted[month_categ]) {
-                isBudgeted[month_categ] = true;
-                budgetedMonths[cat_id]++;
+        for (const Data& budget_d : *month_aa[month]) {
+            const int i = catId_i_m[budget_d.m_category_id];
+            if (!isBudgeted_a[i * 12 + month]) {
+                isBudgeted_a[i * 12 + month] = 1;
+                budgetedMonths_a[i]++;
             }
-            budgetStats[cat_id][month] = budget_d.amount_per_month();
-            yearDeduction[cat_id] += budgetStats[cat_id][month];
+            stat_a[i * 12 + month] = budget_d.amount_per_month();
+            yearDeduction_a[i] += stat_a[i * 12 + month];
         }
     }
+
     // Now go month by month and add the yearly budget
-    for (int month = 0; month < 12; month++) {
-        // If user selected to deduct monthly budgeted amounts 
-        if (budgetDeductMonthly)
-            for (const auto& categoryBudget : yearlyBudgetValue) {
-                if (yearDeduction[categoryBudget.first] / categoryBudget.second >= 1) continue;
+    for (std::size_t i = 0; i < n; i++) {
+        if (!hasYearly_a[i])
+            continue;
+        for (int month = 0; month < 12; month++) {
+            double& stat = stat_a[i * 12 + month];
+            const bool isBudgeted = isBudgeted_a[i * 12 + month];
+            // If user selected to deduct monthly budgeted amounts
+            if (budgetDeductMonthly) {
+                if (yearDeduction_a[i] / yearlyValue_a[i] >= 1) continue;
                 //Deduct the monthly total from the yearly budget
-                double adjusted_amount = categoryBudget.second - yearDeduction[categoryBudget.first];
+                double adjusted_amount = yearlyValue_a[i] - yearDeduction_a[i];
                 if (!budgetOverride)
                     // If user doesn't override the budget, add 1/12 of the adjusted amount to every period
-                    budgetStats[categoryBudget.first][month] += adjusted_amount / 12;
-                else if (!isBudgeted[std::make_pair(month, categoryBudget.first)])
+                    stat += adjusted_amount / 12;
+                else if (!isBudgeted)
                     // Otherwise if n months have a defined budget, add 1/(12-n) of the adjusted amount only to the (12-n) non-budgeted periods
-                    budgetStats[categoryBudget.first][month] = adjusted_amount / (12 - budgetedMonths[categoryBudget.first]);
+                    stat = adjusted_amount / (12 - budgetedMonths_a[i]);
             }
-        else
-            // If the user is not deducting the monthly budget from the yearly budget
-            for (const auto& categoryBudget : monthlyBudgetValue) {
+            else {
+                // If the user is not deducting the monthly budget from the yearly budget
                 if (!budgetOverride)
                     // If user doesn't override their budget, add 1/12 of the yearly amount to every period
-                    budgetStats[categoryBudget.first][month] += categoryBudget.second;
-                else if (!isBudgeted[std::make_pair(month, categoryBudget.first)])
+                    stat += monthlyValue_a[i];
+                else if (!isBudgeted)
                     // Otherwise fill 1/12 of the yearly amount only in non-budgeted periods
-                    budgetStats[categoryBudget.first][month] = categoryBudget.second;
+                    stat = monthlyValue_a[i];
             }
-    }
-    if (!groupByMonth) {
-        std::map<int64, std::map<int,double> > yearlyBudgetStats;
-        for (const auto& cat_d : CategoryModel::instance().find_data_a()) {
-            yearlyBudgetStats[cat_d.m_id][0] = 0.0;
         }
+    }
 
-        for (const auto& cat : budgetStats)
-            for(int month = 0; month < 12; month++)
-                yearlyBudgetStats[cat.first][0] += budgetStats[cat.first][month];
+    // Set std::map with zeros
+    const int columns = groupByMonth ? 12 : 1;
+    if (!groupByMonth)
+        budgetStats.clear();
+    for (int64 cat_id : CategoryModel::instance().get_all_id_a()) {
+        for (int month = 0; month < columns; month++)
+            budgetStats[cat_id][month] = 0.0;
+    }
 
-        budgetStats = yearlyBudgetStats;
+    for (std::size_t i = 0; i < n; i++) {
+        std::map<int, double>& stat_mMonth = budgetStats[i_catId_a[i]];
+        for (int month = 0; month < 12; month++) {
+            if (groupByMonth)
+                stat_mMonth[month] = stat_a[i * 12 + month];
+            else
+                stat_mMonth[0] += stat_a[i * 12 + month];
+        }
+        // Store the yearly budget to use in reporting.
+        // Monthly budgets are stored in index 0-11, so use index 12 for year
+        if (groupByMonth && hasYearly_a[i])
+            stat_mMonth[12] = yearlyValue_a[i];
     }
 }
 
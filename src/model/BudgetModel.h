@@ -21,6 +21,7 @@
 #pragma once
 
 #include <float.h>
+#include <unordered_map>
 #include "base/_defs.h"
 #include "base/mmSingleton.h"
 #include "util/mmDateRange.h"
@@ -34,6 +35,22 @@ class BudgetModel : public TableFactory<BudgetTable, BudgetData>
 public:
     static auto WHERE_FREQUENCY(OP op, BudgetFreq freq) -> TableClauseV<wxString>;
 
+// -- state
+
+private:
+    // Budget rows grouped by period, and period ids by name.
+    // Each table is loaded in one query; the index is rebuilt when either
+    // table is written.
+    struct Index
+    {
+        std::vector<std::size_t> m_key_a;
+        bool m_is_valid = false;
+        std::unordered_map<wxString, int64> m_name_periodId_m;
+        std::unordered_map<int64, DataA> m_periodId_dataA_m;
+    };
+
+    Index c_index;
+
 // -- constructor
 
 public:
@@ -54,7 +71,14 @@ public:
 
 // -- methods
 
+private:
+    auto get_index() -> const Index&;
+    auto get_period_data_a(int64 bp_id) -> const DataA&;
+    auto get_name_data_a(const wxString& bp_name) -> const DataA&;
+
 public:
+    void reset_index() { c_index.m_is_valid = false; }
+
     void getBudgetEntry(
         int64 bp_id,
         std::map<int64, BudgetFreq>& freq_mCatId,
@@ -21,6 +21,8 @@
 #include "CategoryModel.h"
 
 #include <tuple>
+#include <algorithm>
+#include <unordered_set>
 #include "base/_defs.h"
 #include "util/mmDateRange.h"
 
@@ -29,8 +31,11 @@
 #include "AccountModel.h"
 #include "PayeeModel.h"
 #include "TrxModel.h"
+#include "TrxLinkModel.h"
+#include "CurrencyModel.h"
 #include "SchedModel.h"
 #include "BudgetModel.h"
+#include "_ModelAll.h"
 
 // -- constructor
 
@@ -40,6 +45,8 @@ CategoryModel& CategoryModel::instance(wxSQLite3Database* db)
 {
     CategoryModel& ins = Singleton<CategoryModel>::instance();
     ins.reset_cache();
+    ins.reset_tree();
+    ins.reset_actuals();
     ins.m_db = db;
     ins.ensure_table();
     ins.preload_cache();
@@ -53,6 +60,12 @@ CategoryModel& CategoryModel::instance()
     return Singleton<CategoryModel>::instance();
 }
 
+CategoryModel::~CategoryModel()
+{
+    if (m_actuals_handle != 0)
+        TableChangeBus::instance().unsubscribe(m_actuals_handle);
+}
+
 // -- override
 
 bool CategoryModel::find_id_isUsed(int64 cat_id, bool ignore_deleted)
@@ -60,6 +73,11 @@ bool CategoryModel::find_id_isUsed(int64 cat_id, bool ignore_deleted)
     if (cat_id <= 0)
         return false;
 
+    // references include sub-categories, payees and budgets
+    ModelAll& all = ModelAll::instance();
+    if (all.has_ref_count())
+        return all.get_ref_count(ModelAll::e_ref_category, cat_id).get(ignore_deleted) > 0;
+
     bool is_used = false;
 
     // TODO: move this check out of find_id_isUsed()
@@ -112,6 +130,179 @@ bool CategoryModel::find_id_isUsed(int64 cat_id, bool ignore_deleted)
 
 // -- methods
 
+namespace
+{
+
+// Same order as the NOCASE collation of CATEGNAME (folds ASCII letters only).
+bool name_less(const wxString& x, const wxString& y)
+{
+    auto fold = [](wxUniChar ch) -> wxUniChar {
+        return (ch >= 'A' && ch <= 'Z') ? wxUniChar(ch.GetValue() + ('a' - 'A')) : ch;
+    };
+    StringIt x_it = x.begin(), y_it = y.begin();
+    for (; x_it != x.end() && y_it != y.end(); ++x_it, ++y_it) {
+        const wxUniChar x_ch = fold(*x_it), y_ch = fold(*y_it);
+        if (x_ch != y_ch)
+            return x_ch < y_ch;
+    }
+    return x_it == x.end() && y_it != y.end();
+}
+
+} // namespace
+
+// Return the category hierarchy.
+// The hierarchy is built in one pass over the table and it is reused until
+// the table is written or CATEG_DELIMITER is changed.
+const CategoryModel::Tree& CategoryModel::get_tree()
+{
+    // note: CATEG_DELIMITER may change during program execution;
+    // it is read again only when the info table is written.
+    const std::size_t info_version = InfoModel::instance().data_version();
+    if (c_tree.m_is_valid && c_tree.m_version == data_version()) {
+        if (c_tree.m_info_version == info_version)
+            return c_tree;
+        if (InfoModel::instance().getString("CATEG_DELIMITER", ":") == c_tree.m_delimiter) {
+            c_tree.m_info_version = info_version;
+            return c_tree;
+        }
+    }
+
+    c_tree = Tree();
+    c_tree.m_delimiter = InfoModel::instance().getString("CATEG_DELIMITER", ":");
+
+    DataA cat_a = find_data_a();
+    std::stable_sort(cat_a.begin(), cat_a.end(),
+        [](const Data& x, const Data& y) { return name_less(x.m_name, y.m_name); }
+    );
+
+    std::unordered_map<int64, const Data*> id_data_m;
+    for (const auto& cat_d : cat_a) {
+        id_data_m[cat_d.m_id] = &cat_d;
+        c_tree.m_id_node_m[cat_d.m_id] = Node{ -1, 0, -1, -1, "", {} };
+    }
+
+    for (const auto& cat_d : cat_a) {
+        const int64 parent_id = cat_d.m_parent_id_n;
+        if (parent_id > 0 && parent_id != cat_d.m_id && id_data_m.count(parent_id) > 0) {
+            c_tree.m_id_node_m[cat_d.m_id].m_parent_id = parent_id;
+            c_tree.m_id_node_m[parent_id].m_child_id_a.push_back(cat_d.m_id);
+        }
+        else
+            c_tree.m_root_id_a.push_back(cat_d.m_id);
+    }
+
+    // iterative depth-first walk from each root
+    auto walk = [this, &id_data_m](int64 root_id) {
+        Node& root = c_tree.m_id_node_m[root_id];
+        const Data* root_n = id_data_m[root_id];
+        // #8276: temporary fix for corrupted CATEGORY_V1 (parent does not exist)
+        root.m_fullname = (root_n->m_parent_id_n > 0)
+            ? _t("Error") + c_tree.m_delimiter + root_n->m_name
+            : root_n->m_name;
+        root.m_depth = 0;
+        root.m_tin = static_cast<int>(c_tree.m_preorder_id_a.size());
+        c_tree.m_preorder_id_a.push_back(root_id);
+
+        std::vector<std::pair<int64, std::size_t>> stack_a = { { root_id, 0 } };
+        while (!stack_a.empty()) {
+            auto& [id, child_i] = stack_a.back();
+            Node& node = c_tree.m_id_node_m[id];
+            if (child_i >= node.m_child_id_a.size()) {
+                node.m_tout = static_cast<int>(c_tree.m_preorder_id_a.size());
+                stack_a.pop_back();
+                continue;
+            }
+            const int64 child_id = node.m_child_id_a[child_i++];
+            Node& child = c_tree.m_id_node_m[child_id];
+            if (child.m_tin >= 0)
+                continue;
+            child.m_fullname = node.m_fullname + c_tree.m_delimiter + id_data_m[child_id]->m_name;
+            child.m_depth = node.m_depth + 1;
+            child.m_tin = static_cast<int>(c_tree.m_preorder_id_a.size());
+            c_tree.m_preorder_id_a.push_back(child_id);
+            stack_a.emplace_back(child_id, 0);
+        }
+    };
+
+    for (int64 root_id : std::vector<int64>(c_tree.m_root_id_a))
+        walk(root_id);
+
+    // categories in a parent cycle are not reachable from a root
+    for (const auto& cat_d : cat_a) {
+        Node& node = c_tree.m_id_node_m[cat_d.m_id];
+        if (node.m_tin >= 0)
+            continue;
+        node.m_parent_id = -1;
+        c_tree.m_root_id_a.push_back(cat_d.m_id);
+        walk(cat_d.m_id);
+    }
+
+    c_tree.m_version = data_version();
+    c_tree.m_info_version = info_version;
+    c_tree.m_is_valid = true;
+    return c_tree;
+}
+
+const CategoryModel::Node* CategoryModel::get_id_node_n(int64 cat_id)
+{
+    const Tree& tree = get_tree();
+    const auto it = tree.m_id_node_m.find(cat_id);
+    return (it != tree.m_id_node_m.end()) ? &it->second : nullptr;
+}
+
+// Return the depth of cat_id in the hierarchy (0 for a root category),
+// or -1 if cat_id does not exist.
+int CategoryModel::get_id_depth(int64 cat_id)
+{
+    const Node* node_n = get_id_node_n(cat_id);
+    return node_n ? node_n->m_depth : -1;
+}
+
+int64 CategoryModel::get_id_parent_id(int64 cat_id)
+{
+    const Node* node_n = get_id_node_n(cat_id);
+    return node_n ? node_n->m_parent_id : -1;
+}
+
+// Return the direct sub-categories of cat_id (or the root categories,
+// if cat_id is -1), ordered by name.
+const std::vector<int64> CategoryModel::get_id_child_id_a(int64 cat_id)
+{
+    if (cat_id <= 0)
+        return get_tree().m_root_id_a;
+
+    const Node* node_n = get_id_node_n(cat_id);
+    return node_n ? node_n->m_child_id_a : std::vector<int64>();
+}
+
+// Return true if cat_id is root_id or one of its descendants.
+bool CategoryModel::is_id_in_subtree(int64 cat_id, int64 root_id)
+{
+    const Tree& tree = get_tree();
+    const auto cat_it = tree.m_id_node_m.find(cat_id);
+    const auto root_it = tree.m_id_node_m.find(root_id);
+    if (cat_it == tree.m_id_node_m.end() || root_it == tree.m_id_node_m.end())
+        return false;
+
+    return root_it->second.m_tin <= cat_it->second.m_tin &&
+        cat_it->second.m_tin < root_it->second.m_tout;
+}
+
+// Return the descendants of cat_id (excluding cat_id) in depth-first order;
+// siblings are ordered by name.
+const std::vector<int64> CategoryModel::find_id_subtree_a(int64 cat_id)
+{
+    const Node* node_n = get_id_node_n(cat_id);
+    if (!node_n)
+        return {};
+
+    const std::vector<int64>& preorder_id_a = get_tree().m_preorder_id_a;
+    return std::vector<int64>(
+        preorder_id_a.begin() + node_n->m_tin + 1,
+        preorder_id_a.begin() + node_n->m_tout
+    );
+}
+
 bool CategoryModel::get_id_active(int64 cat_id)
 {
     // root category (id -1) is always active
@@ -129,21 +320,30 @@ const wxString CategoryModel::get_data_fullname(
     if (!cat_n)
         return "";
 
-    // note: CATEG_DELIMITER may change during program execution
-    if (delimiter.empty()) {
-        delimiter = InfoModel::instance().getString("CATEG_DELIMITER", ":");
+    const Tree& tree = get_tree();
+    if (delimiter.empty())
+        delimiter = tree.m_delimiter;
+
+    if (cat_n->m_parent_id_n <= 0)
+        return cat_n->m_name;
+
+    // use the full name of the parent, since cat_n may be a modified copy
+    if (delimiter == tree.m_delimiter) {
+        const auto it = tree.m_id_node_m.find(cat_n->m_parent_id_n);
+        // #8276: temporary fix for corrupted CATEGORY_V1 (parent does not exist)
+        if (it == tree.m_id_node_m.end())
+            return _t("Error") + delimiter + cat_n->m_name;
+        return it->second.m_fullname + delimiter + cat_n->m_name;
     }
 
     wxString fullname = cat_n->m_name;
     while (cat_n->m_parent_id_n > 0) {
         cat_n = get_idN_data_n(cat_n->m_parent_id_n);
-        // #8276: temporary fix for corrupted CATEGORY_V1 (parent does not exist)
-        if (!cat_n) 
-        {
+        if (!cat_n) {
             fullname = _t("Error") + delimiter + fullname;
             break;
-        } else
-            fullname = cat_n->m_name + delimiter + fullname;
+        }
+        fullname = cat_n->m_name + delimiter + fullname;
     }
 
     return fullname;
@@ -151,6 +351,11 @@ const wxString CategoryModel::get_data_fullname(
 
 const wxString CategoryModel::get_id_fullname(int64 cat_id, wxString delimiter)
 {
+    if (delimiter.empty()) {
+        const Node* node_n = get_id_node_n(cat_id);
+        if (node_n)
+            return node_n->m_fullname;
+    }
     return get_data_fullname(get_idN_data_n(cat_id), delimiter);
 }
 
@@ -237,18 +442,15 @@ CategoryModel::DataA CategoryModel::find_data_sub_a(const Data& cat_d)
     );
 }
 
+// Return the descendants of cat_d in depth-first order;
+// siblings are ordered by name.
 CategoryModel::DataA CategoryModel::find_data_subtree_a(const Data& cat_d)
 {
     DataA tree_a;
-    for (const auto& sub_d : find_data_a(
-        CategoryCol::WHERE_PARENTID(OP_EQ, cat_d.m_id),
-        TableClause::ORDERBY(Col::NAME_CATEGNAME)
-    )) {
-        tree_a.push_back(sub_d);
-        DataA subtree_a = find_data_subtree_a(sub_d);
-        for (const auto& subtree_d : subtree_a) {
-            tree_a.push_back(subtree_d);
-        }
+    for (int64 sub_id : find_id_subtree_a(cat_d.m_id)) {
+        const Data* sub_n = get_idN_data_n(sub_id);
+        if (sub_n)
+            tree_a.push_back(*sub_n);
     }
     return tree_a;
 }
@@ -277,6 +479,13 @@ const wxArrayString CategoryModel::find_pattern_name_a(const wxString& cat_patte
     return name_a;
 }
 
+// Fill amount_mMonth_mCatId with the actual amounts of the valid transactions
+// in date_range, per category and month (or in column 0 if group_by_month is false).
+// If account_name_a_n is not null, only transactions of these accounts are included.
+// If amount_mCatId_n is not null, non-split transfers are included with the
+// sign of the budgeted amount of their category.
+// The amounts are computed once for each date range and account filter,
+// and they are kept current as transactions change (see on_actuals_change()).
 void CategoryModel::getCategoryStats(
     std::map<int64, std::map<int, double>>& amount_mMonth_mCatId,
     wxSharedPtr<wxArrayString> account_name_a_n,
@@ -286,82 +495,287 @@ void CategoryModel::getCategoryStats(
     std::map<int64, double>* amount_mCatId_n,
     [[maybe_unused]] bool fin_months
 ) {
-    mmDate startDate = mmDate(date_range->start_date());
-    mmDate endDate = mmDate(date_range->end_date());
+    std::vector<int64> account_id_a;
+    if (account_name_a_n) {
+        for (const auto& account_name : *account_name_a_n) {
+            const AccountData* account_n = AccountModel::instance().get_name_data_n(
+                account_name
+            );
+            if (account_n)
+                account_id_a.push_back(account_n->m_id);
+        }
+        // an empty filter selects no account
+        if (account_id_a.empty())
+            account_id_a.push_back(-1);
+        std::sort(account_id_a.begin(), account_id_a.end());
+    }
 
-    // Initialization
-    // Set std::map with zerros
-    double value = 0;
+    const Actuals& actuals = get_actuals(
+        mmDate(date_range->start_date()),
+        mmDate(date_range->end_date()),
+        account_id_a
+    );
+
+    // Set std::map with zeros
     int columns = group_by_month ? 12 : 1;
+    for (int64 cat_id : get_all_id_a()) {
+        for (int month = 0; month < columns; month++)
+            amount_mMonth_mCatId[cat_id][month] = 0.0;
+    }
+
+    for (const auto& [cat_id, i] : actuals.m_catId_i_m) {
+        double sign = 0.0;
+        if (amount_mCatId_n && std::any_of(
+            actuals.m_transfer_a.begin() + i * 12,
+            actuals.m_transfer_a.begin() + i * 12 + 12,
+            [](double amount) { return amount != 0.0; }
+        ))
+            sign = ((*amount_mCatId_n)[cat_id] < 0) ? -1.0 : 1.0;
+        std::map<int, double>& amount_mMonth = amount_mMonth_mCatId[cat_id];
+        for (int m = 0; m < 12; m++) {
+            const int cell = i * 12 + m;
+            amount_mMonth[group_by_month ? m : 0] +=
+                actuals.m_flow_a[cell] + sign * actuals.m_transfer_a[cell];
+        }
+    }
+}
+
+// Key of the actuals: the data versions of the tables which require a full
+// rebuild, and the preferences which affect the conversion rates.
+// Changes to transactions and splits are applied incrementally.
+std::vector<std::size_t> CategoryModel::actuals_key()
+{
+    return {
+        AccountModel::instance().data_version(),
+        TrxLinkModel::instance().data_version(),
+        CurrencyModel::instance().data_version(),
+        CurrencyHistoryModel::instance().data_version(),
+        static_cast<std::size_t>(PrefModel::instance().getBaseCurrencyID().GetValue()),
+        static_cast<std::size_t>(PrefModel::instance().getUseCurrencyHistory()),
+    };
+}
+
+const CategoryModel::Actuals& CategoryModel::get_actuals(
+    const mmDate& start, const mmDate& end,
+    const std::vector<int64>& account_id_a
+) {
+    if (m_actuals_handle == 0) {
+        m_actuals_handle = TableChangeBus::instance().subscribe(
+            [this](const TableChangeM& change_m) { on_actuals_change(change_m); }
+        );
+    }
 
-    std::vector<std::pair<mmDate, int>> date_month_a;
-    for (int m = 0; m < columns; m++) {
-        mmDate date = startDate.plusDateSpan(wxDateSpan::Months(m));
-        date_month_a.emplace_back(date, m);
+    // apply the committed changes which have not been published yet;
+    // they are delivered only to this model, not to the other subscribers
+    const std::size_t trx_version = TrxModel::instance().data_version();
+    const std::size_t tp_version = TrxSplitModel::instance().data_version();
+    for (const auto& actuals : c_actuals_a) {
+        if (actuals.m_trx_version != trx_version || actuals.m_tp_version != tp_version) {
+            TableChangeBus::instance().deliver(m_actuals_handle);
+            break;
+        }
     }
-    std::reverse(date_month_a.begin(), date_month_a.end());
 
-    for (int64 cat_id : find_id_a()) {
-        for (int m = 0; m < columns; m++) {
-            int month = group_by_month ? m : 0;
-            amount_mMonth_mCatId[cat_id][month] = value;
+    std::vector<std::size_t> key_a = actuals_key();
+    auto it = std::find_if(c_actuals_a.begin(), c_actuals_a.end(),
+        [&](const Actuals& actuals) {
+            return actuals.m_start == start && actuals.m_end == end &&
+                actuals.m_account_id_a == account_id_a;
         }
+    );
+    if (it != c_actuals_a.end()) {
+        Actuals actuals = std::move(*it);
+        c_actuals_a.erase(it);
+        c_actuals_a.push_back(std::move(actuals));
+    }
+    else {
+        if (c_actuals_a.size() >= s_actuals_cap)
+            c_actuals_a.erase(c_actuals_a.begin());
+        c_actuals_a.emplace_back();
+        c_actuals_a.back().m_start = start;
+        c_actuals_a.back().m_end = end;
+        c_actuals_a.back().m_account_id_a = account_id_a;
+    }
+
+    Actuals& actuals = c_actuals_a.back();
+    if (actuals.m_key_a != key_a ||
+        actuals.m_trx_version != TrxModel::instance().data_version() ||
+        actuals.m_tp_version != TrxSplitModel::instance().data_version()
+    ) {
+        actuals.m_key_a = std::move(key_a);
+        build_actuals(actuals);
     }
+    return actuals;
+}
 
-    // Calculations
+// Load the transactions of the date range in one query, and all splits in another.
+void CategoryModel::build_actuals(Actuals& actuals)
+{
+    actuals.m_month_a.clear();
+    for (int m = 0; m < 12; m++)
+        actuals.m_month_a.push_back(actuals.m_start.plusDateSpan(wxDateSpan::Months(m)));
+    actuals.m_catId_i_m.clear();
+    actuals.m_flow_a.clear();
+    actuals.m_transfer_a.clear();
+    actuals.m_trxId_item_a_m.clear();
+    actuals.m_tpId_trxId_m.clear();
+    actuals.m_trx_version = TrxModel::instance().data_version();
+    actuals.m_tp_version = TrxSplitModel::instance().data_version();
+
+    const TrxSplitModel::DataA empty_tp_a;
     auto trxId_tpA_m = TrxSplitModel::instance().find_all_mTrxId();
     for (const auto& trx_d : TrxModel::instance().find_data_a(
-        TrxModel::WHERE_DATE(OP_GE, startDate),
-        TrxModel::WHERE_DATE(OP_LE, endDate),
+        TrxModel::WHERE_DATE(OP_GE, actuals.m_start),
+        TrxModel::WHERE_DATE(OP_LE, actuals.m_end),
         TrxModel::WHERE_IS_VALID(true)
     )) {
-        if (account_name_a_n) {
-            const AccountData* account_n = AccountModel::instance().get_idN_data_n(
-                trx_d.m_account_id
-            );
-            if (account_name_a_n->Index(account_n->m_name) == wxNOT_FOUND)
-                continue;
-        }
-
-        const double convRate = CurrencyHistoryModel::instance().get_id_date_rate(
-            AccountModel::instance().get_idN_data_n(trx_d.m_account_id)->m_currency_id,
-            trx_d.m_date()
+        auto tp_it = trxId_tpA_m.find(trx_d.m_id);
+        add_actuals_trx(actuals, trx_d,
+            tp_it != trxId_tpA_m.end() ? tp_it->second : empty_tp_a
         );
+    }
+}
+
+void CategoryModel::add_actuals_trx(
+    Actuals& actuals,
+    const TrxData& trx_d,
+    const std::vector<TrxSplitData>& tp_a
+) {
+    for (const auto& tp_d : tp_a)
+        actuals.m_tpId_trxId_m[tp_d.m_id] = trx_d.m_id;
+
+    if (!trx_d.is_valid() ||
+        trx_d.m_date() < actuals.m_start || trx_d.m_date() > actuals.m_end
+    )
+        return;
+    if (!actuals.m_account_id_a.empty() && !std::binary_search(
+        actuals.m_account_id_a.begin(), actuals.m_account_id_a.end(),
+        trx_d.m_account_id
+    ))
+        return;
+
+    const AccountData* account_n = AccountModel::instance().get_idN_data_n(
+        trx_d.m_account_id
+    );
+    if (!account_n)
+        return;
+    const double convRate = CurrencyHistoryModel::instance().get_id_date_rate(
+        account_n->m_currency_id,
+        trx_d.m_date()
+    );
 
-        mmDate trx_date = trx_d.m_date();
-        int month = 0;
-        if (group_by_month) {
-            auto it = std::find_if(date_month_a.begin(), date_month_a.end(),
-                [trx_date](std::pair<mmDate, int> date_month) {
-                    return trx_date >= date_month.first;
-                }
+    const mmDate trx_date = trx_d.m_date();
+    const int month = static_cast<int>(std::upper_bound(
+        actuals.m_month_a.begin(), actuals.m_month_a.end(), trx_date
+    ) - actuals.m_month_a.begin()) - 1;
+
+    std::vector<Actuals::Item>& item_a = actuals.m_trxId_item_a_m[trx_d.m_id];
+    auto add_item = [&](int64 cat_id, double amount, bool is_transfer) {
+        auto [it, is_new] = actuals.m_catId_i_m.emplace(
+            cat_id, static_cast<int>(actuals.m_catId_i_m.size())
+        );
+        if (is_new) {
+            actuals.m_flow_a.resize(actuals.m_flow_a.size() + 12, 0.0);
+            actuals.m_transfer_a.resize(actuals.m_transfer_a.size() + 12, 0.0);
+        }
+        const int cell = it->second * 12 + month;
+        (is_transfer ? actuals.m_transfer_a : actuals.m_flow_a)[cell] += amount;
+        item_a.push_back({ cell, amount, is_transfer });
+    };
+
+    if (tp_a.empty()) {
+        if (!trx_d.is_transfer()) {
+            // Do not include asset or stock transfers in income expense calculations.
+            if (!TrxModel::is_foreignAsTransfer(trx_d))
+                add_item(trx_d.m_category_id_n,
+                    trx_d.account_flow(trx_d.m_account_id) * convRate, false
+                );
+        }
+        else {
+            add_item(trx_d.m_category_id_n, trx_d.m_amount * convRate, true);
+        }
+    }
+    else {
+        for (const auto& tp_d : tp_a) {
+            add_item(tp_d.m_category_id,
+                (trx_d.is_withdrawal() ? -tp_d.m_amount : tp_d.m_amount) * convRate,
+                false
             );
-            month = it->second;
         }
+    }
+}
 
-        int64 cat_id_n = trx_d.m_category_id_n;
+void CategoryModel::remove_actuals_trx(Actuals& actuals, int64 trx_id)
+{
+    auto it = actuals.m_trxId_item_a_m.find(trx_id);
+    if (it == actuals.m_trxId_item_a_m.end())
+        return;
+
+    for (const auto& item : it->second)
+        (item.m_is_transfer ? actuals.m_transfer_a : actuals.m_flow_a)[item.m_cell] -=
+            item.m_amount;
+    actuals.m_trxId_item_a_m.erase(it);
+}
 
-        if (trxId_tpA_m[trx_d.m_id].empty()) {
-            if (!trx_d.is_transfer()) {
-                // Do not include asset or stock transfers in income expense calculations.
-                if (TrxModel::is_foreignAsTransfer(trx_d))
-                    continue;
-                amount_mMonth_mCatId[cat_id_n][month] += trx_d.account_flow(trx_d.m_account_id) * convRate;
-            }
-            else if (amount_mCatId_n) {
-                double amount = trx_d.m_amount * convRate;
-                if ((*amount_mCatId_n)[cat_id_n] < 0)
-                    amount_mMonth_mCatId[cat_id_n][month] -= amount;
-                else
-                    amount_mMonth_mCatId[cat_id_n][month] += amount;
+// Apply the committed changes of transactions and splits to the actuals.
+// The changed transactions are read from the database, bypassing the cache,
+// since the cache of TrxModel may not yet reflect changes made with raw SQL.
+void CategoryModel::on_actuals_change(const TableChangeM& change_m)
+{
+    if (c_actuals_a.empty())
+        return;
+
+    auto trx_it = change_m.find(TrxModel::instance().table_name());
+    auto tp_it = change_m.find(TrxSplitModel::instance().table_name());
+    if (trx_it == change_m.end() && tp_it == change_m.end())
+        return;
+
+    if ((trx_it != change_m.end() && trx_it->second.m_is_all) ||
+        (tp_it != change_m.end() && tp_it->second.m_is_all)
+    ) {
+        reset_actuals();
+        return;
+    }
+
+    // the transactions of the changed splits
+    std::unordered_set<int64> trx_id_s;
+    if (trx_it != change_m.end())
+        trx_id_s = trx_it->second.m_id_s;
+    if (tp_it != change_m.end()) {
+        for (const int64& tp_id : tp_it->second.m_id_s) {
+            for (const auto& actuals : c_actuals_a) {
+                auto it = actuals.m_tpId_trxId_m.find(tp_id);
+                if (it != actuals.m_tpId_trxId_m.end())
+                    trx_id_s.insert(it->second);
             }
+            for (const auto& tp_d : TrxSplitModel::instance().find_data_a(
+                TrxSplitCol::WHERE_SPLITTRANSID(OP_EQ, tp_id)
+            ))
+                trx_id_s.insert(tp_d.m_trx_id);
         }
-        else {
-            for (const auto& tp_d : trxId_tpA_m[trx_d.m_id]) {
-                amount_mMonth_mCatId[tp_d.m_category_id][month] +=
-                    (trx_d.is_withdrawal() ? -tp_d.m_amount : tp_d.m_amount) *
-                    convRate;
-            }
+    }
+
+    for (const int64& trx_id : trx_id_s) {
+        TrxModel::DataA trx_a = TrxModel::instance().find_data_a(
+            TrxCol::WHERE_TRANSID(OP_EQ, trx_id)
+        );
+        TrxSplitModel::DataA tp_a;
+        if (!trx_a.empty())
+            tp_a = TrxSplitModel::instance().find_data_a(
+                TrxSplitCol::WHERE_TRANSID(OP_EQ, trx_id)
+            );
+        for (auto& actuals : c_actuals_a) {
+            remove_actuals_trx(actuals, trx_id);
+            if (!trx_a.empty())
+                add_actuals_trx(actuals, trx_a.front(), tp_a);
+        }
+    }
+
+    // changes which are not committed yet will be applied when they are published
+    if (!TableChangeBus::instance().has_pending()) {
+        for (auto& actuals : c_actuals_a) {
+            actuals.m_trx_version = TrxModel::instance().data_version();
+            actuals.m_tp_version = TrxSplitModel::instance().data_version();
         }
     }
 }
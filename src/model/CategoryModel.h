@@ -21,21 +21,88 @@
 #pragma once
 
 #include "base/_defs.h"
+#include <unordered_map>
 #include <wx/sharedptr.h>
 #include "base/mmSingleton.h"
 #include "table/_TableFactory.h"
 #include "data/CategoryData.h"
+#include "data/TrxData.h"
+#include "data/TrxSplitData.h"
 
 class mmDateRange;
 
 class CategoryModel : public TableFactory<CategoryTable, CategoryData>
 {
+// -- state
+
+private:
+    // Position of a category in the hierarchy.
+    // A category d is in the subtree of r iff r.m_tin <= d.m_tin < r.m_tout.
+    struct Node
+    {
+        int64 m_parent_id;              // -1 for a root or an orphan
+        int m_depth;                    // 0 for a root
+        int m_tin;                      // Euler-tour entry index
+        int m_tout;                     // Euler-tour exit index
+        wxString m_fullname;            // with m_delimiter
+        std::vector<int64> m_child_id_a; // ordered by name
+    };
+
+    // Category hierarchy; rebuilt when the table is written.
+    // m_info_version is the version of InfoModel when m_delimiter was read.
+    struct Tree
+    {
+        std::size_t m_version = 0;
+        std::size_t m_info_version = 0;
+        bool m_is_valid = false;
+        wxString m_delimiter;
+        std::unordered_map<int64, Node> m_id_node_m;
+        std::vector<int64> m_root_id_a;  // ordered by name
+        std::vector<int64> m_preorder_id_a;
+    };
+
+    Tree c_tree;
+
+    // Actual amounts of transactions in a date range, per category and month.
+    // m_flow_a and m_transfer_a are dense arrays of size (number of rows) * 12;
+    // the row of a category is m_catId_i_m[cat_id] and the column is the month
+    // offset from m_start (later dates are in the last column).
+    // The contributions of each transaction are kept, such that the arrays
+    // are updated incrementally when transactions or splits change.
+    struct Actuals
+    {
+        struct Item
+        {
+            int m_cell;           // row * 12 + column
+            double m_amount;      // in base currency
+            bool m_is_transfer;   // non-split transfer (see getCategoryStats)
+        };
+
+        std::vector<std::size_t> m_key_a;  // a change of the key requires a rebuild
+        std::size_t m_trx_version = 0;
+        std::size_t m_tp_version = 0;
+        mmDate m_start = mmDate::min();
+        mmDate m_end = mmDate::min();
+        std::vector<int64> m_account_id_a; // sorted; empty for all accounts
+        std::vector<mmDate> m_month_a;     // start date of each column
+        std::unordered_map<int64, int> m_catId_i_m;
+        std::vector<double> m_flow_a;
+        std::vector<double> m_transfer_a;
+        std::unordered_map<int64, std::vector<Item>> m_trxId_item_a_m;
+        std::unordered_map<int64, int64> m_tpId_trxId_m;
+    };
+
+    // a few recently used date ranges; the most recent is last
+    static constexpr std::size_t s_actuals_cap = 4;
+    std::vector<Actuals> c_actuals_a;
+    int m_actuals_handle = 0;
+
 // -- constructor
 
 public:
     CategoryModel() :
         TableFactory<CategoryTable, CategoryData>() {}
-    ~CategoryModel() {}
+    ~CategoryModel();
 
 public:
     static CategoryModel& instance(wxSQLite3Database* db);
@@ -52,7 +119,35 @@ public:
 
 // -- methods
 
+private:
+    auto get_tree() -> const Tree&;
+    auto get_id_node_n(int64 cat_id) -> const Node*;
+
+    auto actuals_key() -> std::vector<std::size_t>;
+    auto get_actuals(
+        const mmDate& start, const mmDate& end,
+        const std::vector<int64>& account_id_a
+    ) -> const Actuals&;
+    void build_actuals(Actuals& actuals);
+    void add_actuals_trx(
+        Actuals& actuals,
+        const TrxData& trx_d,
+        const std::vector<TrxSplitData>& tp_a
+    );
+    void remove_actuals_trx(Actuals& actuals, int64 trx_id);
+    void on_actuals_change(const TableChangeM& change_m);
+
 public:
+    void reset_tree() { c_tree.m_is_valid = false; }
+    void reset_actuals() { c_actuals_a.clear(); }
+    auto get_all_id_a() -> const std::vector<int64>& { return get_tree().m_preorder_id_a; }
+
+    auto get_id_depth(int64 cat_id) -> int;
+    auto get_id_parent_id(int64 cat_id) -> int64;
+    auto get_id_child_id_a(int64 cat_id) -> const std::vector<int64>;
+    bool is_id_in_subtree(int64 cat_id, int64 root_id);
+    auto find_id_subtree_a(int64 cat_id) -> const std::vector<int64>;
+
     auto get_data_fullname(const Data* cat_n, wxString delimiter = "") -> const wxString;
     bool get_id_active(int64 cat_id);
     auto get_id_fullname(int64 cat_id, wxString delimiter = "") -> const wxString;
@@ -82,9 +177,8 @@ public:
     {
         bool operator()(const Data& x, const Data& y)
         {
-            wxString x_fullname = CategoryModel::instance().get_data_fullname(&x);
-            wxString y_fullname = CategoryModel::instance().get_data_fullname(&y);
-            return x_fullname < y_fullname;
+            return CategoryModel::instance().get_data_fullname(&x) <
+                CategoryModel::instance().get_data_fullname(&y);
         }
     };
 };
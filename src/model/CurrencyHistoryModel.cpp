@@ -193,3 +193,20 @@ int64 CurrencyHistoryModel::save_record(
     save_data_n(uh_d);
     return uh_d.m_id;
 }
+
+// Queue in work the addition or update of an element in currency history
+bool CurrencyHistoryModel::work_save_record(
+    TableWork& work,
+    int64 currency_id,
+    const mmDate& date,
+    double price,
+    UpdateType update_type
+) {
+    const Data *uh_n = get_key_data_n(currency_id, date);
+    Data uh_d = uh_n ? *uh_n : Data();
+    uh_d.m_currency_id    = currency_id;
+    uh_d.m_date           = date;
+    uh_d.m_base_conv_rate = price;
+    uh_d.m_update_type    = update_type;
+    return work_save(work, uh_d);
+}
@@ -63,4 +63,8 @@ public:
     auto save_record(
         int64 currency_id, const mmDate& date, double price, UpdateType update_type
     ) -> int64;
+    bool work_save_record(
+        TableWork& work,
+        int64 currency_id, const mmDate& date, double price, UpdateType update_type
+    );
 };
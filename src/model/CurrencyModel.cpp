@@ -33,6 +33,7 @@
 #include "PrefModel.h"
 #include "StockModel.h"
 #include "TrxModel.h"
+#include "_ModelAll.h"
 
 constexpr auto LIMIT = 1e-10;
 static wxString s_locale;
@@ -77,6 +78,10 @@ bool CurrencyModel::find_id_isUsed(int64 currency_id, bool ignore_closed)
 
     is_used = is_used || (PrefModel::instance().getBaseCurrencyID() == currency_id);
 
+    ModelAll& all = ModelAll::instance();
+    if (all.has_ref_count())
+        return is_used || all.get_ref_count(ModelAll::e_ref_currency, currency_id).get(ignore_closed) > 0;
+
     is_used = is_used || AccountModel::instance().find_count(
         AccountCol::WHERE_CURRENCYID(OP_EQ, currency_id),
         AccountModel::WHERE_IGNORE_CLOSED(ignore_closed)
@@ -24,6 +24,7 @@
 #include "AttachmentModel.h"
 #include "TrxModel.h"
 #include "SchedModel.h"
+#include "_ModelAll.h"
 
 // -- static
 
@@ -54,6 +55,10 @@ PayeeModel& PayeeModel::instance()
 
 bool PayeeModel::find_id_isUsed(int64 payee_id, bool ignore_deleted)
 {
+    ModelAll& all = ModelAll::instance();
+    if (all.has_ref_count())
+        return all.get_ref_count(ModelAll::e_ref_payee, payee_id).get(ignore_deleted) > 0;
+
     bool is_used = false;
 
     is_used = is_used || TrxModel::instance().find_count(
@@ -134,15 +139,34 @@ const std::map<wxString, int64> PayeeModel::find_all_name_id_m(bool only_active)
 const std::set<int64> PayeeModel::find_used_id_m()
 {
     std::set<int64> used_id_m;
-    for (const auto& trx_d : TrxModel::instance().find_data_a()) {
-        used_id_m.insert(trx_d.m_payee_id_n);
-    }
-    for (const auto& sched_d : SchedModel::instance().find_data_a()) {
-        used_id_m.insert(sched_d.m_payee_id_n);
+    for (const auto& [payee_id, usage_c] : find_usage_c_m()) {
+        used_id_m.insert(payee_id);
     }
     return used_id_m;
 }
 
+// Return the number of transactions and scheduled transactions of each payee.
+// The counts are taken from the usage counters, or aggregated in the database.
+const std::map<int64, std::size_t> PayeeModel::find_usage_c_m()
+{
+    ModelAll& all = ModelAll::instance();
+    if (all.has_ref_count()) {
+        std::map<int64, std::size_t> usage_c_m;
+        for (const auto& [payee_id, count] : all.get_ref_count_m(ModelAll::e_ref_payee))
+            usage_c_m[payee_id] = count.m_all_c;
+        return usage_c_m;
+    }
+
+    std::map<int64, std::size_t> usage_c_m =
+        TrxModel::instance().find_count_mGroup<int64>(TrxCol::NAME_PAYEEID);
+    for (const auto& [payee_id, usage_c] :
+        SchedModel::instance().find_count_mGroup<int64>(SchedCol::NAME_PAYEEID)
+    ) {
+        usage_c_m[payee_id] += usage_c;
+    }
+    return usage_c_m;
+}
+
 const PayeeModel::DataA PayeeModel::find_pattern_data_a(
     const wxString& pattern,
     bool only_active
@@ -191,6 +191,7 @@ void PrefModel::load(bool include_infotable)
     loadTransDateDefault();
     loadSendUsageStats();
     loadCheckNews();
+    loadDbProfile();
 
     loadThemeMode();
     loadHtmlScale();
@@ -661,6 +662,28 @@ void PrefModel::saveCheckNews(const bool value)
     m_check_news = value;
 }
 
+void PrefModel::loadDbProfile()
+{
+    m_db_wal = SettingModel::instance().getBool("DB_WAL", false);
+    m_db_cache_size = std::max(SettingModel::instance().getInt("DB_CACHE_SIZE", 16384), 0);
+    m_db_mmap_size = std::max(SettingModel::instance().getInt("DB_MMAP_SIZE", 256), 0);
+}
+void PrefModel::saveDbWal(const bool value)
+{
+    SettingModel::instance().saveBool("DB_WAL", value);
+    m_db_wal = value;
+}
+void PrefModel::saveDbCacheSize(const int value)
+{
+    SettingModel::instance().saveInt("DB_CACHE_SIZE", value);
+    m_db_cache_size = value;
+}
+void PrefModel::saveDbMmapSize(const int value)
+{
+    SettingModel::instance().saveInt("DB_MMAP_SIZE", value);
+    m_db_mmap_size = value;
+}
+
 void PrefModel::loadThemeMode()
 {
     m_theme_mode = SettingModel::instance().getInt("THEMEMODE", PrefModel::THEME_MODE::AUTO);
@@ -106,6 +106,9 @@ private:
     int m_trans_date_default = 0;                       // TRANSACTION_DATE_DEFAULT
     bool m_send_usage_stats = true;                     // SENDUSAGESTATS
     bool m_check_news = true;                           // CHECKNEWS
+    bool m_db_wal = false;                              // DB_WAL
+    int m_db_cache_size = 16384;                        // DB_CACHE_SIZE
+    int m_db_mmap_size = 256;                           // DB_MMAP_SIZE
     int m_theme_mode = PrefModel::AUTO;                 // THEMEMODE
     int m_html_scale = 100;                             // HTMLSCALE
     int m_icon_size = 16;                               // ICONSIZE
@@ -291,6 +294,16 @@ public:
     void saveCheckNews(const bool value);
     bool getCheckNews() const noexcept;
 
+    // m_db_wal, m_db_cache_size (KiB), m_db_mmap_size (MiB):
+    // connection profile, applied when the database is opened
+    void loadDbProfile();
+    void saveDbWal(const bool value);
+    void saveDbCacheSize(const int value);
+    void saveDbMmapSize(const int value);
+    bool getDbWal() const noexcept;
+    int getDbCacheSize() const noexcept;
+    int getDbMmapSize() const noexcept;
+
     // m_html_scale: scale factor for html font and other objects, in percantage
     void loadHtmlScale();
     void saveHtmlScale(const int value);
@@ -508,6 +521,21 @@ inline bool PrefModel::getCheckNews() const noexcept
     return m_check_news;
 }
 
+inline bool PrefModel::getDbWal() const noexcept
+{
+    return m_db_wal;
+}
+
+inline int PrefModel::getDbCacheSize() const noexcept
+{
+    return m_db_cache_size;
+}
+
+inline int PrefModel::getDbMmapSize() const noexcept
+{
+    return m_db_mmap_size;
+}
+
 inline bool PrefModel::getHideShareAccounts() const noexcept
 {
     return m_hide_share_accounts;
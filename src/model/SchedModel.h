@@ -94,7 +94,7 @@ public:
     {
         bool operator()(const DataExt& x, const DataExt& y)
         {
-            return std::wcscoll(x.ACCOUNTNAME.Lower().wc_str(), y.ACCOUNTNAME.Lower().wc_str()) < 0;
+            return mmSortKey::Less()(x.ACCOUNTNAME, y.ACCOUNTNAME);
         }
     };
 
@@ -102,7 +102,7 @@ public:
     {
         bool operator()(const DataExt& x, const DataExt& y)
         {
-            return std::wcscoll(x.PAYEENAME.Lower().wc_str(), y.PAYEENAME.Lower().wc_str()) < 0;
+            return mmSortKey::Less()(x.PAYEENAME, y.PAYEENAME);
         }
     };
 
@@ -110,7 +110,7 @@ public:
     {
         bool operator()(const DataExt& x, const DataExt& y)
         {
-            return std::wcscoll(x.CATEGNAME.Lower().wc_str(), y.CATEGNAME.Lower().wc_str()) < 0;
+            return mmSortKey::Less()(x.CATEGNAME, y.CATEGNAME);
         }
     };
 
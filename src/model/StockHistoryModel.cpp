@@ -26,6 +26,41 @@ TableClauseV<wxString> StockHistoryModel::WHERE_DATE(OP op, const mmDate& date)
     return StockHistoryCol::WHERE_DATE(op, date.isoDate());
 }
 
+// -- Series
+
+int StockHistoryModel::Series::find_prev_i(int date) const
+{
+    auto it = std::upper_bound(m_date_a.begin(), m_date_a.end(), date);
+    return static_cast<int>(it - m_date_a.begin()) - 1;
+}
+
+std::size_t StockHistoryModel::Series::find_next_i(int date) const
+{
+    auto it = std::lower_bound(m_date_a.begin(), m_date_a.end(), date);
+    return static_cast<std::size_t>(it - m_date_a.begin());
+}
+
+void StockHistoryModel::Series::set(int date, double price)
+{
+    std::size_t i = find_next_i(date);
+    if (i < m_date_a.size() && m_date_a[i] == date) {
+        m_price_a[i] = price;
+    }
+    else {
+        m_date_a.insert(m_date_a.begin() + i, date);
+        m_price_a.insert(m_price_a.begin() + i, price);
+    }
+}
+
+void StockHistoryModel::Series::remove(int date)
+{
+    std::size_t i = find_next_i(date);
+    if (i < m_date_a.size() && m_date_a[i] == date) {
+        m_date_a.erase(m_date_a.begin() + i);
+        m_price_a.erase(m_price_a.begin() + i);
+    }
+}
+
 // -- constructor
 
 // Initialize the global StockHistoryModel table.
@@ -33,6 +68,7 @@ TableClauseV<wxString> StockHistoryModel::WHERE_DATE(OP op, const mmDate& date)
 StockHistoryModel& StockHistoryModel::instance(wxSQLite3Database* db)
 {
     StockHistoryModel& ins = Singleton<StockHistoryModel>::instance();
+    ins.reset_series_all();
     ins.m_db = db;
     ins.ensure_table();
 
@@ -45,6 +81,44 @@ StockHistoryModel& StockHistoryModel::instance()
     return Singleton<StockHistoryModel>::instance();
 }
 
+// -- override
+
+bool StockHistoryModel::purge_id(int64 sh_id)
+{
+    const Data* sh_n = get_idN_data_n(sh_id);
+    if (sh_n) {
+        auto it = c_symbol_series_m.find(sh_n->m_symbol);
+        if (it != c_symbol_series_m.end())
+            it->second.remove(sh_n->m_date.yyyymmdd());
+    }
+
+    return unsafe_remove_id(sh_id);
+}
+
+// Prices changed with raw SQL are not reflected in the series.
+// Inserted prices can be located by id; the symbol of an updated or
+// deleted price is not known anymore, and all series are reset.
+void StockHistoryModel::on_change(const TableChange& change)
+{
+    TableFactory<StockHistoryTable, StockHistoryData>::on_change(change);
+    if (!change.m_is_external)
+        return;
+
+    if (change.m_is_all ||
+        change.has_op(TableChange::e_update) ||
+        change.has_op(TableChange::e_delete)
+    ) {
+        reset_series_all();
+        return;
+    }
+
+    for (const int64& sh_id : change.m_id_s) {
+        const Data* sh_n = get_idN_data_n(sh_id);
+        if (sh_n)
+            reset_symbol_series(sh_n->m_symbol);
+    }
+}
+
 // -- methods
 
 bool StockHistoryModel::purge_symbol_all(const wxString& symbol)
@@ -59,9 +133,45 @@ bool StockHistoryModel::purge_symbol_all(const wxString& symbol)
     }
 
     db_release_savepoint();
+    c_symbol_series_m.erase(symbol);
     return ok;
 }
 
+// Return the price history of symbol.
+// The history is loaded from database on first use, and then it is kept
+// in memory until it is reset.
+const StockHistoryModel::Series& StockHistoryModel::get_symbol_series(const wxString& symbol)
+{
+    auto it = c_symbol_series_m.find(symbol);
+    if (it != c_symbol_series_m.end())
+        return it->second;
+
+    Series& series = c_symbol_series_m[symbol];
+    for (const Data& sh_d : find_data_a(
+        StockHistoryCol::WHERE_SYMBOL(OP_EQ, symbol),
+        TableClause::ORDERBY(StockHistoryCol::NAME_DATE)
+    )) {
+        int date = sh_d.m_date.yyyymmdd();
+        // keep the last record if a date is duplicated
+        if (!series.m_date_a.empty() && series.m_date_a.back() == date) {
+            series.m_price_a.back() = sh_d.m_price;
+            continue;
+        }
+        series.m_date_a.push_back(date);
+        series.m_price_a.push_back(sh_d.m_price);
+    }
+
+    return series;
+}
+
+// Discard the price history of symbol from memory.
+// This must be called after records are added or updated with the generic
+// methods of TableFactory (e.g., add_data_n), instead of save_record().
+void StockHistoryModel::reset_symbol_series(const wxString& symbol)
+{
+    c_symbol_series_m.erase(symbol);
+}
+
 const StockHistoryData* StockHistoryModel::get_key_data_n(
     const wxString& symbol,
     const mmDate& date
@@ -104,6 +214,32 @@ int64 StockHistoryModel::save_record(
         StockModel::instance().update_symbol_current_price(symbol, price);
     }
 
-    save_data_n(sh_d);
+    if (save_data_n(sh_d)) {
+        auto it = c_symbol_series_m.find(symbol);
+        if (it != c_symbol_series_m.end())
+            it->second.set(date.yyyymmdd(), price);
+    }
     return sh_d.m_id;
 }
+
+// Queue in work the addition or update of the price of symbol on date.
+// The current price of the stocks is not updated (see save_record()); the
+// caller shall queue these updates in the same work.
+// The price history of symbol is reset, and it is reloaded on next use.
+bool StockHistoryModel::work_save_record(
+    TableWork& work,
+    const wxString& symbol,
+    const mmDate& date,
+    double price,
+    UpdateType update_type
+) {
+    const Data* sh_n = get_key_data_n(symbol, date);
+    Data sh_d = sh_n ? *sh_n : Data();
+    sh_d.m_symbol      = symbol;
+    sh_d.m_date        = date;
+    sh_d.m_price       = price;
+    sh_d.m_update_type = update_type;
+
+    reset_symbol_series(symbol);
+    return work_save(work, sh_d);
+}
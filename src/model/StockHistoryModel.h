@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include "base/_defs.h"
 #include "base/mmSingleton.h"
 #include "table/_TableFactory.h"
@@ -31,6 +32,30 @@ class StockHistoryModel : public TableFactory<StockHistoryTable, StockHistoryDat
 public:
     static auto WHERE_DATE(OP op, const mmDate& date) -> TableClauseV<wxString>;
 
+// -- state
+
+public:
+    // Price history of one symbol, sorted by date (ascending).
+    // Dates are stored as integers of the form YYYYMMDD (see mmDate::yyyymmdd).
+    struct Series
+    {
+        std::vector<int> m_date_a;
+        std::vector<double> m_price_a;
+
+        bool empty() const { return m_date_a.empty(); }
+        auto size() const -> std::size_t { return m_date_a.size(); }
+        // index of the last price on or before date, or -1 if there is none
+        int  find_prev_i(int date) const;
+        // index of the first price on or after date, or size() if there is none
+        auto find_next_i(int date) const -> std::size_t;
+        void set(int date, double price);
+        void remove(int date);
+    };
+
+private:
+    // loaded on demand for each symbol; kept coherent by the methods of this class
+    std::unordered_map<wxString, Series> c_symbol_series_m;
+
 // -- constructor
 
 public:
@@ -46,18 +71,25 @@ public:
 
 public:
     // override TableFactory
-    virtual bool purge_id(int64 id) override {
-        return unsafe_remove_id(id);
-    }
+    virtual bool purge_id(int64 id) override;
+    virtual void on_change(const TableChange& change) override;
 
 // -- methods
 
 public:
     bool purge_symbol_all(const wxString& symbol);
 
+    auto get_symbol_series(const wxString& symbol) -> const Series&;
+    void reset_symbol_series(const wxString& symbol);
+    void reset_series_all() { c_symbol_series_m.clear(); }
+
     auto get_key_data_n(const wxString& symbol, const mmDate& date) -> const Data*;
 
     auto save_record(
         const wxString& symbol, const mmDate& date, double price, UpdateType update_type
     ) -> int64;
+    bool work_save_record(
+        TableWork& work,
+        const wxString& symbol, const mmDate& date, double price, UpdateType update_type
+    );
 };
@@ -18,6 +18,8 @@
  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ********************************************************/
 
+#include <set>
+
 #include "StockModel.h"
 
 #include "StockHistoryModel.h"
@@ -135,52 +137,29 @@ mmDate StockModel::find_last_hist_date(const Data& stock_d)
 // Return the total stock balance at a given date
 double StockModel::calculate_account_balance(const AccountData& account_d, const mmDate& date)
 {
-    double balance = 0.0;
+    return calculate_account_balance_a(account_d, { date }).front();
+}
+
+// Return the total stock balance at each date in date_a.
+// date_a shall be sorted in ascending order.
+// The price history of each stock is read from the in-memory series of
+// StockHistoryModel, and the number of shares is computed in a single pass
+// over the share transactions of each stock.
+std::vector<double> StockModel::calculate_account_balance_a(
+    const AccountData& account_d,
+    const std::vector<mmDate>& date_a
+) {
+    std::vector<double> balance_a(date_a.size(), 0.0);
 
     for (const Data& stock_d : find_data_a(
         StockCol::WHERE_HELDAT(OP_EQ, account_d.m_id)
     )) {
-        mmDateN prev_date; double prev_price = 0.0;
-        mmDateN next_date; //double next_price = 0.0;
-        for (const StockHistoryData& sh_d : StockHistoryModel::instance().find_data_a(
-            StockCol::WHERE_SYMBOL(OP_EQ, stock_d.m_symbol),
-            TableClause::ORDERBY(StockHistoryCol::NAME_DATE, true)
-        )) {
-            // stop if the exact date is found
-            if (sh_d.m_date == date) {
-                prev_date = sh_d.m_date; prev_price = sh_d.m_price;
-                next_date = sh_d.m_date; //next_price = sh_d.m_price;
-                break;
-            }
-            // stop at the first past date
-            if (sh_d.m_date < date) {
-                prev_date = sh_d.m_date; prev_price = sh_d.m_price;
-                break;
-            }
-            // scan all future dates
-            if (sh_d.m_date > date) {
-                next_date = sh_d.m_date; //next_price = sh_d.m_price;
-            }
-        }
-        // if no previous date is found, fallback to purchase date and price
-        if (!prev_date.has_value() && stock_d.m_purchase_date <= date) {
-            prev_date = stock_d.m_purchase_date;
-            prev_price = stock_d.m_purchase_price;
-        }
-        //  if no next date is found and the account is open, fallback to previous
-        if (!next_date.has_value() && account_d.is_open()) {
-            next_date = prev_date; //next_price = prev_price;
-        }
-        // if previous and next date is still not found, skip this stock
-        if (!prev_date.has_value() || prev_date.value() < stock_d.m_purchase_date ||
-            !next_date.has_value() || next_date.value() < stock_d.m_purchase_date
-        ) {
-            continue;
-        }
-        // take the previous price
-        double price = prev_price;
+        const StockHistoryModel::Series& series =
+            StockHistoryModel::instance().get_symbol_series(stock_d.m_symbol);
+        const int purchase_date = stock_d.m_purchase_date.yyyymmdd();
 
-        double num_shares = 0.0;
+        // (date, number of shares) for each share transaction
+        std::vector<std::pair<int, double>> date_shares_a;
         TrxLinkModel::DataA tl_a = TrxLinkModel::instance().find_ref_data_a(
             s_ref_type, stock_d.m_id
         );
@@ -188,25 +167,67 @@ double StockModel::calculate_account_balance(const AccountData& account_d, const
             const TrxData* trx_n = TrxModel::instance().get_idN_data_n(
                 tl_d.m_trx_id
             );
-            if (trx_n && trx_n->m_id > 0 &&
-                // CHECK: ignore Void transactions
-                !trx_n->is_deleted() &&
-                trx_n->m_date() <= date
+            // CHECK: ignore Void transactions
+            if (!trx_n || trx_n->m_id <= 0 || trx_n->is_deleted())
+                continue;
+            const TrxShareData* ts_n = TrxShareModel::instance().get_trxId_data_n(
+                tl_d.m_trx_id
+            );
+            if (ts_n)
+                date_shares_a.emplace_back(trx_n->m_date().yyyymmdd(), ts_n->m_number);
+        }
+        std::sort(date_shares_a.begin(), date_shares_a.end(),
+            [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+                return a.first < b.first;
+            }
+        );
+
+        std::size_t shares_i = 0;
+        double num_shares = 0.0;
+        for (std::size_t date_i = 0; date_i < date_a.size(); ++date_i) {
+            const int date = date_a[date_i].yyyymmdd();
+
+            while (shares_i < date_shares_a.size() && date_shares_a[shares_i].first <= date)
+                num_shares += date_shares_a[shares_i++].second;
+
+            int prev_i = series.find_prev_i(date);
+            int prev_date = 0; double prev_price = 0.0;
+            if (prev_i >= 0) {
+                prev_date = series.m_date_a[prev_i];
+                prev_price = series.m_price_a[prev_i];
+            }
+            int next_date = 0;
+            std::size_t next_i = (prev_i >= 0 && prev_date == date)
+                ? static_cast<std::size_t>(prev_i)
+                : static_cast<std::size_t>(prev_i + 1);
+            if (next_i < series.size())
+                next_date = series.m_date_a[next_i];
+
+            // if no previous date is found, fallback to purchase date and price
+            if (prev_date == 0 && purchase_date <= date) {
+                prev_date = purchase_date;
+                prev_price = stock_d.m_purchase_price;
+            }
+            //  if no next date is found and the account is open, fallback to previous
+            if (next_date == 0 && account_d.is_open())
+                next_date = prev_date;
+            // if previous and next date is still not found, skip this stock
+            if (prev_date == 0 || prev_date < purchase_date ||
+                next_date == 0 || next_date < purchase_date
             ) {
-                const TrxShareData* ts_n = TrxShareModel::instance().get_trxId_data_n(
-                    tl_d.m_trx_id
-                );
-                if (ts_n)
-                    num_shares += ts_n->m_number;
+                continue;
             }
-        }
-        if (tl_a.empty() && stock_d.m_purchase_date <= date)
-            num_shares = stock_d.m_num_shares;
 
-        balance += num_shares * price;
+            double shares = num_shares;
+            if (tl_a.empty())
+                shares = (purchase_date <= date) ? stock_d.m_num_shares : 0.0;
+
+            // take the previous price
+            balance_a[date_i] += shares * prev_price;
+        }
     }
 
-    return balance;
+    return balance_a;
 }
 
 // Returns the realized gain/loss of the stock due to sold shares.
@@ -364,14 +385,10 @@ void StockModel::update_symbol_current_price(const wxString& symbol, double pric
 {
     double current_price = price;
     if (current_price == -1) {
-        for (const StockHistoryData& sh_d : StockHistoryModel::instance().find_data_a(
-            StockHistoryCol::WHERE_SYMBOL(OP_EQ, symbol),
-            TableClause::ORDERBY(StockHistoryCol::NAME_DATE, true),
-            TableClause::LIMIT(1)
-        )) {
-            current_price = sh_d.m_price;
-            break;
-        }
+        const StockHistoryModel::Series& series =
+            StockHistoryModel::instance().get_symbol_series(symbol);
+        if (!series.empty())
+            current_price = series.m_price_a.back();
     }
     if (current_price == -1)
         return;
@@ -384,6 +401,54 @@ void StockModel::update_symbol_current_price(const wxString& symbol, double pric
     }
 }
 
+// Queue in work the update of the current price of the stocks whose symbol
+// (in upper case) is in symbol_price_m, and of the price history on date.
+// Zero prices are ignored. A line is appended to msg for each updated stock.
+// Return the symbols of the stocks which are not in symbol_price_m.
+std::vector<wxString> StockModel::work_update_symbol_price_m(
+    TableWork& work,
+    const std::map<wxString, double>& symbol_price_m,
+    const mmDate& date,
+    wxString& msg
+) {
+    std::vector<wxString> missing_a;
+    std::set<wxString> history_s;
+    for (Data& stock_d : find_data_a(
+        TableClause::ORDERBY(StockCol::s_primary_name)
+    )) {
+        const wxString symbol = stock_d.m_symbol.Upper();
+        if (symbol.IsEmpty())
+            continue;
+        auto it = symbol_price_m.find(symbol);
+        if (it == symbol_price_m.end()) {
+            if (std::find(missing_a.begin(), missing_a.end(), symbol) == missing_a.end())
+                missing_a.push_back(symbol);
+            continue;
+        }
+
+        double price = it->second;
+        if (price == 0)
+            continue;
+
+        msg += wxString::Format("%s\t: %0.6f -> %0.6f\n",
+            stock_d.m_symbol, stock_d.m_current_price, price
+        );
+        stock_d.m_current_price = price;
+        if (stock_d.m_name.empty())
+            stock_d.m_name = stock_d.m_symbol;
+        work_update(work, stock_d);
+
+        // stocks with the same symbol share the price history
+        if (history_s.insert(stock_d.m_symbol).second) {
+            StockHistoryModel::instance().work_save_record(work,
+                stock_d.m_symbol, date, price, UpdateType(UpdateType::e_online)
+            );
+        }
+    }
+
+    return missing_a;
+}
+
 // stock_entry.m_purchase_price = avg price of shares purchased.
 // stock_entry.m_num_shares = total amount of shares purchased.
 // stock_entry.VALUE     = value of shares based on:
@@ -62,9 +62,19 @@ public:
     auto find_last_hist_date(const Data& stock_d) -> mmDate;
 
     auto calculate_account_balance(const AccountData& account_d, const mmDate& date) -> double;
+    auto calculate_account_balance_a(
+        const AccountData& account_d,
+        const std::vector<mmDate>& date_a
+    ) -> std::vector<double>;
     auto calculate_realized_gain(const Data& stock_d, bool base_curr = false) -> double;
     auto calculate_unrealiazed_gain(const Data& stock_d, bool base_curr = false) -> double;
 
     void update_symbol_current_price(const wxString& symbol, double price = -1);
+    auto work_update_symbol_price_m(
+        TableWork& work,
+        const std::map<wxString, double>& symbol_price_m,
+        const mmDate& date,
+        wxString& msg
+    ) -> std::vector<wxString>;
     void update_data_position(Data* stock_n);
 };
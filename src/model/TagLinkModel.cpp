@@ -160,3 +160,47 @@ int TagLinkModel::update(RefTypeN ref_type, int64 ref_id, const DataA& src_gl_a)
 
     return src_gl_a.size();
 }
+
+// Queue in work the changes which bring the tag links of (ref_type, ref_id)
+// to the tags in src_gl_a; links to tags which are kept are not rewritten.
+// Return true if the set of tags has changed. Unlike update(), the timestamp
+// of the referred transaction is not saved; this is left to the caller.
+bool TagLinkModel::work_update(
+    TableWork& work,
+    RefTypeN ref_type, int64 ref_id,
+    const DataA& src_gl_a
+) {
+    bool changed = false;
+    std::vector<bool> is_kept_a(src_gl_a.size(), false);
+
+    for (const auto& old_gl_d : find_data_a(
+        TagLinkCol::WHERE_REFTYPE(OP_EQ, ref_type.key_n()),
+        TagLinkCol::WHERE_REFID(OP_EQ, ref_id)
+    )) {
+        bool match = false;
+        for (std::size_t i = 0; i < src_gl_a.size(); i++) {
+            match = (src_gl_a[i].m_tag_id == old_gl_d.m_tag_id && !is_kept_a[i]);
+            if (match) {
+                is_kept_a[i] = true;
+                break;
+            }
+        }
+        if (!match) {
+            work_remove(work, old_gl_d.m_id);
+            changed = true;
+        }
+    }
+
+    for (std::size_t i = 0; i < src_gl_a.size(); i++) {
+        if (is_kept_a[i])
+            continue;
+        Data new_gl_d = Data();
+        new_gl_d.m_tag_id   = src_gl_a[i].m_tag_id;
+        new_gl_d.m_ref_type = ref_type;
+        new_gl_d.m_ref_id   = ref_id;
+        work_add(work, new_gl_d);
+        changed = true;
+    }
+
+    return changed;
+}
@@ -51,6 +51,7 @@ public:
     bool purge_ref_all(RefTypeN ref_type, int64 ref_id);
 
     int  update(RefTypeN ref_type, int64 ref_id, const DataA& src_gl_a);
+    bool work_update(TableWork& work, RefTypeN ref_type, int64 ref_id, const DataA& src_gl_a);
 
     auto get_key_data_n(int64 tag_id, RefTypeN ref_type, int64 ref_id) -> const Data*;
     auto find_ref_mTagName(RefTypeN ref_type, int64 ref_id) -> std::map<wxString, int64>;
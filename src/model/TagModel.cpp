@@ -47,6 +47,10 @@ TagModel& TagModel::instance()
 
 bool TagModel::find_id_isUsed(int64 tag_id, bool ignore_deleted)
 {
+    ModelAll& all = ModelAll::instance();
+    if (all.has_ref_count())
+        return all.get_ref_count(ModelAll::e_ref_tag, tag_id).get(ignore_deleted) > 0;
+
     bool is_used = false;
 
     if (!ignore_deleted) {
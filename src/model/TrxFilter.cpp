@@ -51,11 +51,11 @@ void TrxFilter::setDateRange(mmDateN start_date_n, mmDateN end_date_n)
 void TrxFilter::setAccountList(wxSharedPtr<wxArrayString> accountList)
 {
     if (accountList) {
-        m_account_id_a.clear();
+        m_account_id_m.clear();
         for (const auto &entry : *accountList) {
             const auto account = AccountModel::instance().get_name_data_n(entry);
             if (account)
-                m_account_id_a.push_back(account->m_id);
+                m_account_id_m.insert(account->m_id);
         }
         m_filter_account = true;
     }
@@ -64,13 +64,34 @@ void TrxFilter::setAccountList(wxSharedPtr<wxArrayString> accountList)
 void TrxFilter::setPayeeList(const wxArrayInt64& payeeList)
 {
     m_filter_payee = true;
-    m_payee_id_a = payeeList;
+    m_payee_id_m = std::unordered_set<int64>(payeeList.begin(), payeeList.end());
 }
 
 void TrxFilter::setCategoryList(const wxArrayInt64 &categoryList)
 {
     m_filter_category = true;
-    m_category_id_a = categoryList;
+    m_category_id_m = std::unordered_set<int64>(categoryList.begin(), categoryList.end());
+    m_category_root_id_a.clear();
+}
+
+// Match cat_id and all its sub-categories.
+void TrxFilter::setCategorySubtree(int64 cat_id)
+{
+    m_filter_category = true;
+    m_category_id_m.clear();
+    m_category_root_id_a.clear();
+    m_category_root_id_a.push_back(cat_id);
+}
+
+bool TrxFilter::checkCategoryId(int64 cat_id)
+{
+    if (m_category_id_m.count(cat_id) > 0)
+        return true;
+    for (auto root_id : m_category_root_id_a) {
+        if (CategoryModel::instance().is_id_in_subtree(cat_id, root_id))
+            return true;
+    }
+    return false;
 }
 
 template<class MODEL, class DATA>
@@ -79,19 +100,12 @@ bool TrxFilter::checkCategory(
     const std::map<int64, typename MODEL::SplitDataA>& id_splitA_m
 ) {
     const auto id_splitA = id_splitA_m.find(d.m_id);
-    if (id_splitA == id_splitA_m.end()) {
-        for (auto it2 : m_category_id_a) {
-            if (it2 == d.m_category_id_n)
-                return true;
-        }
-    }
-    else {
-        for (const auto& split_d : id_splitA->second) {
-            for (auto it2 : m_category_id_a) {
-                if (it2 == split_d.m_category_id)
-                    return true;
-            }
-        }
+    if (id_splitA == id_splitA_m.end())
+        return checkCategoryId(d.m_category_id_n);
+
+    for (const auto& split_d : id_splitA->second) {
+        if (checkCategoryId(split_d.m_category_id))
+            return true;
     }
     return false;
 }
@@ -103,20 +117,17 @@ bool TrxFilter::mmIsRecordMatches(
     bool ok = true;
     // note: date comparisons have granularity of a day
     mmDate trx_date = trx_d.m_date();
-    if (m_filter_account && (std::find(m_account_id_a.begin(), m_account_id_a.end(),
-        trx_d.m_account_id
-    ) == m_account_id_a.end()) && (std::find(m_account_id_a.begin(), m_account_id_a.end(),
-        trx_d.m_to_account_id_n
-    ) == m_account_id_a.end()))
+    if (m_filter_account &&
+        m_account_id_m.count(trx_d.m_account_id) == 0 &&
+        m_account_id_m.count(trx_d.m_to_account_id_n) == 0
+    )
         ok = false;
     else if (m_filter_date && (
         (m_start_date_n.has_value() && trx_date < m_start_date_n.value()) ||
         (m_end_date_n.has_value() && trx_date > m_end_date_n.value())
     ))
         ok = false;
-    else if (m_filter_payee && (std::find(m_payee_id_a.begin(), m_payee_id_a.end(),
-        trx_d.m_payee_id_n
-    ) == m_payee_id_a.end()))
+    else if (m_filter_payee && m_payee_id_m.count(trx_d.m_payee_id_n) == 0)
         ok = false;
     else if (m_filter_category && !checkCategory<TrxModel>(trx_d, split))
         ok = false;
@@ -143,16 +154,8 @@ wxString TrxFilter::getHTML()
         if (full_tran.has_split()) {
             bool found = true;
             for (const auto& tp_d : full_tran.m_tp_a) {
-                if (m_filter_category) {
-                    found = false;
-
-                    for (const auto& it : m_category_id_a) {
-                        if (it == tp_d.m_category_id) {
-                            found = true;
-                            break;
-                        }
-                    }
-                }
+                if (m_filter_category)
+                    found = checkCategoryId(tp_d.m_category_id);
 
                 if (found) {
                     full_tran.CATEGNAME = CategoryModel::instance().get_id_fullname(tp_d.m_category_id);
@@ -18,6 +18,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #pragma once
 
+#include <unordered_set>
 #include "util/mmDateRange2.h"
 #include "_all.h"
 
@@ -31,9 +32,10 @@ private:
     bool m_filter_payee;
     bool m_filter_category;
     mmDateN m_start_date_n, m_end_date_n;
-    wxArrayInt64 m_account_id_a;
-    wxArrayInt64 m_payee_id_a;
-    wxArrayInt64 m_category_id_a;
+    std::unordered_set<int64> m_account_id_m;
+    std::unordered_set<int64> m_payee_id_m;
+    std::unordered_set<int64> m_category_id_m;
+    wxArrayInt64 m_category_root_id_a;  // match the whole subtree
     TrxModel::DataExtA m_trx_xa;
 
 // -- constructor
@@ -50,8 +52,10 @@ public:
     void setAccountList(wxSharedPtr<wxArrayString> accountList);
     void setPayeeList(const wxArrayInt64& payeeList);
     void setCategoryList(const wxArrayInt64 &categoryList);
+    void setCategorySubtree(int64 cat_id);
 
     // Apply Filter methods
+    bool checkCategoryId(int64 cat_id);
     template<class MODEL, class DATA = typename MODEL::Data>
     bool checkCategory(
         const DATA& d,
@@ -125,6 +125,63 @@ bool TrxModel::is_foreignAsTransfer(const Data& this_d)
     );
 }
 
+// -- NoteScope
+
+bool TrxModel::NoteScope::RankLess::operator()(const Rank& x, const Rank& y) const
+{
+    if (std::get<0>(x) != std::get<0>(y))
+        return std::get<0>(x) > std::get<0>(y);
+    if (std::get<1>(x) != std::get<1>(y))
+        return std::get<1>(x) > std::get<1>(y);
+    return std::get<2>(x) < std::get<2>(y);
+}
+
+auto TrxModel::NoteScope::get_rank(
+    const wxString& note,
+    const std::multiset<wxString>& date_s
+) const -> Rank {
+    return Rank(date_s.size(), *date_s.rbegin(), note);
+}
+
+void TrxModel::NoteScope::add(const wxString& note, const wxString& date)
+{
+    std::multiset<wxString>& date_s = m_note_dateS_m[note];
+    if (!date_s.empty())
+        m_rank_s.erase(get_rank(note, date_s));
+    date_s.insert(date);
+    m_rank_s.insert(get_rank(note, date_s));
+}
+
+void TrxModel::NoteScope::remove(const wxString& note, const wxString& date)
+{
+    auto it = m_note_dateS_m.find(note);
+    if (it == m_note_dateS_m.end())
+        return;
+
+    std::multiset<wxString>& date_s = it->second;
+    auto date_it = date_s.find(date);
+    if (date_it == date_s.end())
+        return;
+
+    m_rank_s.erase(get_rank(note, date_s));
+    date_s.erase(date_it);
+    if (date_s.empty())
+        m_note_dateS_m.erase(it);
+    else
+        m_rank_s.insert(get_rank(note, date_s));
+}
+
+auto TrxModel::NoteScope::find_top_a(std::size_t max) const -> std::vector<wxString>
+{
+    std::vector<wxString> note_a;
+    for (const Rank& rank : m_rank_s) {
+        if (note_a.size() >= max)
+            break;
+        note_a.push_back(std::get<2>(rank));
+    }
+    return note_a;
+}
+
 // -- constructor
 
 // Initialize the global TrxModel table.
@@ -133,6 +190,7 @@ TrxModel& TrxModel::instance(wxSQLite3Database* db)
 {
     TrxModel& ins = Singleton<TrxModel>::instance();
     ins.reset_cache();
+    ins.c_note_is_valid = false;
     ins.m_db = db;
     ins.ensure_table();
 
@@ -182,6 +240,27 @@ bool TrxModel::purge_id(int64 trx_id)
     return ok;
 }
 
+// Update the note index with the changed transactions, after the cache has
+// been updated.
+void TrxModel::on_change(const TableChange& change)
+{
+    TableFactory<TrxTable, TrxData>::on_change(change);
+    if (!c_note_is_valid)
+        return;
+
+    if (change.m_is_all) {
+        c_note_is_valid = false;
+        return;
+    }
+
+    for (const int64& trx_id : change.m_id_s)
+        note_set(trx_id);
+
+    // changes of an open transaction are not included; reload on next use
+    if (!TableChangeBus::instance().has_pending())
+        c_note_version = data_version();
+}
+
 // -- methods
 
 void TrxModel::save_timestamp(int64 trx_id)
@@ -225,6 +304,9 @@ bool TrxModel::save_trx_a(DataA& trx_a)
 {
     bool ok = true;
 
+    IdReserve id_reserve(*this, std::count_if(trx_a.begin(), trx_a.end(),
+        [](const Data& trx_d) { return trx_d.m_id <= 0; }
+    ));
     db_savepoint();
     for (auto& trx_d : trx_a) {
         if (trx_d.m_id < 0)
@@ -239,6 +321,22 @@ bool TrxModel::save_trx_a(DataA& trx_a)
     return ok;
 }
 
+// Queue in work the addition or update of trx_d.
+// trx_d shall not point into cache; the timestamp is updated if trx_d differs
+// from the record in cache (the database is not queried, as in update_timestamp()).
+bool TrxModel::work_save_trx(TableWork& work, Data& trx_d)
+{
+    const Data* old_trx_n = (trx_d.m_id > 0) ? get_idN_data_n(trx_d.m_id) : nullptr;
+    bool skip = old_trx_n && (
+        old_trx_n->equals(&trx_d) ||
+        old_trx_n->is_deleted() || trx_d.is_deleted()
+    );
+    if (!skip)
+        trx_d.m_updated_utc_n = mmDateTime::now().fromLocalToUtc();
+
+    return work_save(work, trx_d);
+}
+
 // This function is called by find_id_isUsed(), in the slow branch
 // (when ignore_deleted is true), to check if a trx_id is not deleted.
 std::size_t TrxModel::find_id_count(int64 trx_id, bool ignore_deleted)
@@ -275,56 +373,90 @@ const TrxModel::DataA TrxModel::find_all_aDateTimeId()
     return trx_a;
 }
 
-bool CompareUsedNotes(
-    const std::tuple<int, wxString, wxString>& a,
-    const std::tuple<int, wxString, wxString>& b
-) {
-    if (std::get<0>(a) < std::get<0>(b)) return true;
-    if (std::get<0>(b) < std::get<0>(a)) return false;
+void TrxModel::getFrequentUsedNotes(std::vector<wxString>& frequentNotes, int64 account_id)
+{
+    frequentNotes = find_frequent_note_a(account_id);
+}
+
+// Return up to max notes of the transactions in account_id (or in all
+// accounts, if account_id is -1), ranked by frequency, then by last date.
+// The note index is loaded on first use; afterwards, it is updated with the
+// changes of each transaction, and this function does not scan the table.
+std::vector<wxString> TrxModel::find_frequent_note_a(int64 account_id, std::size_t max)
+{
+    // apply committed changes which have not been delivered to this model
+    if (c_note_is_valid && c_note_version != data_version())
+        TableChangeBus::instance().deliver(m_change_handle);
+
+    if (!c_note_is_valid || c_note_version != data_version())
+        note_load();
 
-    // a=b for primary condition, go to secondary (but reverse order)
-    if (std::get<1>(a) > std::get<1>(b)) return true;
-    if (std::get<1>(b) > std::get<1>(a)) return false;
+    if (account_id <= 0)
+        return c_note_all.find_top_a(max);
 
-    return false;
+    auto it = c_accountId_note_m.find(account_id);
+    if (it == c_accountId_note_m.end())
+        return {};
+    return it->second.find_top_a(max);
 }
 
-void TrxModel::getFrequentUsedNotes(std::vector<wxString>& frequentNotes, int64 account_id)
+void TrxModel::note_load()
 {
-    frequentNotes.clear();
-    size_t max = 20;
-
-    const auto trx_a = instance().find_data_a(
-        TrxCol::WHERE_NOTES(OP_NEN, ""),
-        account_id > 0
-            ? TrxCol::WHERE_ACCOUNTID(OP_EQ, account_id)
-            : TrxCol::WHERE_ACCOUNTID(OP_NE, -1)
-    );
+    c_trxId_note_m.clear();
+    c_note_all = NoteScope();
+    c_accountId_note_m.clear();
 
-    // Count frequency
-    std::map<wxString, std::pair<int, wxString>> counterMap;
-    for (const auto& trx_d : trx_a) {
-        wxString trx_date = trx_d.m_isoDate();
-        auto& counter = counterMap[trx_d.m_notes];
-        counter.first--;
-        if (trx_date > counter.second)
-            counter.second = trx_date;
+    for (const Data& trx_d : find_data_a(
+        TrxCol::WHERE_NOTES(OP_NEN, "")
+    )) {
+        NoteRef ref = { trx_d.m_account_id, trx_d.m_notes, trx_d.m_isoDate() };
+        c_note_all.add(ref.m_note, ref.m_date);
+        c_accountId_note_m[ref.m_account_id].add(ref.m_note, ref.m_date);
+        c_trxId_note_m.emplace(trx_d.m_id, std::move(ref));
     }
 
-    // Convert to vector
-    std::vector<std::tuple<int, wxString, wxString>> vec;
-    for (const auto& [note, counter] : counterMap)
-        vec.emplace_back(counter.first, counter.second, note);
+    c_note_version = data_version();
+    c_note_is_valid = true;
+}
 
-    // Sort by frequency then date
-    std::sort(vec.begin(), vec.end(), CompareUsedNotes);
+// Update the note of trx_id from the cache (or the database).
+void TrxModel::note_set(int64 trx_id)
+{
+    const Data* trx_n = get_idN_data_n(trx_id);
+    if (!trx_n || trx_n->m_notes.empty()) {
+        note_remove(trx_id);
+        return;
+    }
 
-    // Pull out top 20 (max)
-    for (const auto& kv : vec) {
-        if (0 == max--)
-            break;
-        frequentNotes.push_back(std::get<2>(kv));
+    NoteRef ref = { trx_n->m_account_id, trx_n->m_notes, trx_n->m_isoDate() };
+    auto it = c_trxId_note_m.find(trx_id);
+    if (it != c_trxId_note_m.end()) {
+        const NoteRef& old_ref = it->second;
+        if (old_ref.m_account_id == ref.m_account_id &&
+            old_ref.m_note == ref.m_note &&
+            old_ref.m_date == ref.m_date
+        )
+            return;
+        note_remove(trx_id);
     }
+
+    c_note_all.add(ref.m_note, ref.m_date);
+    c_accountId_note_m[ref.m_account_id].add(ref.m_note, ref.m_date);
+    c_trxId_note_m.emplace(trx_id, std::move(ref));
+}
+
+void TrxModel::note_remove(int64 trx_id)
+{
+    auto it = c_trxId_note_m.find(trx_id);
+    if (it == c_trxId_note_m.end())
+        return;
+
+    const NoteRef& ref = it->second;
+    c_note_all.remove(ref.m_note, ref.m_date);
+    auto scope_it = c_accountId_note_m.find(ref.m_account_id);
+    if (scope_it != c_accountId_note_m.end())
+        scope_it->second.remove(ref.m_note, ref.m_date);
+    c_trxId_note_m.erase(it);
 }
 
 void TrxModel::setEmptyData(Data& dst_trx_d, int64 account_id)
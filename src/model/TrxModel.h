@@ -19,10 +19,13 @@
 
 #pragma once
 
+#include <set>
+#include <unordered_map>
 #include "base/_defs.h"
 #include "base/mmSingleton.h"
 #include "table/_TableFactory.h"
 #include "data/TrxData.h"
+#include "util/mmSortKey.h"
 // cannot include "util/util.h"
 
 #include "TrxSplitModel.h"
@@ -108,6 +111,49 @@ public:
     static bool is_foreign(const Data& this_d);
     static bool is_foreignAsTransfer(const Data& this_d);
 
+// -- state
+
+public:
+    // Usage of the notes of transactions in one scope (one account, or all
+    // accounts). The ranking is kept up to date, such that the most frequent
+    // notes are read without a scan.
+    struct NoteScope
+    {
+        // (count, last date, note)
+        using Rank = std::tuple<std::size_t, wxString, wxString>;
+        // count (descending), then last date (descending), then note
+        struct RankLess
+        {
+            bool operator()(const Rank& x, const Rank& y) const;
+        };
+
+        // isoDate of each transaction with the note
+        std::unordered_map<wxString, std::multiset<wxString>> m_note_dateS_m;
+        std::set<Rank, RankLess> m_rank_s;
+
+        void add(const wxString& note, const wxString& date);
+        void remove(const wxString& note, const wxString& date);
+        auto find_top_a(std::size_t max) const -> std::vector<wxString>;
+
+    private:
+        auto get_rank(const wxString& note, const std::multiset<wxString>& date_s) const -> Rank;
+    };
+
+private:
+    struct NoteRef
+    {
+        int64    m_account_id;
+        wxString m_note;
+        wxString m_date;
+    };
+
+    // loaded on first use; kept coherent by on_change()
+    bool c_note_is_valid = false;
+    std::size_t c_note_version = 0;
+    std::unordered_map<int64, NoteRef> c_trxId_note_m;
+    NoteScope c_note_all;
+    std::unordered_map<int64, NoteScope> c_accountId_note_m;
+
 // -- constructor
 
 public:
@@ -124,6 +170,7 @@ public:
 public:
     // override TableFactory
     virtual bool purge_id(int64 id) override;
+    virtual void on_change(const TableChange& change) override;
 
 // -- methods
 
@@ -133,6 +180,7 @@ public:
     auto unsafe_save_trx_n(Data* trx_n) -> const Data*;
     auto save_trx_n(Data& trx_d) -> const Data*;
     bool save_trx_a(DataA& trx_a);
+    bool work_save_trx(TableWork& work, Data& trx_d);
 
     auto find_id_count(int64 trx_id, bool ignore_deleted = false) -> std::size_t;
     auto find_id_tp_a(int64 trx_id) -> const TrxSplitModel::DataA;
@@ -140,9 +188,15 @@ public:
     auto find_all_aDateTimeId() -> const TrxModel::DataA;
 
     void getFrequentUsedNotes(std::vector<wxString> &frequentNotes, int64 accountID = -1);
+    auto find_frequent_note_a(int64 account_id = -1, std::size_t max = 20) -> std::vector<wxString>;
     void setEmptyData(Data& trx_d, int64 account_id);
     bool is_locked(const Data& trx_d);
 
+private:
+    void note_load();
+    void note_set(int64 trx_id);
+    void note_remove(int64 trx_id);
+
 // -- sorter
 
 public:
@@ -150,7 +204,7 @@ public:
     {
         bool operator()(const DataExt& x, const DataExt& y)
         {
-            return std::wcscoll(x.ACCOUNTNAME.Lower().wc_str(), y.ACCOUNTNAME.Lower().wc_str()) < 0;
+            return mmSortKey::Less()(x.ACCOUNTNAME, y.ACCOUNTNAME);
         }
     };
 
@@ -158,7 +212,7 @@ public:
     {
         bool operator()(const DataExt& x, const DataExt& y)
         {
-            return std::wcscoll(x.TOACCOUNTNAME.Lower().wc_str(), y.TOACCOUNTNAME.Lower().wc_str()) < 0;
+            return mmSortKey::Less()(x.TOACCOUNTNAME, y.TOACCOUNTNAME);
         }
     };
 
@@ -166,7 +220,7 @@ public:
     {
         bool operator()(const DataExt& x, const DataExt& y)
         {
-            return std::wcscoll(x.PAYEENAME.Lower().wc_str(), y.PAYEENAME.Lower().wc_str()) < 0;
+            return mmSortKey::Less()(x.PAYEENAME, y.PAYEENAME);
         }
     };
 
@@ -174,7 +228,7 @@ public:
     {
         bool operator()(const DataExt& x, const DataExt& y)
         {
-            return std::wcscoll(x.CATEGNAME.Lower().wc_str(), y.CATEGNAME.Lower().wc_str()) < 0;
+            return mmSortKey::Less()(x.CATEGNAME, y.CATEGNAME);
         }
     };
 
@@ -193,6 +193,60 @@ int TrxSplitModel::update_trx(int64 trx_id, DataA& src_tp_a)
     return src_tp_a.size();
 }
 
+// Queue in work the replacement of the splits of trx_id with src_tp_a, as in
+// update_trx(). The new splits get their id in src_tp_a.
+// Return true if the splits are changed; in that case the caller shall update
+// the timestamp of the transaction.
+bool TrxSplitModel::work_update_trx(TableWork& work, int64 trx_id, DataA& src_tp_a)
+{
+    DataA old_tp_a = find_data_a(
+        TrxSplitCol::WHERE_TRANSID(OP_EQ, trx_id)
+    );
+    bool changed = (old_tp_a.size() != src_tp_a.size());
+    std::vector<bool> is_matched_a(src_tp_a.size(), false);
+
+    for (const auto& old_tp_d : old_tp_a) {
+        if (!changed) {
+            bool match = false;
+            for (std::size_t i = 0; i < src_tp_a.size(); ++i) {
+                if (is_matched_a[i])
+                    continue;
+                match = (
+                    src_tp_a[i].m_category_id == old_tp_d.m_category_id &&
+                    src_tp_a[i].m_amount == old_tp_d.m_amount &&
+                    src_tp_a[i].m_notes.IsSameAs(old_tp_d.m_notes)
+                );
+                if (match) {
+                    is_matched_a[i] = true;
+                    break;
+                }
+            }
+            changed = !match;
+        }
+
+        // same as purge_id()
+        for (int64 gl_id : TagLinkModel::instance().find_id_a(
+            TagLinkCol::WHERE_REFTYPE(OP_EQ, s_ref_type.key_n()),
+            TagLinkCol::WHERE_REFID(OP_EQ, old_tp_d.m_id)
+        )) {
+            TagLinkModel::instance().work_remove(work, gl_id);
+        }
+        work_remove(work, old_tp_d.m_id);
+    }
+
+    for (auto& src_tp_d : src_tp_a) {
+        Data new_tp_d = Data();
+        new_tp_d.m_trx_id      = trx_id;
+        new_tp_d.m_amount      = src_tp_d.m_amount;
+        new_tp_d.m_category_id = src_tp_d.m_category_id;
+        new_tp_d.m_notes       = src_tp_d.m_notes;
+        work_add(work, new_tp_d);
+        src_tp_d.m_id = new_tp_d.m_id;
+    }
+
+    return changed;
+}
+
 int TrxSplitModel::update_trx(int64 trx_id, const std::vector<Split>& split_a)
 {
     DataA tp_a;
@@ -77,4 +77,5 @@ public:
 
     int  update_trx(int64 trx_id, DataA& src_tp_a);
     int  update_trx(int64 trx_id, const std::vector<Split>& split_a);
+    bool work_update_trx(TableWork& work, int64 trx_id, DataA& src_tp_a);
 };
@@ -74,6 +74,21 @@ void UsageModel::append_cache(const wxString& json_string)
     m_json_cache.Add(json_string);
 }
 
+// Appends the duration of a startup phase (in milliseconds) to phase array
+void UsageModel::append_phase(const wxString& name, long msec)
+{
+    wxLogDebug("UsageModel::append_phase: %s %ld ms", name, msec);
+    StringBuffer json_buffer;
+    Writer<StringBuffer> json_writer(json_buffer);
+    json_writer.StartObject();
+    json_writer.Key("name");
+    json_writer.String(name.utf8_str());
+    json_writer.Key("msec");
+    json_writer.Int64(msec);
+    json_writer.EndObject();
+    m_json_phase.Add(wxString::FromUTF8(json_buffer.GetString()));
+}
+
 // Return a json string
 const wxString UsageModel::to_json() const
 {
@@ -105,6 +120,15 @@ const wxString UsageModel::to_json() const
         }
         json_writer.EndArray();
     }
+    json_writer.Key("phase");
+    {
+        json_writer.StartArray();
+        for (size_t i = 0; i < m_json_phase.GetCount(); i++) {
+            const char* item = m_json_phase.Item(i).utf8_str();
+            json_writer.RawValue(item, strlen(item), kObjectType);
+        }
+        json_writer.EndArray();
+    }
     json_writer.EndObject();
     return wxString::FromUTF8(json_buffer.GetString());
 }
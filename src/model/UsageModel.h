@@ -33,7 +33,7 @@ class UsageModel : public TableFactory<UsageTable, UsageData>
 
 private:
     wxDateTime m_start;
-    wxArrayString m_json_usage, m_json_cache;
+    wxArrayString m_json_usage, m_json_cache, m_json_phase;
 
 // -- constructor
 
@@ -59,6 +59,7 @@ public:
 public:
     void append_usage(const wxString& json_string);
     void append_cache(const wxString& json_string);
+    void append_phase(const wxString& name, long msec);
     auto to_json() const -> const wxString;
 
     void pageview(const wxString& documentPath, const wxString& documentTitle, long plt = 0 /*msec*/);
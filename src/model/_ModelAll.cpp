@@ -18,8 +18,21 @@
 
 #include "_ModelAll.h"
 
+#include "AccountModel.h"
+#include "AssetModel.h"
+#include "BudgetModel.h"
+#include "CategoryModel.h"
+#include "InfoModel.h"
+#include "PayeeModel.h"
+#include "ReportModel.h"
+#include "SchedModel.h"
+#include "SchedSplitModel.h"
+#include "SettingModel.h"
+#include "StockModel.h"
+#include "TagLinkModel.h"
 #include "TrxModel.h"
 #include "TrxSplitModel.h"
+#include "UsageModel.h"
 
 // -- constructor
 
@@ -27,6 +40,7 @@ ModelAll& ModelAll::instance(wxSQLite3Database* db)
 {
     ModelAll& ins = Singleton<ModelAll>::instance();
     ins.m_db = db;
+    ins.m_ref_is_valid = false;
 
     return ins;
 }
@@ -52,3 +66,426 @@ std::size_t ModelAll::find_ref_count(RefTypeN ref_type, int64 ref_id, bool ignor
         return 1;
     }
 }
+
+// Return true if the usage counters are up to date with the database, after
+// they are loaded (on first use) and the committed changes are applied.
+// Return false while a write transaction is open; the caller shall query the
+// database instead.
+bool ModelAll::has_ref_count()
+{
+    TableChangeBus& bus = TableChangeBus::instance();
+    if (bus.has_pending())
+        return false;
+
+    if (m_ref_handle == 0) {
+        m_ref_handle = bus.subscribe(
+            [this](const TableChangeM& change_m) { ref_on_change(change_m); }
+        );
+    }
+
+    // apply committed changes which have not been delivered to the counters;
+    // the other subscribers are not called
+    bus.deliver(m_ref_handle);
+
+    if (!m_ref_is_valid)
+        ref_load();
+    return true;
+}
+
+// has_ref_count() shall return true before this function is called.
+ModelAll::RefCount ModelAll::get_ref_count(REF ref, int64 id)
+{
+    auto it = m_ref_count_m[ref].find(id);
+    return (it != m_ref_count_m[ref].end()) ? it->second : RefCount();
+}
+
+// Return the counters of all ids of ref which are used.
+// has_ref_count() shall return true before this function is called.
+const ModelAll::RefCountM& ModelAll::get_ref_count_m(REF ref)
+{
+    return m_ref_count_m[ref];
+}
+
+// Reload the usage counters from the database, and return the number of
+// counters which were different.
+std::size_t ModelAll::rebuild_ref_count()
+{
+    if (!has_ref_count())
+        return 0;
+
+    std::vector<RefCountM> old_count_a(m_ref_count_m, m_ref_count_m + e_ref_size);
+    ref_load();
+
+    std::size_t diff_c = 0;
+    for (int ref = 0; ref < e_ref_size; ++ref) {
+        const RefCountM& old_count_m = old_count_a[ref];
+        const RefCountM& new_count_m = m_ref_count_m[ref];
+        for (const auto& [id, count] : new_count_m) {
+            auto it = old_count_m.find(id);
+            if (it == old_count_m.end() || !(it->second == count))
+                ++diff_c;
+        }
+        for (const auto& [id, count] : old_count_m) {
+            if (new_count_m.find(id) == new_count_m.end())
+                ++diff_c;
+        }
+    }
+
+    if (diff_c > 0)
+        wxLogDebug("ModelAll::rebuild_ref_count: %d counters were different", static_cast<int>(diff_c));
+    return diff_c;
+}
+
+// Return true if change_m changes the data shown in the home page and the
+// reports. The settings, the usage log and the report definitions are written
+// while pages are shown (e.g., when a section is collapsed); they are ignored.
+bool ModelAll::has_data_change(const TableChangeM& change_m)
+{
+    for (const auto& [table_name, change] : change_m) {
+        if (table_name != InfoModel::instance().table_name() &&
+            table_name != SettingModel::instance().table_name() &&
+            table_name != UsageModel::instance().table_name() &&
+            table_name != ReportModel::instance().table_name()
+        )
+            return true;
+    }
+    return false;
+}
+
+const wxString& ModelAll::get_src_table_name(SRC src)
+{
+    switch (src) {
+    case e_src_trx:         return TrxModel::instance().table_name();
+    case e_src_trx_split:   return TrxSplitModel::instance().table_name();
+    case e_src_sched:       return SchedModel::instance().table_name();
+    case e_src_sched_split: return SchedSplitModel::instance().table_name();
+    case e_src_payee:       return PayeeModel::instance().table_name();
+    case e_src_budget:      return BudgetModel::instance().table_name();
+    case e_src_category:    return CategoryModel::instance().table_name();
+    case e_src_tag_link:    return TagLinkModel::instance().table_name();
+    case e_src_stock:       return StockModel::instance().table_name();
+    case e_src_account:     return AccountModel::instance().table_name();
+    default:                return AssetModel::instance().table_name();
+    }
+}
+
+// Scan the referring tables once. Transactions and transaction splits are
+// loaded before the records which depend on their active state.
+void ModelAll::ref_load()
+{
+    for (auto& count_m : m_ref_count_m)
+        count_m.clear();
+    for (auto& source_m : m_src_source_m)
+        source_m.clear();
+
+    for (const auto& trx_d : TrxModel::instance().find_data_a()) {
+        Source source = get_source(trx_d);
+        ref_set(e_src_trx, trx_d.m_id, &source);
+    }
+    for (const auto& tp_d : TrxSplitModel::instance().find_data_a()) {
+        Source source = get_source(tp_d);
+        ref_set(e_src_trx_split, tp_d.m_id, &source);
+    }
+    for (const auto& sched_d : SchedModel::instance().find_data_a()) {
+        Source source = get_source(sched_d);
+        ref_set(e_src_sched, sched_d.m_id, &source);
+    }
+    for (const auto& qp_d : SchedSplitModel::instance().find_data_a()) {
+        Source source = get_source(qp_d);
+        ref_set(e_src_sched_split, qp_d.m_id, &source);
+    }
+    for (const auto& payee_d : PayeeModel::instance().find_data_a()) {
+        Source source = get_source(payee_d);
+        ref_set(e_src_payee, payee_d.m_id, &source);
+    }
+    for (const auto& budget_d : BudgetModel::instance().find_data_a()) {
+        Source source = get_source(budget_d);
+        ref_set(e_src_budget, budget_d.m_id, &source);
+    }
+    for (const auto& cat_d : CategoryModel::instance().find_data_a()) {
+        Source source = get_source(cat_d);
+        ref_set(e_src_category, cat_d.m_id, &source);
+    }
+    for (const auto& gl_d : TagLinkModel::instance().find_data_a()) {
+        Source source = get_source(gl_d);
+        ref_set(e_src_tag_link, gl_d.m_id, &source);
+    }
+    for (const auto& stock_d : StockModel::instance().find_data_a()) {
+        Source source = get_source(stock_d);
+        ref_set(e_src_stock, stock_d.m_id, &source);
+    }
+    for (const auto& account_d : AccountModel::instance().find_data_a()) {
+        Source source = get_source(account_d);
+        ref_set(e_src_account, account_d.m_id, &source);
+    }
+    for (const auto& asset_d : AssetModel::instance().find_data_a()) {
+        Source source = get_source(asset_d);
+        ref_set(e_src_asset, asset_d.m_id, &source);
+    }
+
+    m_ref_is_valid = true;
+}
+
+// Update the references of the changed records. If the active state of a
+// transaction (or transaction split) has changed, the records which depend
+// on it are also updated.
+void ModelAll::ref_on_change(const TableChangeM& change_m)
+{
+    if (!m_ref_is_valid)
+        return;
+
+    for (int src = 0; src < e_src_size; ++src) {
+        auto it = change_m.find(get_src_table_name(static_cast<SRC>(src)));
+        if (it == change_m.end())
+            continue;
+        const TableChange& change = it->second;
+        if (change.m_is_all) {
+            m_ref_is_valid = false;
+            return;
+        }
+        for (const int64& id : change.m_id_s)
+            ref_update(static_cast<SRC>(src), id);
+    }
+}
+
+void ModelAll::ref_update(SRC src, int64 id)
+{
+    bool was_active = is_active(src, id);
+    Source source;
+    bool is_found = false;
+
+    switch (src) {
+    case e_src_trx:
+        if (const TrxData* trx_n = TrxModel::instance().get_idN_data_n(id)) {
+            source = get_source(*trx_n); is_found = true;
+        }
+        break;
+    case e_src_trx_split:
+        if (const TrxSplitData* tp_n = TrxSplitModel::instance().get_idN_data_n(id)) {
+            source = get_source(*tp_n); is_found = true;
+        }
+        break;
+    case e_src_sched:
+        if (const SchedData* sched_n = SchedModel::instance().get_idN_data_n(id)) {
+            source = get_source(*sched_n); is_found = true;
+        }
+        break;
+    case e_src_sched_split:
+        if (const SchedSplitData* qp_n = SchedSplitModel::instance().get_idN_data_n(id)) {
+            source = get_source(*qp_n); is_found = true;
+        }
+        break;
+    case e_src_payee:
+        if (const PayeeData* payee_n = PayeeModel::instance().get_idN_data_n(id)) {
+            source = get_source(*payee_n); is_found = true;
+        }
+        break;
+    case e_src_budget:
+        if (const BudgetData* budget_n = BudgetModel::instance().get_idN_data_n(id)) {
+            source = get_source(*budget_n); is_found = true;
+        }
+        break;
+    case e_src_category:
+        if (const CategoryData* cat_n = CategoryModel::instance().get_idN_data_n(id)) {
+            source = get_source(*cat_n); is_found = true;
+        }
+        break;
+    case e_src_tag_link:
+        if (const TagLinkData* gl_n = TagLinkModel::instance().get_idN_data_n(id)) {
+            source = get_source(*gl_n); is_found = true;
+        }
+        break;
+    case e_src_stock:
+        if (const StockData* stock_n = StockModel::instance().get_idN_data_n(id)) {
+            source = get_source(*stock_n); is_found = true;
+        }
+        break;
+    case e_src_account:
+        if (const AccountData* account_n = AccountModel::instance().get_idN_data_n(id)) {
+            source = get_source(*account_n); is_found = true;
+        }
+        break;
+    case e_src_asset:
+        if (const AssetData* asset_n = AssetModel::instance().get_idN_data_n(id)) {
+            source = get_source(*asset_n); is_found = true;
+        }
+        break;
+    default:
+        return;
+    }
+
+    ref_set(src, id, is_found ? &source : nullptr);
+
+    if (is_active(src, id) == was_active)
+        return;
+
+    if (src == e_src_trx) {
+        for (int64 tp_id : TrxSplitModel::instance().find_id_a(
+            TrxSplitCol::WHERE_TRANSID(OP_EQ, id)
+        )) {
+            ref_update(e_src_trx_split, tp_id);
+        }
+        for (int64 gl_id : TagLinkModel::instance().find_id_a(
+            TagLinkCol::WHERE_REFTYPE(OP_EQ, TrxModel::s_ref_type.key_n()),
+            TagLinkCol::WHERE_REFID(OP_EQ, id)
+        )) {
+            ref_update(e_src_tag_link, gl_id);
+        }
+    }
+    else if (src == e_src_trx_split) {
+        for (int64 gl_id : TagLinkModel::instance().find_id_a(
+            TagLinkCol::WHERE_REFTYPE(OP_EQ, TrxSplitModel::s_ref_type.key_n()),
+            TagLinkCol::WHERE_REFID(OP_EQ, id)
+        )) {
+            ref_update(e_src_tag_link, gl_id);
+        }
+    }
+}
+
+// Replace the references of record id in src with source_n (or remove them,
+// if source_n is null).
+void ModelAll::ref_set(SRC src, int64 id, Source* source_n)
+{
+    SourceM& source_m = m_src_source_m[src];
+    auto it = source_m.find(id);
+    if (it != source_m.end()) {
+        ref_add(it->second, false);
+        source_m.erase(it);
+    }
+
+    if (source_n) {
+        ref_add(*source_n, true);
+        source_m.emplace(id, std::move(*source_n));
+    }
+}
+
+void ModelAll::ref_add(const Source& source, bool is_add)
+{
+    for (const auto& [ref, id] : source.m_ref_a) {
+        RefCountM& count_m = m_ref_count_m[ref];
+        RefCount& count = count_m[id];
+        if (is_add) {
+            ++count.m_all_c;
+            if (source.m_is_active)
+                ++count.m_active_c;
+        }
+        else {
+            --count.m_all_c;
+            if (source.m_is_active)
+                --count.m_active_c;
+            if (count.m_all_c == 0)
+                count_m.erase(id);
+        }
+    }
+}
+
+// Return true if record id in src exists and it is active.
+bool ModelAll::is_active(SRC src, int64 id) const
+{
+    const SourceM& source_m = m_src_source_m[src];
+    auto it = source_m.find(id);
+    return it != source_m.end() && it->second.m_is_active;
+}
+
+auto ModelAll::get_source(const TrxData& trx_d) const -> Source
+{
+    Source source;
+    source.m_ref_a.emplace_back(e_ref_account, trx_d.m_account_id);
+    if (trx_d.m_to_account_id_n > 0)
+        source.m_ref_a.emplace_back(e_ref_account, trx_d.m_to_account_id_n);
+    if (trx_d.m_payee_id_n > 0)
+        source.m_ref_a.emplace_back(e_ref_payee, trx_d.m_payee_id_n);
+    if (trx_d.m_category_id_n > 0)
+        source.m_ref_a.emplace_back(e_ref_category, trx_d.m_category_id_n);
+    source.m_is_active = !trx_d.is_deleted();
+    return source;
+}
+
+auto ModelAll::get_source(const TrxSplitData& tp_d) const -> Source
+{
+    Source source;
+    source.m_ref_a.emplace_back(e_ref_category, tp_d.m_category_id);
+    source.m_is_active = is_active(e_src_trx, tp_d.m_trx_id);
+    return source;
+}
+
+auto ModelAll::get_source(const SchedData& sched_d) const -> Source
+{
+    Source source;
+    source.m_ref_a.emplace_back(e_ref_account, sched_d.m_account_id);
+    if (sched_d.m_to_account_id_n > 0)
+        source.m_ref_a.emplace_back(e_ref_account, sched_d.m_to_account_id_n);
+    if (sched_d.m_payee_id_n > 0)
+        source.m_ref_a.emplace_back(e_ref_payee, sched_d.m_payee_id_n);
+    if (sched_d.m_category_id_n > 0)
+        source.m_ref_a.emplace_back(e_ref_category, sched_d.m_category_id_n);
+    return source;
+}
+
+auto ModelAll::get_source(const SchedSplitData& qp_d) const -> Source
+{
+    Source source;
+    source.m_ref_a.emplace_back(e_ref_category, qp_d.m_category_id);
+    return source;
+}
+
+auto ModelAll::get_source(const PayeeData& payee_d) const -> Source
+{
+    Source source;
+    if (payee_d.m_category_id_n > 0)
+        source.m_ref_a.emplace_back(e_ref_category, payee_d.m_category_id_n);
+    return source;
+}
+
+auto ModelAll::get_source(const BudgetData& budget_d) const -> Source
+{
+    Source source;
+    source.m_ref_a.emplace_back(e_ref_category, budget_d.m_category_id);
+    return source;
+}
+
+auto ModelAll::get_source(const CategoryData& cat_d) const -> Source
+{
+    Source source;
+    if (cat_d.m_parent_id_n > 0)
+        source.m_ref_a.emplace_back(e_ref_category, cat_d.m_parent_id_n);
+    return source;
+}
+
+// A tag link of a transaction (or transaction split) is active if the
+// transaction exists and it is not deleted.
+auto ModelAll::get_source(const TagLinkData& gl_d) const -> Source
+{
+    Source source;
+    source.m_ref_a.emplace_back(e_ref_tag, gl_d.m_tag_id);
+    if (gl_d.m_ref_type == TrxModel::s_ref_type)
+        source.m_is_active = is_active(e_src_trx, gl_d.m_ref_id);
+    else if (gl_d.m_ref_type == TrxSplitModel::s_ref_type)
+        source.m_is_active = is_active(e_src_trx_split, gl_d.m_ref_id);
+    return source;
+}
+
+auto ModelAll::get_source(const StockData& stock_d) const -> Source
+{
+    Source source;
+    if (stock_d.m_account_id_n > 0)
+        source.m_ref_a.emplace_back(e_ref_account, stock_d.m_account_id_n);
+    return source;
+}
+
+auto ModelAll::get_source(const AccountData& account_d) const -> Source
+{
+    Source source;
+    source.m_ref_a.emplace_back(e_ref_currency, account_d.m_currency_id);
+    source.m_is_active = account_d.is_open();
+    return source;
+}
+
+auto ModelAll::get_source(const AssetData& asset_d) const -> Source
+{
+    Source source;
+    if (asset_d.m_currency_id_n > 0)
+        source.m_ref_a.emplace_back(e_ref_currency, asset_d.m_currency_id_n);
+    source.m_is_active = asset_d.m_status.id() != AssetStatus::e_closed;
+    return source;
+}
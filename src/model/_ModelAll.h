@@ -28,18 +28,99 @@
 // as member methods, and they are accessed through ModelAll::instance().
 // This allows a future extension, in which the application can open
 // more than database simultaneously.
+//
+// ModelAll also keeps usage counters of payees, categories, tags, accounts and
+// currencies: the number of records which refer to each id. The counters are
+// loaded on first use; afterwards, they are updated with the committed changes
+// reported by TableChangeBus, such that "is used" checks do not scan the
+// referring tables. While a write transaction is open, the counters do not
+// include its changes, and has_ref_count() returns false.
 
+#include <unordered_map>
+#include <vector>
 #include "base/_defs.h"
 #include "base/mmSingleton.h"
 #include "data/_DataEnum.h"
+#include "table/_TableChange.h"
+
+struct TrxData;
+struct TrxSplitData;
+struct SchedData;
+struct SchedSplitData;
+struct PayeeData;
+struct BudgetData;
+struct CategoryData;
+struct TagLinkData;
+struct StockData;
+struct AccountData;
+struct AssetData;
 
 class ModelAll
 {
+public:
+    // referred entities
+    enum REF
+    {
+        e_ref_payee = 0,
+        e_ref_category,
+        e_ref_tag,
+        e_ref_account,
+        e_ref_currency,
+        e_ref_size
+    };
+
+    struct RefCount
+    {
+        std::size_t m_all_c = 0;
+        // references from valid records: transactions which are not deleted,
+        // accounts and assets which are not closed
+        std::size_t m_active_c = 0;
+
+        auto get(bool ignore_inactive) const -> std::size_t {
+            return ignore_inactive ? m_active_c : m_all_c;
+        }
+        bool operator== (const RefCount& other) const {
+            return m_all_c == other.m_all_c && m_active_c == other.m_active_c;
+        }
+    };
+    using RefCountM = std::unordered_map<int64, RefCount>;
+
+private:
+    // referring tables, in the order of processing
+    enum SRC
+    {
+        e_src_trx = 0,
+        e_src_trx_split,
+        e_src_sched,
+        e_src_sched_split,
+        e_src_payee,
+        e_src_budget,
+        e_src_category,
+        e_src_tag_link,
+        e_src_stock,
+        e_src_account,
+        e_src_asset,
+        e_src_size
+    };
+
+    // the references of one record
+    struct Source
+    {
+        std::vector<std::pair<REF, int64>> m_ref_a;
+        bool m_is_active = true;
+    };
+    using SourceM = std::unordered_map<int64, Source>;
+
 // -- state
 
 private:
     wxSQLite3Database* m_db;
 
+    bool      m_ref_is_valid = false;
+    int       m_ref_handle = 0;
+    RefCountM m_ref_count_m[e_ref_size];
+    SourceM   m_src_source_m[e_src_size];
+
 // -- constructor
 
 public:
@@ -57,4 +138,33 @@ public:
         RefTypeN ref_type, int64 ref_id,
         bool ignore_deleted = false
     ) -> std::size_t;
+
+    bool has_ref_count();
+    auto get_ref_count(REF ref, int64 id) -> RefCount;
+    auto get_ref_count_m(REF ref) -> const RefCountM&;
+    auto rebuild_ref_count() -> std::size_t;
+
+    static bool has_data_change(const TableChangeM& change_m);
+
+private:
+    static auto get_src_table_name(SRC src) -> const wxString&;
+
+    void ref_load();
+    void ref_on_change(const TableChangeM& change_m);
+    void ref_update(SRC src, int64 id);
+    void ref_set(SRC src, int64 id, Source* source_n);
+    void ref_add(const Source& source, bool is_add);
+    bool is_active(SRC src, int64 id) const;
+
+    auto get_source(const TrxData& trx_d) const -> Source;
+    auto get_source(const TrxSplitData& tp_d) const -> Source;
+    auto get_source(const SchedData& sched_d) const -> Source;
+    auto get_source(const SchedSplitData& qp_d) const -> Source;
+    auto get_source(const PayeeData& payee_d) const -> Source;
+    auto get_source(const BudgetData& budget_d) const -> Source;
+    auto get_source(const CategoryData& cat_d) const -> Source;
+    auto get_source(const TagLinkData& gl_d) const -> Source;
+    auto get_source(const StockData& stock_d) const -> Source;
+    auto get_source(const AccountData& account_d) const -> Source;
+    auto get_source(const AssetData& asset_d) const -> Source;
 };
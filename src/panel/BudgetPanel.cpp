@@ -311,10 +311,9 @@ bool BudgetPanel::displayEntryAllowed(int64 cat_id, int64 subcat_id)
         is_visible = true;
 
     if (cat_id > 0) {
-        const CategoryData* cat_n = CategoryModel::instance().get_idN_data_n(cat_id);
         m_level_visible_mCatId[cat_id].second = is_visible;
-        for (const auto& subcat_d : CategoryModel::instance().find_data_subtree_a(*cat_n)) {
-            is_visible = is_visible || displayEntryAllowed(subcat_d.m_id, -1);
+        for (int64 subcat_id : CategoryModel::instance().find_id_subtree_a(cat_id)) {
+            is_visible = is_visible || displayEntryAllowed(subcat_id, -1);
         }
     }
     return is_visible;
@@ -436,17 +435,15 @@ void BudgetPanel::initVirtualListControl()
             m_estimate_actual_mCatId[cat_d.m_id].second += actual;
 
             // walk up the hierarchy and update all the parent totals as well
-            int64 parent_id_n = subcat_a[i].m_parent_id_n;
-            m_level_visible_mCatId[subcat_a[i].m_id].first = 1;
-            for (int j = i; j > 0; --j) {
-                if (subcat_a[j - 1].m_id != parent_id_n)
-                    continue;
-                m_level_visible_mCatId[subcat_a[i].m_id].first++;
-                m_estimate_actual_mCatId[parent_id_n].first += estimated;
-                m_estimate_actual_mCatId[parent_id_n].second += actual;
-                parent_id_n = subcat_a[j - 1].m_parent_id_n;
-                if (parent_id_n == cat_d.m_id)
-                    break;
+            m_level_visible_mCatId[subcat_a[i].m_id].first =
+                CategoryModel::instance().get_id_depth(subcat_a[i].m_id) -
+                CategoryModel::instance().get_id_depth(cat_d.m_id);
+            for (int64 parent_id = subcat_a[i].m_parent_id_n;
+                parent_id != cat_d.m_id && parent_id > 0;
+                parent_id = CategoryModel::instance().get_id_parent_id(parent_id)
+            ) {
+                m_estimate_actual_mCatId[parent_id].first += estimated;
+                m_estimate_actual_mCatId[parent_id].second += actual;
             }
 
             // add the subcategory row to the display list
@@ -21,6 +21,8 @@ Copyright (C) 2026 Klaus Wich
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
+#include <future>
 #include <html_template.h>
 
 #include "base/_constants.h"
@@ -36,6 +38,34 @@ Copyright (C) 2026 Klaus Wich
 #include "SchedPanel.h"
 #include "app/mmFrame.h"
 
+namespace
+{
+
+using FetchFunc = std::function<void(wxSQLite3Database*)>;
+
+// Run fetch on a worker thread, with its own read-only connection.
+// The result of the returned task is false if the connection cannot be opened;
+// in that case fetch has not been executed.
+std::future<bool> fetch_async(const mmFrame* frame, const FetchFunc& fetch)
+{
+    return std::async(std::launch::async, [frame, fetch]() {
+        wxSharedPtr<wxSQLite3Database> db = frame->openReadOnlyDb();
+        if (!db)
+            return false;
+        fetch(db.get());
+        return true;
+    });
+}
+
+// Wait for task; if it was not executed, run fetch on the main connection.
+void fetch_wait(std::future<bool>& task, const FetchFunc& fetch)
+{
+    if (!task.get())
+        fetch(nullptr);
+}
+
+} // namespace
+
 wxBEGIN_EVENT_TABLE(DashboardPanel, wxPanel)
     EVT_WEBVIEW_NAVIGATING(wxID_ANY, DashboardPanel::onLinkClicked)
 wxEND_EVENT_TABLE()
@@ -51,12 +81,16 @@ DashboardPanel::DashboardPanel(
 ) :
     w_frame(frame)
 {
+    m_change_handle = TableChangeBus::instance().subscribe(
+        [this](const TableChangeM& change_m) { onTableChange(change_m); }
+    );
     create(parent_win, win_id, pos, size, style, name);
     w_frame->menuPrintingEnable(true);
 }
 
 DashboardPanel::~DashboardPanel()
 {
+    TableChangeBus::instance().unsubscribe(m_change_handle);
     w_frame->menuPrintingEnable(false);
     clearVFprintedFiles("hp");
 }
@@ -90,6 +124,9 @@ bool DashboardPanel::create(
 
 void DashboardPanel::createHtml()
 {
+    // the changes committed so far are shown in the new page
+    TableChangeBus::instance().skip(m_change_handle);
+
     // Read template from file
     m_templateText.clear();
     const wxString template_path = mmPath::getPathResource(mmPath::HOME_PAGE_TEMPLATE);
@@ -150,6 +187,27 @@ void DashboardPanel::insertDataIntoTemplate()
 
     double tBalance = 0.0, tAccountBalance = 0.0, tReconciled = 0.0;
 
+    // The widgets which scan transactions fetch their data on a worker thread,
+    // with one connection, while the other widgets are rendered on this thread.
+    htmlWidgetIncomeVsExpenses income_vs_expenses;
+    htmlWidgetTop7Categories top_trx;
+    htmlWidgetStatistics stat_widget;
+
+    const FetchFunc widget_fetch = [&income_vs_expenses, &top_trx, &stat_widget](
+        wxSQLite3Database* db
+    ) {
+        income_vs_expenses.fetch(db);
+        top_trx.fetch(db);
+        stat_widget.fetch(db);
+    };
+    std::future<bool> widget_task = fetch_async(w_frame, widget_fetch);
+
+    htmlWidgetBillsAndDeposits bills_and_deposits(_t("Upcoming Transactions"));
+    m_htmlText_mLabel["BILLS_AND_DEPOSITS"] = bills_and_deposits.getHTMLText();
+
+    htmlWidgetCurrency currency_rates;
+    m_htmlText_mLabel["CURRENCY_RATES"] = currency_rates.getHtmlText();
+
     // Accounts
     htmlWidgetStocks stocks_widget;
     htmlWidgetAccounts account_stats;
@@ -212,7 +270,7 @@ void DashboardPanel::insertDataIntoTemplate()
     );
 
     //
-    htmlWidgetIncomeVsExpenses income_vs_expenses;
+    fetch_wait(widget_task, widget_fetch);
     m_htmlText_mLabel["INCOME_VS_EXPENSES"] = income_vs_expenses.getHTMLText();
     m_htmlText_mLabel["INCOME_VS_EXPENSES_FORECOLOR"] =
         mmImage::themeMetaString(mmImage::COLOR_REPORT_FORECOLOR);
@@ -237,18 +295,10 @@ void DashboardPanel::insertDataIntoTemplate()
         ? wxString::Format("%d", static_cast<int>(log10(base_currency_n->m_scale.GetValue())))
         : "";
 
-    htmlWidgetBillsAndDeposits bills_and_deposits(_t("Upcoming Transactions"));
-    m_htmlText_mLabel["BILLS_AND_DEPOSITS"] = bills_and_deposits.getHTMLText();
-
-    htmlWidgetTop7Categories top_trx;
     m_htmlText_mLabel["TOP_CATEGORIES"] = top_trx.getHTMLText();
 
-    htmlWidgetStatistics stat_widget;
     m_htmlText_mLabel["STATISTICS"] = stat_widget.getHTMLText();
     m_htmlText_mLabel["TOGGLES"] = getToggles();
-
-    htmlWidgetCurrency currency_rates;
-    m_htmlText_mLabel["CURRENCY_RATES"] = currency_rates.getHtmlText();
 }
 
 const wxString DashboardPanel::getToggles()
@@ -257,6 +307,13 @@ const wxString DashboardPanel::getToggles()
     return json;
 }
 
+// Build the page again if the committed changes modify the data it shows.
+void DashboardPanel::onTableChange(const TableChangeM& change_m)
+{
+    if (ModelAll::has_data_change(change_m))
+        createHtml();
+}
+
 void DashboardPanel::fillData()
 {
     for (const auto& entry : m_htmlText_mLabel) {
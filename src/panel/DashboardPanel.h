@@ -19,6 +19,7 @@
 #pragma once
 
 #include "base/_constants.h"
+#include "table/_TableChange.h"
 #include "model/AccountModel.h"
 #include "_PanelBase.h"
 
@@ -33,6 +34,7 @@ class DashboardPanel : public PanelBase
 private:
     wxString m_templateText;
     std::map<wxString, wxString> m_htmlText_mLabel;
+    int m_change_handle = 0;
 
     mmFrame* w_frame   = nullptr;
     wxWebView*  w_browser = nullptr;
@@ -71,6 +73,7 @@ private:
     void insertDataIntoTemplate();
     void fillData();
     const wxString getToggles();
+    void onTableChange(const TableChangeM& change_m);
 
     void onNewWindow(wxWebViewEvent& event);
     void onLinkClicked(wxWebViewEvent& event);
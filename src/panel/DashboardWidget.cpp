@@ -108,18 +108,12 @@ const wxString htmlWidgetStocks::getHTMLText()
         if (!account_d.is_open())
             continue;
 
-        double conv_rate = CurrencyHistoryModel::instance().get_id_date_rate(
-            account_d.m_currency_id
+        const AccountModel::Balance& balance = AccountModel::instance().get_id_balance(
+            account_d.m_id
         );
-        auto inv_bal = AccountModel::instance().get_data_investment_balance(account_d);
-        if (btoday) {
-            cash_bal = AccountModel::instance().get_data_balance_to_date(
-                account_d, mmDate::today()
-            );
-        }
-        else {
-            cash_bal = AccountModel::instance().get_data_balance(account_d);
-        }
+        double conv_rate = balance.m_base_rate;
+        std::pair<double, double> inv_bal = { balance.m_market, balance.m_invest };
+        cash_bal = account_d.m_open_balance + (btoday ? balance.m_today_flow : balance.m_flow);
 
         grand_gain_lost    += (inv_bal.first - inv_bal.second) * conv_rate;
         grand_market_value += inv_bal.first * conv_rate;
@@ -177,6 +171,8 @@ const wxString htmlWidgetStocks::getHTMLText()
 htmlWidgetTop7Categories::htmlWidgetTop7Categories()
 {
     m_date_range = new mmLast30Days();
+    m_start_isoDate = mmDate(m_date_range->start_date()).isoDate();
+    m_end_isoDate = mmDate(m_date_range->end_date()).isoDate();
     m_title = wxString::Format(_t("Top Withdrawals: %s"), m_date_range->local_title());
 }
 
@@ -186,11 +182,32 @@ htmlWidgetTop7Categories::~htmlWidgetTop7Categories()
         delete m_date_range;
 }
 
+void htmlWidgetTop7Categories::fetch(wxSQLite3Database* db)
+{
+    m_trx_a = TrxModel::instance().find_db_data_a(db,
+        TrxModel::WHERE_DATE(OP_GE, mmDate(m_start_isoDate)),
+        TrxModel::WHERE_DATE(OP_LE, mmDate(m_end_isoDate)),
+        TrxModel::WHERE_TYPE(OP_NE, TrxType(TrxType::e_transfer)),
+        TrxModel::WHERE_IS_VALID(true)
+    );
+
+    m_trxId_tpA_m.clear();
+    for (auto& tp_d : TrxSplitModel::instance().find_db_data_a(db,
+        TableClause::ORDERBY(TrxSplitCol::s_primary_name)
+    )) {
+        m_trxId_tpA_m[tp_d.m_trx_id].push_back(std::move(tp_d));
+    }
+
+    m_is_fetched = true;
+}
+
 const wxString htmlWidgetTop7Categories::getHTMLText()
 {
+    if (!m_is_fetched)
+        fetch();
 
     std::vector<std::pair<wxString, double> > topCategoryStats;
-    getTopCategoryStats(topCategoryStats, m_date_range);
+    getTopCategoryStats(topCategoryStats);
     wxString output, data;
 
     if (!topCategoryStats.empty())
@@ -214,20 +231,14 @@ const wxString htmlWidgetTop7Categories::getHTMLText()
 }
 
 void htmlWidgetTop7Categories::getTopCategoryStats(
-    std::vector<std::pair<wxString, double> > &categoryStats,
-    const mmDateRange* date_range
+    std::vector<std::pair<wxString, double> > &categoryStats
 ) const
 {
     // Temporary map
     std::map<int64 /*cat_id*/, double> stat;
 
-    const auto trxId_tpA_m = TrxSplitModel::instance().find_all_mTrxId();
-    for (const auto& trx_d : TrxModel::instance().find_data_a(
-        TrxModel::WHERE_DATE(OP_GE, mmDate(date_range->start_date())),
-        TrxModel::WHERE_DATE(OP_LE, mmDate(date_range->end_date())),
-        TrxModel::WHERE_TYPE(OP_NE, TrxType(TrxType::e_transfer)),
-        TrxModel::WHERE_IS_VALID(true)
-    )) {
+    const auto& trxId_tpA_m = m_trxId_tpA_m;
+    for (const auto& trx_d : m_trx_a) {
         // Do not include asset or stock transfers in income expense calculations.
         if (TrxModel::is_foreignAsTransfer(trx_d))
             continue;
@@ -412,21 +423,37 @@ const wxString htmlWidgetBillsAndDeposits::getHTMLText()
     return output;
 }
 
-const wxString htmlWidgetIncomeVsExpenses::getHTMLText()
+htmlWidgetIncomeVsExpenses::htmlWidgetIncomeVsExpenses()
 {
     DashboardPref home_options;
-    wxSharedPtr<mmDateRange> date_range(home_options.get_inc_vs_exp_date_range());
+    m_date_range = home_options.get_inc_vs_exp_date_range();
+    m_start_isoDate = mmDate(m_date_range.get()->start_date()).isoDate();
+    m_end_isoDate = mmDate(m_date_range.get()->end_date()).isoDate();
+}
+
+void htmlWidgetIncomeVsExpenses::fetch(wxSQLite3Database* db)
+{
+    m_trx_a = TrxModel::instance().find_db_data_a(db,
+        TrxModel::WHERE_DATE(OP_GE, mmDate(m_start_isoDate)),
+        TrxModel::WHERE_DATE(OP_LE, mmDate(m_end_isoDate)),
+        TrxModel::WHERE_TYPE(OP_NE, TrxType(TrxType::e_transfer)),
+        TrxModel::WHERE_IS_VALID(true)
+    );
+    m_is_fetched = true;
+}
+
+const wxString htmlWidgetIncomeVsExpenses::getHTMLText()
+{
+    if (!m_is_fetched)
+        fetch();
+
+    const wxSharedPtr<mmDateRange>& date_range = m_date_range;
 
     double tIncome = 0.0, tExpenses = 0.0;
     std::map<int64, std::pair<double, double> > incomeExpensesStats;
 
     // Calculations
-    for (const auto& trx_d : TrxModel::instance().find_data_a(
-        TrxModel::WHERE_DATE(OP_GE, mmDate(date_range.get()->start_date())),
-        TrxModel::WHERE_DATE(OP_LE, mmDate(date_range.get()->end_date())),
-        TrxModel::WHERE_TYPE(OP_NE, TrxType(TrxType::e_transfer)),
-        TrxModel::WHERE_IS_VALID(true)
-    )) {
+    for (const auto& trx_d : m_trx_a) {
         // Do not include asset or stock transfers in income expense calculations.
         if (TrxModel::is_foreignAsTransfer(trx_d))
             continue;
@@ -490,72 +517,64 @@ htmlWidgetIncomeVsExpenses::~htmlWidgetIncomeVsExpenses()
 {
 }
 
-const wxString htmlWidgetStatistics::getHTMLText()
+htmlWidgetStatistics::htmlWidgetStatistics() :
+    m_ignore_future(PrefModel::instance().getIgnoreFutureTransactionsHomePage()),
+    m_today_isoDate(mmDate::today().isoDate())
 {
-    StringBuffer json_buffer;
-    PrettyWriter<StringBuffer> json_writer(json_buffer);
-    json_writer.StartObject();
-
-    json_writer.Key("NAME");
-    json_writer.String(_t("Transaction Statistics").utf8_str());
-
-    wxSharedPtr<mmDateRange> date_range;
-    /*if (PrefModel::instance().getIgnoreFutureTransactions())
-        date_range = new mmCurrentMonthToDate;
-    else
-        date_range = new mmCurrentMonth;*/
+}
 
+void htmlWidgetStatistics::fetch(wxSQLite3Database* db)
+{
     TrxModel::DataA trx_a;
-    if (PrefModel::instance().getIgnoreFutureTransactionsHomePage()) {
-        date_range = new mmCurrentMonthToDate;
-        trx_a = TrxModel::instance().find_data_a(
-            TrxModel::WHERE_DATE(OP_LE, mmDate::today())
+    if (m_ignore_future) {
+        trx_a = TrxModel::instance().find_db_data_a(db,
+            TrxModel::WHERE_DATE(OP_LE, mmDate(m_today_isoDate))
         );
     }
     else {
-        date_range = new mmCurrentMonth;
-        trx_a = TrxModel::instance().find_data_a(
+        trx_a = TrxModel::instance().find_db_data_a(db,
             TableClause::ORDERBY(TrxCol::s_primary_name)
         );
     }
-    int countFollowUp = 0;
-    int total_transactions = 0;
 
-    std::map<int64, std::pair<double, double> > accountStats;
+    m_total_c = 0;
+    m_followup_c = 0;
     for (const auto& trx_d : trx_a) {
         if (trx_d.is_deleted())
             continue;
 
-        total_transactions++;
+        m_total_c++;
 
         // Do not include asset or stock transfers in income expense calculations.
         if (TrxModel::is_foreignAsTransfer(trx_d))
             continue;
 
         if (trx_d.m_status.id() == TrxStatus::e_followup)
-            countFollowUp++;
-
-        accountStats[trx_d.m_account_id].first +=
-            trx_d.account_recflow(trx_d.m_account_id);
-        accountStats[trx_d.m_account_id].second +=
-            trx_d.account_flow(trx_d.m_account_id);
-
-        if (trx_d.is_transfer()) {
-            accountStats[trx_d.m_to_account_id_n].first +=
-                trx_d.account_recflow(trx_d.m_to_account_id_n);
-            accountStats[trx_d.m_to_account_id_n].second +=
-                trx_d.account_flow(trx_d.m_to_account_id_n);
-        }
+            m_followup_c++;
     }
 
+    m_is_fetched = true;
+}
+
+const wxString htmlWidgetStatistics::getHTMLText()
+{
+    if (!m_is_fetched)
+        fetch();
+
+    StringBuffer json_buffer;
+    PrettyWriter<StringBuffer> json_writer(json_buffer);
+    json_writer.StartObject();
+
+    json_writer.Key("NAME");
+    json_writer.String(_t("Transaction Statistics").utf8_str());
 
-    if (countFollowUp > 0) {
+    if (m_followup_c > 0) {
         json_writer.Key(_t("Follow Up On Transactions: ").utf8_str());
-        json_writer.Double(countFollowUp);
+        json_writer.Double(m_followup_c);
     }
 
     json_writer.Key(_t("Total Transactions: ").utf8_str());
-    json_writer.Int(total_transactions);
+    json_writer.Int(m_total_c);
     json_writer.EndObject();
 
     wxLogDebug("======= DashboardPanel::getStatWidget =======");
@@ -646,10 +665,12 @@ const wxString htmlWidgetAssets::getHTMLText()
         if (!asset_account_d.is_open())
             continue;
 
-        double cash = AccountModel::instance().get_data_balance(asset_account_d);
-        auto inv = AccountModel::instance().get_data_investment_balance(asset_account_d);
-        double current = inv.first;
-        double initial = inv.second;
+        const AccountModel::Balance& balance = AccountModel::instance().get_id_balance(
+            asset_account_d.m_id
+        );
+        double cash = asset_account_d.m_open_balance + balance.m_flow;
+        double current = balance.m_market;
+        double initial = balance.m_invest;
 
         initialTotal += initial;
         currentTotal += current;
@@ -690,47 +711,9 @@ htmlWidgetAssets::~htmlWidgetAssets()
 
 //
 
-htmlWidgetAccounts::htmlWidgetAccounts()
+htmlWidgetAccounts::htmlWidgetAccounts() :
+    m_ignore_future(PrefModel::instance().getIgnoreFutureTransactionsHomePage())
 {
-    get_account_stats();
-}
-
-void htmlWidgetAccounts::get_account_stats()
-{
-
-    wxSharedPtr<mmDateRange> date_range;
-    /*if (PrefModel::instance().getIgnoreFutureTransactions())
-        date_range = new mmCurrentMonthToDate;
-    else
-        date_range = new mmCurrentMonth;*/
-
-    TrxModel::DataA trx_a;
-    if (PrefModel::instance().getIgnoreFutureTransactionsHomePage()) {
-        date_range = new mmCurrentMonthToDate;
-        trx_a = TrxModel::instance().find_data_a(
-            TrxModel::WHERE_DATE(OP_LE, mmDate::today())
-        );
-    }
-    else {
-        date_range = new mmCurrentMonth;
-        trx_a = TrxModel::instance().find_data_a(
-            TableClause::ORDERBY(TrxCol::s_primary_name)
-        );
-    }
-
-    for (const auto& trx_d : trx_a) {
-        accountStats_[trx_d.m_account_id].first +=
-            trx_d.account_recflow(trx_d.m_account_id);
-        accountStats_[trx_d.m_account_id].second +=
-            trx_d.account_flow(trx_d.m_account_id);
-
-        if (trx_d.is_transfer()) {
-            accountStats_[trx_d.m_to_account_id_n].first +=
-                trx_d.account_recflow(trx_d.m_to_account_id_n);
-            accountStats_[trx_d.m_to_account_id_n].second +=
-                trx_d.account_flow(trx_d.m_to_account_id_n);
-        }
-    }
 }
 
 const wxString htmlWidgetAccounts::displayAccounts(
@@ -771,12 +754,14 @@ const wxString htmlWidgetAccounts::displayAccounts(
         const CurrencyData* currency_p = AccountModel::instance().get_data_currency_p(
             account_d
         );
-        double currency_rate = CurrencyHistoryModel::instance().get_id_date_rate(
-            account_d.m_currency_id
+        const AccountModel::Balance& balance = AccountModel::instance().get_id_balance(
+            account_d.m_id
         );
-        double bal = account_d.m_open_balance + accountStats_[account_d.m_id].second;
-        //AccountModel::instance().get_data_balance(account_d);
-        double reconciledBal = account_d.m_open_balance + accountStats_[account_d.m_id].first;
+        double currency_rate = balance.m_base_rate;
+        double bal = account_d.m_open_balance +
+            (m_ignore_future ? balance.m_today_flow : balance.m_flow);
+        double reconciledBal = account_d.m_open_balance +
+            (m_ignore_future ? balance.m_today_recflow : balance.m_recflow);
         tabBalance += bal * currency_rate;
         tabReconciled += reconciledBal * currency_rate;
 
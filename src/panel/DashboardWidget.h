@@ -24,6 +24,17 @@ Copyright (C) 2022 Mark Whalley (mark@ipx.co.uk)
 #include "base/_defs.h"
 #include "base/_types.h"
 #include "util/mmDateRange.h"
+#include "model/TrxModel.h"
+#include "model/TrxSplitModel.h"
+
+class wxSQLite3Database;
+
+// Widgets which scan transactions load their data in fetch(db).
+// fetch() does not use the model caches, thus it can run on a worker thread
+// with its own read-only connection db (if db is null, the main connection
+// is used). The date bounds are computed in the constructor, on the GUI
+// thread, since converting a wxDateTime to mmDate writes a shared cache.
+// The widget calls fetch() itself, if it was not called before getHTMLText().
 
 class htmlWidgetStocks
 {
@@ -44,15 +55,20 @@ class htmlWidgetTop7Categories
 private:
     wxString m_title;
     mmDateRange* m_date_range;
+    wxString m_start_isoDate;
+    wxString m_end_isoDate;
+    bool m_is_fetched = false;
+    TrxModel::DataA m_trx_a;
+    std::map<int64, TrxSplitModel::DataA> m_trxId_tpA_m;
 
 public:
     explicit htmlWidgetTop7Categories();
     ~htmlWidgetTop7Categories();
 
+    void fetch(wxSQLite3Database* db = nullptr);
     const wxString getHTMLText();
     void getTopCategoryStats(
-        std::vector<std::pair<wxString, double>>& categoryStats,
-        const mmDateRange* date_range
+        std::vector<std::pair<wxString, double>>& categoryStats
     ) const;
 };
 
@@ -74,17 +90,35 @@ public:
 
 class htmlWidgetIncomeVsExpenses
 {
+private:
+    wxSharedPtr<mmDateRange> m_date_range;
+    wxString m_start_isoDate;
+    wxString m_end_isoDate;
+    bool m_is_fetched = false;
+    TrxModel::DataA m_trx_a;
+
 public:
+    htmlWidgetIncomeVsExpenses();
     ~htmlWidgetIncomeVsExpenses();
 
+    void fetch(wxSQLite3Database* db = nullptr);
     const wxString getHTMLText();
 };
 
 class htmlWidgetStatistics
 {
+private:
+    bool m_ignore_future;
+    wxString m_today_isoDate;
+    bool m_is_fetched = false;
+    int m_total_c = 0;
+    int m_followup_c = 0;
+
 public:
+    htmlWidgetStatistics();
     ~htmlWidgetStatistics();
 
+    void fetch(wxSQLite3Database* db = nullptr);
     const wxString getHTMLText();
 };
 
@@ -107,17 +141,17 @@ public:
     const wxString getHTMLText();
 };
 
+// Account balances are read from the balance snapshot of AccountModel.
 class htmlWidgetAccounts
 {
 private:
-    std::map<int64, std::pair<double, double>> accountStats_;
+    bool m_ignore_future;
 
 public:
     htmlWidgetAccounts();
     ~htmlWidgetAccounts();
 
     const wxString displayAccounts(double& tBalance, double& tReconciled, int type);
-    void get_account_stats();
 };
 
 class htmlWidgetCurrency
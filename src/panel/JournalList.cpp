@@ -34,9 +34,13 @@
 #include "util/mmAttachment.h"
 #include "util/_util.h"
 #include "util/_simple.h"
+#include "util/mmSortKey.h"
 
+#include "model/CategoryModel.h"
+#include "model/PayeeModel.h"
 #include "model/PrefModel.h"
 #include "model/SettingModel.h"
+#include "model/TagModel.h"
 #include "model/Journal.h"
 
 #include "dialog/AssetDialog.h"
@@ -266,10 +270,16 @@ JournalList::JournalList(
     createColumns();
 
     SetSingleStyle(wxLC_SINGLE_SEL, false);
+
+    m_change_handle = TableChangeBus::instance().subscribe(
+        [this](const TableChangeM& change_m) { onTableChange(change_m); }
+    );
 }
 
 JournalList::~JournalList()
-{}
+{
+    TableChangeBus::instance().unsubscribe(m_change_handle);
+}
 
 // -- override
 
@@ -501,8 +511,11 @@ void JournalList::refreshVisualList(bool filter)
     this->SetEvtHandlerEnabled(false);
     Hide();
 
-    if (filter)
+    if (filter) {
+        // the changes committed so far are loaded with the list
+        TableChangeBus::instance().skip(m_change_handle);
         w_panel->filterList();
+    }
     SetItemCount(m_journal_xa.size());
     Show();
     sortList();
@@ -576,6 +589,14 @@ void JournalList::sortBy(Compare comp, bool ascend)
         std::stable_sort(this->m_journal_xa.rbegin(), this->m_journal_xa.rend(), comp);
 }
 
+// Sort by a name column. The names are ranked once, such that the sort
+// compares integers instead of collating strings.
+template<class NameFn>
+void JournalList::sortByName(NameFn name_fn, bool ascend)
+{
+    mmSortKey::sort_by_name(this->m_journal_xa, name_fn, ascend);
+}
+
 void JournalList::sortTransactions(int col_id, bool ascend)
 {
     mmChoiceIdN type_id_n;
@@ -591,16 +612,16 @@ void JournalList::sortTransactions(int col_id, bool ascend)
         sortBy(TrxData::SorterByNumber(), ascend);
         break;
     case JournalList::LIST_ID_ACCOUNT:
-        sortBy(TrxModel::SorterByACCOUNTNAME(), ascend);
+        sortByName([](const Journal::DataExt& x) -> const wxString& { return x.ACCOUNTNAME; }, ascend);
         break;
     case JournalList::LIST_ID_PAYEE_STR:
-        sortBy(TrxModel::SorterByPAYEENAME(), ascend);
+        sortByName([](const Journal::DataExt& x) -> const wxString& { return x.PAYEENAME; }, ascend);
         break;
     case JournalList::LIST_ID_STATUS:
         sortBy(TrxData::SorterByStatus(), ascend);
         break;
     case JournalList::LIST_ID_CATEGORY:
-        sortBy(TrxModel::SorterByCATEGNAME(), ascend);
+        sortByName([](const Journal::DataExt& x) -> const wxString& { return x.CATEGNAME; }, ascend);
         break;
     case JournalList::LIST_ID_TAGS:
         sortBy(TrxModel::SorterByTAGNAMES(), ascend);
@@ -675,7 +696,10 @@ void JournalList::sortTransactions(int col_id, bool ascend)
     }
 }
 
-int64 JournalList::pasteTrx(const TrxData* trx_n)
+// Queue in work the copy of trx_n, with its splits, tags and custom values,
+// and return the id of the copy. The attachments are cloned by the caller,
+// after work is flushed.
+int64 JournalList::pasteTrx(TableWork& work, const TrxData* trx_n)
 {
     wxASSERT(w_panel->isAccount());
 
@@ -700,12 +724,10 @@ int64 JournalList::pasteTrx(const TrxData* trx_n)
         w_panel->m_account_id != new_trx.m_to_account_id_n
     ))
     new_trx.m_account_id = w_panel->m_account_id;
-    TrxModel::instance().save_trx_n(new_trx);
+    TrxModel::instance().work_save_trx(work, new_trx);
     int64 new_trx_id = new_trx.m_id;
-    m_paste_key_a.push_back(JournalKey(-1, new_trx_id));   // add the newly pasted transaction
 
     // Clone transaction tags
-    TagLinkModel::DataA new_gl_a;
     for (const auto& tl_d : TagLinkModel::instance().find_data_a(
         TagLinkCol::WHERE_REFTYPE(OP_EQ, TrxModel::s_ref_type.key_n()),
         TagLinkCol::WHERE_REFID(OP_EQ, trx_n->m_id)
@@ -713,7 +735,7 @@ int64 JournalList::pasteTrx(const TrxData* trx_n)
         TagLinkData new_gl_d;
         new_gl_d.clone_from(tl_d);
         new_gl_d.m_ref_id = new_trx_id;
-        new_gl_a.push_back(new_gl_d);
+        TagLinkModel::instance().work_add(work, new_gl_d);
     }
 
     // Clone split transactions
@@ -721,7 +743,7 @@ int64 JournalList::pasteTrx(const TrxData* trx_n)
         TrxSplitData new_tp_d;
         new_tp_d.clone_from(tp_d);
         new_tp_d.m_trx_id = new_trx_id;
-        TrxSplitModel::instance().add_data_n(new_tp_d);
+        TrxSplitModel::instance().work_add(work, new_tp_d);
 
         // Clone split tags
         for (const auto& tl_d : TagLinkModel::instance().find_data_a(
@@ -731,34 +753,20 @@ int64 JournalList::pasteTrx(const TrxData* trx_n)
             TagLinkData new_gl_d;
             new_gl_d.clone_from(tl_d);
             new_gl_d.m_ref_id = new_tp_d.m_id;
-            new_gl_a.push_back(new_gl_d);
+            TagLinkModel::instance().work_add(work, new_gl_d);
         }
     }
-    TagLinkModel::instance().save_data_a(new_gl_a);
 
     // Clone duplicate custom fields
-    const auto& fv_a = FieldValueModel::instance().find_data_a(
+    for (const auto& fv_d : FieldValueModel::instance().find_data_a(
         FieldValueModel::WHERE_REFTYPEID(TrxModel::s_ref_type, trx_n->m_id)
-    );
-    if (fv_a.size() > 0) {
-        FieldValueModel::instance().db_savepoint();
-        for (const auto& fv_d : fv_a) {
-            FieldValueData new_fv_d = FieldValueData();
-            new_fv_d.m_field_id = fv_d.m_field_id;
-            new_fv_d.m_ref_type = RefTypeN(RefTypeN::e_trx);
-            new_fv_d.m_ref_id   = new_trx_id;
-            new_fv_d.m_content  = fv_d.m_content;
-            FieldValueModel::instance().add_data_n(new_fv_d);
-        }
-        FieldValueModel::instance().db_release_savepoint();
-    }
-
-    // Clone attachments if wanted
-    if (InfoModel::instance().getBool("ATTACHMENTSDUPLICATE", false)) {
-        mmAttachment::clone_ref_all(
-            TrxModel::s_ref_type, trx_n->m_id,
-            TrxModel::s_ref_type, new_trx_id
-        );
+    )) {
+        FieldValueData new_fv_d = FieldValueData();
+        new_fv_d.m_field_id = fv_d.m_field_id;
+        new_fv_d.m_ref_type = RefTypeN(RefTypeN::e_trx);
+        new_fv_d.m_ref_id   = new_trx_id;
+        new_fv_d.m_content  = fv_d.m_content;
+        FieldValueModel::instance().work_add(work, new_fv_d);
     }
 
     return new_trx_id;
@@ -1209,6 +1217,166 @@ bool JournalList::checkTransactionLocked(int64 account_id, mmDate date)
     return true;
 }
 
+// Refresh the list with the changes committed to the tables which it shows.
+// If only existing transactions have changed, and none has moved (see
+// refreshChangedRows()), only their rows are rebuilt; otherwise the list
+// is reloaded.
+void JournalList::onTableChange(const TableChangeM& change_m)
+{
+    auto find_change_n = [&change_m](const wxString& table_name) -> const TableChange* {
+        auto it = change_m.find(table_name);
+        return (it != change_m.end()) ? &it->second : nullptr;
+    };
+
+    bool is_reload = false;
+
+    // a changed or deleted name may be shown in any row;
+    // a new name is shown only in the rows of the changed transactions
+    for (const wxString& table_name : {
+        AccountModel::instance().table_name(),
+        PayeeModel::instance().table_name(),
+        CategoryModel::instance().table_name(),
+        TagModel::instance().table_name(),
+        CurrencyModel::instance().table_name(),
+        FieldModel::instance().table_name(),
+    }) {
+        const TableChange* change_n = find_change_n(table_name);
+        if (change_n && change_n->m_op_mask != TableChange::e_insert)
+            is_reload = true;
+    }
+
+    // attachments and custom field values are loaded by filterList() only
+    if (find_change_n(AttachmentModel::instance().table_name()) ||
+        find_change_n(FieldValueModel::instance().table_name())
+    )
+        is_reload = true;
+
+    if (w_panel->m_scheduled_enable && w_panel->m_scheduled_selected && (
+        find_change_n(SchedModel::instance().table_name()) ||
+        find_change_n(SchedSplitModel::instance().table_name())
+    ))
+        is_reload = true;
+
+    std::unordered_set<int64> trx_id_s;
+    if (const TableChange* change_n = find_change_n(TrxModel::instance().table_name())) {
+        if (change_n->m_is_all || change_n->m_op_mask != TableChange::e_update)
+            is_reload = true;
+        else
+            trx_id_s = change_n->m_id_s;
+    }
+
+    // the transactions of the changed splits and tag links, before and after
+    // the change; split tags are shown only with the advanced filter,
+    // which reloads the list anyway
+    const TableChange* tp_change_n = find_change_n(TrxSplitModel::instance().table_name());
+    const TableChange* gl_change_n = find_change_n(TagLinkModel::instance().table_name());
+    if ((tp_change_n && tp_change_n->m_is_all) || (gl_change_n && gl_change_n->m_is_all))
+        is_reload = true;
+    if (!is_reload && (tp_change_n || gl_change_n)) {
+        for (const auto& journal_dx : m_journal_xa) {
+            if (!journal_dx.key().is_realized())
+                continue;
+            for (const auto& tp_d : journal_dx.m_tp_a)
+                if (tp_change_n && tp_change_n->m_id_s.count(tp_d.m_id) > 0)
+                    trx_id_s.insert(journal_dx.m_id);
+            for (const auto& gl_d : journal_dx.m_gl_a)
+                if (gl_change_n && gl_change_n->m_id_s.count(gl_d.m_id) > 0)
+                    trx_id_s.insert(journal_dx.m_id);
+        }
+        if (tp_change_n) {
+            for (const int64& tp_id : tp_change_n->m_id_s) {
+                for (const auto& tp_d : TrxSplitModel::instance().find_data_a(
+                    TrxSplitCol::WHERE_SPLITTRANSID(OP_EQ, tp_id)
+                ))
+                    trx_id_s.insert(tp_d.m_trx_id);
+            }
+        }
+        if (gl_change_n) {
+            for (const int64& gl_id : gl_change_n->m_id_s) {
+                for (const auto& gl_d : TagLinkModel::instance().find_data_a(
+                    TagLinkCol::WHERE_TAGLINKID(OP_EQ, gl_id)
+                )) {
+                    if (gl_d.m_ref_type == TrxModel::s_ref_type)
+                        trx_id_s.insert(gl_d.m_ref_id);
+                }
+            }
+        }
+    }
+
+    if (is_reload || (!trx_id_s.empty() && !refreshChangedRows(trx_id_s)))
+        refreshVisualList();
+}
+
+// Rebuild in place the rows of the transactions in trx_id_s.
+// Return false if a transaction is not in the list, or if it has moved, i.e.,
+// its date, type, status, accounts or amounts have changed: it may enter or
+// leave the list, and the balance of the following rows changes.
+// The list is not sorted again; a rebuilt row stays in place until the
+// list is reloaded.
+bool JournalList::refreshChangedRows(const std::unordered_set<int64>& trx_id_s)
+{
+    // with the advanced filter, a transaction may be expanded into its splits,
+    // and a change may add it to, or remove it from, the list
+    if (w_panel->m_filter_advanced)
+        return false;
+
+    std::vector<std::pair<long, TrxData>> item_trx_a;
+    for (const int64& trx_id : trx_id_s) {
+        const JournalKey journal_key(-1, trx_id);
+        auto it = std::find_if(m_journal_xa.begin(), m_journal_xa.end(),
+            [&journal_key](const Journal::DataExt& journal_dx) {
+                return journal_dx.key() == journal_key;
+            }
+        );
+        if (it == m_journal_xa.end())
+            return false;
+
+        // bypass the cache, which may not reflect changes made with raw SQL
+        TrxModel::DataA trx_a = TrxModel::instance().find_data_a(
+            TrxCol::WHERE_TRANSID(OP_EQ, trx_id)
+        );
+        if (trx_a.empty())
+            return false;
+        const TrxData& trx_d = trx_a.front();
+        if (trx_d.m_datetime != it->m_datetime ||
+            trx_d.m_type.id() != it->m_type.id() ||
+            trx_d.m_status.id() != it->m_status.id() ||
+            trx_d.m_account_id != it->m_account_id ||
+            trx_d.m_to_account_id_n != it->m_to_account_id_n ||
+            trx_d.m_amount != it->m_amount ||
+            trx_d.m_to_amount != it->m_to_amount ||
+            trx_d.m_deleted_utc_n != it->m_deleted_utc_n
+        )
+            return false;
+
+        item_trx_a.emplace_back(static_cast<long>(it - m_journal_xa.begin()), trx_d);
+    }
+
+    for (const auto& [item, trx_d] : item_trx_a) {
+        Journal::DataExt& old_dx = m_journal_xa[item];
+        Journal::DataExt journal_dx(trx_d);
+        w_panel->setAccountSide(journal_dx);
+
+        // set by filterList(); they do not change if the transaction has not moved
+        journal_dx.SN = old_dx.SN;
+        journal_dx.displaySN = old_dx.displaySN;
+        journal_dx.m_account_flow = old_dx.m_account_flow;
+        journal_dx.m_account_balance = old_dx.m_account_balance;
+        journal_dx.ATTACHMENT_DESCRIPTION = old_dx.ATTACHMENT_DESCRIPTION;
+        for (int i = 0; i < 5; i++) {
+            journal_dx.UDFC_type[i] = old_dx.UDFC_type[i];
+            journal_dx.UDFC_content[i] = old_dx.UDFC_content[i];
+            journal_dx.UDFC_value[i] = old_dx.UDFC_value[i];
+        }
+
+        old_dx = std::move(journal_dx);
+        RefreshItem(item);
+    }
+
+    setExtraTransactionData(GetSelectedItemCount() == 1);
+    return true;
+}
+
 // -- event handlers
 
 // If any of these keys are encountered, the search for the event handler
@@ -1949,13 +2117,13 @@ void JournalList::onEditTrx(wxCommandEvent& /*event*/)
             return;
         if (!checkForClosedAccounts())
             return;
+        // the changed rows are refreshed by onTableChange()
         TrxUpdateDialog dlg(this, trx_id_a);
-        if (dlg.ShowModal() == wxID_OK)
-            refreshVisualList();
+        dlg.ShowModal();
         return;
     }
 
-    // edit single transaction
+    // edit single transaction; the changed rows are refreshed by onTableChange()
     JournalKey journal_key = m_select_key_a[0];
     if (journal_key.is_realized()) {
         int64 trx_id = journal_key.rid();
@@ -1969,13 +2137,11 @@ void JournalList::onEditTrx(wxCommandEvent& /*event*/)
             const TrxLinkData* tl_n = TrxLinkModel::instance().get_trx_data_n(trx_id);
             if (tl_n && tl_n->m_ref_type == StockModel::s_ref_type) {
                 TrxShareDialog dlg(this, tl_n, trx_n);
-                if (dlg.ShowModal() == wxID_OK)
-                    refreshVisualList();
+                dlg.ShowModal();
             }
             else if (tl_n && tl_n->m_ref_type == AssetModel::s_ref_type) {
                 AssetDialog dlg(this, tl_n, trx_n);
-                if (dlg.ShowModal() == wxID_OK)
-                    refreshVisualList();
+                dlg.ShowModal();
             }
             else {
                 wxASSERT(false);
@@ -1983,14 +2149,12 @@ void JournalList::onEditTrx(wxCommandEvent& /*event*/)
         }
         else {
             TrxDialog dlg(this, JournalKey(-1, trx_id), false, w_panel->m_account_id);
-            if (dlg.ShowModal() != wxID_CANCEL)
-                refreshVisualList();
+            dlg.ShowModal();
         }
     }
     else {
         SchedDialog dlg(this, SchedDialog::MODE_UPDATE, journal_key.sid());
-        if (dlg.ShowModal() == wxID_OK)
-            refreshVisualList();
+        dlg.ShowModal();
     }
     m_top_item_n = GetTopItem() + GetCountPerPage() - 1;
 }
@@ -2035,23 +2199,26 @@ void JournalList::onMoveTrx(wxCommandEvent& /*event*/)
             else
                 return;
             std::vector<int64> skip_trx;
-            TrxModel::instance().db_savepoint();
+            TableWork work;
             for (const auto& journal_key : m_select_key_a) {
                 if (journal_key.is_realized()) {
-                    TrxData* trx_n = TrxModel::instance().unsafe_get_idN_data_n(journal_key.rid());
-                    if (checkTransactionLocked(trx_n->m_account_id, trx_n->m_date()) ||
-                        TrxModel::is_foreign(*trx_n) ||
-                        trx_n->is_transfer() ||
-                        trx_n->m_date() < dest_account->m_open_date
+                    TrxData trx_d = *TrxModel::instance().get_idN_data_n(journal_key.rid());
+                    if (checkTransactionLocked(trx_d.m_account_id, trx_d.m_date()) ||
+                        TrxModel::is_foreign(trx_d) ||
+                        trx_d.is_transfer() ||
+                        trx_d.m_date() < dest_account->m_open_date
                     ) {
-                        skip_trx.push_back(trx_n->m_id);
+                        skip_trx.push_back(trx_d.m_id);
                     } else {
-                        trx_n->m_account_id = dest_account_id;
-                        TrxModel::instance().unsafe_save_trx_n(trx_n);
+                        trx_d.m_account_id = dest_account_id;
+                        TrxModel::instance().work_save_trx(work, trx_d);
                     }
                 }
             }
-            TrxModel::instance().db_release_savepoint();
+            if (!work.flush()) {
+                mmErrorDialogs::MessageSaveFailed(this);
+                return;
+            }
             if (!skip_trx.empty()) {
                 const wxString detail = wxString::Format("%s\n%s: %zu\n%s: %zu",
                     _t("This is due to some elements of the transaction or account detail not allowing the move"),
@@ -2188,7 +2355,7 @@ void JournalList::onMarkTrx(wxCommandEvent& event)
         wxASSERT(false);
     }
 
-    TrxModel::instance().db_savepoint();
+    TableWork work;
 
     for (int row = 0; row < GetItemCount(); row++) {
         if (GetItemState(row, wxLIST_STATE_SELECTED) != wxLIST_STATE_SELECTED)
@@ -2200,12 +2367,16 @@ void JournalList::onMarkTrx(wxCommandEvent& event)
             continue;
         //bRefreshRequired |= (status.id() == TrxStatus::e_void) || (m_journal_xa[row].is_void());
         if (m_journal_xa[row].key().is_realized()) {
-            m_journal_xa[row].m_status = status;
-            TrxModel::instance().save_trx_n(m_journal_xa[row]);
+            TrxData trx_d = m_journal_xa[row];
+            trx_d.m_status = status;
+            TrxModel::instance().work_save_trx(work, trx_d);
         }
     }
 
-    TrxModel::instance().db_release_savepoint();
+    if (!work.flush()) {
+        mmErrorDialogs::MessageSaveFailed(this);
+        return;
+    }
 
     refreshVisualList();
 }
@@ -2318,17 +2489,33 @@ void JournalList::onPaste(wxCommandEvent& WXUNUSED(event))
         return;
 
     setSelectKeyA();
-    TrxModel::instance().db_savepoint();
     m_paste_key_a.clear();    // make sure the list is empty before we paste
+    TableWork work;
+    std::vector<std::pair<int64, int64>> old_new_id_a;
     for (const auto& journal_key : m_copy_key_a) {
         if (journal_key.is_realized()) {
             const TrxData* trx_d = TrxModel::instance().get_idN_data_n(journal_key.rid());
             if (TrxModel::is_foreign(*trx_d))
                 continue;
-            pasteTrx(trx_d);
+            old_new_id_a.emplace_back(trx_d->m_id, pasteTrx(work, trx_d));
+        }
+    }
+    if (!work.flush()) {
+        mmErrorDialogs::MessageSaveFailed(this);
+        return;
+    }
+
+    bool clone_attachments = InfoModel::instance().getBool("ATTACHMENTSDUPLICATE", false);
+    for (const auto& [old_id, new_id] : old_new_id_a) {
+        m_paste_key_a.push_back(JournalKey(-1, new_id));   // add the newly pasted transaction
+        // Clone attachments if wanted
+        if (clone_attachments) {
+            mmAttachment::clone_ref_all(
+                TrxModel::s_ref_type, old_id,
+                TrxModel::s_ref_type, new_id
+            );
         }
     }
-    TrxModel::instance().db_release_savepoint();
     refreshVisualList();
 }
 
@@ -2413,8 +2600,7 @@ void JournalList::onSetUserColour(wxCommandEvent& event)
     SchedModel::instance().db_release_savepoint();
     TrxModel::instance().db_release_savepoint();
     m_top_item_n = GetTopItem() + GetCountPerPage() - 1;
-
-    refreshVisualList();
+    // the changed rows are refreshed by onTableChange()
 }
 
 void JournalList::onOpenAttachment(wxCommandEvent& WXUNUSED(event))
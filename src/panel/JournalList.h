@@ -23,6 +23,8 @@ Copyright (C) 2026 Klaus Wich
 #pragma once
 
 #include <optional>
+#include <unordered_set>
+#include "table/_TableChange.h"
 #include "model/Journal.h"
 #include "_ListBase.h"
 
@@ -130,6 +132,7 @@ private:
     std::vector<JournalKey> m_select_key_a; // selected transactions
     std::vector<JournalKey> m_copy_key_a;   // copied transactions
     std::vector<JournalKey> m_paste_key_a;  // last pasted transactions
+    int m_change_handle = 0;
 
     JournalPanel* w_panel = nullptr;
     wxSharedPtr<wxListItemAttr> w_attr1;  // style 1
@@ -185,8 +188,10 @@ private:
     void sortList();
     template<class Compare>
     void sortBy(Compare comp, bool ascend);
+    template<class NameFn>
+    void sortByName(NameFn name_fn, bool ascend);
     void sortTransactions(int col_id, bool ascend);
-    auto pasteTrx(const TrxData* tran) -> int64;
+    auto pasteTrx(TableWork& work, const TrxData* tran) -> int64;
     auto getItem(long item, int col_id) const -> const wxString;
     void setExtraTransactionData(const bool single);
     void markItem(long selectedItem);
@@ -199,6 +204,8 @@ private:
     void deleteTransactionsByStatus(std::optional<TrxStatus> status_n);
     bool checkForClosedAccounts();
     bool checkTransactionLocked(int64 account_id, mmDate date);
+    void onTableChange(const TableChangeM& change_m);
+    bool refreshChangedRows(const std::unordered_set<int64>& trx_id_s);
 
 // -- event handlers
 
@@ -855,30 +855,8 @@ void JournalPanel::filterList()
             }
         }
 
-        if (isGroup()) {
-            if (accountInGroup) {
-                journal_dx.PAYEENAME = journal_dx.real_payee_name(m_account_id);
-                if (!toAccountInGroup) {
-                    journal_dx.m_account_d_id_n = -1; journal_dx.m_amount_d = 0.0;
-                }
-            }
-            else if (toAccountInGroup) {
-                journal_dx.PAYEENAME = "< " + journal_dx.ACCOUNTNAME;
-                journal_dx.ACCOUNTNAME = journal_dx.TOACCOUNTNAME;
-                journal_dx.m_account_w_id_n = -1; journal_dx.m_amount_w = 0.0;
-            }
-        }
-        else {
-            journal_dx.PAYEENAME = journal_dx.real_payee_name(m_account_id);
-        }
-
+        setAccountSide(journal_dx);
         if (isAccount()) {
-            if (journal_dx.m_account_w_id_n != m_account_id) {
-                journal_dx.m_account_w_id_n = -1; journal_dx.m_amount_w = 0.0;
-            }
-            if (journal_dx.m_account_d_id_n != m_account_id) {
-                journal_dx.m_account_d_id_n = -1; journal_dx.m_amount_d = 0.0;
-            }
             journal_dx.m_account_flow = account_flow;
             journal_dx.m_account_balance = m_balance;
         }
@@ -999,6 +977,39 @@ void JournalPanel::filterList()
     }
 }
 
+// Set the payee name and the withdrawal/deposit sides of journal_dx,
+// as seen from the account (or the group of accounts) of this panel.
+void JournalPanel::setAccountSide(Journal::DataExt& journal_dx) const
+{
+    if (isGroup()) {
+        bool accountInGroup = m_account_id_m.find(journal_dx.m_account_id) != m_account_id_m.end();
+        bool toAccountInGroup = m_account_id_m.find(journal_dx.m_to_account_id_n) != m_account_id_m.end();
+        if (accountInGroup) {
+            journal_dx.PAYEENAME = journal_dx.real_payee_name(m_account_id);
+            if (!toAccountInGroup) {
+                journal_dx.m_account_d_id_n = -1; journal_dx.m_amount_d = 0.0;
+            }
+        }
+        else if (toAccountInGroup) {
+            journal_dx.PAYEENAME = "< " + journal_dx.ACCOUNTNAME;
+            journal_dx.ACCOUNTNAME = journal_dx.TOACCOUNTNAME;
+            journal_dx.m_account_w_id_n = -1; journal_dx.m_amount_w = 0.0;
+        }
+    }
+    else {
+        journal_dx.PAYEENAME = journal_dx.real_payee_name(m_account_id);
+    }
+
+    if (isAccount()) {
+        if (journal_dx.m_account_w_id_n != m_account_id) {
+            journal_dx.m_account_w_id_n = -1; journal_dx.m_amount_w = 0.0;
+        }
+        if (journal_dx.m_account_d_id_n != m_account_id) {
+            journal_dx.m_account_d_id_n = -1; journal_dx.m_amount_d = 0.0;
+        }
+    }
+}
+
 // -- methods
 
 void JournalPanel::updateHeader()
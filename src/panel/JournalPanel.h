@@ -205,6 +205,7 @@ private:
     void loadFilterSettings();
     void saveFilterSettings();
     void filterList();
+    void setAccountSide(Journal::DataExt& journal_dx) const;
 
     void updateHeader();
     void updateFilter();
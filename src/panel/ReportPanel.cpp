@@ -123,11 +123,15 @@ ReportPanel::ReportPanel(
     m_cleanup(cleanup),
     w_frame(frame)
 {
+    m_change_handle = TableChangeBus::instance().subscribe(
+        [this](const TableChangeM& change_m) { onTableChange(change_m); }
+    );
     create(parent_win, win_id, pos, size, style, name);
 }
 
 ReportPanel::~ReportPanel()
 {
+    TableChangeBus::instance().unsubscribe(m_change_handle);
     if (m_cleanup && m_rb) {
         delete m_rb;
     }
@@ -710,6 +714,9 @@ bool ReportPanel::saveReportText()
     if (!m_rb)
         return false;
 
+    // the changes committed so far are shown in the new report
+    TableChangeBus::instance().skip(m_change_handle);
+
     if (m_rb->getParameters() & ReportBase::M_DATE_RANGE) {
         m_rb->setDateRange(m_date_range);
         m_rb->setDateSelection(0);
@@ -758,6 +765,13 @@ bool ReportPanel::saveReportText()
     return true;
 }
 
+// Build the report again if the committed changes modify its data.
+void ReportPanel::onTableChange(const TableChangeM& change_m)
+{
+    if (m_rb && m_rb->isChangedBy(change_m))
+        saveReportText();
+}
+
 // -- event handlers
 
 void ReportPanel::onNewWindow(wxWebViewEvent& evt)
@@ -799,16 +813,11 @@ void ReportPanel::onNewWindow(wxWebViewEvent& evt)
         }
 
         if (cat_id > 0) {
-            std::vector<int64> sub_id_a;
             // include all sub categories
-            if (sub_id == -2) {
-                const CategoryData* cat_n = CategoryModel::instance().get_idN_data_n(cat_id);
-                for (const auto& sub_d : CategoryModel::instance().find_data_subtree_a(*cat_n)) {
-                    sub_id_a.push_back(sub_d.m_id);
-                }
-            }
-            sub_id_a.push_back(cat_id);
-            m_rb->m_filter.setCategoryList(sub_id_a);
+            if (sub_id == -2)
+                m_rb->m_filter.setCategorySubtree(cat_id);
+            else
+                m_rb->m_filter.setCategoryList({ cat_id });
         }
 
         if (payee_id > 0) {
@@ -77,6 +77,7 @@ private:
     bool m_cleanup;
     int m_shift = 0;
     bool m_use_account_specific_filter;
+    int m_change_handle = 0;
 
 private:
     mmFrame*          w_frame            = nullptr;
@@ -139,6 +140,7 @@ private:
     void saveFilterSettings();
     void updateFilter();
     bool saveReportText();
+    void onTableChange(const TableChangeM& change_m);
 
 // -- event handlers
 
@@ -23,6 +23,7 @@
 
 #include "base/_defs.h"
 #include <wx/clipbrd.h>
+#include <wx/weakref.h>
 
 #include "base/mmTips.h"
 #include "util/mmImage.h"
@@ -548,7 +549,13 @@ void StockPanel::updateHeader()
 void StockPanel::onRefreshQuotes(wxCommandEvent& WXUNUSED(event))
 {
     wxString sError = "";
-    bool ok = onlineQuoteRefresh(sError);
+    if (!onlineQuoteRefresh(sError))
+        onQuoteRefreshDone(false, sError);
+}
+
+void StockPanel::onQuoteRefreshDone(bool ok, const wxString& sError)
+{
+    w_refresh_btn->Enable();
     if (ok) {
         const wxString header = _t("Stock prices updated successfully");
         w_details->SetLabelText(header);
@@ -586,6 +593,8 @@ void StockPanel::onFilterCancel(wxCommandEvent& WXUNUSED(event))
 }
 
 /*** Trigger a quote download ***/
+// The quotes are downloaded in background; onQuoteRefreshDone() is called
+// when the download completes. Return false if the download is not started.
 bool StockPanel::onlineQuoteRefresh(wxString& msg)
 {
     wxString base_currency_symbol;
@@ -599,75 +608,75 @@ bool StockPanel::onlineQuoteRefresh(wxString& msg)
         return false;
     }
 
-    std::map<wxString, double> symbols;
-    StockModel::DataA stock_a = StockModel::instance().find_data_a(
-        TableClause::ORDERBY(StockCol::s_primary_name)
-    );
-    for (const auto& stock_d : stock_a) {
+    std::vector<wxString> symbol_a;
+    for (const auto& stock_d : StockModel::instance().find_data_a()) {
         const wxString symbol = stock_d.m_symbol.Upper();
-        if (symbol.IsEmpty()) continue;
-        symbols[symbol] = stock_d.m_purchase_value;
+        if (!symbol.IsEmpty())
+            symbol_a.push_back(symbol);
     }
+    std::sort(symbol_a.begin(), symbol_a.end());
+    symbol_a.erase(std::unique(symbol_a.begin(), symbol_a.end()), symbol_a.end());
 
     w_refresh_btn->SetBitmapLabel(mmImage::bitmapBundle(
         mmImage::png::LED_YELLOW, mmImage::bitmapButtonSize
     ));
+    w_refresh_btn->Disable();
     w_details->SetLabelText(_tu("Connecting…"));
 
-    std::map<wxString, double > stocks_data;
-    bool ok = get_yahoo_prices(
-        symbols, stocks_data, base_currency_symbol, msg, yahoo_price_type::SHARES
-    );
-    if (!ok) {
-        return false;
-    }
-
-    std::map<wxString, double> nonYahooSymbols;
-
-    StockHistoryModel::instance().db_savepoint();
-    for (auto& stock_d : stock_a) {
-        std::map<wxString, double>::const_iterator it = stocks_data.find(
-            stock_d.m_symbol.Upper()
-        );
-        if (it == stocks_data.end()) {
-            nonYahooSymbols[stock_d.m_symbol.Upper()] = 0;
-            continue;
-        }
-
-        double dPrice = it->second;
-
-        if (dPrice != 0) {
-            msg += wxString::Format("%s\t: %0.6f -> %0.6f\n",
-                stock_d.m_symbol, stock_d.m_current_price, dPrice
-            );
-            stock_d.m_current_price = dPrice;
-            StockModel::instance().save_data_n(stock_d);
-            StockHistoryModel::instance().save_record(
-                stock_d.m_symbol,
-                mmDate::today(),
-                dPrice,
-                UpdateType(UpdateType::e_online)
-            );
-        }
-    }
-    StockHistoryModel::instance().db_release_savepoint();
-
-    for (const auto& entry : nonYahooSymbols) {
-        msg += wxString::Format("%s\t: %s\n", entry.first, _t("Missing"));
-    }
-
-    // Now refresh the display
-    refreshList();
-
-    // We are done!
-    m_last_refresh = wxDateTime::Now();
-    m_refresh_status = true;
+    mmQuote::Config config = mmQuote::Config::from_settings();
+    config.m_abort_n = w_frame->getClosingFlag();
+    const wxString filename = w_frame->getFilename();
+    wxWeakRef<StockPanel> panel_ref(this);
+    mmFrame* frame = w_frame;
+    frame->runInBackground([=]() -> std::function<void()> {
+        mmQuote::Result result = mmQuote::fetch_shares(config, symbol_a);
+        return [=]() {
+            // the frame may be closing, or the database closed or replaced
+            if (!frame->isOpenDb(filename))
+                return;
+
+            wxString msg = result.m_msg;
+            std::vector<wxString> missing_a;
+            if (result.m_ok) {
+                msg.clear();
+                mmQuote::save_session(result);
+                TableWork work;
+                missing_a = StockModel::instance().work_update_symbol_price_m(work,
+                    result.m_price_m, mmDate::today(), msg
+                );
+                if (!work.flush()) {
+                    if (panel_ref)
+                        panel_ref->onQuoteRefreshDone(false,
+                            mmErrorDialogs::SaveFailedText()
+                        );
+                    else
+                        mmErrorDialogs::MessageSaveFailed(frame);
+                    return;
+                }
+                for (const wxString& symbol : missing_a)
+                    msg += wxString::Format("%s\t: %s\n", symbol, _t("Missing"));
+
+                wxDateTime now = wxDateTime::Now();
+                const wxString last_update = wxString::Format(_t("%1$s on %2$s"),
+                    now.FormatTime(),
+                    mmGetDateTimeForDisplay(now.FormatISODate())
+                );
+                InfoModel::instance().saveString("STOCKS_LAST_REFRESH_DATETIME", last_update);
+                if (panel_ref) {
+                    panel_ref->m_last_refresh = now;
+                    panel_ref->m_refresh_status = true;
+                    panel_ref->m_last_update = last_update;
+                }
+            }
 
-    m_last_update.Printf(_t("%1$s on %2$s"),
-        m_last_refresh.FormatTime(),
-        mmGetDateTimeForDisplay(m_last_refresh.FormatISODate())
-    );
-    InfoModel::instance().saveString("STOCKS_LAST_REFRESH_DATETIME", m_last_update);
+            if (!panel_ref)
+                return;
+            // Now refresh the display
+            if (result.m_ok)
+                panel_ref->refreshList();
+            panel_ref->onQuoteRefreshDone(result.m_ok, msg);
+        };
+    });
 
     return true;
 }
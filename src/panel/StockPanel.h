@@ -102,6 +102,7 @@ private:
 
     void updateExtraStocksData(int selIndex);
     bool onlineQuoteRefresh(wxString& sError);
+    void onQuoteRefreshDone(bool ok, const wxString& sError);
     auto getPanelTitle(const AccountData& account) const -> wxString;
 
     // Event handlers
@@ -146,6 +146,12 @@ void OtherPref::Create()
         "create or update the backup database: dbFile_update_YYYY-MM-DD.bak"));
     databaseStaticBoxSizer->Add(databaseUpdateCheckBox, g_flagsV);
 
+    m_backup_compress = new wxCheckBox(databaseStaticBox, wxID_ANY
+        , _t("Compress backup files"), wxDefaultPosition, wxDefaultSize, wxCHK_2STATE);
+    m_backup_compress->SetValue(SettingModel::instance().getBool("BACKUPDB_COMPRESS", false));
+    mmToolTip(m_backup_compress, _t("Store the backup databases in zip archives: dbFile_start_YYYY-MM-DD.bak.zip"));
+    databaseStaticBoxSizer->Add(m_backup_compress, g_flagsV);
+
     int max = SettingModel::instance().getInt("MAX_BACKUP_FILES", 4);
     m_max_files = new wxSpinCtrl(databaseStaticBox, wxID_ANY
         , wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 1, 999, max);
@@ -167,6 +173,14 @@ void OtherPref::Create()
     flex_sizer3->Add(m_deleted_trans_retain_days, g_flagsBorder1H);
     databaseStaticBoxSizer->Add(flex_sizer3);
 
+    m_db_wal = new wxCheckBox(databaseStaticBox, wxID_ANY
+        , _t("Use write-ahead logging"), wxDefaultPosition, wxDefaultSize, wxCHK_2STATE);
+    m_db_wal->SetValue(PrefModel::instance().getDbWal());
+    mmToolTip(m_db_wal, _t("Faster reads and commits while the database is open.\n"
+        "Do not enable it for a database on a network drive.\n"
+        "The change takes effect when the database is opened again."));
+    databaseStaticBoxSizer->Add(m_db_wal, g_flagsV);
+
     //CSV Import
     const wxString delimiter = InfoModel::instance().getString("DELIMITER", mmex::DEFDELIMTER);
 
@@ -215,6 +229,7 @@ void OtherPref::OnBackupChanged(wxCommandEvent& WXUNUSED(event))
     wxCheckBox* ChkBackup = static_cast<wxCheckBox*>(FindWindow(ID_DIALOG_OPTIONS_CHK_BACKUP));
     wxCheckBox* ChkBackupUpdate = static_cast<wxCheckBox*>(FindWindow(ID_DIALOG_OPTIONS_CHK_BACKUP_UPDATE));
     m_max_files->Enable(ChkBackup->GetValue() || ChkBackupUpdate->GetValue());
+    m_backup_compress->Enable(ChkBackup->GetValue() || ChkBackupUpdate->GetValue());
 }
 
 void OtherPref::SaveStocksUrl()
@@ -246,8 +261,10 @@ bool OtherPref::SaveSettings()
     SettingModel::instance().saveBool("BACKUPDB_UPDATE", itemCheckBoxUpdate->GetValue());
 
     SettingModel::instance().saveInt("MAX_BACKUP_FILES", m_max_files->GetValue());
+    SettingModel::instance().saveBool("BACKUPDB_COMPRESS", m_backup_compress->IsChecked());
     SettingModel::instance().saveInt("DELETED_TRANS_RETAIN_DAYS", m_deleted_trans_retain_days->GetValue());
     SettingModel::instance().saveBool("REFRESH_STOCK_QUOTES_ON_OPEN", m_refresh_quotes_on_open->IsChecked());
+    PrefModel::instance().saveDbWal(m_db_wal->IsChecked());
 
     PrefModel::instance().saveUsePerAccountFilter(m_store_account_specific_filter->IsChecked());
 
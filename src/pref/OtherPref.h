@@ -54,6 +54,8 @@ private:
     wxCheckBox* m_refresh_quotes_on_open = nullptr;
     wxChoice* m_asset_compounding = nullptr;
     wxCheckBox* m_store_account_specific_filter = nullptr;
+    wxCheckBox* m_db_wal = nullptr;
+    wxCheckBox* m_backup_compress = nullptr;
 
     enum
     {
@@ -74,17 +74,19 @@ double BalanceReport::getCheckingBalance(const AccountData* account_n, const mmD
     return account_n->m_open_balance;
 }
 
+// date_i is the index of date in the report dates
 std::pair<double, double> BalanceReport::getBalance(
     const AccountData* account_n,
-    const mmDate& date
+    const mmDate& date,
+    std::size_t date_i
 ) {
     std::pair<double /*cash bal*/, double /*market bal*/> bal = { 0.0, 0.0 };
     if (date < account_n->m_open_date)
         return bal;
     bal.first = getCheckingBalance(account_n, date);
-    if (AccountModel::type_id(*account_n) == mmNavigatorItem::TYPE_ID_INVESTMENT) {
-        bal.second = StockModel::instance().calculate_account_balance(*account_n, date);
-    }
+    const auto market_it = m_market_balance_aDate_mId.find(account_n->m_id);
+    if (market_it != m_market_balance_aDate_mId.end())
+        bal.second = market_it->second[date_i];
     return bal;
 }
 
@@ -142,7 +144,7 @@ wxString BalanceReport::getHTMLText()
         hb.displayDateHeading(m_date_range);
 
     m_currencyDateRateCache.clear();
-    m_stock_xa.clear();
+    m_market_balance_aDate_mId.clear();
 
     mmDate selected_start_date = m_date_range
         ? mmDate(m_date_range->start_date())
@@ -173,18 +175,6 @@ wxString BalanceReport::getHTMLText()
         }
 
         m_account_balance_mDate_mId[account_d.m_id] = loadAccountBalance_mDate(account_d);
-        if (AccountModel::type_id(account_d) != mmNavigatorItem::TYPE_ID_INVESTMENT)
-            continue;
-        for (const auto& stock_d : StockModel::instance().find_data_a(
-            StockCol::WHERE_HELDAT(OP_EQ, account_d.m_id)
-        )) {
-            StockDataExt stock_dx = StockDataExt(stock_d);
-            stock_dx.m_hist_data_a = StockHistoryModel::instance().find_data_a(
-                StockHistoryCol::WHERE_SYMBOL(OP_EQ, stock_d.m_symbol),
-                TableClause::ORDERBY(StockHistoryCol::NAME_DATE, true)
-            );
-            m_stock_xa.push_back(stock_dx);
-        }
     }
 
     const bool include_assets = mmNavigatorList::instance().isAssetAccountActive();
@@ -235,7 +225,28 @@ wxString BalanceReport::getHTMLText()
     }
     std::reverse(end_date_a.begin(), end_date_a.end());
 
-    for (const auto& end_date : end_date_a) {
+    // Evaluate the market balance of investment accounts at all dates at once
+    for (const auto& account_d : account_a) {
+        if (m_account_a && wxNOT_FOUND == m_account_a->Index(account_d.m_name))
+            continue;
+        if (AccountModel::type_id(account_d) != mmNavigatorItem::TYPE_ID_INVESTMENT)
+            continue;
+        m_market_balance_aDate_mId[account_d.m_id] =
+            StockModel::instance().calculate_account_balance_a(account_d, end_date_a);
+    }
+
+    // Evaluate the market value of assets at all dates at once
+    std::vector<std::vector<std::pair<double, double>>> asset_value_aDate_a;
+    if (include_assets) {
+        for (const auto& asset_d : asset_a) {
+            asset_value_aDate_a.push_back(
+                AssetModel::instance().get_data_value_date_a(asset_d, end_date_a)
+            );
+        }
+    }
+
+    for (std::size_t date_i = 0; date_i < end_date_a.size(); ++date_i) {
+        const mmDate& end_date = end_date_a[date_i];
         BalanceEntry date_balanceA;
         date_balanceA.date = end_date;
         double total = 0.0;
@@ -250,7 +261,7 @@ wxString BalanceReport::getHTMLText()
 
             if (view_accounts) {
                 double rate = getCurrencyDateRate(account_d.m_currency_id, end_date);
-                std::pair<double, double> dailybal = getBalance(&account_d, end_date);
+                std::pair<double, double> dailybal = getBalance(&account_d, end_date, date_i);
                 balance_a[idx] = dailybal.first * rate;
                 if (AccountModel::type_id(account_d) == mmNavigatorItem::TYPE_ID_INVESTMENT) {
                     balance_a[idx] += dailybal.second * rate;
@@ -264,7 +275,7 @@ wxString BalanceReport::getHTMLText()
                 }
                 if (type_idx > -1) {
                     double rate = getCurrencyDateRate(account_d.m_currency_id, end_date);
-                    std::pair<double, double> dailybal = getBalance(&account_d, end_date);
+                    std::pair<double, double> dailybal = getBalance(&account_d, end_date, date_i);
                     balance_a[type_idx] += dailybal.first * rate;
                     if (AccountModel::type_id(account_d) == mmNavigatorItem::TYPE_ID_INVESTMENT) {
                         balance_a[type_idx] += dailybal.second * rate;
@@ -276,11 +287,9 @@ wxString BalanceReport::getHTMLText()
         if (view_accounts) {
             if (include_asset_series) {
                 double asset_balance = 0.0;
-                for (const auto& asset_d : asset_a) {
-                    double rate = getCurrencyDateRate(asset_d.m_currency_id_n, end_date);
-                    asset_balance += AssetModel::instance().get_data_value_date(
-                        asset_d, end_date
-                    ).second * rate;
+                for (std::size_t asset_i = 0; asset_i < asset_a.size(); ++asset_i) {
+                    double rate = getCurrencyDateRate(asset_a[asset_i].m_currency_id_n, end_date);
+                    asset_balance += asset_value_aDate_a[asset_i][date_i].second * rate;
                 }
                 balance_a[idx] = asset_balance;
             }
@@ -289,11 +298,9 @@ wxString BalanceReport::getHTMLText()
             if (include_assets) {
                 type_idx = mmNavigatorList::instance().getAccountTypeIdx(mmNavigatorItem::TYPE_ID_ASSET);
                 if (type_idx > -1) {
-                    for (const auto& asset_d : asset_a) {
-                        double rate = getCurrencyDateRate(asset_d.m_currency_id_n, end_date);
-                        balance_a[type_idx] += AssetModel::instance().get_data_value_date(
-                            asset_d, end_date
-                        ).second * rate;
+                    for (std::size_t asset_i = 0; asset_i < asset_a.size(); ++asset_i) {
+                        double rate = getCurrencyDateRate(asset_a[asset_i].m_currency_id_n, end_date);
+                        balance_a[type_idx] += asset_value_aDate_a[asset_i][date_i].second * rate;
                     }
                 }
             }
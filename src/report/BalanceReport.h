@@ -22,15 +22,6 @@
 #include "model/AccountModel.h"
 #include "_ReportBase.h"
 
-// FIXME: m_stock_xa is set but mot used
-struct StockDataExt : StockData
-{
-    StockHistoryModel::DataA m_hist_data_a;
-
-    StockDataExt() : StockData() {}
-    StockDataExt(const StockData& stock_d) : StockData(stock_d) {}
-};
-
 class BalanceReport : public ReportBase
 {
 public:
@@ -43,7 +34,8 @@ public:
 private:
     PERIOD_ID m_period_id;
     std::map<int64, std::map<mmDate, double>> m_account_balance_mDate_mId;
-    std::vector<StockDataExt> m_stock_xa;
+    // market balance of investment accounts at each report date
+    std::map<int64, std::vector<double>> m_market_balance_aDate_mId;
     std::map<wxString, double> m_currencyDateRateCache;
 
 public:
@@ -53,7 +45,9 @@ public:
 private:
     std::map<mmDate, double> loadAccountBalance_mDate(const AccountData& account_d);
     double getCheckingBalance(const AccountData* account_n, const mmDate& date);
-    std::pair<double, double> getBalance(const AccountData* account_n, const mmDate& date);
+    std::pair<double, double> getBalance(
+        const AccountData* account_n, const mmDate& date, std::size_t date_i
+    );
     double getCurrencyDateRate(int64 currency_id, const mmDate& date);
 };
 
@@ -308,26 +308,29 @@ wxString mmReportChartStocks::getHTMLText()
         );
         symbols.Add(stock_d.m_symbol);
         int dataCount = 0, freq = 1;
-        auto sh_a = StockHistoryModel::instance().find_data_a(
-            StockHistoryCol::WHERE_SYMBOL(OP_EQ, stock_d.m_symbol),
-            StockHistoryModel::WHERE_DATE(OP_GE, m_date_range->start_date()),
-            StockHistoryModel::WHERE_DATE(OP_LE, m_date_range->end_date()),
-            TableClause::ORDERBY(StockHistoryCol::NAME_DATE)
+        const StockHistoryModel::Series& series =
+            StockHistoryModel::instance().get_symbol_series(stock_d.m_symbol);
+        const std::size_t begin_i = series.find_next_i(
+            mmDate(m_date_range->start_date()).yyyymmdd()
         );
-
-        //bool showGridLines = (sh_a.size() <= 366);
-        //bool pointDot = (sh_a.size() <= 30);
-        if (sh_a.size() > 366) {
-            freq = sh_a.size() / 366;
+        const std::size_t end_i = static_cast<std::size_t>(series.find_prev_i(
+            mmDate(m_date_range->end_date()).yyyymmdd()
+        ) + 1);
+        const std::size_t count = (end_i > begin_i) ? end_i - begin_i : 0;
+
+        //bool showGridLines = (count <= 366);
+        //bool pointDot = (count <= 30);
+        if (count > 366) {
+            freq = count / 366;
         }
 
         GraphData gd;
         GraphSeries data;
 
-        for (const auto& sh_d : sh_a) {
+        for (std::size_t i = begin_i; i < begin_i + count; ++i) {
             if (dataCount % freq == 0) {
-                gd.labels.push_back(sh_d.m_date.isoDate());
-                data.values.push_back(sh_d.m_price);
+                gd.labels.push_back(mmDate::fromYyyymmdd(series.m_date_a[i]).isoDate());
+                data.values.push_back(series.m_price_a[i]);
             }
             dataCount++;
         }
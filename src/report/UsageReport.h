@@ -27,6 +27,8 @@ public:
     virtual ~UsageReport();
 
     virtual wxString getHTMLText();
+    // the report shows the usage log, which is appended while it is shown
+    virtual bool isChangedBy(const TableChangeM&) const { return false; }
 private:
     static const char * usage_template;
 };
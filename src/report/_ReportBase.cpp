@@ -27,6 +27,7 @@
 #include "util/_util.h"
 #include "util/_simple.h"
 #include "model/AccountModel.h"
+#include "model/_ModelAll.h"
 
 ReportBase::ReportBase(const wxString& title)
     : m_title(title)
@@ -164,6 +165,12 @@ const wxString ReportBase::getAccountNames() const
     return accountsMsg;
 }
 
+// By default, a report reads any data, but not the settings and the usage log.
+bool ReportBase::isChangedBy(const TableChangeM& change_m) const
+{
+    return ModelAll::has_data_change(change_m);
+}
+
 void ReportBase::saveReportSettings()
 {
     REPORT_ID report_id = getReportId();
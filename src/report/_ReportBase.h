@@ -27,6 +27,7 @@
 #include "model/PrefModel.h"
 #include "model/ReportModel.h"
 #include "model/TrxFilter.h"
+#include "table/_TableChange.h"
 
 class wxString;
 class wxArrayString;
@@ -111,6 +112,9 @@ public:
     virtual int extractParameters();
     virtual void refreshData() {}
     virtual wxString getHTMLText() = 0;
+    // Return true if the report shall be built again after the committed
+    // changes change_m.
+    virtual bool isChangedBy(const TableChangeM& change_m) const;
 
 public:
     void setReportParameters(REPORT_ID report_id);
@@ -189,6 +193,9 @@ public:
 public:
     wxString getHTMLText();
     virtual int extractParameters();
+    // the script of the report may write to the database; it is not run again
+    // after its own changes
+    virtual bool isChangedBy(const TableChangeM&) const { return false; }
     std::map<wxString, wxString> extractVarDetails(const wxString& input, const wxString& marker);
 
 private:
@@ -237,7 +237,6 @@ wxString mmReportBudgetCategorySummary::getHTMLText()
         std::vector<int> totals_stack;
         CategoryModel::DataA sub_a = CategoryModel::instance().find_data_subtree_a(cat_d);
         for (int i = 0; i < static_cast<int>(sub_a.size()); i++) {
-            categLevel[sub_a[i].m_id].first = 1;
             estimated = budgetStats[sub_a[i].m_id][budgetMonth];
 
             if (estimated < 0)
@@ -260,16 +259,14 @@ wxString mmReportBudgetCategorySummary::getHTMLText()
             catTotalsActual[cat_d.m_id] += actual;
 
             //walk up the hierarchy and update all the parent totals as well
-            int64 nextParent = sub_a[i].m_parent_id_n;
-            for (int j = i; j > 0; j--) {
-                if (sub_a[j - 1].m_id == nextParent) {
-                    categLevel[sub_a[i].m_id].first++;
-                    catTotalsEstimated[sub_a[j - 1].m_id] += estimated;
-                    catTotalsActual[sub_a[j - 1].m_id] += actual;
-                    nextParent = sub_a[j - 1].m_parent_id_n;
-                    if (nextParent == cat_d.m_id)
-                        break;
-                }
+            categLevel[sub_a[i].m_id].first = CategoryModel::instance().get_id_depth(sub_a[i].m_id) -
+                CategoryModel::instance().get_id_depth(cat_d.m_id);
+            for (int64 parent_id = sub_a[i].m_parent_id_n;
+                parent_id != cat_d.m_id && parent_id > 0;
+                parent_id = CategoryModel::instance().get_id_parent_id(parent_id)
+            ) {
+                catTotalsEstimated[parent_id] += estimated;
+                catTotalsActual[parent_id] += actual;
             }
             categLevel[sub_a[i].m_id].second = "";
             for (int j = categLevel[sub_a[i].m_id].first; j > 0; j--) {
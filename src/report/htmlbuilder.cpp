@@ -18,8 +18,12 @@
  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ********************************************************/
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <ios>
+#include <sstream>
+#include <cstdio>
 #include <float.h>
 
 #include "base/_constants.h"
@@ -127,7 +131,6 @@ namespace tags
     static const wxString TFOOT_START = "<tfoot>\n";
     static const wxString TFOOT_END = "</tfoot>\n";
     static const wxString TABLE_ROW = "<tr>\n";
-    static const wxString TABLE_ROW_EXTRA = "<tr %s>\n";
     static const wxString TOTAL_TABLE_ROW = "<tr class='success'>\n";
     static const wxString TABLE_ROW_END = "</tr>\n";
     static const wxString TABLE_CELL = "<td%s>";
@@ -135,7 +138,6 @@ namespace tags
     static const wxString TABLE_CELL_END = "</td>\n";
     static const wxString TABLE_CELL_LINK = R"(<a href="%s" target="_blank">%s</a>)";
     static const wxString TABLE_CELL_LINK_COLOR = R"(<a style="color: %s;" href="%s" target="_blank">%s</a>)";
-    static const wxString TABLE_HEADER = "<th%s>";
     static const wxString HEADER = "<h%i>%s</h%i>";
     static const wxString TABLE_HEADER_END = "</th>\n";
     static const wxString LINK = "<a href=\"%s\">%s</a>\n";
@@ -145,12 +147,13 @@ namespace tags
     static const wxString NBSP = "&nbsp;";
     static const wxString CENTER = "<center>\n";
     static const wxString CENTER_END = "</center>\n";
-    static const wxString TABLE_CELL_SPAN = "<td colspan=\"%i\" >";
     static const wxString TABLE_CELL_RIGHT = "<td style='text-align: right'>";
     static const wxString SPAN = "<span %s>%s";
     static const wxString SPAN_END = "</span>\n";
 }
 
+std::size_t mmHTMLBuilder::s_size_hint = 0;
+
 mmHTMLBuilder::mmHTMLBuilder()
 {
     today_.date = wxDateTime::Now();
@@ -176,6 +179,28 @@ void mmHTMLBuilder::init(bool simple, const wxString& extra_style)
             , extra_style);
     }
     formatHTML(html_);
+
+    // pre-size the document, in order to avoid repeated reallocation
+    // while the rows are appended
+    html_.reserve(std::max(s_size_hint, html_.length()));
+}
+
+// Append value in the same format as wxString::Format("%f", value).
+void mmHTMLBuilder::appendFixed(double value)
+{
+    char buf[64];
+    const int n = snprintf(buf, sizeof(buf), "%f", value);
+    if (n > 0 && n < static_cast<int>(sizeof(buf)))
+        html_.append(buf, static_cast<std::size_t>(n));
+    else
+        html_ += wxString::Format("%f", value);
+}
+
+void mmHTMLBuilder::appendInt(int value)
+{
+    char buf[16];
+    const int n = snprintf(buf, sizeof(buf), "%d", value);
+    html_.append(buf, static_cast<std::size_t>(n));
 }
 
 void mmHTMLBuilder::showUserName()
@@ -315,10 +340,17 @@ void mmHTMLBuilder::startTfoot()
     html_ += tags::TFOOT_START;
 }
 
+void mmHTMLBuilder::startTableCellSpan(int cols)
+{
+    html_ += wxS("<td colspan=\"");
+    appendInt(cols);
+    html_ += wxS("\" >");
+}
+
 void mmHTMLBuilder::addEmptyTableRow(int cols)
 {
     this->startTotalTableRow();
-    html_ += wxString::Format(tags::TABLE_CELL_SPAN, cols);
+    this->startTableCellSpan(cols);
     this->endTableCell();
     this->endTableRow();
 }
@@ -327,7 +359,7 @@ void mmHTMLBuilder::addTotalRow(const wxString& caption
     , int cols, double value)
 {
     this->startTotalTableRow();
-    html_ += wxString::Format(tags::TABLE_CELL_SPAN, cols - 1);
+    this->startTableCellSpan(cols - 1);
     html_ += caption;
     this->endTableCell();
     this->addMoneyCell(value);
@@ -338,7 +370,7 @@ void mmHTMLBuilder::addTotalRow(const wxString& caption, int cols
     , const std::vector<wxString>& data)
 {
     this->startTotalTableRow();
-    html_ += wxString::Format(tags::TABLE_CELL_SPAN, cols - static_cast<int>(data.size()));
+    this->startTableCellSpan(cols - static_cast<int>(data.size()));
     html_ += caption;
 
     for (unsigned long idx = 0; idx < data.size(); idx++)
@@ -371,11 +403,18 @@ void mmHTMLBuilder::addMoneyTotalRow(const wxString& caption, int cols, const st
 
 void mmHTMLBuilder::addTableHeaderCell(const wxString& value, const wxString& css_class, int cols)
 {
-    html_ += wxString::Format(tags::TABLE_HEADER //TABLE_HEADER = "<th%s>";
-        , wxString::Format("%s%s"
-            , css_class.empty() ? "" : wxString::Format(" class='%s'", css_class)
-            , cols > 1 ? wxString::Format(" colspan='%i'", cols) : "")
-    );
+    html_ += wxS("<th");
+    if (!css_class.empty()) {
+        html_ += wxS(" class='");
+        html_ += css_class;
+        html_ += wxS("'");
+    }
+    if (cols > 1) {
+        html_ += wxS(" colspan='");
+        appendInt(cols);
+        html_ += wxS("'");
+    }
+    html_ += wxS(">");
     html_ += value;
     html_ += tags::TABLE_HEADER_END;
 }
@@ -388,12 +427,14 @@ void mmHTMLBuilder::addCurrencyCell(
 ) {
     if (precision == -1)
         precision = currency_n->precision();
-    wxString s = CurrencyModel::instance().toCurrency(amount, currency_n, precision);
+    html_ += wxS("<td class='money' sorttable_customkey = '");
+    appendFixed(amount);
+    html_ += wxS("' nowrap>");
     if (isVoid)
-        s = wxString::Format("<s>%s</s>", s);
-    const wxString f = wxString::Format(" class='money' sorttable_customkey = '%f' nowrap", amount);
-    html_ += wxString::Format(tags::TABLE_CELL, f);
-    html_ += s;
+        html_ += wxS("<s>");
+    html_ += CurrencyModel::instance().toCurrency(amount, currency_n, precision);
+    if (isVoid)
+        html_ += wxS("</s>");
     this->endTableCell();
 }
 
@@ -401,25 +442,28 @@ void mmHTMLBuilder::addMoneyCell(double amount, int precision)
 {
     if (precision == -1)
         precision = CurrencyModel::instance().get_base_data_n()->precision();
-    const wxString s = CurrencyModel::instance().toString(amount, CurrencyModel::instance().get_base_data_n(), precision);
-    wxString f = wxString::Format(" class='money' sorttable_customkey = '%f' nowrap", amount);
-    html_ += wxString::Format(tags::TABLE_CELL, f);
-    html_ += (amount == -DBL_MAX) ? "" : s;     // If -DBL_MAX then just display empty string
+    html_ += wxS("<td class='money' sorttable_customkey = '");
+    appendFixed(amount);
+    html_ += wxS("' nowrap>");
+    if (amount != -DBL_MAX)     // If -DBL_MAX then just display empty string
+        html_ += CurrencyModel::instance().toString(amount, CurrencyModel::instance().get_base_data_n(), precision);
     this->endTableCell();
 }
 
 void mmHTMLBuilder::addTableCellDate(const wxString& iso_date)
 {
-    html_ += wxString::Format(tags::TABLE_CELL
-        , wxString::Format(" class='text-left' sorttable_customkey = '%s' nowrap", iso_date));
+    html_ += wxS("<td class='text-left' sorttable_customkey = '");
+    html_ += iso_date;
+    html_ += wxS("' nowrap>");
     html_ += mmGetDateTimeForDisplay(iso_date);
     this->endTableCell();
 }
 
 void mmHTMLBuilder::addTableCell(const wxString& value, bool numeric, bool center)
 {
-    const wxString align = (center ? " class='text-center'" : (numeric ? " class='text-right' nowrap" : " class='text-left'"));
-    html_ += wxString::Format(tags::TABLE_CELL, align);
+    html_ += center ? wxS("<td class='text-center'>")
+        : numeric ? wxS("<td class='text-right' nowrap>")
+        : wxS("<td class='text-left'>");
     html_ += value;
     this->endTableCell();
 }
@@ -475,10 +519,13 @@ const wxString mmHTMLBuilder::getRandomColor(bool positive)
 void mmHTMLBuilder::addTableCellMonth(int month, int year)
 {
     if (month >= 0 && month < 12) {
-        wxString f = wxString::Format(" sorttable_customkey = '%i'", year * 100 + month);
-        html_ += wxString::Format(tags::TABLE_CELL, f);
-        if (0 != year)
-            html_ += wxString::Format("%d ", year);
+        html_ += wxS("<td sorttable_customkey = '");
+        appendInt(year * 100 + month);
+        html_ += wxS("'>");
+        if (0 != year) {
+            appendInt(year);
+            html_ += wxS(" ");
+        }
         html_ += wxGetTranslation(wxDateTime::GetEnglishMonthName(static_cast<wxDateTime::Month>(month)));
         this->endTableCell();
     }
@@ -489,7 +536,15 @@ void mmHTMLBuilder::addTableCellMonth(int month, int year)
 void mmHTMLBuilder::addTableCellLink(const wxString& href
     , const wxString& value, bool numeric, bool center)
 {
-    addTableCell(wxString::Format(tags::TABLE_CELL_LINK, href, value), numeric, center);
+    html_ += center ? wxS("<td class='text-center'>")
+        : numeric ? wxS("<td class='text-right' nowrap>")
+        : wxS("<td class='text-left'>");
+    html_ += wxS("<a href=\"");
+    html_ += href;
+    html_ += wxS("\" target=\"_blank\">");
+    html_ += value;
+    html_ += wxS("</a>");
+    this->endTableCell();
 }
 
 void mmHTMLBuilder::addTableRow(const wxString& label, double data)
@@ -503,6 +558,10 @@ void mmHTMLBuilder::addTableRow(const wxString& label, double data)
 void mmHTMLBuilder::end(bool simple)
 {
     html_ += simple ? tags::END_SIMPLE : tags::END;
+
+    // the next report is likely to have a similar size
+    if (!simple)
+        s_size_hint = html_.length();
 }
 void mmHTMLBuilder::addDivContainer(const wxString& style)
 {
@@ -551,11 +610,15 @@ void mmHTMLBuilder::startTableRow()
 }
 void mmHTMLBuilder::startTableRow(const wxString& classname)
 {
-    html_ += wxString::Format(tags::TABLE_ROW_EXTRA, wxString::Format("class='%s'", classname));
+    html_ += wxS("<tr class='");
+    html_ += classname;
+    html_ += wxS("'>\n");
 }
 void mmHTMLBuilder::startTableRowColor(const wxString& color)
 {
-    html_ += wxString::Format(tags::TABLE_ROW_EXTRA, wxString::Format("style='background-color:%s'", color));
+    html_ += wxS("<tr style='background-color:");
+    html_ += color;
+    html_ += wxS("'>\n");
 }
 
 void mmHTMLBuilder::startAltTableRow()
@@ -600,7 +663,9 @@ void mmHTMLBuilder::addHorizontalLine(int size)
 
 void mmHTMLBuilder::startTableCell(const wxString& width)
 {
-    html_ += wxString::Format(tags::TABLE_CELL, width);
+    html_ += wxS("<td");
+    html_ += width;
+    html_ += wxS(">");
 }
 void mmHTMLBuilder::endTableCell()
 {
@@ -609,8 +674,145 @@ void mmHTMLBuilder::endTableCell()
 
 // Chart method (uses ApexChart.js)
 
-void mmHTMLBuilder::addChart(const GraphData& gd)
+namespace
+{
+
+// Largest-Triangle-Three-Buckets: keep the first and the last point, and in
+// each bucket the point which forms the largest triangle with the point kept
+// in the previous bucket and the average of the next bucket.
+std::vector<std::size_t> lttb_index_a(const std::vector<double>& value_a, std::size_t max_points)
+{
+    const std::size_t n = value_a.size();
+    std::vector<std::size_t> index_a;
+    index_a.reserve(max_points);
+    index_a.push_back(0);
+
+    const double bucket_size = static_cast<double>(n - 2) / (max_points - 2);
+    std::size_t a = 0;
+    for (std::size_t b = 0; b < max_points - 2; ++b) {
+        const std::size_t start = 1 + static_cast<std::size_t>(b * bucket_size);
+        const std::size_t end = std::min(n - 1, 1 + static_cast<std::size_t>((b + 1) * bucket_size));
+
+        const std::size_t next_start = end;
+        const std::size_t next_end = std::min(n, 1 + static_cast<std::size_t>((b + 2) * bucket_size));
+        double avg_x = 0.0, avg_y = 0.0;
+        for (std::size_t i = next_start; i < next_end; ++i) {
+            avg_x += i;
+            avg_y += value_a[i];
+        }
+        const std::size_t next_c = next_end - next_start;
+        if (next_c > 0) {
+            avg_x /= next_c;
+            avg_y /= next_c;
+        }
+        else {
+            avg_x = static_cast<double>(n - 1);
+            avg_y = value_a[n - 1];
+        }
+
+        double max_area = -1.0;
+        std::size_t max_i = start;
+        for (std::size_t i = start; i < end; ++i) {
+            const double area = std::fabs(
+                (static_cast<double>(a) - avg_x) * (value_a[i] - value_a[a]) -
+                (static_cast<double>(a) - i) * (avg_y - value_a[a])
+            );
+            if (area > max_area) {
+                max_area = area;
+                max_i = i;
+            }
+        }
+        index_a.push_back(max_i);
+        a = max_i;
+    }
+
+    index_a.push_back(n - 1);
+    return index_a;
+}
+
+// Min-max decimation for several series with shared labels: keep the first
+// and the last point, and in each bucket the minimum and the maximum of each series.
+std::vector<std::size_t> minmax_index_a(const GraphData& gd, std::size_t max_points)
+{
+    const std::size_t n = gd.labels.size();
+    const std::size_t bucket_c = std::max<std::size_t>(1, max_points / (2 * gd.series.size()));
+    std::vector<bool> is_kept(n, false);
+    is_kept[0] = is_kept[n - 1] = true;
+
+    for (std::size_t b = 0; b < bucket_c; ++b) {
+        const std::size_t start = 1 + b * (n - 2) / bucket_c;
+        const std::size_t end = 1 + (b + 1) * (n - 2) / bucket_c;
+        if (start >= end)
+            continue;
+        for (const auto& series : gd.series) {
+            std::size_t min_i = start, max_i = start;
+            for (std::size_t i = start + 1; i < end; ++i) {
+                if (series.values[i] < series.values[min_i]) min_i = i;
+                if (series.values[i] > series.values[max_i]) max_i = i;
+            }
+            is_kept[min_i] = is_kept[max_i] = true;
+        }
+    }
+
+    std::vector<std::size_t> index_a;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (is_kept[i])
+            index_a.push_back(i);
+    }
+    return index_a;
+}
+
+// Return gd, or a copy of gd reduced to about gd.max_points points (in sampled_gd).
+// Only line and area charts are downsampled; bars and pies keep all their points.
+const GraphData& downsample_chart(const GraphData& gd, GraphData& sampled_gd)
+{
+    const std::size_t n = gd.labels.size();
+    if (gd.max_points < 4 || n <= gd.max_points || gd.series.empty())
+        return gd;
+    if (gd.type != GraphData::LINE &&
+        gd.type != GraphData::LINE_DATETIME &&
+        gd.type != GraphData::STACKEDAREA
+    )
+        return gd;
+    for (const auto& series : gd.series) {
+        if (series.values.size() != n)
+            return gd;
+    }
+
+    const std::vector<std::size_t> index_a = (gd.series.size() == 1)
+        ? lttb_index_a(gd.series[0].values, gd.max_points)
+        : minmax_index_a(gd, gd.max_points);
+
+    sampled_gd.title = gd.title;
+    sampled_gd.type = gd.type;
+    sampled_gd.colors = gd.colors;
+    sampled_gd.max_points = gd.max_points;
+    sampled_gd.labels.reserve(index_a.size());
+    for (std::size_t i : index_a)
+        sampled_gd.labels.push_back(gd.labels[i]);
+    for (const auto& series : gd.series) {
+        GraphSeries sampled_series;
+        sampled_series.name = series.name;
+        sampled_series.type = series.type;
+        sampled_series.values.reserve(index_a.size());
+        for (std::size_t i : index_a)
+            sampled_series.values.push_back(series.values[i]);
+        sampled_gd.series.push_back(std::move(sampled_series));
+    }
+
+    wxLogDebug("mmHTMLBuilder::addChart(): %d points downsampled to %d",
+        static_cast<int>(n), static_cast<int>(index_a.size())
+    );
+    return sampled_gd;
+}
+
+} // namespace
+
+void mmHTMLBuilder::addChart(const GraphData& data)
 {
+    GraphData sampled_data;
+    const GraphData& gd = downsample_chart(data, sampled_data);
+
     int precision = CurrencyModel::instance().get_base_data_n()->precision();
     int k = mmMath::pow10(precision);
     wxString htmlChart, htmlPieData;
@@ -747,45 +949,47 @@ void mmHTMLBuilder::addChart(const GraphData& gd)
     else
         htmlChart += wxString::Format(", xaxis: { type: '%s', categories: [%s], labels: { hideOverlappingLabels: true } }\n", gSeriesType, categories);
 
+    // avoid locale usage with standard printf functionality. Always want 00000.00 format
+    std::ostringstream oss;
+    oss.imbue(std::locale::classic());
+    oss << std::fixed << std::setprecision(precision);
+
     wxString seriesList, pieEntries;
     bool firstList = true;
     for (const auto& entry : gd.series)
     {
-        wxString seriesEntries;
+        const bool is_pie = (gd.type == GraphData::PIE || gd.type == GraphData::DONUT);
+        std::string seriesEntries, pieSeriesEntries;
         first = true;
         for (const auto& item : entry.values)
         {
             long double v = item * k;
             v = round(v) / k;
 
-            // avoid locale usage with standard printf functionality. Always want 00000.00 format
-            std::ostringstream oss;
-            oss.imbue(std::locale::classic());
-
-            oss << std::fixed << std::setprecision(precision) << fabs(v);
-            wxString valueAbs = oss.str();
-
+            if (!first) {
+                seriesEntries += ',';
+                if (is_pie)
+                    pieSeriesEntries += ',';
+            }
             oss.str(std::string());
-            oss << std::fixed << std::setprecision(precision) << v;
-            wxString value = oss.str();
-
-            if (gd.type == GraphData::PIE || gd.type == GraphData::DONUT)
-            {
-                seriesEntries += wxString::Format("%s%s", first ? "":",", valueAbs);    // pie data series must be positive
-                pieEntries += wxString::Format("%s%s", first ? "":",", value);
-            } else
-            {
-                seriesEntries += wxString::Format("%s%s", first ? "":",", value);
+            oss << (is_pie ? fabs(v) : v);     // pie data series must be positive
+            seriesEntries += oss.str();
+            if (is_pie) {
+                oss.str(std::string());
+                oss << v;
+                pieSeriesEntries += oss.str();
             }
             first = false;
         }
-        if (gd.type == GraphData::PIE || gd.type == GraphData::DONUT)
-            seriesList = seriesEntries;
+        if (is_pie)
+            pieEntries += wxString::FromAscii(pieSeriesEntries.c_str());
+        if (is_pie)
+            seriesList = wxString::FromAscii(seriesEntries.c_str());
         else
         {
             const wxString typeString = (gd.type == GraphData::BARLINE || gd.type == GraphData::STACKEDBARLINE)
                                 ? wxString::Format("type: '%s',", entry.type) : "";
-            seriesList += wxString::Format("%s{ name: '%s', %s data: [%s] }", firstList ? "":",", entry.name, typeString, seriesEntries);
+            seriesList += wxString::Format("%s{ name: '%s', %s data: [%s] }", firstList ? "":",", entry.name, typeString, wxString::FromAscii(seriesEntries.c_str()));
         }
         firstList = false;
     }
@@ -44,6 +44,8 @@ struct GraphData
     std::vector<wxString> labels;
     std::vector<GraphSeries> series;
     std::vector<wxColour> colors;
+    // line and area charts with more points are downsampled (0: no limit)
+    std::size_t max_points = 1000;
 };
 
 class mmHTMLBuilder
@@ -52,6 +54,9 @@ public:
     mmHTMLBuilder();
     ~mmHTMLBuilder() {}
 
+    // forget the size of the last report, e.g., when the database is closed
+    static void reset_size_hint() { s_size_hint = 0; }
+
     void displayDateHeading(const wxString& header);
     void displayDateHeading(const wxDateTime& startDate, const wxDateTime& endDate, bool withDateRange = true, bool withNoEndDate = false);
     void displayDateHeading(const mmDateRange* date_range);
@@ -157,6 +162,14 @@ public:
     void addChart(const GraphData& data);
 
 private:
+    void appendFixed(double value);
+    void appendInt(int value);
+    void startTableCellSpan(int cols);
+
+private:
+    // length of the last complete report; used to pre-size html_
+    static std::size_t s_size_hint;
+
     wxString html_;
     struct today_
     {
@@ -41,24 +41,14 @@ void TableBase::drop_table()
     m_db->ExecuteUpdate(m_drop_query);
 }
 
+// Return a new id of the form ticks * 1000 + suffix (see TableId).
+// If a block of ids has been reserved for this table, the id is taken from it.
 int64 TableBase::newId()
 {
-    // Get the current time in milliseconds as wxLongLong/int64
-    int64 ticks = wxDateTime::UNow().GetValue();
-
-    // Ensure uniqueness from last generated value
-    if (ticks <= m_ticks)
-        ticks = m_ticks + 1;
-    m_ticks = ticks;
-
-    // Generate a random 3-digit number (0 to 999)
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> dist(0, 999);
-    int randomSuffix = dist(gen);
-
-    // Combine ticks and randomSuffix
-    return (ticks * 1000) + randomSuffix;
+    if (!m_id_block.empty())
+        return m_id_block.take();
+
+    return TableId::next_id();
 }
 
 // This is a helper function used in the implementation of variadic select_query().
@@ -30,11 +30,15 @@ using namespace tmpl;
 
 #include "base/_types.h"
 #include "_TableClause.h"
+#include "_TableId.h"
 
 class wxString;
 
 struct TableBase
 {
+    // TableWork executes queued writes with the queries of each table
+    friend class TableWork;
+
 // -- static
 
     void get_select_result(wxSQLite3ResultSet& q, int i, wxString& v) {
@@ -52,7 +56,9 @@ struct TableBase
 protected:
     // member variables are independent for each table derived from TableBase
     wxSQLite3Database* m_db;
-    int64 m_ticks;
+    // ids reserved by reserve_id(); newId() takes from it until it is empty,
+    // or until release_id()
+    TableId::Block m_id_block;
     wxString m_table_name;
     wxString m_create_query;
     wxString m_drop_query;
@@ -61,11 +67,34 @@ protected:
     wxString m_update_query;
     wxString m_delete_query;
     wxString m_select_query;
+    // incremented after each write through TableFactory; used by derived
+    // caches (in models) to detect that the table content has changed
+    std::size_t m_data_version;
+
+// -- nested
+
+public:
+    // Reserve ids for a bulk write, for the lifetime of this object.
+    // The reserved ids which have not been used are released at the end, such
+    // that later ids are not out of order with the ids handed out since.
+    class IdReserve
+    {
+    private:
+        TableBase& m_table;
+
+    public:
+        IdReserve(TableBase& table, std::size_t count) : m_table(table) {
+            m_table.reserve_id(count);
+        }
+        ~IdReserve() { m_table.release_id(); }
+        IdReserve(const IdReserve&) = delete;
+        IdReserve& operator=(const IdReserve&) = delete;
+    };
 
 // -- constructor
 
 public:
-    TableBase(): m_db(0), m_ticks(0) {};
+    TableBase(): m_db(0), m_data_version(0) {};
     virtual ~TableBase() {};
 
 // -- methods
@@ -81,6 +110,11 @@ public:
     bool ensure_table();
     void drop_table();
     int64 newId();
+    void reserve_id(std::size_t count) { m_id_block = TableId::reserve(count); }
+    void release_id() { m_id_block = TableId::Block(); }
+    auto table_name() const -> const wxString& { return m_table_name; }
+    auto data_version() const -> std::size_t { return m_data_version; }
+    void bump_data_version() { ++m_data_version; }
 
     template<typename... Args>
     void select_query(wxString& query, std::vector<int>& index_a, const Args&... args);
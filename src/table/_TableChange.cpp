@@ -0,0 +1,165 @@
+/*******************************************************
+ Copyright: (c) 2026      George Ef (george.a.ef@gmail.com)
+ ********************************************************/
+
+#include <algorithm>
+
+#include "_TableChange.h"
+
+void TableChange::add(OP op, int64 id, bool is_external)
+{
+    m_op_mask |= op;
+    m_is_external = m_is_external || is_external;
+    if (m_is_all)
+        return;
+
+    m_id_s.insert(id);
+    if (m_id_s.size() > s_id_cap) {
+        m_is_all = true;
+        m_id_s.clear();
+    }
+}
+
+void TableChange::merge(const TableChange& other)
+{
+    m_op_mask |= other.m_op_mask;
+    m_is_external = m_is_external || other.m_is_external;
+    m_is_all = m_is_all || other.m_is_all;
+    if (!m_is_all)
+        m_id_s.insert(other.m_id_s.begin(), other.m_id_s.end());
+    if (m_is_all || m_id_s.size() > s_id_cap) {
+        m_is_all = true;
+        m_id_s.clear();
+    }
+}
+
+// The instance is created on first use (by the first subscriber), such that
+// it is destroyed after all model singletons.
+TableChangeBus& TableChangeBus::instance()
+{
+    static TableChangeBus s_instance;
+    return s_instance;
+}
+
+int TableChangeBus::subscribe(Handler handler)
+{
+    int handle = m_next_handle++;
+    m_subscriber_a.push_back({handle, std::move(handler), 0});
+    return handle;
+}
+
+void TableChangeBus::unsubscribe(int handle)
+{
+    m_subscriber_a.erase(
+        std::remove_if(m_subscriber_a.begin(), m_subscriber_a.end(),
+            [handle](const Subscriber& sub) { return sub.m_handle == handle; }
+        ),
+        m_subscriber_a.end()
+    );
+}
+
+void TableChangeBus::record(TableChange::OP op, const wxString& table_name, int64 id)
+{
+    m_pending_m[table_name].add(op, id, m_own_c == 0);
+}
+
+// Move the pending changes to the committed changes.
+// Return true if publish() shall be scheduled, i.e., if there were no
+// committed changes waiting to be published.
+bool TableChangeBus::commit()
+{
+    if (m_pending_m.empty())
+        return false;
+
+    bool schedule = m_committed_a.empty();
+    if (m_committed_a.empty() || m_committed_a.back().m_is_delivered)
+        m_committed_a.push_back({m_next_serial++, false, {}});
+    TableChangeM& committed_m = m_committed_a.back().m_change_m;
+    for (const auto& [table_name, change] : m_pending_m)
+        committed_m[table_name].merge(change);
+    m_pending_m.clear();
+
+    return schedule;
+}
+
+void TableChangeBus::rollback()
+{
+    m_pending_m.clear();
+}
+
+// Merge the committed batches after serial.
+TableChangeM TableChangeBus::collect(std::size_t serial) const
+{
+    TableChangeM change_m;
+    for (const Batch& batch : m_committed_a) {
+        if (batch.m_serial <= serial)
+            continue;
+        for (const auto& [table_name, change] : batch.m_change_m)
+            change_m[table_name].merge(change);
+    }
+    return change_m;
+}
+
+void TableChangeBus::publish()
+{
+    if (m_committed_a.empty())
+        return;
+
+    // collect the changes of each subscriber before any handler is called;
+    // handlers may commit, subscribe or unsubscribe
+    std::vector<std::pair<Handler, TableChangeM>> call_a;
+    for (Subscriber& sub : m_subscriber_a) {
+        TableChangeM change_m = collect(sub.m_serial);
+        sub.m_serial = m_committed_a.back().m_serial;
+        if (!change_m.empty())
+            call_a.emplace_back(sub.m_handler, std::move(change_m));
+    }
+    m_committed_a.clear();
+
+    for (const auto& [handler, change_m] : call_a)
+        handler(change_m);
+}
+
+// Move the committed changes which have not been delivered to the subscriber
+// handle into change_m; they will not be delivered to it again.
+// Return the subscriber, or nullptr if handle is not subscribed.
+TableChangeBus::Subscriber* TableChangeBus::take(int handle, TableChangeM& change_m)
+{
+    auto it = std::find_if(m_subscriber_a.begin(), m_subscriber_a.end(),
+        [handle](const Subscriber& sub) { return sub.m_handle == handle; }
+    );
+    if (it == m_subscriber_a.end())
+        return nullptr;
+
+    change_m = collect(it->m_serial);
+    it->m_serial = m_committed_a.back().m_serial;
+    m_committed_a.back().m_is_delivered = true;
+    return &(*it);
+}
+
+// Deliver the committed changes to the subscriber handle only.
+void TableChangeBus::deliver(int handle)
+{
+    if (m_committed_a.empty())
+        return;
+
+    TableChangeM change_m;
+    Subscriber* sub_n = take(handle, change_m);
+    if (!sub_n || change_m.empty())
+        return;
+
+    // the handler may subscribe or unsubscribe
+    Handler handler = sub_n->m_handler;
+    handler(change_m);
+}
+
+// Drop the committed changes which have not been delivered to the subscriber
+// handle, without calling it.
+void TableChangeBus::skip(int handle)
+{
+    if (m_committed_a.empty())
+        return;
+
+    TableChangeM change_m;
+    take(handle, change_m);
+}
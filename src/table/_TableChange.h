@@ -0,0 +1,124 @@
+/*******************************************************
+ Copyright: (c) 2026      George Ef (george.a.ef@gmail.com)
+ ********************************************************/
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <unordered_set>
+#include <vector>
+#include <wx/string.h>
+
+#include "base/_types.h"
+
+// The changes committed to one table, as reported by the SQLite update hook.
+struct TableChange
+{
+    enum OP
+    {
+        e_insert = 1,
+        e_update = 2,
+        e_delete = 4,
+    };
+
+    // beyond this number of rows, only m_is_all is kept
+    static constexpr std::size_t s_id_cap = 1000;
+
+    int m_op_mask = 0;
+    // too many rows have changed; m_id_s is not complete
+    bool m_is_all = false;
+    // some rows have been changed with raw SQL, not through TableFactory;
+    // the cache of the table does not reflect these changes
+    bool m_is_external = false;
+    std::unordered_set<int64> m_id_s;
+
+    bool has_op(OP op) const { return (m_op_mask & op) != 0; }
+    void add(OP op, int64 id, bool is_external);
+    void merge(const TableChange& other);
+};
+
+// The changes committed to all tables, keyed by table name.
+using TableChangeM = std::map<wxString, TableChange>;
+
+// TableChangeBus collects the row changes reported by the update hook of the
+// main connection, coalesces them per commit, and publishes them to subscribers.
+// record() is called for each changed row, commit() and rollback() at the end
+// of each transaction (including each autocommit statement).
+// publish() delivers all committed changes since the previous call; it is
+// called from the event loop (not from the hooks), such that subscribers can
+// query the database. A subscriber which needs the committed changes before
+// they are published (e.g., to bring an index up to date within a read) calls
+// deliver() with its own handle; the other subscribers are not called, and
+// publish() does not deliver the same changes to it again. A subscriber which
+// has just reloaded all its data from the database calls skip() instead.
+// Changes within a savepoint which is rolled back (but the enclosing
+// transaction is committed) are published; subscribers only invalidate,
+// so this is harmless.
+// Deletions with the truncate optimization ("DELETE FROM table" without WHERE)
+// are not reported by SQLite. All methods shall be called from the main thread.
+class TableChangeBus
+{
+public:
+    using Handler = std::function<void(const TableChangeM&)>;
+
+    // Changes recorded while an OwnWrite is alive are made through TableFactory,
+    // which updates its cache itself.
+    struct OwnWrite
+    {
+        OwnWrite() { ++instance().m_own_c; }
+        ~OwnWrite() { --instance().m_own_c; }
+    };
+
+// -- state
+
+private:
+    struct Subscriber
+    {
+        int m_handle;
+        Handler m_handler;
+        std::size_t m_serial;   // last batch delivered to this subscriber
+    };
+
+    // Committed changes; a new batch is started after deliver(), such that
+    // each subscriber receives each change once.
+    struct Batch
+    {
+        std::size_t m_serial;
+        bool m_is_delivered;
+        TableChangeM m_change_m;
+    };
+
+    int m_own_c = 0;
+    int m_next_handle = 1;
+    std::size_t m_next_serial = 1;
+    std::vector<Subscriber> m_subscriber_a;
+    TableChangeM m_pending_m;
+    std::vector<Batch> m_committed_a;
+
+// -- constructor
+
+private:
+    TableChangeBus() {};
+
+public:
+    static auto instance() -> TableChangeBus&;
+
+// -- methods
+
+public:
+    int  subscribe(Handler handler);
+    void unsubscribe(int handle);
+
+    void record(TableChange::OP op, const wxString& table_name, int64 id);
+    bool commit();
+    void rollback();
+    bool has_pending() const { return !m_pending_m.empty(); }
+    void publish();
+    void deliver(int handle);
+    void skip(int handle);
+
+private:
+    auto collect(std::size_t serial) const -> TableChangeM;
+    auto take(int handle, TableChangeM& change_m) -> Subscriber*;
+};
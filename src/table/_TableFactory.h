@@ -10,6 +10,8 @@
 #pragma once
 
 #include "_TableBase.h"
+#include "_TableChange.h"
+#include "_TableWork.h"
 #include "base/mmCache.h"
 
 template<typename TableType, typename DataType>
@@ -37,17 +39,40 @@ public:
 
 protected:
     mmCache<int64, Data> m_cache;
+    int m_change_handle;
 
 // -- constructor
 
 public:
-    TableFactory<TableType, DataType>() : m_cache(mmCache<int64, Data>()) {};
-    ~TableFactory<TableType, DataType>() { m_cache.reset(); };
+    TableFactory<TableType, DataType>() : m_cache(mmCache<int64, Data>()) {
+        m_change_handle = TableChangeBus::instance().subscribe(
+            [this](const TableChangeM& change_m) {
+                auto it = change_m.find(this->m_table_name);
+                if (it != change_m.end())
+                    on_change(it->second);
+            }
+        );
+    };
+    ~TableFactory<TableType, DataType>() {
+        TableChangeBus::instance().unsubscribe(m_change_handle);
+        m_cache.reset();
+    };
 
 // -- methods
 
 public:
     // Methods starting with 'find_' bypass the cache; other methods use the cache.
+    // A pointer into the cache (returned by get_idN_data_n(), search_cache_n(),
+    // etc.) is valid until the record leaves the cache: when it is removed
+    // (unsafe_remove_id(), work_remove()), when the cache is reset (e.g., the
+    // database is closed), or when on_change() evicts it after a change made
+    // with raw SQL. on_change() runs from the event loop (publish()), but also
+    // synchronously within a read of a model which calls deliver() (e.g.,
+    // TrxModel::find_frequent_note_a()). Updates through this class modify
+    // the record in place and keep the pointer valid.
+    // Thus a pointer shall not be kept across event-loop turns (e.g., in a
+    // dialog or a panel), nor across calls into the models; keep the id, or
+    // a copy of Data, and look it up again.
     auto unsafe_get_idN_data_n(const int64 idN) -> Data*;
     auto get_idN_data_n(const int64 idN) -> const Data*;
     auto get_idN_data_n(wxLongLong_t idN) -> const Data* { return get_idN_data_n(int64(idN)); }
@@ -59,8 +84,13 @@ public:
     auto save_data_n(Data& data) -> const Data*;
     bool save_data_a(DataA& data);
     bool unsafe_remove_id(const int64 id);
+    bool work_add(TableWork& work, Data& data);
+    bool work_update(TableWork& work, const Data& data);
+    bool work_save(TableWork& work, Data& data);
+    bool work_remove(TableWork& work, const int64 id);
     void preload_cache(int max_size = 1000);
-    void reset_cache() { m_cache.reset(); }
+    void preload_cache(const DataA& data_a);
+    void reset_cache() { m_cache.reset(); this->bump_data_version(); }
     bool cache_empty() const { return m_cache.get_stat().max_size == 0; }
     auto stat_json() const -> const wxString;
     void debug_stat() const;
@@ -69,6 +99,8 @@ public:
     auto find_data_a(const Args&... clause_args) -> DataA;
     auto find_data_a() -> DataA;
     template<typename... Args>
+    auto find_db_data_a(wxSQLite3Database* db, const Args&... clause_args) -> DataA;
+    template<typename... Args>
     auto find_id_a(const Args&... clause_args) -> std::vector<int64>;
     auto find_id_a() -> std::vector<int64>;
     template<typename... Args>
@@ -99,6 +131,12 @@ public:
 
 // -- virtual
 
+    // Called with the committed changes to this table, from the event loop or
+    // from TableChangeBus::deliver().
+    // The default implementation removes from cache the rows which may have been
+    // changed with raw SQL (not through this class).
+    virtual void on_change(const TableChange& change);
+
     // Check if id in this table is used by other records (in this or other tables).
     // id in this table cannot be deleted if it is used by other records.
     // Records fully owned by id are ignored (they can be deleted together with id).
@@ -142,6 +180,25 @@ template<typename T, typename D>
 template<typename... Args>
 auto TableFactory<T, D>::find_data_a(const Args&... clause_args) -> DataA
 {
+    return find_db_data_a(this->m_db, clause_args...);
+}
+
+template<typename T, typename D>
+auto TableFactory<T, D>::find_data_a() -> DataA
+{
+    return find_data_a(TableClause::EMPTY());
+}
+
+// Same as find_data_a(), except that the query is executed on db (if not null),
+// instead of the connection of this table.
+// Since this method neither reads nor writes the cache, it can be called from a
+// worker thread with its own (read-only) connection.
+template<typename T, typename D>
+template<typename... Args>
+auto TableFactory<T, D>::find_db_data_a(
+    wxSQLite3Database* db,
+    const Args&... clause_args
+) -> DataA {
     static_assert(
         (std::is_base_of<TableClause, Args>::value && ...),
         "Args must derive from TableClause"
@@ -154,7 +211,7 @@ auto TableFactory<T, D>::find_data_a(const Args&... clause_args) -> DataA
         this->select_query(query, index_a, clause_args...);
         //wxLogDebug("TableFactory::find_data_a: query: [%s]", query);
 
-        wxSQLite3Statement stmt = this->m_db->PrepareStatement(query);
+        wxSQLite3Statement stmt = (db ? db : this->m_db)->PrepareStatement(query);
         this->bind_stmt(stmt, index_a, 0, clause_args...);
         wxSQLite3ResultSet q = stmt.ExecuteQuery();
 
@@ -174,12 +231,6 @@ auto TableFactory<T, D>::find_data_a(const Args&... clause_args) -> DataA
     return result;
 }
 
-template<typename T, typename D>
-auto TableFactory<T, D>::find_data_a() -> DataA
-{
-    return find_data_a(TableClause::EMPTY());
-}
-
 // Return the results of the following query:
 //   SELECT ${PRIMARY} FROM ${TABLE} ${clause_args}
 // clause_args may contain _WHERE, _PAREN, _ORDER, _LIMIT clauses, as in find_data_a().
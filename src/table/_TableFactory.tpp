@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "_TableFactory.h"
 #include "base/mmCache.tpp"
 
@@ -93,6 +95,7 @@ auto TableFactory<T, D>::add_data_n(Data& data) -> const Data*
     }
 
     try {
+        TableChangeBus::OwnWrite own;
         wxSQLite3Statement stmt = this->m_db->PrepareStatement(this->m_insert_query);
         int64 id = this->newId();
         data.to_insert_stmt(stmt, id);
@@ -107,6 +110,7 @@ auto TableFactory<T, D>::add_data_n(Data& data) -> const Data*
         return nullptr;
     }
 
+    this->bump_data_version();
     return m_cache.add(data.id(), data);
 }
 
@@ -116,6 +120,7 @@ template<typename T, typename D>
 bool TableFactory<T, D>::add_data_a(DataA& data_a)
 {
     bool ok = true;
+    TableBase::IdReserve id_reserve(*this, data_a.size());
     this->db_savepoint();
     for (auto& data : data_a) {
         if (!add_data_n(data)) {
@@ -136,6 +141,7 @@ template<typename T, typename D>
 auto TableFactory<T, D>::unsafe_update_data_n(Data* data) -> Data*
 {
     try {
+        TableChangeBus::OwnWrite own;
         wxSQLite3Statement stmt = this->m_db->PrepareStatement(this->m_update_query);
         data->to_update_stmt(stmt);
         stmt.ExecuteUpdate();
@@ -148,6 +154,8 @@ auto TableFactory<T, D>::unsafe_update_data_n(Data* data) -> Data*
         return nullptr;
     }
 
+    this->bump_data_version();
+
     // no need to update the cache. data shall point into cache and the caller
     // updated directly the Data record in cache before this call.
     // nevertheless, the input argument is not specified as const. in the future,
@@ -171,6 +179,7 @@ auto TableFactory<T, D>::update_data_n(Data& data) -> const Data*
     }
 
     try {
+        TableChangeBus::OwnWrite own;
         wxSQLite3Statement stmt = this->m_db->PrepareStatement(this->m_update_query);
         data.to_update_stmt(stmt);
         stmt.ExecuteUpdate();
@@ -185,6 +194,7 @@ auto TableFactory<T, D>::update_data_n(Data& data) -> const Data*
 
     // data is not modified, but see comments in unsafe_update_data_n().
 
+    this->bump_data_version();
     return m_cache.set(data.id(), data);
 }
 
@@ -222,6 +232,9 @@ bool TableFactory<T, D>::save_data_a(DataA& data_a)
 {
     bool ok = true;
 
+    TableBase::IdReserve id_reserve(*this, std::count_if(data_a.begin(), data_a.end(),
+        [](const Data& data) { return data.id() <= 0; }
+    ));
     this->db_savepoint();
     for (Data& data : data_a) {
         if (!save_data_n(data)) {
@@ -251,6 +264,7 @@ bool TableFactory<T, D>::unsafe_remove_id(const int64 id)
     m_cache.remove(id);
 
     try {
+        TableChangeBus::OwnWrite own;
         wxSQLite3Statement stmt = this->m_db->PrepareStatement(this->m_delete_query);
         stmt.Bind(1, id);
         stmt.ExecuteUpdate();
@@ -263,9 +277,94 @@ bool TableFactory<T, D>::unsafe_remove_id(const int64 id)
         return false;
     }
 
+    this->bump_data_version();
+    return true;
+}
+
+// Queue the insertion of a new Data record in work.
+// data gets a new id immediately; the record is added in cache after work is flushed.
+// Return false if data already has an id.
+template<typename T, typename D>
+bool TableFactory<T, D>::work_add(TableWork& work, Data& data)
+{
+    if (data.id() > 0) {
+        wxLogError("%s: Cannot add existing %s",
+            this->m_table_name, data.to_json().utf8_str()
+        );
+        return false;
+    }
+
+    data.id(this->newId());
+    auto data_p = std::make_shared<const Data>(data);
+    work.add_op(this, TableWork::e_insert,
+        [data_p](wxSQLite3Statement& stmt) { data_p->to_insert_stmt(stmt, data_p->id()); },
+        [this, data_p]() { m_cache.add(data_p->id(), *data_p); }
+    );
+    return true;
+}
+
+// Queue the update of an existing Data record in work.
+// data is copied; it is added or updated in cache after work is flushed.
+template<typename T, typename D>
+bool TableFactory<T, D>::work_update(TableWork& work, const Data& data)
+{
+    if (data.id() <= 0) {
+        wxLogError("%s: Cannot update non-existing %s",
+            this->m_table_name, data.to_json().utf8_str()
+        );
+        return false;
+    }
+
+    auto data_p = std::make_shared<const Data>(data);
+    work.add_op(this, TableWork::e_update,
+        [data_p](wxSQLite3Statement& stmt) { data_p->to_update_stmt(stmt); },
+        [this, data_p]() { m_cache.set(data_p->id(), *data_p); }
+    );
     return true;
 }
 
+template<typename T, typename D>
+bool TableFactory<T, D>::work_save(TableWork& work, Data& data)
+{
+    return (data.id() <= 0) ? work_add(work, data) : work_update(work, data);
+}
+
+// Queue the removal of a Data record in work.
+// id is removed from cache after work is flushed.
+// As in unsafe_remove_id(), the caller shall also remove all auxiliary data.
+template<typename T, typename D>
+bool TableFactory<T, D>::work_remove(TableWork& work, const int64 id)
+{
+    if (id <= 0) {
+        wxLogError("%s: Cannot remove id %lld", this->m_table_name, id.GetValue());
+        return false;
+    }
+
+    work.add_op(this, TableWork::e_delete,
+        [id](wxSQLite3Statement& stmt) { stmt.Bind(1, id); },
+        [this, id]() { m_cache.remove(id); }
+    );
+    return true;
+}
+
+// Evict the records changed with raw SQL; they are loaded again on next use.
+// Pointers to the evicted records become invalid (see get_idN_data_n()).
+template<typename T, typename D>
+void TableFactory<T, D>::on_change(const TableChange& change)
+{
+    if (!change.m_is_external)
+        return;
+
+    if (change.m_is_all) {
+        m_cache.reset();
+    }
+    else {
+        for (const int64& id : change.m_id_s)
+            m_cache.remove(id);
+    }
+    this->bump_data_version();
+}
+
 // Preload cache with up to max_size Data records.
 template<typename T, typename D>
 void TableFactory<T, D>::preload_cache(int max_size)
@@ -284,6 +383,15 @@ void TableFactory<T, D>::preload_cache(int max_size)
     }
 }
 
+// Preload cache with Data records fetched in advance (e.g., by a worker thread
+// on its own connection). Records which are already in cache are not replaced.
+template<typename T, typename D>
+void TableFactory<T, D>::preload_cache(const DataA& data_a)
+{
+    for (const Data& data : data_a)
+        m_cache.add(data.id(), data);
+}
+
 // Return cache statistics as a json string.
 template<typename T, typename D>
 auto TableFactory<T, D>::stat_json() const -> const wxString
@@ -0,0 +1,62 @@
+/*******************************************************
+ Copyright: (c) 2026      George Ef (george.a.ef@gmail.com)
+ ********************************************************/
+
+#include <chrono>
+
+#include "_TableId.h"
+
+// -- static
+
+std::mutex TableId::s_mutex;
+int64 TableId::s_ticks = 0;
+std::mt19937 TableId::s_gen = std::mt19937(std::random_device()());
+
+int64 TableId::now_ticks()
+{
+    return static_cast<wxLongLong_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count()
+    );
+}
+
+// s_mutex shall be locked by the caller.
+int TableId::next_suffix()
+{
+    return std::uniform_int_distribution<int>(0, 999)(s_gen);
+}
+
+int64 TableId::next_id()
+{
+    int64 ticks = now_ticks();
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    // ensure uniqueness from last generated value
+    if (ticks <= s_ticks)
+        ticks = s_ticks + 1;
+    s_ticks = ticks;
+
+    return ticks * 1000 + next_suffix();
+}
+
+// Reserve count consecutive ticks. The ids can be taken from the returned
+// block without locking; ids which are not taken are lost.
+TableId::Block TableId::reserve(std::size_t count)
+{
+    if (count == 0)
+        return Block();
+
+    int64 ticks = now_ticks();
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (ticks <= s_ticks)
+        ticks = s_ticks + 1;
+    s_ticks = ticks + static_cast<wxLongLong_t>(count) - 1;
+
+    Block block;
+    block.m_ticks  = ticks;
+    block.m_end    = ticks + static_cast<wxLongLong_t>(count);
+    block.m_suffix = next_suffix();
+    return block;
+}
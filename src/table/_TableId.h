@@ -0,0 +1,49 @@
+/*******************************************************
+ Copyright: (c) 2026      George Ef (george.a.ef@gmail.com)
+ ********************************************************/
+
+#pragma once
+
+#include <mutex>
+#include <random>
+
+#include "base/_types.h"
+
+// TableId allocates primary keys for all tables.
+// An id has the form ticks * 1000 + suffix, where ticks is the time in
+// milliseconds since the epoch and suffix is a random number in [0, 999],
+// as expected by the mobile apps (ids created on different devices are
+// unlikely to collide). The ticks of successive ids are strictly increasing,
+// also across tables and threads; if ids are requested faster than the clock
+// advances, the ticks run ahead of the clock.
+// The random generator is seeded once; next_id() does not make system calls
+// apart from reading the clock.
+class TableId
+{
+public:
+    // A block of ids reserved in advance, e.g., by a bulk import.
+    // The ids in a block share the same suffix.
+    struct Block
+    {
+        int64 m_ticks = 0;
+        int64 m_end = 0;
+        int m_suffix = 0;
+
+        bool empty() const { return m_ticks >= m_end; }
+        auto take() -> int64 { return (m_ticks++) * 1000 + m_suffix; }
+    };
+
+// -- static
+
+private:
+    static std::mutex s_mutex;
+    static int64 s_ticks;
+    static std::mt19937 s_gen;
+
+    static auto now_ticks() -> int64;
+    static auto next_suffix() -> int;
+
+public:
+    static auto next_id() -> int64;
+    static auto reserve(std::size_t count) -> Block;
+};
@@ -0,0 +1,86 @@
+/*******************************************************
+ Copyright: (c) 2026      George Ef (george.a.ef@gmail.com)
+ ********************************************************/
+
+#include <map>
+#include <utility>
+
+#include "_TableBase.h"
+#include "_TableChange.h"
+#include "_TableWork.h"
+
+void TableWork::add_op(
+    TableBase* table,
+    QUERY query,
+    std::function<void(wxSQLite3Statement&)> bind,
+    std::function<void()> apply
+) {
+    m_op_a.push_back({table, query, std::move(bind), std::move(apply)});
+}
+
+// Execute all operations in a single savepoint, and then update the caches.
+// Return false in case of error; in that case the database and the caches
+// are not modified. The work is empty after this call.
+bool TableWork::flush()
+{
+    if (m_op_a.empty())
+        return true;
+
+    // all tables share the same connection
+    wxSQLite3Database* db = m_op_a.front().m_table->m_db;
+    std::map<std::pair<TableBase*, QUERY>, wxSQLite3Statement> stmt_m;
+    const Op* op_n = nullptr;
+
+    TableChangeBus::OwnWrite own;
+    db->Savepoint("WORK");
+    try {
+        for (const Op& op : m_op_a) {
+            op_n = &op;
+            auto key = std::make_pair(op.m_table, op.m_query);
+            auto it = stmt_m.find(key);
+            if (it == stmt_m.end()) {
+                const wxString& query =
+                    op.m_query == e_insert ? op.m_table->m_insert_query :
+                    op.m_query == e_update ? op.m_table->m_update_query :
+                    op.m_table->m_delete_query;
+                it = stmt_m.emplace(key, db->PrepareStatement(query)).first;
+            }
+            else {
+                it->second.Reset();
+                it->second.ClearBindings();
+            }
+            op.m_bind(it->second);
+            it->second.ExecuteUpdate();
+        }
+
+        for (auto& [key, stmt] : stmt_m)
+            stmt.Finalize();
+        db->ReleaseSavepoint("WORK");
+    }
+    catch (const wxSQLite3Exception &e) {
+        wxLogError("%s: Exception %s",
+            op_n ? op_n->m_table->m_table_name : wxString("TableWork"),
+            e.GetMessage().utf8_str()
+        );
+        try {
+            for (auto& [key, stmt] : stmt_m)
+                stmt.Finalize();
+            db->Rollback("WORK");
+            db->ReleaseSavepoint("WORK");
+        }
+        catch (const wxSQLite3Exception &e) {
+            wxLogError("TableWork: Exception %s", e.GetMessage().utf8_str());
+        }
+        m_op_a.clear();
+        return false;
+    }
+
+    // the cache is a subset of the database; update it after the database
+    for (const Op& op : m_op_a) {
+        op.m_apply();
+        op.m_table->bump_data_version();
+    }
+
+    m_op_a.clear();
+    return true;
+}
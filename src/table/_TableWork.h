@@ -0,0 +1,66 @@
+/*******************************************************
+ Copyright: (c) 2026      George Ef (george.a.ef@gmail.com)
+ ********************************************************/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <wx/wxsqlite3.h>
+
+struct TableBase;
+
+// TableWork collects write operations (insert, update, delete) on one or more
+// tables, and executes them in a single savepoint when flush() is called.
+// Operations are added with TableFactory::work_add(), work_update(),
+// work_save(), work_remove(), and they are executed in the same order.
+// A statement is prepared once for each (table, query) and it is reused for
+// all operations of the same kind.
+// The cache of each table is updated only after the savepoint is released.
+// In case of error the savepoint is rolled back, and no cache is modified.
+// A new Data record gets its id when it is added to the work (not when the work
+// is flushed), such that dependent records can refer to it.
+// Operations which are not flushed are discarded when the work is destroyed.
+class TableWork
+{
+// -- state
+
+public:
+    enum QUERY
+    {
+        e_insert = 0,
+        e_update,
+        e_delete,
+    };
+
+private:
+    struct Op
+    {
+        TableBase* m_table;
+        QUERY m_query;
+        std::function<void(wxSQLite3Statement&)> m_bind;
+        std::function<void()> m_apply;
+    };
+
+    std::vector<Op> m_op_a;
+
+// -- constructor
+
+public:
+    TableWork() {};
+    ~TableWork() {};
+
+// -- methods
+
+public:
+    void add_op(
+        TableBase* table,
+        QUERY query,
+        std::function<void(wxSQLite3Statement&)> bind,
+        std::function<void()> apply
+    );
+    bool empty() const { return m_op_a.empty(); }
+    auto size() const -> std::size_t { return m_op_a.size(); }
+    void clear() { m_op_a.clear(); }
+    bool flush();
+};
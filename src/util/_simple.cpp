@@ -211,6 +211,18 @@ void mmErrorDialogs::MessageWarning(wxWindow *parent
     msgDlg.ShowModal();
 }
 
+// A TableWork could not be flushed; the database has not been modified.
+void mmErrorDialogs::MessageSaveFailed(wxWindow *parent)
+{
+    MessageError(parent, SaveFailedText(), _t("Database Error"));
+}
+
+// The text of MessageSaveFailed(), for callers which show it in their own way.
+wxString mmErrorDialogs::SaveFailedText()
+{
+    return _t("The changes could not be saved to the database.");
+}
+
 void mmErrorDialogs::MessageInvalid(wxWindow *parent, const wxString &message)
 {
     const wxString& msg = wxString::Format(_t("Entry %s is invalid"), message, wxICON_ERROR);
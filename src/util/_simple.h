@@ -92,6 +92,8 @@ public:
     static void MessageInvalid(wxWindow *parent, const wxString &message);
     static void MessageError(wxWindow *parent, const wxString &message, const wxString &title);
     static void MessageWarning(wxWindow *parent, const wxString &message, const wxString &title);
+    static void MessageSaveFailed(wxWindow *parent);
+    static auto SaveFailedText() -> wxString;
     static void InvalidCategory(wxWindow *button);
     static void InvalidAccount(wxWindow *object, bool transfer = false, TOOL_TIP tm = MESSAGE_DROPDOWN_BOX);
     static void InvalidFile(wxWindow *object, bool open = false);
@@ -28,6 +28,8 @@
 #include "_util.h"
 
 #include <map>
+#include <future>
+#include <chrono>
 #include <cwchar>
 #include <locale>
 #include <lua.hpp>
@@ -38,6 +40,7 @@
 #include <wx/fs_mem.h>
 #include <wx/webview.h>
 #include <wx/dataview.h>
+#include <wx/progdlg.h>
 
 #include "build.h"
 #include "base/_constants.h"
@@ -45,6 +48,7 @@
 #include "base/mmUserColor.h"
 #include "table/_TableUpgrade.h"
 #include "mmCalcValidator.h"
+#include "mmDateMask.h"
 #include "mmPath.h"
 #include "mmImage.h"
 #include "_simple.h"
@@ -324,6 +328,11 @@ bool getNewsRSS(std::vector<WebsiteNews>& news_a)
     if (http_get_data(mmex::weblink::NewsRSS, rssContent) != CURLE_OK)
         return false;
 
+    return parseNewsRSS(rssContent, news_a);
+}
+
+bool parseNewsRSS(const wxString& rssContent, std::vector<WebsiteNews>& news_a)
+{
     // simple validation to avoid bug #1083
     if (!rssContent.Contains("</rss>"))
         return false;
@@ -559,104 +568,31 @@ const wxString mmGetTimeForDisplay(const wxString& isoDateTime)
         : wxString("00:00:00");
 }
 
+// Parse a date string with a date format, like "%d/%m/%Y".
+// The format is compiled once into an mmDateMask; see mmDateMask.h.
 bool mmParseDisplayStringToDate(
     wxDateTime& date,
     const wxString& str_date,
     const wxString& sDateMask
 ) {
-    if (date_formats_regex().count(sDateMask) == 0)
-        return false;
-
-    wxString date_str = str_date;
-    wxString mask_str = sDateMask;
-
-    static std::unordered_map<wxString, wxDateTime> cache;
-    if (const auto it = cache.find(str_date); it != cache.end()) {
-        date = it->second;
-        return true;
-    }
-
-    wxString regex = date_formats_regex().at(mask_str);
-    wxRegEx pattern(regex);
-
-    if (pattern.Matches(str_date)) {
-        if (mask_str.Contains("%w")) {
-            mask_str.Replace("%w ", "");
-            regex = R"(^(\D*))";
-            pattern.Compile(regex);
-            pattern.ReplaceAll(&date_str, "");
-        }
-
-        if (mask_str.Contains("Mon")) {
-
-            static std::map<wxString, wxString> monCache;
-            if (monCache.empty()) {
-                int i = 1;
-                for (const auto& m : MONTHS_SHORT) {
-                    monCache[m] = wxString::Format("%02d", i);
-                    monCache[wxGetTranslation(m)] = wxString::Format("%02d", i);
-                    i++;
-                }
-            }
-
-            regex = R"([^\d\s\'\-]{3})";
-            pattern.Compile(regex);
-            wxString month;
-            if (pattern.Matches(date_str)) {
-                month = pattern.GetMatch(date_str);
-            }
-
-            bool is_month_ok = false;
-            for (const auto& i : monCache) {
-                if (month.CmpNoCase(i.first) == 0) {
-                    date_str.Replace(month, i.second);
-                    mask_str.Replace("%Mon", "%m");
-                    is_month_ok = true;
-                    break;
-                }
-            }
-
-            if (!is_month_ok)
-                return false;
-
-            wxRegEx pattern2(R"([^%dmyY])");
-            pattern2.ReplaceAll(&mask_str, " ");
-            if (date_formats_regex().find(mask_str) != date_formats_regex().end())
-                regex = date_formats_regex().at(mask_str);
-            else
-                return false;
-
-            wxRegEx pattern3(R"([^0-9])");
-            pattern3.ReplaceAll(&date_str, " ");
-        }
-
-        pattern.Compile(regex);
-        if (pattern.Matches(date_str)) {
-            date_str = pattern.GetMatch(date_str);
-            date_str.Trim(false);
-            const auto& date_formats = g_date_formats_map();
-            const auto it2 = std::find_if(date_formats.begin(), date_formats.end(),
-                [&mask_str](const std::pair<wxString, wxString>& element) {
-                    return element.first == mask_str;
-                }
-            );
-            if (!it2->second.Contains(" ")) {
-                date_str.Replace(" ", "");
-            }
+    const bool ok = mmDateMask::parse(date, str_date, sDateMask);
+    wxLogDebug("String:%s Mask:%s OK:%s ISO:%s",
+        str_date,
+        sDateMask,
+        wxString(ok ? "true" : "false"),
+        ok ? date.FormatISODate() : wxString("")
+    );
+    return ok;
+}
 
-            wxString::const_iterator end;
-            bool t = date.ParseFormat(date_str, mask_str, &end);
-            wxLogDebug("String:%s Mask:%s OK:%s ISO:%s Pattern:%s",
-                str_date,
-                sDateMask,
-                wxString(t ? "true" : "false"),
-                date.FormatISODate(),
-                regex
-            );
-            return t;
-        }
-    }
-    return false;
+// Parse a column of date strings with the same format.
+// Return the number of strings which cannot be parsed; see mmDateMask::parse_a().
+int mmParseDisplayStringToDate_a(
+    std::vector<wxDateTime>& date_a,
+    const wxArrayString& str_a,
+    const wxString& sDateMask
+) {
+    return mmDateMask::parse_a(date_a, str_a, sDateMask);
 }
 
 const wxDateTime getUserDefinedFinancialYear(const bool prevDayRequired)
@@ -676,41 +612,6 @@ const wxDateTime getUserDefinedFinancialYear(const bool prevDayRequired)
     return financialYear;
 }
 
-const std::map<wxString, wxString>& date_formats_regex()
-{
-    static std::map<wxString, wxString> format_re_m;
-    if (!format_re_m.empty())
-        return format_re_m;
-
-    // First time this function is called, fill the map.
-    const wxString week = "([^0-9]{3})";
-    const wxString mon  = "([^0-9]{3})";
-    const wxString dd   = "((([0 ][1-9])|([1-2][0-9])|(3[0-1]))|([1-9]))";
-    const wxString mm   = "((([0 ][1-9])|(1[0-2]))|([1-9]))";
-    const wxString yy   = "(([ ][0-9])|([0-9]{1,2}))";
-    const wxString yyyy = "(((19)|([2]([0]{1})))([0-9]{2}))";
-    const wxString tail = "($|[^0-9])+";
-    const wxString head = "^";
-
-    for (const auto& format_mask : g_date_formats_map()) {
-        wxString re = format_mask.first;
-        re.Replace(".",    R"([.])");
-        re.Replace("/",    R"(\/)");
-        re.Replace(" ",    R"(\s)");
-        re.Replace("%Mon", mon);
-        re.Replace("%w",   week);
-        re.Replace("%d",   dd);
-        re.Replace("%m",   mm);
-        re.Replace("%Y",   yyyy);
-        re.Replace("%y",   yy);
-        re.Append(tail);
-        re.Prepend(head);
-        format_re_m[format_mask.first] = re;
-    }
-
-    return format_re_m;
-}
-
 bool comp(const std::pair<wxString, wxString>& a, const std::pair<wxString, wxString>& b)
 {
 
@@ -773,23 +674,22 @@ END_EVENT_TABLE()
 
 //--------------------------------------------------------------------
 
-// CHECK: used_only has wrong name
-bool getOnlineCurrencyRates(wxString& msg, const int64 currency_id, const bool used_only)
+// Collect the currencies to update and their current rates.
+// If currency_id is positive, only that currency is updated; otherwise only
+// the currencies which are used.
+bool CurrencyRateUpdate::prepare(wxString& msg, int64 currency_id, bool used_only)
 {
-    wxString base_currency_symbol;
-
-    if (!CurrencyModel::instance().get_base_symbol(base_currency_symbol)) {
+    m_used_only = used_only;
+    if (!CurrencyModel::instance().get_base_symbol(m_base_symbol)) {
         msg = _t("Unable to find base currency symbol!");
         return false;
     }
 
-    std::map<wxString, double> symbol_rate_m;
     mmDate today = mmDate::today();
-
-    CurrencyModel::DataA currency_a = CurrencyModel::instance().find_data_a(
-        CurrencyCol::WHERE_CURRENCY_SYMBOL(OP_NE, base_currency_symbol)
+    m_currency_a = CurrencyModel::instance().find_data_a(
+        CurrencyCol::WHERE_CURRENCY_SYMBOL(OP_NE, m_base_symbol)
     );
-    for (const CurrencyData& currency_d : currency_a) {
+    for (const CurrencyData& currency_d : m_currency_a) {
         if (currency_id > 0 && currency_d.m_id != currency_id)
             continue;
         if (currency_id < 0 && !CurrencyModel::instance().find_id_isUsed(currency_d.m_id, true))
@@ -799,57 +699,46 @@ bool getOnlineCurrencyRates(wxString& msg, const int64 currency_id, const bool u
         if (symbol.IsEmpty())
             continue;
 
-        symbol_rate_m[symbol] = CurrencyHistoryModel::instance().get_id_date_rate(
+        m_symbol_rate_m[symbol] = CurrencyHistoryModel::instance().get_id_date_rate(
             currency_d.m_id, today
         );
     }
 
-    if (symbol_rate_m.empty()) {
+    if (m_symbol_rate_m.empty()) {
         msg = _t("Nothing to update");
         return false;
     }
 
-    wxString output;
-    std::map<wxString, double> new_symbol_rate_m;
-
-    get_yahoo_prices(
-        symbol_rate_m, new_symbol_rate_m, base_currency_symbol, output, yahoo_price_type::FIAT
-    );
-
-    // fallback to coincap if some currencies were not found
-    double usd_conv_rate = -1;
-    for (const auto & symbol_rate : symbol_rate_m) {
-        if (new_symbol_rate_m.find(symbol_rate.first) != new_symbol_rate_m.end() ||
-            g_fiat_curr().Contains(symbol_rate.first)
-        )
-            continue;
+    // coincap prices are in USD; they can't be used without USD
+    const CurrencyData* usd_n = CurrencyModel::instance().get_symbol_data_n("USD");
+    m_usd_rate = usd_n ? usd_n->m_base_conv_rate : -1;
+    m_config = mmQuote::Config::from_settings();
+    return true;
+}
 
-        wxString coincap_id;
-        wxString coincap_msg;
-        double coincap_price_usd;
-        if (
-            getCoincapInfoFromSymbol(
-                symbol_rate.first, coincap_id, coincap_price_usd, coincap_msg
-            ) &&
-            coincap_price_usd > 0
-        ) {
-            if (usd_conv_rate < 0) {
-                auto usd = CurrencyModel::instance().get_symbol_data_n("USD");
-                // can't use coincap without USD, since all prices are in USD so give up
-                if (usd == nullptr) {
-                    break;
-                }
-                usd_conv_rate = usd->m_base_conv_rate;
-            }
+// Download the new rates. This function does not use the models; it can be
+// called on a worker thread.
+auto CurrencyRateUpdate::fetch() const -> mmQuote::Result
+{
+    std::vector<wxString> symbol_a;
+    for (const auto& symbol_rate : m_symbol_rate_m)
+        symbol_a.push_back(symbol_rate.first);
+    return mmQuote::fetch_rates(m_config, symbol_a, m_base_symbol, m_usd_rate);
+}
 
-            new_symbol_rate_m[symbol_rate.first] = coincap_price_usd * usd_conv_rate;
-        }
-    }
+// Queue in work the new rates in result, and describe them in msg.
+void CurrencyRateUpdate::work_apply(
+    TableWork& work,
+    const mmQuote::Result& result,
+    wxString& msg
+) {
+    mmQuote::save_session(result);
+    const std::map<wxString, double>& new_symbol_rate_m = result.m_price_m;
 
     const auto b = CurrencyModel::instance().get_base_data_n();
     msg << _t("Currency rates have been updated");
     msg << "\n\n";
-    for (const auto & symbol_rate : symbol_rate_m) {
+    for (const auto & symbol_rate : m_symbol_rate_m) {
         const wxString old_rate_s(fmt::format("{:>{}}",
             fmt::string_view(CurrencyModel::instance().toString(
                 symbol_rate.second, b, 4
@@ -861,11 +750,11 @@ bool getOnlineCurrencyRates(wxString& msg, const int64 currency_id, const bool u
             10
         ));
 
-        if (new_symbol_rate_m.find(symbol_rate.first) != new_symbol_rate_m.end()) {
-            auto new_rate = new_symbol_rate_m[symbol_rate.first];
+        auto it = new_symbol_rate_m.find(symbol_rate.first);
+        if (it != new_symbol_rate_m.end()) {
             const wxString new_rate_s(fmt::format("{:>{}}",
                 fmt::string_view(
-                    CurrencyModel::instance().toString(new_rate, b, 4).mb_str()
+                    CurrencyModel::instance().toString(it->second, b, 4).mb_str()
                 ),
                 20
             ));
@@ -876,25 +765,29 @@ bool getOnlineCurrencyRates(wxString& msg, const int64 currency_id, const bool u
         }
     }
 
-    CurrencyModel::instance().db_savepoint();
-    CurrencyHistoryModel::instance().db_savepoint();
-    for (auto& currency_d : currency_a) {
+    mmDate today = mmDate::today();
+    for (const auto& prepared_d : m_currency_a) {
+        // the currency may have been changed since prepare()
+        const CurrencyData* currency_n = CurrencyModel::instance().get_idN_data_n(prepared_d.m_id);
+        if (!currency_n)
+            continue;
+        CurrencyData currency_d = *currency_n;
+
         // CHECK: used_only has wrong name
-        if (!used_only && !CurrencyModel::instance().find_id_isUsed(currency_d.m_id, true))
+        if (!m_used_only && !CurrencyModel::instance().find_id_isUsed(currency_d.m_id, true))
             continue;
 
         const wxString symbol = currency_d.m_symbol;
-        if (symbol.IsEmpty() ||
-            new_symbol_rate_m.find(symbol) == new_symbol_rate_m.end()
-        )
+        auto it = new_symbol_rate_m.find(symbol);
+        if (symbol.IsEmpty() || it == new_symbol_rate_m.end())
             continue;
 
-        double new_rate = new_symbol_rate_m[symbol];
+        double new_rate = it->second;
         if (new_rate <= 0)
             continue;
 
         if (PrefModel::instance().getUseCurrencyHistory()) {
-            CurrencyHistoryModel::instance().save_record(
+            CurrencyHistoryModel::instance().work_save_record(work,
                 currency_d.m_id,
                 today,
                 new_rate,
@@ -903,188 +796,46 @@ bool getOnlineCurrencyRates(wxString& msg, const int64 currency_id, const bool u
         }
         else {
             currency_d.m_base_conv_rate = new_rate;
-            CurrencyModel::instance().save_data_n(currency_d);
+            CurrencyModel::instance().work_update(work, currency_d);
         }
     }
-    CurrencyModel::instance().db_release_savepoint();
-    CurrencyHistoryModel::instance().db_release_savepoint();
-
-    return true;
 }
 
-/* Currencies & stock prices */
-
-bool get_yahoo_prices(
-    std::map<wxString, double>& symbols,
-    std::map<wxString, double>& out,
-    const wxString& base_currency_symbol,
-    wxString& output,
-    int type
+// CHECK: used_only has wrong name
+bool getOnlineCurrencyRates(
+    wxString& msg, const int64 currency_id, const bool used_only, wxWindow* parent
 ) {
-    double conversion_factor = 1.0;
-    wxString buffer;
-
-    wxString base_curr_symbol = base_currency_symbol;
-    if (type == yahoo_price_type::FIAT &&
-        !wxString("USD|EUR|GBP").Contains(base_currency_symbol)
-    ) {
-        base_curr_symbol = "USD";
-        buffer += wxString::Format("%s%s=X,", base_currency_symbol, base_curr_symbol);
-    }
-
-    for (const auto& entry : symbols) {
-        wxRegEx pattern(R"(^([\^-a-zA-Z0-9_@=\.]+)$)");
-        if (!pattern.Matches(entry.first))
-            continue;
-
-        if (type == yahoo_price_type::FIAT) {
-            if (g_fiat_curr().Contains(entry.first))
-                buffer += wxString::Format("%s%s=X,", entry.first, base_curr_symbol);
-            else
-                buffer += wxString::Format("%s-%s,", entry.first, base_curr_symbol);
-        }
-        else {
-            buffer += entry.first + ",";
-        }
-    }
-
-    if (buffer.Right(1).Contains(",")) {
-        buffer.RemoveLast(1);
-    }
-
-    const auto URL = wxString::Format(mmex::weblink::YahooQuotes, buffer);
-
-    wxString json_data;
-    auto err_code = getYahooFinanceQuotes(URL, json_data);
-    if (err_code != CURLE_OK) {
-        output = json_data;
+    CurrencyRateUpdate update;
+    if (!update.prepare(msg, currency_id, used_only))
         return false;
-    }
 
-    Document json_doc;
-    if (json_doc.Parse(json_data.utf8_str()).HasParseError()) {
-        output = _t("JSON Parse Error");
-        return false;
-    }
-
-    /*
+    // the caller waits for the result, but the download and the parsing run
+    // on a worker thread; the GUI is kept responsive by a modal progress dialog
+    std::future<mmQuote::Result> task = std::async(std::launch::async,
+        [&update]() { return update.fetch(); }
+    );
     {
-        "finance":{
-            "result":null,
-            "error":{
-                "code":"Bad Request",
-                "description":"Missing required query parameter=symbols"
-            }
-        }
-    }
-    */
-
-    if (json_doc.HasMember("finance") && json_doc["finance"].IsObject()) {
-        Value e = json_doc["finance"].GetObject();
-        if (e.HasMember("error")) {
-            if (e["error"].IsObject()) {
-                Value err = e["error"].GetObject();
-                if (err.HasMember("description") && err["description"].IsString()) {
-                    output = wxString::FromUTF8(err["description"].GetString());
-                    return false;
-                }
-            }
-        }
+        wxProgressDialog progressDlg(
+            _tu("Please wait…"),
+            _tu("Downloading currency rates…"),
+            100, parent,
+            wxPD_APP_MODAL | wxPD_AUTO_HIDE
+        );
+        while (task.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+            progressDlg.Pulse();
     }
+    mmQuote::Result result = task.get();
 
-    /*{"quoteResponse":{"result":[{"currency":"USD","regularMarketPrice":173.57,"shortName":"Apple Inc.","regularMarketTime":1683316804,"symbol":"AAPL"}],"error":null}}*/
-
-    if (json_doc.HasMember("quoteResponse") && json_doc["quoteResponse"].IsObject()) {
-        Value r = json_doc["quoteResponse"].GetObject();
-        if (r.HasMember("result") && r["result"].IsArray()) {
-            Value e = r["result"].GetArray();
-
-            if (e.Empty()) {
-                output = _t("Nothing to update");
-                return false;
-            }
-
-            if (type == yahoo_price_type::FIAT)
-            {
-                for (rapidjson::SizeType i = 0; i < e.Size(); i++)
-                {
-                    if (!e[i].IsObject()) continue;
-                    Value v = e[i].GetObject();
-
-                    if (!v.HasMember("symbol") || !v["symbol"].IsString())
-                        continue;
-                    auto currency_symbol = wxString::FromUTF8(v["symbol"].GetString());
-
-                    double price = 0.0;
-                    wxRegEx pattern("^([A-Z]{3})[A-Z]{3}=X$");
-                    if (pattern.Matches(currency_symbol))
-                    {
-                        if (!v.HasMember("regularMarketPrice") || !v["regularMarketPrice"].IsFloat())
-                            continue;
-                        price = v["regularMarketPrice"].GetFloat();
-                        currency_symbol = pattern.GetMatch(currency_symbol, 1);
-                    }
-                    wxRegEx crypto_pattern("^([A-Z]{3,})-[A-Z]{3}$");
-                    if (crypto_pattern.Matches(currency_symbol))
-                    {
-                        if (!v.HasMember("regularMarketPrice") || !v["regularMarketPrice"].IsFloat())
-                            continue;
-                        price = v["regularMarketPrice"].GetFloat();
-                        currency_symbol = crypto_pattern.GetMatch(currency_symbol, 1);
-                    }
-
-                    if (currency_symbol == base_currency_symbol)
-                        conversion_factor = price;
-                    else
-                        out[currency_symbol] = (price <= 0.0 ? 0.0 : price);
-
-                }
-            }
-            else
-            {
-                for (rapidjson::SizeType i = 0; i < e.Size(); i++)
-                {
-                    if (!e[i].IsObject()) continue;
-                    Value v = e[i].GetObject();
-
-                    if (!v.HasMember("regularMarketPrice") || !v["regularMarketPrice"].IsFloat())
-                        continue;
-                    auto price = v["regularMarketPrice"].GetFloat();
-
-                    if (!v.HasMember("symbol") || !v["symbol"].IsString())
-                        continue;
-                    const auto symbol = wxString::FromUTF8(v["symbol"].GetString());
-
-                    if (!v.HasMember("currency") || !v["currency"].IsString())
-                        continue;
-                    const auto currency = wxString::FromUTF8(v["currency"].GetString());
-                    double k = currency == "GBp" ? 100 : 1;
-
-                    wxLogDebug("item: %u %s %f", i, symbol, price);
-                    out[symbol] = price <= 0 ? 0 : price / k;
-                }
-            }
-        }
-        else {
-            output = _t("JSON Parse Error");
-            return false;
-        }
-    }
-    else
-    {
-        output = _t("JSON Parse Error");
+    TableWork work;
+    update.work_apply(work, result, msg);
+    if (!work.flush()) {
+        msg = mmErrorDialogs::SaveFailedText();
         return false;
     }
-
-    for (auto& item : out)
-    {
-        item.second /= conversion_factor;
-    }
-
     return true;
 }
 
-
+/* Currencies & stock prices */
 
 // coincap.io operates on ascii IDs for currencies, not their symbol
 // this method searches coincap using a symbol and gets the ID of the first
@@ -1336,6 +1087,24 @@ void curl_set_common_options(CURL* curl, const wxString& useragent = wxEmptyStri
 #endif
 }
 
+// Same as curl_set_common_options(), with the options in config instead of
+// the settings.
+void curl_set_config_options(CURL* curl, const mmHttpConfig& config)
+{
+    if (!config.m_proxy.IsEmpty())
+        curl_easy_setopt(curl, CURLOPT_PROXY, static_cast<const char*>(config.m_proxy.mb_str()));
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, config.m_timeout);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, config.m_connect_timeout);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, static_cast<const char*>(config.m_useragent.mb_str()));
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+#ifdef _DEBUG
+    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
+    curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, log_libcurl_debug);
+#endif
+}
+
 void curl_set_writedata_options(CURL* curl, curlBuff& chunk)
 {
     chunk.memory = static_cast<char *>(malloc(1));
@@ -1370,6 +1139,37 @@ CURLcode http_get_data(const wxString& sSite, wxString& sOutput, const wxString&
     return err_code;
 }
 
+// Same as above, with the options in config instead of the settings; it does
+// not use the models, thus it can be called on a worker thread.
+// The request is aborted (within about one second) when *abort_n becomes true.
+CURLcode http_get_data(
+    const wxString& sSite, wxString& sOutput,
+    const mmHttpConfig& config, const std::atomic<bool>* abort_n
+) {
+    CURL *curl = curl_easy_init();
+    if (!curl) return CURLE_FAILED_INIT;
+
+    curl_set_config_options(curl, config);
+    http_set_abort(curl, abort_n);
+
+    struct curlBuff chunk;
+    curl_set_writedata_options(curl, chunk);
+
+    curl_easy_setopt(curl, CURLOPT_URL, static_cast<const char*>(sSite.mb_str()));
+
+    CURLcode err_code = curl_easy_perform(curl);
+    if (err_code == CURLE_OK)
+        sOutput = wxString::FromUTF8(chunk.memory);
+    else {
+        sOutput = curl_easy_strerror(err_code);
+        wxLogDebug("http_get_data: URL = %s error = %s", sSite, sOutput);
+    }
+
+    free(chunk.memory);
+    curl_easy_cleanup(curl);
+    return err_code;
+}
+
 CURLcode http_post_data(const wxString& sSite, const wxString& sData, const wxString& sContentType, wxString& sOutput)
 {
     CURL *curl = curl_easy_init();
@@ -1433,118 +1233,6 @@ CURLcode http_download_file(const wxString& sSite, const wxString& sPath)
     return err_code;
 }
 
-CURLcode getYahooFinanceQuotes(const wxString& URL, wxString& output) {
-    CURL* curl = curl_easy_init();
-    if (!curl) return CURLE_FAILED_INIT;
-
-    struct curlBuff cookie{nullptr, 0};
-    struct curlBuff crumb{nullptr, 0};
-    struct curlBuff quote{nullptr, 0};
-
-    wxString savedCookie = SettingModel::instance().getString("YAHOO_FINANCE_COOKIE", "");
-    wxString savedCrumb = SettingModel::instance().getString("YAHOO_FINANCE_CRUMB", "");
-
-    // Request to get cookies and save them to the cookie buffer
-    curl_set_common_options(curl);
-    curl_set_writedata_options(curl, quote);
-    wxString crumb_url = URL + "&crumb=" + savedCrumb;
-    curl_easy_setopt(curl, CURLOPT_URL, static_cast<const char*>(crumb_url.mb_str()));
-    curl_easy_setopt(curl, CURLOPT_COOKIEJAR, "");
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8");
-    headers = curl_slist_append(headers, "user-agent: Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/136.0.0.0 Safari/537.36");
-    if (!savedCookie.IsEmpty()) headers = curl_slist_append(headers, static_cast<const char*>(("Cookie: " + savedCookie).mb_str()));
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-    CURLcode res = CURLE_OK;
-    if(!savedCookie.IsEmpty() && !savedCrumb.IsEmpty())
-        res = curl_easy_perform(curl);
-    if (res == CURLE_OK) {
-        if (wxString::FromUTF8(quote.memory).Contains("Unauthorized") || savedCookie.IsEmpty() || savedCrumb.IsEmpty())
-        {
-            curl_set_writedata_options(curl, cookie);
-            curl_easy_setopt(curl, CURLOPT_URL, "https://finance.yahoo.com");
-            res = curl_easy_perform(curl);
-            if (res == CURLE_OK)
-            {
-                wxString response = wxString::FromUTF8(cookie.memory);
-                wxRegEx csrfTokenPattern("csrfToken\" value=\"([^\"]+)\">");
-                if (csrfTokenPattern.Matches(response))
-                {
-                    // Get the csrfToken
-                    wxString csrfToken = csrfTokenPattern.GetMatch(response, 1);
-
-                    wxRegEx sessionIdPattern("sessionId\" value=\"([^\"]+)\">");
-                    if (sessionIdPattern.Matches(response))
-                    {
-                        wxString sessionId = sessionIdPattern.GetMatch(response, 1);
-
-                        wxString postData = "csrfToken=" + csrfToken + "&sessionId=" + sessionId + "&originalDoneUrl=https%3A%2F%2Ffinance.yahoo.com%2F%3Fguccounter%3D1&namespace=yahoo&reject=reject&reject=reject";
-                        curl_easy_setopt(curl, CURLOPT_URL, static_cast<const char*>(("https://consent.yahoo.com/v2/collectConsent?sessionId=" + sessionId).mb_str()));
-                        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, static_cast<const char*>(postData.mb_str()));
-                        res = curl_easy_perform(curl);
-                        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
-                    }
-                }
-
-                if (res == CURLE_OK) {
-                    // Request to get crumb using the saved cookies
-                    curl_set_writedata_options(curl, crumb);
-                    curl_easy_setopt(curl, CURLOPT_URL, "https://query1.finance.yahoo.com/v1/test/getcrumb");
-                    res = curl_easy_perform(curl);
-                    if (res == CURLE_OK) {
-                        struct curlBuff newQuote { nullptr, 0 };
-                        // Request to get the quotes using the crumb and saved cookies
-                        curl_set_writedata_options(curl, newQuote);
-                        crumb_url = URL + "&crumb=" + wxString::FromUTF8(crumb.memory);
-                        curl_easy_setopt(curl, CURLOPT_URL, static_cast<const char*>(crumb_url.mb_str()));
-                        res = curl_easy_perform(curl);
-                        if (res == CURLE_OK) {
-                            output = wxString::FromUTF8(newQuote.memory);
-                            wxString cookieJar;
-                            // Get the cookies from the cookie jar
-                            struct curl_slist* cookies = nullptr;
-                            curl_easy_getinfo(curl, CURLINFO_COOKIELIST, &cookies);
-                            if (cookies) {
-                                for (struct curl_slist* item = cookies; item; item = item->next) {
-                                    wxStringTokenizer tokenizer(wxString::FromUTF8(item->data), "\t");
-                                    int count = 0;
-                                    while (tokenizer.HasMoreTokens()) {
-                                        wxString token = tokenizer.GetNextToken();
-                                        if (count++ < 5) continue;
-                                        cookieJar += token;
-                                        (count < 7) ? cookieJar += "=" : cookieJar += "; ";
-                                    }
-                                }
-                                curl_slist_free_all(cookies);
-                            }
-
-                            SettingModel::instance().saveString("YAHOO_FINANCE_COOKIE", cookieJar);
-                            SettingModel::instance().saveString("YAHOO_FINANCE_CRUMB", wxString::FromUTF8(crumb.memory));
-                        }
-                        free(newQuote.memory);
-                    }
-                }
-            }
-        }
-        else {
-            output = wxString::FromUTF8(quote.memory);
-        }
-    }
-    if (res != CURLE_OK) {
-        output = curl_easy_strerror(res); //TODO: translation
-        wxLogDebug("http_get_data: URL = %s error = %s", URL, output);
-    }
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-    free(cookie.memory);
-    free(crumb.memory);
-    free(quote.memory);
-    return res;
-
-}
-
 const wxString getProgramDescription(const int type)
 {
     const wxString bull = L" \u2022 ";
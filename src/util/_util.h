@@ -23,6 +23,7 @@
 
 #include "base/_defs.h"
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <curl/curl.h>
 #include <wx/clipbrd.h>
@@ -31,6 +32,9 @@
 
 #include "_primitive.h"
 #include "model/PrefModel.h"
+#include "table/_TableWork.h"
+#include "data/CurrencyData.h"
+#include "mmQuote.h"
 
 class mmApp;
 
@@ -98,6 +102,7 @@ struct WebsiteNews
 };
 
 bool getNewsRSS(std::vector<WebsiteNews>& websiteNews_a);
+bool parseNewsRSS(const wxString& rssContent, std::vector<WebsiteNews>& websiteNews_a);
 
 // --
 
@@ -117,18 +122,27 @@ inline wxString getTranslation(bool translate, const wxString& text)
     return translate ? wxGetTranslation(text) : text;
 }
 
-enum yahoo_price_type { FIAT = 0, SHARES };
+// Online update of currency rates: prepare() and work_apply() are called on
+// the GUI thread, fetch() can be called on a worker thread in between.
+struct CurrencyRateUpdate
+{
+    wxString m_base_symbol;
+    bool m_used_only = true;
+    double m_usd_rate = -1;
+    std::vector<CurrencyData> m_currency_a;
+    std::map<wxString, double> m_symbol_rate_m;  // current rates
+    mmQuote::Config m_config;
+
+    bool prepare(wxString& msg, int64 currency_id = -1, bool used_only = true);
+    auto fetch() const -> mmQuote::Result;
+    void work_apply(TableWork& work, const mmQuote::Result& result, wxString& msg);
+};
+
 bool getOnlineCurrencyRates(
     wxString& msg,
     int64 curr_id = -1,
-    bool used_only = true
-);
-bool get_yahoo_prices(
-    std::map<wxString, double>& symbols,
-    std::map<wxString, double>& out,
-    const wxString& base_currency_symbol,
-    wxString& output,
-    int type
+    bool used_only = true,
+    wxWindow* parent = nullptr
 );
 bool getCoincapInfoFromSymbol(
     const wxString& symbol,
@@ -157,16 +171,17 @@ const wxRect GetDefaultMonitorRect();
 // -- http
 
 CURLcode http_get_data(const wxString& site, wxString& output, const wxString& useragent = wxEmptyString);
+CURLcode http_get_data(
+    const wxString& site, wxString& output,
+    const mmHttpConfig& config, const std::atomic<bool>* abort_n = nullptr
+);
 CURLcode http_post_data(const wxString& site, const wxString& data, const wxString& contentType, wxString& output);
 CURLcode http_download_file(const wxString& site, const wxString& path);
-CURLcode getYahooFinanceQuotes(const wxString& URL, wxString& json_data);
 
 // -- Date
 
 extern const std::vector<std::pair<wxString, wxString>> g_date_formats_map();
 
-const std::map<wxString, wxString>& date_formats_regex();
-
 const wxString mmGetDateForDisplay(
     const wxString& datetime_iso,
     const wxString& format = PrefModel::instance().getDateFormat()
@@ -185,6 +200,12 @@ bool mmParseDisplayStringToDate(
     const wxString& sDateMask
 );
 
+int mmParseDisplayStringToDate_a(
+    std::vector<wxDateTime>& date_a,
+    const wxArrayString& sDate_a,
+    const wxString& sDateMask
+);
+
 const wxDateTime getUserDefinedFinancialYear(bool prevDayRequired = false);
 
 // --
@@ -27,6 +27,76 @@
 #include "model/AccountModel.h"
 #include "model/CategoryModel.h"
 #include "model/PayeeModel.h"
+#include "model/SchedModel.h"
+#include "model/TrxModel.h"
+
+// -- shared indexes
+
+static mmSharedNameIndex& currency_index()
+{
+    static mmSharedNameIndex s_index(
+        CurrencyModel::instance().table_name(),
+        []() { return CurrencyModel::instance().data_version(); },
+        [](mmNameIndex& index) {
+            for (const auto& [name, id] : CurrencyModel::instance().find_all_name_id_m())
+                index.set(id, name);
+        }
+    );
+    return s_index;
+}
+
+static mmSharedNameIndex& account_index()
+{
+    static mmSharedNameIndex s_index(
+        AccountModel::instance().table_name(),
+        []() { return AccountModel::instance().data_version(); },
+        [](mmNameIndex& index) {
+            for (const auto& [name, id] : AccountModel::instance().find_all_name_id_m(false))
+                index.set(id, name);
+        }
+    );
+    return s_index;
+}
+
+// a rename changes the full name of all descendants; the index is rebuilt
+static mmSharedNameIndex& category_index()
+{
+    static mmSharedNameIndex s_index(
+        CategoryModel::instance().table_name(),
+        []() { return CategoryModel::instance().data_version(); },
+        [](mmNameIndex& index) {
+            for (const auto& [fullname, id] : CategoryModel::instance().find_all_id_mFullname(false))
+                index.set(id, fullname);
+        }
+    );
+    return s_index;
+}
+
+// payees are updated one by one, and ranked by usage
+static mmSharedNameIndex& payee_index()
+{
+    static mmSharedNameIndex s_index(
+        PayeeModel::instance().table_name(),
+        []() { return PayeeModel::instance().data_version(); },
+        [](mmNameIndex& index) {
+            for (const auto& payee_d : PayeeModel::instance().find_data_a())
+                index.set(payee_d.m_id, payee_d.m_name);
+        },
+        [](mmNameIndex& index, int64 payee_id) {
+            const PayeeData* payee_n = PayeeModel::instance().get_idN_data_n(payee_id);
+            if (payee_n)
+                index.set(payee_id, payee_n->m_name);
+            else
+                index.remove(payee_id);
+        },
+        { TrxModel::instance().table_name(), SchedModel::instance().table_name() },
+        [](mmNameIndex& index) {
+            for (const auto& [payee_id, usage_c] : PayeeModel::instance().find_usage_c_m())
+                index.set_usage(payee_id, usage_c);
+        }
+    );
+    return s_index;
+}
 
 wxBEGIN_EVENT_TABLE(mmComboBox, wxComboBox)
     EVT_SET_FOCUS(                  mmComboBox::onSetFocus)
@@ -95,10 +165,39 @@ void mmComboBox::mmDoReInitialize()
     Clear();
     init();
     m_is_initialized = false;
+    m_is_own_index_valid = false;
     wxFocusEvent evt(wxEVT_SET_FOCUS);
     onSetFocus(evt);
 }
 
+const mmNameIndex& mmComboBox::get_index()
+{
+    if (!m_is_own_index_valid) {
+        m_own_index.clear();
+        for (const auto& [name, id] : m_name_id_m)
+            m_own_index.set(id, name);
+        m_is_own_index_valid = true;
+    }
+    return m_own_index;
+}
+
+// Return the name in m_name_id_m which is equal to text, ignoring case;
+// text itself is preferred. Return nullptr if there is no such name.
+const wxString* mmComboBox::find_fold_name_n(const wxString& text)
+{
+    auto it = m_name_id_m.find(text);
+    if (it != m_name_id_m.end())
+        return &it->first;
+
+    const mmNameIndex& index = get_index();
+    for (int64 id : index.find_fold_id_a(text)) {
+        it = m_name_id_m.find(index.get_entry_n(id)->m_name);
+        if (it != m_name_id_m.end())
+            return &it->first;
+    }
+    return nullptr;
+}
+
 void mmComboBox::onSetFocus(wxFocusEvent& event)
 {
    if (!m_is_initialized) {
@@ -140,10 +239,13 @@ void mmComboBox::onTextUpdated(wxCommandEvent& event)
     if ((m_is_initialized) && (typedText.IsEmpty() || (this->GetSelection() == -1))) {
         this->Clear();
 
-        for (auto& entry : m_name_id_m) {
-            if (entry.first.Lower().Matches(typedText.Lower().Prepend("*").Append("*")))
-                this->Append(entry.first);
-            }
+        // most used names first
+        const mmNameIndex& index = get_index();
+        for (int64 id : index.find_substr_id_a(typedText)) {
+            const wxString& name = index.get_entry_n(id)->m_name;
+            if (m_name_id_m.count(name) == 1)
+                this->Append(name);
+        }
 
         this->ChangeValue(typedText);
         this->SetInsertionPointEnd();
@@ -153,14 +255,12 @@ void mmComboBox::onTextUpdated(wxCommandEvent& event)
             this->Dismiss();
     }
 #endif
-    for (const auto& item : m_name_id_m) {
-        if ((item.first.CmpNoCase(typedText) == 0) && (item.first.Cmp(typedText) != 0)) {
-            ChangeValue(item.first);
-            SetInsertionPointEnd();
-            wxCommandEvent evt(wxEVT_COMBOBOX, this->GetId());
-            AddPendingEvent(evt);
-            break;
-        }
+    const wxString* name_n = find_fold_name_n(typedText);
+    if (name_n && name_n->Cmp(typedText) != 0) {
+        ChangeValue(*name_n);
+        SetInsertionPointEnd();
+        wxCommandEvent evt(wxEVT_COMBOBOX, this->GetId());
+        AddPendingEvent(evt);
     }
     this->SetEvtHandlerEnabled(true);
     event.Skip();
@@ -170,12 +270,10 @@ void mmComboBox::onKeyPressed(wxKeyEvent& event)
 {
     auto text = GetValue();
     if (event.GetKeyCode() == WXK_RETURN) {
-        for (const auto& item : m_name_id_m) {
-            if (item.first.CmpNoCase(text) == 0) {
-                SetValue(item.first);
-                Dismiss();
-                break;
-            }
+        const wxString* name_n = find_fold_name_n(text);
+        if (name_n) {
+            SetValue(*name_n);
+            Dismiss();
         }
         event.Skip();
     }
@@ -227,6 +325,11 @@ void mmComboBoxCurrency::init()
     m_name_id_m = CurrencyModel::instance().find_all_name_id_m();
 }
 
+const mmNameIndex& mmComboBoxCurrency::get_index()
+{
+    return currency_index().get();
+}
+
 // account_id: always include this account (even if it is closed)
 // only_open: exlude closed accounts (other than account_id)
 mmComboBoxAccount::mmComboBoxAccount(
@@ -259,6 +362,11 @@ void mmComboBoxAccount::init()
     }
 }
 
+const mmNameIndex& mmComboBoxAccount::get_index()
+{
+    return account_index().get();
+}
+
 // cat_id: always include this category (even if it is inactive)
 // only_active: exclude inactive categories (other than cat_id)
 mmComboBoxCategory::mmComboBoxCategory(
@@ -305,6 +413,11 @@ void mmComboBoxCategory::init()
     }
 }
 
+const mmNameIndex& mmComboBoxCategory::get_index()
+{
+    return category_index().get();
+}
+
 int64 mmComboBoxCategory::mmGetCategoryId() const
 {
     const wxString text = GetValue();
@@ -346,6 +459,11 @@ void mmComboBoxPayee::init()
     }
 }
 
+const mmNameIndex& mmComboBoxPayee::get_index()
+{
+    return payee_index().get();
+}
+
 mmComboBoxUsedPayee::mmComboBoxUsedPayee(
     wxWindow* parent_win,
     wxWindowID win_id,
@@ -372,3 +490,8 @@ void mmComboBoxUsedPayee::init()
         m_name_id_m[payee_name] = payee_id;
     }
 }
+
+const mmNameIndex& mmComboBoxUsedPayee::get_index()
+{
+    return payee_index().get();
+}
@@ -24,6 +24,7 @@
 #include <map>
 #include "base/_defs.h"
 #include "base/_types.h"
+#include "mmNameIndex.h"
 
 class mmComboBox : public wxComboBox
 {
@@ -33,6 +34,11 @@ protected:
     bool m_is_initialized;
     std::map<wxString, int64> m_name_id_m;
 
+private:
+    // index of m_name_id_m, used if get_index() is not overridden
+    mmNameIndex m_own_index;
+    bool m_is_own_index_valid = false;
+
 public:
     mmComboBox(
         wxWindow* parent_win,
@@ -42,6 +48,8 @@ public:
 
 protected:
     virtual void init() = 0;
+    // Return an index which contains (at least) the names in m_name_id_m.
+    virtual auto get_index() -> const mmNameIndex&;
 
 public:
     bool mmIsValid() const;
@@ -51,6 +59,7 @@ public:
     void mmDoReInitialize();
 
 protected:
+    auto find_fold_name_n(const wxString& text) -> const wxString*;
     void onSetFocus(    wxFocusEvent&   event);
     void onDropDown(    wxCommandEvent& );
     void onTextUpdated( wxCommandEvent& event);
@@ -68,6 +77,7 @@ public:
 
 protected:
     virtual void init() override;
+    virtual auto get_index() -> const mmNameIndex& override;
 };
 
 class mmComboBoxAccount : public mmComboBox
@@ -87,6 +97,7 @@ public:
 
 protected:
     virtual void init() override;
+    virtual auto get_index() -> const mmNameIndex& override;
 };
 
 class mmComboBoxCategory : public mmComboBox
@@ -108,6 +119,7 @@ public:
 
 protected:
     virtual void init() override;
+    virtual auto get_index() -> const mmNameIndex& override;
 
 public:
     int64 mmGetCategoryId() const;
@@ -130,6 +142,7 @@ public:
 
 protected:
     virtual void init() override;
+    virtual auto get_index() -> const mmNameIndex& override;
 };
 
 class mmComboBoxUsedPayee : public mmComboBox
@@ -143,6 +156,7 @@ public:
 
 protected:
     virtual void init() override;
+    virtual auto get_index() -> const mmNameIndex& override;
 };
 
 class mmComboBoxCustom : public mmComboBox
@@ -0,0 +1,333 @@
+/*******************************************************
+ Copyright (C) 2026 George Ef (george.a.ef@gmail.com)
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include <wx/intl.h>
+#include <wx/log.h>
+
+#include "base/mmCache.tpp"
+#include "_primitive.h"
+#include "mmDateMask.h"
+
+// -- static
+
+std::unordered_map<wxString, mmDateMask*> mmDateMask::s_mask_m;
+mmCache<wxString, int> mmDateMask::c_mask_str_packed =
+    mmCache<wxString, int>(mmDateMask::s_cache_cap);
+
+namespace
+{
+
+bool is_digit(wxUniChar ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+bool is_space(wxUniChar ch)
+{
+    return ch == ' ' || ch == '\t' || ch == wxUniChar(0xA0);
+}
+
+// Lower-case month names (English and translated) and their 1-based number.
+// The list is built on first use; the UI language cannot change while MMEX runs.
+const std::vector<std::pair<wxString, int>>& month_name_a()
+{
+    static std::vector<std::pair<wxString, int>> name_a;
+    if (!name_a.empty())
+        return name_a;
+
+    for (int i = 0; i < 12; ++i) {
+        name_a.emplace_back(MONTHS_SHORT[i].Lower(), i + 1);
+        const wxString tr = wxGetTranslation(MONTHS_SHORT[i]).Lower();
+        if (tr != name_a.back().first)
+            name_a.emplace_back(tr, i + 1);
+    }
+    return name_a;
+}
+
+// Read between min_width and max_width digits starting at it.
+// An optional single space before the first digit is skipped (space padding).
+bool read_number(StringIt& it, const StringIt& end, int min_width, int max_width, int& num)
+{
+    if (max_width == 2 && it != end && *it == ' ') {
+        StringIt next = it + 1;
+        if (next != end && is_digit(*next))
+            it = next;
+    }
+
+    num = 0;
+    int width = 0;
+    while (it != end && width < max_width && is_digit(*it)) {
+        num = num * 10 + static_cast<int>((*it).GetValue()) - '0';
+        ++it;
+        ++width;
+    }
+    return width >= min_width && width > 0;
+}
+
+} // namespace
+
+// Return the compiled mask for format, or nullptr if format cannot be compiled.
+// The compiled mask is created on first use and it is kept for the lifetime
+// of the application.
+const mmDateMask* mmDateMask::get_mask_n(const wxString& format)
+{
+    auto it = s_mask_m.find(format);
+    if (it == s_mask_m.end())
+        it = s_mask_m.emplace(format, new mmDateMask(format)).first;
+
+    return it->second->m_is_valid ? it->second : nullptr;
+}
+
+wxDateTime mmDateMask::unpack(int packed)
+{
+    if (packed <= 0)
+        return wxInvalidDateTime;
+
+    return wxDateTime(
+        static_cast<wxDateTime::wxDateTime_t>(packed % 100),
+        static_cast<wxDateTime::Month>((packed / 100) % 100 - 1),
+        packed / 10000
+    );
+}
+
+// Parse str with format and set date; return false if str does not match.
+// Successful and failed parsing results are cached.
+bool mmDateMask::parse(wxDateTime& date, const wxString& str, const wxString& format)
+{
+    const mmDateMask* mask_n = get_mask_n(format);
+    if (!mask_n)
+        return false;
+
+    const wxString key = format + '\t' + str;
+    int packed;
+    const int* packed_n = c_mask_str_packed.get(key);
+    if (packed_n) {
+        packed = *packed_n;
+    }
+    else {
+        packed = mask_n->parse_packed(str);
+        c_mask_str_packed.add(key, packed);
+    }
+
+    if (packed == 0)
+        return false;
+
+    date = unpack(packed);
+    return true;
+}
+
+// Parse a whole column of date strings with the same format.
+// date_a is resized to the size of str_a; an element which cannot be parsed
+// is set to wxInvalidDateTime. Return the number of elements which cannot be parsed.
+// Repeated strings are parsed only once; the cache is not used, in order to
+// avoid evicting the entries of interactive callers.
+int mmDateMask::parse_a(
+    std::vector<wxDateTime>& date_a,
+    const wxArrayString& str_a,
+    const wxString& format
+) {
+    date_a.assign(str_a.size(), wxInvalidDateTime);
+    const mmDateMask* mask_n = get_mask_n(format);
+    if (!mask_n)
+        return static_cast<int>(str_a.size());
+
+    int error_c = 0;
+    std::unordered_map<wxString, int> str_packed_m;
+    for (std::size_t i = 0; i < str_a.size(); ++i) {
+        int packed;
+        auto it = str_packed_m.find(str_a[i]);
+        if (it != str_packed_m.end()) {
+            packed = it->second;
+        }
+        else {
+            packed = mask_n->parse_packed(str_a[i]);
+            str_packed_m.emplace(str_a[i], packed);
+        }
+
+        if (packed == 0)
+            ++error_c;
+        else
+            date_a[i] = unpack(packed);
+    }
+
+    return error_c;
+}
+
+// -- constructor
+
+// Compile format into a token program.
+// m_is_valid is set to false if format contains an unsupported specifier,
+// or if it does not contain a complete date (day, month, year).
+mmDateMask::mmDateMask(const wxString& format) :
+    m_format(format)
+{
+    bool has_day = false, has_month = false, has_year = false;
+
+    for (StringIt it = format.begin(); it != format.end(); ++it) {
+        if (*it != '%') {
+            if (is_space(*it)) {
+                // collapse consecutive spaces
+                if (m_token_a.empty() || m_token_a.back().m_id != e_space)
+                    m_token_a.push_back({ e_space, ' ', 0, 0 });
+            }
+            else
+                m_token_a.push_back({ e_literal, *it, 0, 0 });
+            continue;
+        }
+
+        if (++it == format.end())
+            return;
+
+        switch (static_cast<char>(*it)) {
+        case 'd':
+            m_token_a.push_back({ e_day, 0, 1, 2 });
+            has_day = true;
+            break;
+        case 'm':
+            m_token_a.push_back({ e_month, 0, 1, 2 });
+            has_month = true;
+            break;
+        case 'y':
+            m_token_a.push_back({ e_year2, 0, 1, 2 });
+            has_year = true;
+            break;
+        case 'Y':
+            m_token_a.push_back({ e_year4, 0, 4, 4 });
+            has_year = true;
+            break;
+        case 'w':
+            m_token_a.push_back({ e_weekday, 0, 0, 0 });
+            // the weekday consumes the separator which follows it
+            if (it + 1 != format.end() && is_space(*(it + 1)))
+                ++it;
+            break;
+        case 'M':
+            if (format.Mid(it - format.begin(), 3) != "Mon")
+                return;
+            it += 2;
+            m_token_a.push_back({ e_month_name, 0, 0, 0 });
+            has_month = true;
+            break;
+        default:
+            return;
+        }
+    }
+
+    // numeric fields without a separator between them have fixed width
+    for (std::size_t i = 0; i + 1 < m_token_a.size(); ++i) {
+        Token& t1 = m_token_a[i];
+        Token& t2 = m_token_a[i + 1];
+        if (t1.m_id <= e_year4 && t1.m_id != e_month_name &&
+            t2.m_id <= e_year4 && t2.m_id != e_month_name
+        ) {
+            t1.m_min_width = t1.m_max_width;
+            t2.m_min_width = t2.m_max_width;
+        }
+    }
+
+    m_is_valid = has_day && has_month && has_year;
+    if (!m_is_valid)
+        wxLogDebug("mmDateMask: unsupported date format '%s'", format);
+}
+
+// -- methods
+
+int mmDateMask::parse_packed(const wxString& str) const
+{
+    if (!m_is_valid)
+        return 0;
+
+    int day = 0, month = 0, year = 0;
+    StringIt it = str.begin();
+    const StringIt end = str.end();
+
+    while (it != end && is_space(*it))
+        ++it;
+
+    for (const Token& token : m_token_a) {
+        int num = 0;
+        switch (token.m_id) {
+        case e_day:
+            if (!read_number(it, end, token.m_min_width, token.m_max_width, num) ||
+                num < 1 || num > 31
+            )
+                return 0;
+            day = num;
+            break;
+        case e_month:
+            if (!read_number(it, end, token.m_min_width, token.m_max_width, num) ||
+                num < 1 || num > 12
+            )
+                return 0;
+            month = num;
+            break;
+        case e_year2:
+            if (!read_number(it, end, token.m_min_width, token.m_max_width, num))
+                return 0;
+            year = (num > 30 ? 1900 : 2000) + num;
+            break;
+        case e_year4:
+            if (!read_number(it, end, token.m_min_width, token.m_max_width, num) ||
+                num < 1900 || num > 2099
+            )
+                return 0;
+            year = num;
+            break;
+        case e_month_name: {
+            StringIt start = it;
+            while (it != end && !is_digit(*it) && !is_space(*it) && *it != '\'' && *it != '-')
+                ++it;
+            const wxString name = wxString(start, it).Lower();
+            month = 0;
+            for (const auto& [month_name, month_num] : month_name_a()) {
+                if (name == month_name) {
+                    month = month_num;
+                    break;
+                }
+            }
+            if (month == 0)
+                return 0;
+            break;
+        }
+        case e_weekday:
+            while (it != end && !is_digit(*it))
+                ++it;
+            break;
+        case e_space:
+            if (it == end || !is_space(*it))
+                return 0;
+            while (it != end && is_space(*it))
+                ++it;
+            break;
+        case e_literal:
+            if (it == end || *it != token.m_ch)
+                return 0;
+            ++it;
+            break;
+        }
+    }
+
+    // trailing text is allowed if it does not continue a number
+    if (it != end && is_digit(*it))
+        return 0;
+
+    if (day > wxDateTime::GetNumberOfDays(static_cast<wxDateTime::Month>(month - 1), year))
+        return 0;
+
+    return pack(year, month, day);
+}
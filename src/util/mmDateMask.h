@@ -0,0 +1,106 @@
+/*******************************************************
+ Copyright (C) 2026 George Ef (george.a.ef@gmail.com)
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <wx/string.h>
+#include <wx/arrstr.h>
+#include <wx/datetime.h>
+#include "base/mmCache.h"
+
+// mmDateMask is a date format (like "%d/%m/%Y") compiled into a small
+// program of tokens, which parses a date string directly into a packed
+// date (YYYYMMDD as int), without regular expressions or wxDateTime::ParseFormat.
+//
+// Supported specifiers: %d, %m, %Mon, %y, %Y, %w. Any other character in the
+// format is a literal separator; a space matches one or more whitespace.
+// Numeric fields accept 1 or 2 digits (optionally space-padded), unless
+// they are adjacent to another numeric field (e.g., "%Y%m%d"), in which case
+// they have fixed width. %Y accepts years 1900-2099; %y is mapped to
+// 1931-2030 (the same rule as wxDateTime::ParseFormat). %Mon matches an
+// English or translated short month name (case-insensitive). %w skips
+// any leading non-digit text. The parsed string may contain trailing text
+// (e.g., a time), provided that it does not start with a digit.
+//
+// Compiled masks are owned by a static registry and are never deleted.
+// Parsed results are kept in a bounded cache, keyed by (mask, string).
+
+class mmDateMask
+{
+// -- static
+
+private:
+    static constexpr std::size_t s_cache_cap = 10000;
+    static std::unordered_map<wxString, mmDateMask*> s_mask_m;
+    static mmCache<wxString, int> c_mask_str_packed;
+
+public:
+    static auto get_mask_n(const wxString& format) -> const mmDateMask*;
+    static auto pack(int year, int month, int day) -> int {
+        return year * 10000 + month * 100 + day;
+    }
+    static auto unpack(int packed) -> wxDateTime;
+
+    static bool parse(wxDateTime& date, const wxString& str, const wxString& format);
+    static int  parse_a(
+        std::vector<wxDateTime>& date_a,
+        const wxArrayString& str_a,
+        const wxString& format
+    );
+
+// -- state
+
+private:
+    enum TokenId {
+        e_day = 0,
+        e_month,
+        e_month_name,
+        e_year2,
+        e_year4,
+        e_weekday,
+        e_space,
+        e_literal,
+    };
+
+    struct Token {
+        TokenId m_id;
+        wxUniChar m_ch;
+        int m_min_width;
+        int m_max_width;
+    };
+
+    wxString m_format;
+    std::vector<Token> m_token_a;
+    bool m_is_valid = false;
+
+// -- constructor
+
+private:
+    mmDateMask(const wxString& format);
+
+// -- methods
+
+public:
+    bool is_valid() const { return m_is_valid; }
+    auto format() const -> const wxString& { return m_format; }
+
+    // Return the packed date, or 0 if str does not match the mask.
+    int parse_packed(const wxString& str) const;
+};
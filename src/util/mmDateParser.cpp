@@ -20,6 +20,7 @@
  ********************************************************/
 
 #include "mmDateParser.h"
+#include "mmDateMask.h"
 
 mmDateParser::mmDateParser() :
     m_today(wxDateTime::Today()),
@@ -67,8 +68,11 @@ void mmDateParser::doHandleStatistics(const wxString& date_s)
     std::vector<std::pair<wxString, wxString>> format_mask_a = m_format_mask_a;
     for (const auto& format_mask : format_mask_a) {
         const wxString format = format_mask.first;
-        wxDateTime dateTime = m_today;
-        if (mmParseDisplayStringToDate(dateTime, date_s, format)) {
+        // bypass the parser cache; each sample is tested against all formats
+        const mmDateMask* mask_n = mmDateMask::get_mask_n(format);
+        const int packed = mask_n ? mask_n->parse_packed(date_s) : 0;
+        if (packed > 0) {
+            const wxDateTime dateTime = mmDateMask::unpack(packed);
             // Increase the date format rating if parsed date is recent
             // Decrease the data format rating if parsed date is in future
             m_format_stat_m[format] +=
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <memory>
 #include <map>
 #include <array>
+#include <cstring>
 
 #include <wx/image.h>
 #include <wx/bitmap.h>
@@ -31,6 +32,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <wx/rawbmp.h>
 #include <wx/fs_mem.h>
 #include <wx/mstream.h>
+#include <wx/file.h>
+#include <wx/dir.h>
+#include <wx/stopwatch.h>
+#include <wx/math.h>
 
 #include "base/mmPlatform.h"
 #include "base/mmUserColor.h"
@@ -172,6 +177,19 @@ rapidjson::Document mmImage::metaData_doc;
 wxSharedPtr<wxBitmapBundle> mmImage::programIconBundles[mmImage::numSizes][mmImage::MAX_PNG];
 wxSharedPtr<wxArrayString> mmImage::filesInVFS;
 
+wxString mmImage::themeFile;
+wxString mmImage::cacheKey;
+bool mmImage::cacheHit = false;
+bool mmImage::cacheDirty = false;
+bool mmImage::svgLoaded = false;
+long mmImage::rasterMsec = 0;
+wxString mmImage::metaRaw_a[mmImage::MAX_METADATA];
+wxString mmImage::metaValue_a[mmImage::MAX_METADATA];
+bool mmImage::iconFound_a[mmImage::MAX_PNG];
+std::string mmImage::svgData_a[mmImage::MAX_PNG];
+std::map<int, mmImage::Atlas> mmImage::atlas_m;
+std::map<int, std::vector<int>> mmImage::cachedAtlas_m;
+
 // -- static methods
 
 // Metadata item id, where it can be found, default and if mandatory
@@ -287,139 +305,188 @@ int mmImage::getIconSizeIdx(const int iconSize)
     return it->first;
 }
 
-bool mmImage::processThemes(wxString themeDir, wxString myTheme, bool metaPhase)
+// Return the path of the theme file myTheme in themeDir, or an empty string.
+wxString mmImage::findTheme(const wxString& themeDir, const wxString& myTheme)
 {
     wxDir directory(themeDir);
-    wxLogDebug("{{{ mmImage::processThemes(metaPhase=%s)", metaPhase ? "YES" : "NO");
     wxLogDebug("Scanning [%s] for Theme [%s]", themeDir, myTheme);
-    if (!directory.IsOpened()) {
-        // matching {{{ for next line
-        wxLogDebug("}}}");
-        return false;
-    }
+    if (!directory.IsOpened())
+        return "";
 
-    bool themeMatched = false;
     wxString filename;
-
     bool cont = directory.GetFirst(&filename, "*.mmextheme", wxDIR_FILES);
     while (cont) {
         wxFileName themeFile(themeDir, filename);
-        const wxString thisTheme = themeFile.GetName();
-        wxLogDebug("Found theme [%s]", thisTheme);
+        wxLogDebug("Found theme [%s]", themeFile.GetName());
+        if (!themeFile.GetName().Cmp(myTheme))
+            return themeFile.GetFullPath();
+        cont = directory.GetNext(&filename);
+    }
+    return "";
+}
 
-        wxFileInputStream themeZip(themeFile.GetFullPath());
-        wxASSERT(themeZip.IsOk());   // Make sure we can open find the Zip
+// Load the theme in themePath, from the cache if it is up to date.
+void mmImage::openTheme(const wxString& themePath)
+{
+    mmImage::themeFile = themePath;
+    mmImage::darkFound = false;
+    mmImage::svgLoaded = false;
+    for (int i = 0; i < MAX_PNG; i++) {
+        mmImage::iconFound_a[i] = false;
+        mmImage::svgData_a[i].clear();
+    }
+    mmImage::atlas_m.clear();
+    mmImage::cachedAtlas_m.clear();
+
+    // the cache is keyed by the content of the theme file and the dark mode
+    mmImage::cacheKey = "";
+    const wxString hash = mmImage::getThemeHash(themePath);
+    if (!hash.IsEmpty()) {
+        mmImage::cacheKey = wxString::Format("v%d_%s_%s",
+            mmImage::cacheVersion, hash, mmImage::darkMode ? "dark" : "light"
+        );
+    }
 
-        if (!thisTheme.Cmp(myTheme)) {
-            themeMatched = true;
-            wxZipInputStream themeStream(themeZip);
-            std::unique_ptr<wxZipEntry> themeEntry;
+    mmImage::cacheHit = mmImage::loadCache();
+    if (mmImage::cacheHit) {
+        // extra files are kept in memory (VFS) or in the temp folder
+        bool filesFound = false;
+#if !defined(__WXMSW__) && !defined(__WXMAC__)
+        filesFound = true;
+        for (const auto& fileName : *mmImage::filesInVFS) {
+            if (!wxFileExists(mmPath::getTempFolder() + fileName)) {
+                filesFound = false;
+                break;
+            }
+        }
+#endif
+        if (!filesFound) {
+            mmImage::filesInVFS->Clear();
+            mmImage::processThemeFile(themePath, PHASE_FILES);
+        }
+        mmImage::cacheDirty = false;
+    }
+    else {
+        mmImage::processThemeFile(themePath, PHASE_META);
+        for (const auto& it : mmImage::metaDataTrans()) {
+            wxString metaLocation = std::get<0>(it.second);
+            if (mmImage::darkFound && mmImage::darkMode && !metaLocation.StartsWith("/theme"))
+                metaLocation.Prepend("/dark");
+            const Pointer ptr(metaLocation.mb_str());
+            mmImage::metaRaw_a[it.first] = wxString::FromUTF8(
+                GetValueByPointerWithDefault(mmImage::metaData_doc, ptr, "").GetString()
+            );
+        }
+        mmImage::processThemeFile(themePath, PHASE_FILES | PHASE_ICONS);
+        mmImage::svgLoaded = true;
+        mmImage::cacheDirty = true;
+    }
 
-            const wxString bgString = mmImage::themeMetaString(mmImage::COLOR_NAVPANEL).AfterFirst('#');
-            long bgStringConv;
-            if (!bgString.ToLong(&bgStringConv, 16))
-                bgStringConv = -1;
-            else
-                bgStringConv = bgStringConv * 256 + 255;  // Need to add Alpha
-
-            while (themeEntry.reset(themeStream.GetNextEntry()), themeEntry) { // != nullptr
-                wxASSERT(themeZip.CanRead()); // Make sure we can read the Zip Entry
-
-                const wxFileName fileEntryName = wxFileName(themeEntry->GetName());
-                const wxString fileFullPath = fileEntryName.GetFullPath();
-                const wxString fileEntry = fileEntryName.GetFullName();
-                std::string fileName = std::string(fileEntry.mb_str());
-                const wxString fileNameString(fileName);
-
-                if (fileEntryName.IsDir())
-                    continue;   // We can skip directories
-
-                if (metaPhase) {
-                    // For this phase we are only interested in the metadata and checking
-                    // if theme has dark-mode components
-                    if (fileName == "_theme.json") {
-                        wxMemoryOutputStream memOut(nullptr);
-                        themeStream.Read(memOut);
-                        const wxStreamBuffer* buffer = memOut.GetOutputStreamBuffer();
-                        wxString metaData(static_cast<char *>(buffer->GetBufferStart()), buffer->GetBufferSize());
-                        if (mmImage::metaData_doc.Parse(metaData.utf8_str()).HasParseError()) {
-                            wxMessageBox(
-                                wxString::Format(_tu("Metadata JSON in Theme “%s” is unable to be parsed and looks badly constructed, please correct."), thisTheme),
-                                _t("Warning"),
-                                wxOK | wxICON_WARNING
-                            );
-                        }
-                    }
-                    else {
-                        if (!mmImage::darkFound && fileNameString.StartsWith("dark-"))
-                            mmImage::darkFound = true;
-                    }
-                    continue;
-                }
+    mmImage::resolveMetaData();
+}
 
-                // Only process dark mode files when in theme and needed
-                if (mmImage::darkFound) {
-                    if (mmImage::darkMode && !fileNameString.StartsWith("dark-"))
-                        continue;
-                    else if (!mmImage::darkMode && fileNameString.StartsWith("dark-"))
-                        continue;
-                }
+void mmImage::processThemeFile(const wxString& themePath, int phases)
+{
+    wxLogDebug("{{{ mmImage::processThemeFile(phases=%d)", phases);
 
-                // Remove dark mode prefix
-                if (mmImage::darkFound && mmImage::darkMode)
-                    fileName = fileName.substr(5);
+    const wxString thisTheme = wxFileName(themePath).GetName();
+    wxFileInputStream themeZip(themePath);
+    wxASSERT(themeZip.IsOk());   // Make sure we can open find the Zip
 
-                // If the file does not match an icon file then just load into VFS / tmp
-                if (!mmImage::iconName2enum.count(fileName)) {
-#if defined(__WXMSW__) || defined(__WXMAC__)
-                    wxMemoryOutputStream memOut(nullptr);
-                    themeStream.Read(memOut);
-                    const wxStreamBuffer* buffer = memOut.GetOutputStreamBuffer();
-
-                    if (wxNOT_FOUND != mmImage::filesInVFS->Index(fileName)) // If already loaded then remove and replace
-                        wxMemoryFSHandler::RemoveFile(fileName);
-                    wxMemoryFSHandler::AddFile(
-                        fileName, buffer->GetBufferStart(), buffer->GetBufferSize()
-                    );
-                    wxLogDebug("Theme: '%s' File: '%s' has been copied to VFS", thisTheme, fileName);
-#else
-                    const wxString theme_file = mmPath::getTempFolder() + fileName;
-                    wxFileOutputStream fileOut(theme_file);
-                    if (!fileOut.IsOk())
-                        wxLogError("Could not copy %s !", fileFullPath);
-                    else
-                        wxLogDebug("Copying file:\n %s \nto\n %s", fileFullPath, theme_file);
-                    themeStream.Read(fileOut);
+    wxZipInputStream themeStream(themeZip);
+    std::unique_ptr<wxZipEntry> themeEntry;
 
-#endif
-                    mmImage::filesInVFS->Add(fileName);
-                    continue;
-                }
+    while (themeEntry.reset(themeStream.GetNextEntry()), themeEntry) { // != nullptr
+        wxASSERT(themeZip.CanRead()); // Make sure we can read the Zip Entry
 
-                // So we have an icon file now, now need to convert from SVG to PNG at various resolutions and store
-                // it away for use
+        const wxFileName fileEntryName = wxFileName(themeEntry->GetName());
+        const wxString fileFullPath = fileEntryName.GetFullPath();
+        const wxString fileEntry = fileEntryName.GetFullName();
+        std::string fileName = std::string(fileEntry.mb_str());
+        const wxString fileNameString(fileName);
 
+        if (fileEntryName.IsDir())
+            continue;   // We can skip directories
+
+        if (phases & PHASE_META) {
+            // For this phase we are only interested in the metadata and checking
+            // if theme has dark-mode components
+            if (fileName == "_theme.json") {
                 wxMemoryOutputStream memOut(nullptr);
                 themeStream.Read(memOut);
                 const wxStreamBuffer* buffer = memOut.GetOutputStreamBuffer();
-
-                int svgEnum = mmImage::iconName2enum.find(fileName)->second.first;
-                for(const auto& sizePair : mmImage::sizes) {
-                    const unsigned int icon_size = sizePair.second;
-                    mmImage::programIconBundles[sizePair.first][svgEnum] = new wxBitmapBundle(
-                        wxBitmapBundle::FromSVG(
-                            static_cast<wxByte*>(buffer->GetBufferStart()),
-                            buffer->GetBufferSize(),
-                            wxSize(icon_size, icon_size)
-                        )
+                wxString metaData(static_cast<char *>(buffer->GetBufferStart()), buffer->GetBufferSize());
+                if (mmImage::metaData_doc.Parse(metaData.utf8_str()).HasParseError()) {
+                    wxMessageBox(
+                        wxString::Format(_tu("Metadata JSON in Theme “%s” is unable to be parsed and looks badly constructed, please correct."), thisTheme),
+                        _t("Warning"),
+                        wxOK | wxICON_WARNING
                     );
                 }
             }
+            else {
+                if (!mmImage::darkFound && fileNameString.StartsWith("dark-"))
+                    mmImage::darkFound = true;
+            }
+            continue;
         }
-        cont = directory.GetNext(&filename);
+
+        // Only process dark mode files when in theme and needed
+        if (mmImage::darkFound) {
+            if (mmImage::darkMode && !fileNameString.StartsWith("dark-"))
+                continue;
+            else if (!mmImage::darkMode && fileNameString.StartsWith("dark-"))
+                continue;
+        }
+
+        // Remove dark mode prefix
+        if (mmImage::darkFound && mmImage::darkMode)
+            fileName = fileName.substr(5);
+
+        // If the file does not match an icon file then just load into VFS / tmp
+        if (!mmImage::iconName2enum.count(fileName)) {
+            if (!(phases & PHASE_FILES))
+                continue;
+#if defined(__WXMSW__) || defined(__WXMAC__)
+            wxMemoryOutputStream memOut(nullptr);
+            themeStream.Read(memOut);
+            const wxStreamBuffer* buffer = memOut.GetOutputStreamBuffer();
+
+            if (wxNOT_FOUND != mmImage::filesInVFS->Index(fileName)) // If already loaded then remove and replace
+                wxMemoryFSHandler::RemoveFile(fileName);
+            wxMemoryFSHandler::AddFile(
+                fileName, buffer->GetBufferStart(), buffer->GetBufferSize()
+            );
+            wxLogDebug("Theme: '%s' File: '%s' has been copied to VFS", thisTheme, fileName);
+#else
+            const wxString theme_file = mmPath::getTempFolder() + fileName;
+            wxFileOutputStream fileOut(theme_file);
+            if (!fileOut.IsOk())
+                wxLogError("Could not copy %s !", fileFullPath);
+            else
+                wxLogDebug("Copying file:\n %s \nto\n %s", fileFullPath, theme_file);
+            themeStream.Read(fileOut);
+
+#endif
+            mmImage::filesInVFS->Add(fileName);
+            continue;
+        }
+
+        int svgEnum = mmImage::iconName2enum.find(fileName)->second.first;
+        mmImage::iconFound_a[svgEnum] = true;
+        if (!(phases & PHASE_ICONS))
+            continue;
+
+        // So we have an icon file now; keep the SVG, it is rasterised on first use
+        wxMemoryOutputStream memOut(nullptr);
+        themeStream.Read(memOut);
+        const wxStreamBuffer* buffer = memOut.GetOutputStreamBuffer();
+        mmImage::svgData_a[svgEnum].assign(
+            static_cast<const char*>(buffer->GetBufferStart()),
+            buffer->GetBufferSize()
+        );
     }
     wxLogDebug("}}}");
-    return themeMatched;
 }
 
 // Check that the loaded theme contains all the minimal files needed
@@ -467,7 +534,7 @@ bool mmImage::checkThemeContents(wxArrayString* filesinTheme)
     const int maxCutOff = 10;
     int erroredIcons = 0;
     for (int i = 0; i < MAX_PNG; i++) {
-        if (!mmImage::programIconBundles[0][i]) {
+        if (!mmImage::iconFound_a[i]) {
             for (auto it = mmImage::iconName2enum.begin(); it != mmImage::iconName2enum.end(); it++) {
                 if (it->second.first == i) {
                     if (erroredIcons <= maxCutOff) {
@@ -502,17 +569,315 @@ bool mmImage::checkThemeContents(wxArrayString* filesinTheme)
 void mmImage::reverttoDefaultTheme()
 {
     SettingModel::instance().saveTheme("default");
-    mmImage::darkFound = false;
-    mmImage::processThemes(
-        mmPath::getPathResource(mmPath::THEMESDIR),
-        SettingModel::instance().getTheme(),
-        true
-    );
-    mmImage::processThemes(
+    mmImage::openTheme(mmImage::findTheme(
         mmPath::getPathResource(mmPath::THEMESDIR),
-        SettingModel::instance().getTheme(),
-        false
-    );
+        SettingModel::instance().getTheme()
+    ));
+}
+
+// Resolve all metadata items, such that lookups do not parse the document.
+void mmImage::resolveMetaData()
+{
+    for (const auto& it : mmImage::metaDataTrans()) {
+        wxString metaValue = mmImage::metaRaw_a[it.first];
+        if (metaValue.IsEmpty() && !std::get<2>(it.second))
+            metaValue = std::get<1>(it.second);
+        mmImage::metaValue_a[it.first] = metaValue;
+    }
+}
+
+// -- icon cache
+
+// Return the hash (FNV-1a) of the content of the theme file, or an empty
+// string if the file cannot be read. The hash is kept in a stamp file with
+// the path, the size and the modification time of the theme file; the theme
+// file is read only when one of them has changed.
+wxString mmImage::getThemeHash(const wxString& themePath)
+{
+    wxFile file(themePath);
+    if (!file.IsOpened())
+        return "";
+
+    const wxFileOffset fileSize = file.Length();
+    const wxDateTime fileTime = wxFileName(themePath).GetModificationTime();
+    const long long fileMsec = fileTime.IsValid() ? fileTime.GetValue().GetValue() : 0;
+
+    wxFileName stampName = mmPath::getPathUserRaw(mmPath::USERCACHE, true);
+    stampName.SetFullName("theme.stamp");
+    const wxString stampFile = stampName.GetFullPath();
+
+    wxString stamp;
+    wxFile stampIn;
+    Document doc;
+    if (wxFileExists(stampFile) &&
+        stampIn.Open(stampFile) &&
+        stampIn.ReadAll(&stamp, wxConvUTF8) &&
+        !doc.Parse(stamp.utf8_str()).HasParseError() && doc.IsObject() &&
+        doc.HasMember("path") && doc["path"].IsString() &&
+        doc.HasMember("size") && doc["size"].IsInt64() &&
+        doc.HasMember("mtime") && doc["mtime"].IsInt64() &&
+        doc.HasMember("hash") && doc["hash"].IsString() &&
+        wxString::FromUTF8(doc["path"].GetString()) == themePath &&
+        doc["size"].GetInt64() == fileSize &&
+        doc["mtime"].GetInt64() == fileMsec
+    )
+        return wxString::FromUTF8(doc["hash"].GetString());
+
+    unsigned long long hashValue = 14695981039346656037ULL;
+    char buffer[65536];
+    ssize_t n;
+    while ((n = file.Read(buffer, sizeof(buffer))) > 0) {
+        for (ssize_t i = 0; i < n; i++) {
+            hashValue ^= static_cast<unsigned char>(buffer[i]);
+            hashValue *= 1099511628211ULL;
+        }
+    }
+    const wxString hash = wxString::Format("%016llx", hashValue);
+
+    StringBuffer json_buffer;
+    Writer<StringBuffer> json_writer(json_buffer);
+    json_writer.StartObject();
+    json_writer.Key("path");
+    json_writer.String(themePath.utf8_str());
+    json_writer.Key("size");
+    json_writer.Int64(fileSize);
+    json_writer.Key("mtime");
+    json_writer.Int64(fileMsec);
+    json_writer.Key("hash");
+    json_writer.String(hash.utf8_str());
+    json_writer.EndObject();
+
+    wxFile stampOut;
+    if (stampOut.Create(stampFile, true))
+        stampOut.Write(wxString::FromUTF8(json_buffer.GetString()), wxConvUTF8);
+
+    return hash;
+}
+
+// The cache of a theme consists of a manifest (<key>.json), with the
+// metadata and the file lists of the theme, and one atlas of rasterised
+// icons (<key>_<px>.png) for each pixel size which has been used.
+wxString mmImage::getCacheFile(const wxString& suffix)
+{
+    wxFileName cacheDir = mmPath::getPathUserRaw(mmPath::USERCACHE, true);
+    cacheDir.SetFullName("theme_" + mmImage::cacheKey + suffix);
+    return cacheDir.GetFullPath();
+}
+
+bool mmImage::loadCache()
+{
+    if (mmImage::cacheKey.IsEmpty())
+        return false;
+
+    const wxString manifestFile = mmImage::getCacheFile(".json");
+    wxString manifest;
+    wxFile file;
+    if (!wxFileExists(manifestFile) ||
+        !file.Open(manifestFile) ||
+        !file.ReadAll(&manifest, wxConvUTF8)
+    )
+        return false;
+
+    Document doc;
+    if (doc.Parse(manifest.utf8_str()).HasParseError() || !doc.IsObject())
+        return false;
+    if (!doc.HasMember("version") || !doc["version"].IsInt() ||
+        doc["version"].GetInt() != mmImage::cacheVersion ||
+        !doc.HasMember("dark") || !doc["dark"].IsBool() ||
+        !doc.HasMember("meta") || !doc["meta"].IsArray() ||
+        doc["meta"].Size() != MAX_METADATA ||
+        !doc.HasMember("icons") || !doc["icons"].IsArray() ||
+        !doc.HasMember("files") || !doc["files"].IsArray() ||
+        !doc.HasMember("atlas") || !doc["atlas"].IsObject()
+    )
+        return false;
+
+    mmImage::darkFound = doc["dark"].GetBool();
+    for (int i = 0; i < MAX_METADATA; i++) {
+        const Value& v = doc["meta"][i];
+        mmImage::metaRaw_a[i] = v.IsString() ? wxString::FromUTF8(v.GetString()) : "";
+    }
+    for (const auto& v : doc["icons"].GetArray()) {
+        if (v.IsInt() && v.GetInt() >= 0 && v.GetInt() < MAX_PNG)
+            mmImage::iconFound_a[v.GetInt()] = true;
+    }
+    for (const auto& v : doc["files"].GetArray()) {
+        if (v.IsString())
+            mmImage::filesInVFS->Add(wxString::FromUTF8(v.GetString()));
+    }
+    for (const auto& m : doc["atlas"].GetObject()) {
+        long px;
+        if (!wxString::FromUTF8(m.name.GetString()).ToLong(&px) || !m.value.IsArray())
+            continue;
+        std::vector<int>& icon_a = mmImage::cachedAtlas_m[static_cast<int>(px)];
+        for (const auto& v : m.value.GetArray()) {
+            if (v.IsInt() && v.GetInt() >= 0 && v.GetInt() < MAX_PNG)
+                icon_a.push_back(v.GetInt());
+        }
+    }
+
+    wxLogDebug("mmImage::loadCache: %s", manifestFile);
+    return true;
+}
+
+void mmImage::saveCache()
+{
+    if (mmImage::cacheKey.IsEmpty())
+        return;
+
+    bool atlasDirty = false;
+    for (auto& [px, atlas] : mmImage::atlas_m) {
+        if (!atlas.m_is_dirty)
+            continue;
+        std::vector<int>& icon_a = mmImage::cachedAtlas_m[px];
+        icon_a.clear();
+        for (int i = 0; i < MAX_PNG; i++) {
+            if (atlas.m_has_a[i])
+                icon_a.push_back(i);
+        }
+        if (!atlas.m_image.SaveFile(
+            mmImage::getCacheFile(wxString::Format("_%d.png", px)),
+            wxBITMAP_TYPE_PNG
+        )) {
+            mmImage::cachedAtlas_m.erase(px);
+        }
+        atlas.m_is_dirty = false;
+        atlasDirty = true;
+    }
+    if (!mmImage::cacheDirty && !atlasDirty)
+        return;
+
+    StringBuffer json_buffer;
+    Writer<StringBuffer> json_writer(json_buffer);
+    json_writer.StartObject();
+    json_writer.Key("version");
+    json_writer.Int(mmImage::cacheVersion);
+    json_writer.Key("dark");
+    json_writer.Bool(mmImage::darkFound);
+    json_writer.Key("meta");
+    json_writer.StartArray();
+    for (int i = 0; i < MAX_METADATA; i++)
+        json_writer.String(mmImage::metaRaw_a[i].utf8_str());
+    json_writer.EndArray();
+    json_writer.Key("icons");
+    json_writer.StartArray();
+    for (int i = 0; i < MAX_PNG; i++) {
+        if (mmImage::iconFound_a[i])
+            json_writer.Int(i);
+    }
+    json_writer.EndArray();
+    json_writer.Key("files");
+    json_writer.StartArray();
+    for (const auto& fileName : *mmImage::filesInVFS)
+        json_writer.String(fileName.utf8_str());
+    json_writer.EndArray();
+    json_writer.Key("atlas");
+    json_writer.StartObject();
+    for (const auto& [px, icon_a] : mmImage::cachedAtlas_m) {
+        json_writer.Key(wxString::Format("%d", px).utf8_str());
+        json_writer.StartArray();
+        for (int i : icon_a)
+            json_writer.Int(i);
+        json_writer.EndArray();
+    }
+    json_writer.EndObject();
+    json_writer.EndObject();
+
+    wxFile file;
+    if (file.Create(mmImage::getCacheFile(".json"), true))
+        file.Write(wxString::FromUTF8(json_buffer.GetString()), wxConvUTF8);
+    mmImage::cacheDirty = false;
+
+    // remove the cache files of other versions of this and other themes
+    const wxString keyPrefix = "theme_" + mmImage::cacheKey.BeforeLast('_');
+    wxFileName cacheDir = mmPath::getPathUserRaw(mmPath::USERCACHE, false);
+    wxDir dir(cacheDir.GetPath());
+    if (dir.IsOpened()) {
+        wxArrayString oldFile_a;
+        wxString filename;
+        bool cont = dir.GetFirst(&filename, "theme_*", wxDIR_FILES);
+        while (cont) {
+            if (!filename.StartsWith(keyPrefix))
+                oldFile_a.Add(filename);
+            cont = dir.GetNext(&filename);
+        }
+        for (const auto& oldFile : oldFile_a)
+            wxRemoveFile(wxFileName(cacheDir.GetPath(), oldFile).GetFullPath());
+    }
+}
+
+mmImage::Atlas& mmImage::getAtlas(int px)
+{
+    auto it = mmImage::atlas_m.find(px);
+    if (it != mmImage::atlas_m.end())
+        return it->second;
+
+    Atlas& atlas = mmImage::atlas_m[px];
+    atlas.m_has_a.assign(MAX_PNG, false);
+
+    auto cached_it = mmImage::cachedAtlas_m.find(px);
+    if (cached_it != mmImage::cachedAtlas_m.end()) {
+        wxImage image;
+        const wxString atlasFile = mmImage::getCacheFile(wxString::Format("_%d.png", px));
+        if (wxFileExists(atlasFile) &&
+            image.LoadFile(atlasFile, wxBITMAP_TYPE_PNG) &&
+            image.GetWidth() == px * MAX_PNG && image.GetHeight() == px
+        ) {
+            if (!image.HasAlpha())
+                image.InitAlpha();
+            atlas.m_image = image;
+            for (int i : cached_it->second)
+                atlas.m_has_a[i] = true;
+            return atlas;
+        }
+    }
+
+    atlas.m_image = wxImage(px * MAX_PNG, px);
+    atlas.m_image.InitAlpha();
+    memset(atlas.m_image.GetAlpha(), 0, static_cast<size_t>(px) * MAX_PNG * px);
+    return atlas;
+}
+
+// Return icon ref rasterised at px pixels. The icon is taken from the atlas;
+// on a miss, it is rasterised from the SVG in the theme and added to the atlas.
+wxBitmap mmImage::getRaster(int ref, int px)
+{
+    if (!mmImage::iconFound_a[ref])
+        return wxNullBitmap;
+
+    Atlas& atlas = mmImage::getAtlas(px);
+    if (!atlas.m_has_a[ref]) {
+        wxStopWatch sw;
+        if (!mmImage::svgLoaded) {
+            mmImage::processThemeFile(mmImage::themeFile, PHASE_ICONS);
+            mmImage::svgLoaded = true;
+        }
+        const std::string& svg = mmImage::svgData_a[ref];
+        if (svg.empty())
+            return wxNullBitmap;
+
+        const wxSize size(px, px);
+        wxImage icon = wxBitmapBundle::FromSVG(
+            reinterpret_cast<const wxByte*>(svg.data()), svg.size(), size
+        ).GetBitmap(size).ConvertToImage();
+        if (!icon.HasAlpha())
+            icon.InitAlpha();
+
+        const int x0 = ref * px;
+        for (int y = 0; y < px && y < icon.GetHeight(); y++) {
+            for (int x = 0; x < px && x < icon.GetWidth(); x++) {
+                atlas.m_image.SetRGB(x0 + x, y,
+                    icon.GetRed(x, y), icon.GetGreen(x, y), icon.GetBlue(x, y)
+                );
+                atlas.m_image.SetAlpha(x0 + x, y, icon.GetAlpha(x, y));
+            }
+        }
+        atlas.m_has_a[ref] = true;
+        atlas.m_is_dirty = true;
+        mmImage::rasterMsec += sw.Time();
+    }
+
+    return wxBitmap(atlas.m_image.GetSubImage(wxRect(ref * px, 0, px, px)));
 }
 
 void mmImage::loadTheme()
@@ -525,40 +890,29 @@ void mmImage::loadTheme()
     );
     mmImage::filesInVFS = new wxArrayString();
 
-    // Scan first for metadata then for the icons and other files
-    mmImage::darkFound = false;
-    if (mmImage::processThemes(
+    // Look first in the resources, then in the user themes
+    wxString themePath = mmImage::findTheme(
         mmPath::getPathResource(mmPath::THEMESDIR),
-        SettingModel::instance().getTheme(),
-        true
-    ))
-        mmImage::processThemes(
-            mmPath::getPathResource(mmPath::THEMESDIR),
-            SettingModel::instance().getTheme(),
-            false
+        SettingModel::instance().getTheme()
+    );
+    if (themePath.IsEmpty())
+        themePath = mmImage::findTheme(
+            mmPath::getPathUser(mmPath::USERTHEMEDIR),
+            SettingModel::instance().getTheme()
         );
-    else
-        if (
-            mmImage::processThemes(
-                mmPath::getPathUser(mmPath::USERTHEMEDIR),
-                SettingModel::instance().getTheme(),
-                true
-            ))
-            mmImage::processThemes(
-                mmPath::getPathUser(mmPath::USERTHEMEDIR),
-                SettingModel::instance().getTheme(),
-                false
-            );
-        else {
-            wxMessageBox(
-                wxString::Format(_t("Theme %s not found; it may no longer be supported. Reverting to the default theme."),
-                    SettingModel::instance().getTheme()
-                ),
-                _t("Warning"),
-                wxOK | wxICON_WARNING
-            );
-            mmImage::reverttoDefaultTheme();
-        }
+
+    if (!themePath.IsEmpty())
+        mmImage::openTheme(themePath);
+    else {
+        wxMessageBox(
+            wxString::Format(_t("Theme %s not found; it may no longer be supported. Reverting to the default theme."),
+                SettingModel::instance().getTheme()
+            ),
+            _t("Warning"),
+            wxOK | wxICON_WARNING
+        );
+        mmImage::reverttoDefaultTheme();
+    }
 
     if (!mmImage::checkThemeContents(mmImage::filesInVFS.get())) {
         wxMessageBox(
@@ -583,26 +937,19 @@ void mmImage::loadTheme()
 
 void mmImage::closeTheme()
 {
+    mmImage::saveCache();
+
     // Release icons - needed before app closure
     // https://github.com/wxWidgets/wxWidgets/issues/22862
     for (int i = 0; i < mmImage::numSizes; i++)
         for (int j = 0; j < MAX_PNG; j++)
             mmImage::programIconBundles[i][j].reset();
+    mmImage::atlas_m.clear();
 }
 
 const wxString mmImage::themeMetaString(int ref)
 {
-    auto i = mmImage::metaDataTrans().find(ref)->second;
-    wxString metaLocation = std::get<0>(i);
-    if (mmImage::darkFound && mmImage::darkMode && !metaLocation.StartsWith("/theme"))
-        metaLocation.Prepend("/dark");
-    const Pointer ptr(metaLocation.mb_str());
-    wxString metaValue = wxString::FromUTF8(
-        GetValueByPointerWithDefault(mmImage::metaData_doc, ptr, "").GetString()
-    );
-    if (metaValue.IsEmpty() && !std::get<2>(i))
-        metaValue = std::get<1>(i);
-    return (metaValue);
+    return mmImage::metaValue_a[ref];
 }
 
 // helpers
@@ -649,9 +996,54 @@ const std::vector<wxColour> mmImage::themeMetaColour_a(int ref)
     return colours;
 }
 
+// The icon is rasterised from the SVG at the pixel size of each scale the
+// bundle is asked for (also at fractional scales, e.g. 20px at 125%), and
+// each pixel size is kept in its atlas.
+class mmImage::BundleImpl : public wxBitmapBundleImpl
+{
+public:
+    BundleImpl(int ref, int px) : m_ref(ref), m_px(px) {}
+
+    wxSize GetDefaultSize() const override
+    {
+        return wxSize(m_px, m_px);
+    }
+
+    wxSize GetPreferredBitmapSizeAtScale(double scale) const override
+    {
+        const int px = wxRound(m_px * scale);
+        return wxSize(px, px);
+    }
+
+    wxBitmap GetBitmap(const wxSize& size) override
+    {
+        auto it = m_px_bitmap_m.find(size.GetWidth());
+        if (it == m_px_bitmap_m.end()) {
+            it = m_px_bitmap_m.emplace(
+                size.GetWidth(), mmImage::getRaster(m_ref, size.GetWidth())
+            ).first;
+        }
+        return it->second;
+    }
+
+private:
+    int m_ref;
+    int m_px;
+    std::map<int, wxBitmap> m_px_bitmap_m;
+};
+
+// The bundle of each size is created on first use.
 const wxBitmapBundle mmImage::bitmapBundle(const int ref, const int defSize)
 {
     const int idx = mmImage::getIconSizeIdx(defSize);
+    if (!mmImage::programIconBundles[idx][ref]) {
+        const int px = mmImage::sizes[idx].second;
+        mmImage::programIconBundles[idx][ref] = new wxBitmapBundle(
+            mmImage::iconFound_a[ref]
+                ? wxBitmapBundle::FromImpl(new BundleImpl(ref, px))
+                : wxBitmapBundle()
+        );
+    }
     return *mmImage::programIconBundles[idx][ref];
 }
 
@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "base/_defs.h"
 #include <wx/bmpbndl.h>
+#include <wx/image.h>
 #include <wx/window.h>
 #include <wx/arrstr.h>
 
@@ -243,6 +244,26 @@ private:
     static const std::vector<std::pair<int, int>> sizes;
     static const std::map<std::string, std::pair<int, bool>> iconName2enum;
 
+    // Bump when the format of the cache files changes
+    static constexpr int cacheVersion = 1;
+
+    // Parts of a theme file read by processThemeFile()
+    enum phase {
+        PHASE_META  = 1,
+        PHASE_FILES = 2,
+        PHASE_ICONS = 4,
+    };
+
+    // Bundle of one icon, rasterised at the pixel size of each scale
+    class BundleImpl;
+
+    // Icons rasterised at one pixel size, side by side in the order of png
+    struct Atlas {
+        wxImage m_image;
+        std::vector<bool> m_has_a;
+        bool m_is_dirty = false;
+    };
+
 // -- static state
 
 private:
@@ -251,18 +272,43 @@ private:
     static wxSharedPtr<wxBitmapBundle> programIconBundles[mmImage::numSizes][mmImage::MAX_PNG];
     static wxSharedPtr<wxArrayString> filesInVFS;
 
+    static wxString themeFile;
+    static wxString cacheKey;
+    static bool cacheHit, cacheDirty, svgLoaded;
+    static long rasterMsec;
+    // metadata as found in the theme, and resolved with defaults
+    static wxString metaRaw_a[MAX_METADATA];
+    static wxString metaValue_a[MAX_METADATA];
+    static bool iconFound_a[MAX_PNG];
+    static std::string svgData_a[MAX_PNG];
+    static std::map<int, Atlas> atlas_m;
+    // icons in the cached atlas of each pixel size
+    static std::map<int, std::vector<int>> cachedAtlas_m;
+
 // -- static methods
 
 private:
     static auto metaDataTrans() -> const std::map<int, std::tuple<wxString, wxString, bool>>;
     static int  getIconSizeIdx(const int iconSize);
-    static bool processThemes(wxString themeDir, wxString myTheme, bool metaPhase);
+    static auto findTheme(const wxString& themeDir, const wxString& myTheme) -> wxString;
+    static void openTheme(const wxString& themePath);
+    static void processThemeFile(const wxString& themePath, int phases);
     static bool checkThemeContents(wxArrayString* filesinTheme);
     static void reverttoDefaultTheme();
+    static void resolveMetaData();
+
+    static auto getThemeHash(const wxString& themePath) -> wxString;
+    static auto getCacheFile(const wxString& suffix) -> wxString;
+    static bool loadCache();
+    static void saveCache();
+    static auto getAtlas(int px) -> Atlas&;
+    static auto getRaster(int ref, int px) -> wxBitmap;
 
 public:
     static void loadTheme();
     static void closeTheme();
+    static bool isCacheHit() { return cacheHit; }
+    static long rasterTime() { return rasterMsec; }
     static auto themeMetaString(int ref) -> const wxString;
     static long themeMetaLong(int ref);
     static auto themeMetaColour(int ref) -> const wxColour;
@@ -0,0 +1,268 @@
+/*******************************************************
+ Copyright (C) 2026 George Ef (george.a.ef@gmail.com)
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include <algorithm>
+
+#include "mmNameIndex.h"
+
+// -- mmNameIndex
+
+const mmNameIndex::Entry* mmNameIndex::get_entry_n(int64 id) const
+{
+    auto it = m_id_entry_m.find(id);
+    return (it != m_id_entry_m.end()) ? &it->second : nullptr;
+}
+
+void mmNameIndex::clear()
+{
+    m_id_entry_m.clear();
+    m_fold_id_m.clear();
+    m_gram_idA_m.clear();
+}
+
+// Add or replace the name of id. The usage count of id is kept.
+void mmNameIndex::set(int64 id, const wxString& name)
+{
+    std::size_t usage_c = 0;
+    const Entry* entry_n = get_entry_n(id);
+    if (entry_n) {
+        if (entry_n->m_name == name)
+            return;
+        usage_c = entry_n->m_usage_c;
+        remove(id);
+    }
+
+    Entry entry;
+    entry.m_name    = name;
+    entry.m_fold    = fold(name);
+    entry.m_usage_c = usage_c;
+
+    m_fold_id_m.emplace(entry.m_fold, id);
+    for (const wxString& gram : get_gram_a(entry.m_fold))
+        m_gram_idA_m[gram].push_back(id);
+    m_id_entry_m.emplace(id, std::move(entry));
+}
+
+void mmNameIndex::remove(int64 id)
+{
+    auto entry_it = m_id_entry_m.find(id);
+    if (entry_it == m_id_entry_m.end())
+        return;
+
+    const wxString& fold = entry_it->second.m_fold;
+    auto range = m_fold_id_m.equal_range(fold);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == id) {
+            m_fold_id_m.erase(it);
+            break;
+        }
+    }
+
+    for (const wxString& gram : get_gram_a(fold)) {
+        auto gram_it = m_gram_idA_m.find(gram);
+        if (gram_it == m_gram_idA_m.end())
+            continue;
+        std::vector<int64>& id_a = gram_it->second;
+        id_a.erase(std::remove(id_a.begin(), id_a.end(), id), id_a.end());
+        if (id_a.empty())
+            m_gram_idA_m.erase(gram_it);
+    }
+
+    m_id_entry_m.erase(entry_it);
+}
+
+void mmNameIndex::set_usage(int64 id, std::size_t usage_c)
+{
+    auto it = m_id_entry_m.find(id);
+    if (it != m_id_entry_m.end())
+        it->second.m_usage_c = usage_c;
+}
+
+void mmNameIndex::clear_usage()
+{
+    for (auto& [id, entry] : m_id_entry_m)
+        entry.m_usage_c = 0;
+}
+
+// Return the ids of the names which are equal to text, ignoring case.
+std::vector<int64> mmNameIndex::find_fold_id_a(const wxString& text) const
+{
+    std::vector<int64> id_a;
+    auto range = m_fold_id_m.equal_range(fold(text));
+    for (auto it = range.first; it != range.second; ++it)
+        id_a.push_back(it->second);
+
+    rank(id_a);
+    return id_a;
+}
+
+// Return the ids of the names which start with text, ignoring case.
+std::vector<int64> mmNameIndex::find_prefix_id_a(const wxString& text) const
+{
+    const wxString text_fold = fold(text);
+    std::vector<int64> id_a;
+    for (auto it = m_fold_id_m.lower_bound(text_fold);
+        it != m_fold_id_m.end() && it->first.StartsWith(text_fold);
+        ++it
+    ) {
+        id_a.push_back(it->second);
+    }
+
+    rank(id_a);
+    return id_a;
+}
+
+// Return the ids of the names which contain text, ignoring case.
+// If text has at least three characters, only the names in the shortest
+// posting list of its trigrams are compared; otherwise all names are compared.
+std::vector<int64> mmNameIndex::find_substr_id_a(const wxString& text) const
+{
+    const wxString text_fold = fold(text);
+    std::vector<int64> id_a;
+
+    if (text_fold.length() < s_gram_len) {
+        for (const auto& [id, entry] : m_id_entry_m) {
+            if (entry.m_fold.Contains(text_fold))
+                id_a.push_back(id);
+        }
+        rank(id_a);
+        return id_a;
+    }
+
+    const std::vector<int64>* posting_n = nullptr;
+    for (const wxString& gram : get_gram_a(text_fold)) {
+        auto it = m_gram_idA_m.find(gram);
+        if (it == m_gram_idA_m.end())
+            return id_a;
+        if (!posting_n || it->second.size() < posting_n->size())
+            posting_n = &it->second;
+    }
+
+    for (int64 id : *posting_n) {
+        if (m_id_entry_m.at(id).m_fold.Contains(text_fold))
+            id_a.push_back(id);
+    }
+
+    rank(id_a);
+    return id_a;
+}
+
+// Return the distinct trigrams of fold.
+std::vector<wxString> mmNameIndex::get_gram_a(const wxString& fold)
+{
+    std::vector<wxString> gram_a;
+    if (fold.length() < s_gram_len)
+        return gram_a;
+
+    for (std::size_t i = 0; i + s_gram_len <= fold.length(); ++i)
+        gram_a.push_back(fold.Mid(i, s_gram_len));
+    std::sort(gram_a.begin(), gram_a.end());
+    gram_a.erase(std::unique(gram_a.begin(), gram_a.end()), gram_a.end());
+    return gram_a;
+}
+
+void mmNameIndex::rank(std::vector<int64>& id_a) const
+{
+    std::sort(id_a.begin(), id_a.end(), [this](int64 x_id, int64 y_id) {
+        const Entry& x = m_id_entry_m.at(x_id);
+        const Entry& y = m_id_entry_m.at(y_id);
+        if (x.m_usage_c != y.m_usage_c)
+            return x.m_usage_c > y.m_usage_c;
+        if (x.m_fold != y.m_fold)
+            return x.m_fold < y.m_fold;
+        return x.m_name < y.m_name;
+    });
+}
+
+// -- mmSharedNameIndex
+
+mmSharedNameIndex::mmSharedNameIndex(
+    const wxString& table_name,
+    VersionFn version_fn,
+    LoadFn load_fn,
+    LoadIdFn load_id_fn,
+    const std::vector<wxString>& usage_table_a,
+    LoadFn usage_fn
+) :
+    m_table_name(table_name),
+    m_version_fn(std::move(version_fn)),
+    m_load_fn(std::move(load_fn)),
+    m_load_id_fn(std::move(load_id_fn)),
+    m_usage_table_a(usage_table_a),
+    m_usage_fn(std::move(usage_fn))
+{
+    // TableChangeBus::instance() is constructed before this object, so the
+    // bus is still alive when a static index is destroyed.
+    m_change_handle = TableChangeBus::instance().subscribe(
+        [this](const TableChangeM& change_m) { on_change(change_m); }
+    );
+}
+
+mmSharedNameIndex::~mmSharedNameIndex()
+{
+    TableChangeBus::instance().unsubscribe(m_change_handle);
+}
+
+// Return the index, after it is brought up to date.
+const mmNameIndex& mmSharedNameIndex::get()
+{
+    // apply committed changes which have not been delivered to this index
+    if (m_is_valid && m_version != m_version_fn())
+        TableChangeBus::instance().deliver(m_change_handle);
+
+    if (!m_is_valid || m_version != m_version_fn()) {
+        m_index.clear();
+        m_load_fn(m_index);
+        m_version = m_version_fn();
+        m_is_valid = true;
+        m_is_usage_valid = false;
+    }
+
+    if (!m_is_usage_valid && m_usage_fn) {
+        m_index.clear_usage();
+        m_usage_fn(m_index);
+        m_is_usage_valid = true;
+    }
+
+    return m_index;
+}
+
+void mmSharedNameIndex::on_change(const TableChangeM& change_m)
+{
+    for (const wxString& table_name : m_usage_table_a) {
+        if (change_m.find(table_name) != change_m.end())
+            m_is_usage_valid = false;
+    }
+
+    auto it = change_m.find(m_table_name);
+    if (it == change_m.end() || !m_is_valid)
+        return;
+
+    const TableChange& change = it->second;
+    if (change.m_is_all || !m_load_id_fn) {
+        m_is_valid = false;
+        return;
+    }
+
+    for (const int64& id : change.m_id_s)
+        m_load_id_fn(m_index, id);
+
+    // changes of an open transaction are not included; rebuild on next use
+    if (!TableChangeBus::instance().has_pending())
+        m_version = m_version_fn();
+}
@@ -0,0 +1,130 @@
+/*******************************************************
+ Copyright (C) 2026 George Ef (george.a.ef@gmail.com)
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+#include "base/_types.h"
+#include "table/_TableChange.h"
+
+// mmNameIndex is a case-insensitive index of names, for autocompletion.
+// Each name is case-folded once, when it is added. An ordered map of folded
+// names serves exact and prefix lookups; trigram postings serve substring
+// lookups. Results are ranked by usage count (descending), then by name.
+class mmNameIndex
+{
+public:
+    struct Entry
+    {
+        wxString    m_name;
+        wxString    m_fold;
+        std::size_t m_usage_c = 0;
+    };
+
+    static auto fold(const wxString& name) -> wxString { return name.Lower(); }
+
+// -- state
+
+private:
+    static constexpr std::size_t s_gram_len = 3;
+
+    std::unordered_map<int64, Entry> m_id_entry_m;
+    std::multimap<wxString, int64> m_fold_id_m;
+    // ids of the names whose folded text contains each trigram
+    std::unordered_map<wxString, std::vector<int64>> m_gram_idA_m;
+
+// -- methods
+
+public:
+    auto size() const -> std::size_t { return m_id_entry_m.size(); }
+    auto get_entry_n(int64 id) const -> const Entry*;
+
+    void clear();
+    void set(int64 id, const wxString& name);
+    void remove(int64 id);
+    void set_usage(int64 id, std::size_t usage_c);
+    void clear_usage();
+
+    auto find_fold_id_a(const wxString& text) const -> std::vector<int64>;
+    auto find_prefix_id_a(const wxString& text) const -> std::vector<int64>;
+    auto find_substr_id_a(const wxString& text) const -> std::vector<int64>;
+
+private:
+    static auto get_gram_a(const wxString& fold) -> std::vector<wxString>;
+    void rank(std::vector<int64>& id_a) const;
+};
+
+// mmSharedNameIndex keeps the mmNameIndex of a model table, shared by all
+// combo boxes of a type.
+// Rows reported by TableChangeBus are updated one by one if load_id_fn is
+// given; otherwise, and if the table has changed in a way not reported by the
+// bus, the index is rebuilt on next use. Usage counts are reloaded when one
+// of the usage tables has changed.
+class mmSharedNameIndex
+{
+public:
+    using VersionFn = std::function<std::size_t()>;
+    using LoadFn    = std::function<void(mmNameIndex&)>;
+    // set or remove the entry of one id
+    using LoadIdFn  = std::function<void(mmNameIndex&, int64)>;
+
+// -- state
+
+private:
+    wxString              m_table_name;
+    VersionFn             m_version_fn;
+    LoadFn                m_load_fn;
+    LoadIdFn              m_load_id_fn;
+    std::vector<wxString> m_usage_table_a;
+    LoadFn                m_usage_fn;
+
+    mmNameIndex m_index;
+    bool        m_is_valid = false;
+    bool        m_is_usage_valid = false;
+    std::size_t m_version = 0;
+    int         m_change_handle = 0;
+
+// -- constructor
+
+public:
+    mmSharedNameIndex(
+        const wxString& table_name,
+        VersionFn version_fn,
+        LoadFn load_fn,
+        LoadIdFn load_id_fn = nullptr,
+        const std::vector<wxString>& usage_table_a = {},
+        LoadFn usage_fn = nullptr
+    );
+    ~mmSharedNameIndex();
+    mmSharedNameIndex(const mmSharedNameIndex&) = delete;
+    mmSharedNameIndex& operator=(const mmSharedNameIndex&) = delete;
+
+// -- methods
+
+public:
+    auto get() -> const mmNameIndex&;
+    void reset() { m_is_valid = false; }
+
+private:
+    void on_change(const TableChangeM& change_m);
+};
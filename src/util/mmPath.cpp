@@ -199,7 +199,8 @@ const wxFileName mmPath::getPathUserRaw(EUserFile f, bool create)
       mmPath::getSettingsFileName(),
       mmPath::getDirectory(),
       mmPath::getUserTheme(),
-      mmPath::getIconDir()
+      mmPath::getIconDir(),
+      mmPath::getCacheDir()
     };
 
     wxASSERT(f >= 0 && f < USER_FILES_MAX);
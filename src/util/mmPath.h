@@ -63,6 +63,7 @@ struct mmPath
         DIRECTORY,
         USERTHEMEDIR,
         USERICONS,
+        USERCACHE,
         USER_FILES_MAX
     };
 
@@ -70,6 +71,7 @@ struct mmPath
     static auto getUserTheme() -> const wxString { return "themes"; }
     static auto getDirectory() -> const wxString { return ""; }
     static auto getIconDir() -> const wxString { return "icons"; }
+    static auto getCacheDir() -> const wxString { return "cache"; }
     static auto getSettingsPathPortable() -> wxFileName;
     static auto getUserDir(bool create) -> const wxFileName;
     static auto getLogDir(bool create) -> const wxFileName;
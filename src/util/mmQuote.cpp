@@ -0,0 +1,628 @@
+/*******************************************************
+ Copyright (C) 2026 George Ef (george.a.ef@gmail.com)
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <thread>
+#include <rapidjson/document.h>
+#include <wx/regex.h>
+#include <wx/tokenzr.h>
+
+#include "base/_defs.h"
+#include "base/_constants.h"
+#include "model/SettingModel.h"
+#include "mmQuote.h"
+
+using Clock = std::chrono::steady_clock;
+
+static size_t http_write_string(void* contents, size_t size, size_t nmemb, void* userp)
+{
+    static_cast<std::string*>(userp)->append(static_cast<char*>(contents), size * nmemb);
+    return size * nmemb;
+}
+
+static void http_set_options(CURL* curl, const mmHttpConfig& config)
+{
+    if (!config.m_proxy.IsEmpty())
+        curl_easy_setopt(curl, CURLOPT_PROXY, static_cast<const char*>(config.m_proxy.mb_str()));
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, config.m_timeout);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, config.m_connect_timeout);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, static_cast<const char*>(config.m_useragent.mb_str()));
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+}
+
+static int http_abort_callback(void* clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+{
+    const std::atomic<bool>* abort_n = static_cast<const std::atomic<bool>*>(clientp);
+    return abort_n->load() ? 1 : 0;
+}
+
+void http_set_abort(CURL* curl, const std::atomic<bool>* abort_n)
+{
+    if (!abort_n)
+        return;
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, http_abort_callback);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, const_cast<std::atomic<bool>*>(abort_n));
+}
+
+// -- mmHttpConfig
+
+auto mmHttpConfig::from_settings() -> mmHttpConfig
+{
+    mmHttpConfig config;
+    const wxString proxyName = SettingModel::instance().getString("PROXYIP", "");
+    if (!proxyName.IsEmpty())
+        config.m_proxy = wxString::Format("%s:%d",
+            proxyName, SettingModel::instance().getInt("PROXYPORT", 0)
+        );
+    config.m_timeout = SettingModel::instance().getInt("NETWORKTIMEOUT", 10);
+    config.m_useragent = wxString::Format("%s/%s",
+        mmex::getProgramName(), mmex::version::string
+    );
+    return config;
+}
+
+// -- http_get_multi
+
+auto http_get_multi(
+    const std::vector<wxString>& url_a,
+    const mmHttpConfig& config,
+    const std::vector<wxString>& header_a,
+    const std::atomic<bool>* abort_n
+) -> std::vector<mmHttpResult>
+{
+    struct Transfer
+    {
+        std::size_t m_i;
+        int m_attempt_c;
+        Clock::time_point m_start_t;  // not before
+        CURL* m_curl = nullptr;
+        std::string m_body;
+    };
+
+    std::vector<mmHttpResult> result_a(url_a.size());
+    if (url_a.empty())
+        return result_a;
+
+    CURLM* multi = curl_multi_init();
+    if (!multi) {
+        for (auto& result : result_a) {
+            result.m_code = CURLE_FAILED_INIT;
+            result.m_body = curl_easy_strerror(CURLE_FAILED_INIT);
+        }
+        return result_a;
+    }
+
+    struct curl_slist* headers = nullptr;
+    for (const wxString& header : header_a)
+        headers = curl_slist_append(headers, static_cast<const char*>(header.mb_str()));
+
+    const auto interval = std::chrono::milliseconds(config.m_interval_msec);
+    std::deque<Transfer> queue;
+    for (std::size_t i = 0; i < url_a.size(); ++i)
+        queue.push_back({i, 0, Clock::now()});
+    // transfers in flight, keyed by their easy handle
+    std::map<CURL*, Transfer> active_m;
+    Clock::time_point last_start_t = Clock::now() - interval;
+
+    while (!queue.empty() || !active_m.empty()) {
+        if (abort_n && abort_n->load()) {
+            for (auto& [curl, transfer] : active_m) {
+                result_a[transfer.m_i].m_code = CURLE_ABORTED_BY_CALLBACK;
+                curl_multi_remove_handle(multi, curl);
+                curl_easy_cleanup(curl);
+            }
+            active_m.clear();
+            for (const Transfer& transfer : queue)
+                result_a[transfer.m_i].m_code = CURLE_ABORTED_BY_CALLBACK;
+            queue.clear();
+            for (auto& result : result_a) {
+                if (result.m_code == CURLE_ABORTED_BY_CALLBACK)
+                    result.m_body = curl_easy_strerror(CURLE_ABORTED_BY_CALLBACK);
+            }
+            break;
+        }
+
+        // start new transfers, within the connection and rate limits
+        Clock::time_point now = Clock::now();
+        while (!queue.empty() &&
+            static_cast<int>(active_m.size()) < config.m_conn_max &&
+            queue.front().m_start_t <= now &&
+            now - last_start_t >= interval
+        ) {
+            Transfer transfer = std::move(queue.front());
+            queue.pop_front();
+            CURL* curl = curl_easy_init();
+            if (!curl) {
+                result_a[transfer.m_i].m_code = CURLE_FAILED_INIT;
+                result_a[transfer.m_i].m_body = curl_easy_strerror(CURLE_FAILED_INIT);
+                continue;
+            }
+            transfer.m_curl = curl;
+            Transfer& t = active_m.emplace(curl, std::move(transfer)).first->second;
+            http_set_options(curl, config);
+            http_set_abort(curl, abort_n);
+            if (headers)
+                curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+            curl_easy_setopt(curl, CURLOPT_URL, static_cast<const char*>(url_a[t.m_i].mb_str()));
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, http_write_string);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &t.m_body);
+            curl_multi_add_handle(multi, curl);
+            last_start_t = now;
+        }
+
+        int running_c = 0;
+        curl_multi_perform(multi, &running_c);
+
+        int msg_c = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &msg_c)) {
+            if (msg->msg != CURLMSG_DONE)
+                continue;
+            CURL* curl = msg->easy_handle;
+            auto it = active_m.find(curl);
+            Transfer transfer = std::move(it->second);
+            active_m.erase(it);
+
+            mmHttpResult& result = result_a[transfer.m_i];
+            result.m_code = msg->data.result;
+            result.m_status = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &result.m_status);
+            curl_multi_remove_handle(multi, curl);
+            curl_easy_cleanup(curl);
+
+            bool is_retry = result.m_code != CURLE_OK ||
+                result.m_status == 429 || result.m_status >= 500;
+            if (is_retry && transfer.m_attempt_c < config.m_retry_max) {
+                transfer.m_attempt_c++;
+                transfer.m_start_t = Clock::now() + interval * (2 << transfer.m_attempt_c);
+                transfer.m_body.clear();
+                transfer.m_curl = nullptr;
+                queue.push_back(std::move(transfer));
+                continue;
+            }
+
+            if (result.m_code == CURLE_OK)
+                result.m_body = wxString::FromUTF8(transfer.m_body.c_str());
+            else {
+                result.m_body = curl_easy_strerror(result.m_code);
+                wxLogDebug("http_get_multi: URL = %s error = %s", url_a[transfer.m_i], result.m_body);
+            }
+        }
+
+        if (!active_m.empty())
+            curl_multi_wait(multi, nullptr, 0, 100, nullptr);
+        else if (!queue.empty())
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    curl_slist_free_all(headers);
+    curl_multi_cleanup(multi);
+    return result_a;
+}
+
+// -- mmQuote
+
+auto mmQuote::Config::from_settings() -> Config
+{
+    Config config;
+    config.m_http = mmHttpConfig::from_settings();
+    config.m_quote_url = mmex::weblink::YahooQuotes;
+    config.m_cookie_url = mmex::weblink::YahooCookie;
+    config.m_consent_url = mmex::weblink::YahooConsent;
+    config.m_crumb_url = mmex::weblink::YahooCrumb;
+    config.m_coincap_search_url = mmex::weblink::CoinCapSearch;
+    config.m_cookie = SettingModel::instance().getString("YAHOO_FINANCE_COOKIE", "");
+    config.m_crumb = SettingModel::instance().getString("YAHOO_FINANCE_CRUMB", "");
+    return config;
+}
+
+void mmQuote::save_session(const Result& result)
+{
+    if (!result.m_is_session_new)
+        return;
+    SettingModel::instance().saveString("YAHOO_FINANCE_COOKIE", result.m_cookie);
+    SettingModel::instance().saveString("YAHOO_FINANCE_CRUMB", result.m_crumb);
+}
+
+// Return true if symbol can be sent to Yahoo, i.e., if it matches
+// ^[\^-a-zA-Z0-9_@=\.]+$
+bool mmQuote::is_symbol(const wxString& symbol)
+{
+    if (symbol.IsEmpty())
+        return false;
+    for (const wxUniChar& c : symbol) {
+        const wxUniChar::value_type a = c.GetValue();
+        if (!((a >= '^' && a <= 'z') || (a >= 'A' && a <= 'Z') ||
+            (a >= '0' && a <= '9') || a == '@' || a == '=' || a == '.'
+        ))
+            return false;
+    }
+    return true;
+}
+
+auto mmQuote::fetch_shares(
+    const Config& config,
+    const std::vector<wxString>& symbol_a
+) -> Result
+{
+    Clock::time_point start_t = Clock::now();
+    Result result;
+
+    std::vector<wxString> query_a;
+    for (const wxString& symbol : symbol_a) {
+        if (is_symbol(symbol))
+            query_a.push_back(symbol);
+    }
+
+    result.m_ok = fetch_yahoo(config, query_a, e_shares, result);
+    for (auto& [symbol, price] : result.m_price_m) {
+        if (price <= 0)
+            price = 0;
+    }
+
+    result.m_msec = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::now() - start_t
+    ).count());
+    return result;
+}
+
+auto mmQuote::fetch_rates(
+    const Config& config,
+    const std::vector<wxString>& symbol_a,
+    const wxString& base_symbol,
+    double usd_rate
+) -> Result
+{
+    Clock::time_point start_t = Clock::now();
+    Result result;
+    const wxString fiat_curr = g_fiat_curr();
+
+    // Yahoo has rates for USD, EUR and GBP; other bases are converted through USD
+    wxString yahoo_base_symbol = base_symbol;
+    std::vector<wxString> query_a;
+    if (!wxString("USD|EUR|GBP").Contains(base_symbol)) {
+        yahoo_base_symbol = "USD";
+        query_a.push_back(wxString::Format("%s%s=X", base_symbol, yahoo_base_symbol));
+    }
+    for (const wxString& symbol : symbol_a) {
+        if (!is_symbol(symbol))
+            continue;
+        if (fiat_curr.Contains(symbol))
+            query_a.push_back(wxString::Format("%s%s=X", symbol, yahoo_base_symbol));
+        else
+            query_a.push_back(wxString::Format("%s-%s", symbol, yahoo_base_symbol));
+    }
+
+    std::map<wxString, double> yahoo_price_m;
+    result.m_ok = fetch_yahoo(config, query_a, e_fiat, result);
+    yahoo_price_m.swap(result.m_price_m);
+
+    double conversion_factor = 1.0;
+    auto base_it = yahoo_price_m.find(base_symbol);
+    if (base_it != yahoo_price_m.end())
+        conversion_factor = base_it->second;
+    for (const auto& [symbol, price] : yahoo_price_m) {
+        if (symbol != base_symbol)
+            result.m_price_m[symbol] = (price <= 0.0 ? 0.0 : price) / conversion_factor;
+    }
+
+    // fallback to coincap for the cryptocurrencies not found in Yahoo;
+    // coincap prices are in USD
+    std::vector<wxString> coincap_symbol_a;
+    std::vector<wxString> coincap_url_a;
+    if (usd_rate > 0) {
+        for (const wxString& symbol : symbol_a) {
+            if (result.m_price_m.find(symbol) != result.m_price_m.end() ||
+                fiat_curr.Contains(symbol)
+            )
+                continue;
+            coincap_symbol_a.push_back(symbol);
+            coincap_url_a.push_back(wxString::Format(config.m_coincap_search_url, symbol));
+        }
+    }
+    std::vector<mmHttpResult> coincap_a = http_get_multi(
+        coincap_url_a, config.m_http, {}, config.m_abort_n
+    );
+    for (std::size_t i = 0; i < coincap_a.size(); ++i) {
+        double price_usd = -1;
+        if (coincap_a[i].is_ok() &&
+            parse_coincap_price(coincap_a[i].m_body, coincap_symbol_a[i], price_usd) &&
+            price_usd > 0
+        ) {
+            result.m_price_m[coincap_symbol_a[i]] = price_usd * usd_rate;
+        }
+    }
+
+    result.m_msec = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::now() - start_t
+    ).count());
+    return result;
+}
+
+// Fetch the quotes of query_a from Yahoo, in chunks of config.m_chunk_size
+// symbols, and add them to result.m_price_m.
+// The Yahoo session is renewed once, if it is missing or rejected.
+bool mmQuote::fetch_yahoo(
+    const Config& config,
+    const std::vector<wxString>& query_a,
+    TYPE type,
+    Result& result
+) {
+    if (query_a.empty()) {
+        result.m_msg = _t("Nothing to update");
+        return false;
+    }
+
+    result.m_cookie = config.m_cookie;
+    result.m_crumb = config.m_crumb;
+    if ((result.m_cookie.IsEmpty() || result.m_crumb.IsEmpty()) &&
+        !renew_session(config, result)
+    )
+        return false;
+
+    std::vector<wxString> chunk_a;
+    for (std::size_t i = 0; i < query_a.size(); i += config.m_chunk_size) {
+        wxString chunk;
+        for (std::size_t j = i; j < query_a.size() && j < i + config.m_chunk_size; ++j)
+            chunk << (j > i ? "," : "") << query_a[j];
+        chunk_a.push_back(chunk);
+    }
+
+    std::vector<mmHttpResult> http_a(chunk_a.size());
+    std::vector<std::size_t> pending_a(chunk_a.size());
+    for (std::size_t i = 0; i < chunk_a.size(); ++i)
+        pending_a[i] = i;
+
+    for (int attempt = 0; attempt < 2 && !pending_a.empty(); ++attempt) {
+        std::vector<wxString> url_a;
+        for (std::size_t i : pending_a) {
+            url_a.push_back(wxString::Format(config.m_quote_url, chunk_a[i]) +
+                "&crumb=" + result.m_crumb
+            );
+        }
+        const std::vector<wxString> header_a = {
+            "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8",
+            "user-agent: Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/136.0.0.0 Safari/537.36",
+            "Cookie: " + result.m_cookie
+        };
+        std::vector<mmHttpResult> pending_http_a = http_get_multi(
+            url_a, config.m_http, header_a, config.m_abort_n
+        );
+
+        // keep the chunks which have been rejected, to retry with a new session
+        std::vector<std::size_t> rejected_a;
+        for (std::size_t k = 0; k < pending_a.size(); ++k) {
+            http_a[pending_a[k]] = pending_http_a[k];
+            if (pending_http_a[k].m_code == CURLE_OK &&
+                (pending_http_a[k].m_status == 401 ||
+                    pending_http_a[k].m_body.Contains("Unauthorized")
+                )
+            )
+                rejected_a.push_back(pending_a[k]);
+        }
+        pending_a.swap(rejected_a);
+        if (!pending_a.empty() &&
+            (attempt > 0 || is_aborted(config) || !renew_session(config, result))
+        )
+            break;
+    }
+
+    bool ok = false;
+    for (const mmHttpResult& http : http_a) {
+        if (http.m_code != CURLE_OK) {
+            if (result.m_msg.IsEmpty())
+                result.m_msg = http.m_body;
+            continue;
+        }
+        wxString msg;
+        if (parse_yahoo(http.m_body, type, result.m_price_m, msg))
+            ok = true;
+        else if (result.m_msg.IsEmpty())
+            result.m_msg = msg;
+    }
+
+    if (ok && result.m_price_m.empty()) {
+        result.m_msg = _t("Nothing to update");
+        ok = false;
+    }
+    return ok;
+}
+
+// Get a new cookie and crumb from Yahoo.
+bool mmQuote::renew_session(const Config& config, Result& result)
+{
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        result.m_msg = curl_easy_strerror(CURLE_FAILED_INIT);
+        return false;
+    }
+
+    std::string body;
+    http_set_options(curl, config.m_http);
+    http_set_abort(curl, config.m_abort_n);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, http_write_string);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+    curl_easy_setopt(curl, CURLOPT_COOKIEFILE, "");  // enable the cookie engine
+
+    struct curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8");
+    headers = curl_slist_append(headers, "user-agent: Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/136.0.0.0 Safari/537.36");
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+
+    curl_easy_setopt(curl, CURLOPT_URL, static_cast<const char*>(config.m_cookie_url.mb_str()));
+    CURLcode res = curl_easy_perform(curl);
+    if (res == CURLE_OK) {
+        // accept or reject the consent form, if it is shown
+        const wxString response = wxString::FromUTF8(body.c_str());
+        wxRegEx csrfTokenPattern("csrfToken\" value=\"([^\"]+)\">");
+        wxRegEx sessionIdPattern("sessionId\" value=\"([^\"]+)\">");
+        if (csrfTokenPattern.Matches(response) && sessionIdPattern.Matches(response)) {
+            const wxString csrfToken = csrfTokenPattern.GetMatch(response, 1);
+            const wxString sessionId = sessionIdPattern.GetMatch(response, 1);
+            const wxString postData = "csrfToken=" + csrfToken + "&sessionId=" + sessionId + "&originalDoneUrl=https%3A%2F%2Ffinance.yahoo.com%2F%3Fguccounter%3D1&namespace=yahoo&reject=reject&reject=reject";
+            const wxString consentUrl = wxString::Format(config.m_consent_url, sessionId);
+            curl_easy_setopt(curl, CURLOPT_URL, static_cast<const char*>(consentUrl.mb_str()));
+            curl_easy_setopt(curl, CURLOPT_COPYPOSTFIELDS, static_cast<const char*>(postData.mb_str()));
+            res = curl_easy_perform(curl);
+            curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+        }
+    }
+
+    if (res == CURLE_OK) {
+        body.clear();
+        curl_easy_setopt(curl, CURLOPT_URL, static_cast<const char*>(config.m_crumb_url.mb_str()));
+        res = curl_easy_perform(curl);
+    }
+
+    if (res == CURLE_OK) {
+        result.m_crumb = wxString::FromUTF8(body.c_str());
+        result.m_cookie.clear();
+        struct curl_slist* cookies = nullptr;
+        curl_easy_getinfo(curl, CURLINFO_COOKIELIST, &cookies);
+        for (struct curl_slist* item = cookies; item; item = item->next) {
+            // Netscape format: domain, flag, path, secure, expiration, name, value
+            wxStringTokenizer tokenizer(wxString::FromUTF8(item->data), "\t", wxTOKEN_RET_EMPTY_ALL);
+            wxArrayString field_a;
+            while (tokenizer.HasMoreTokens())
+                field_a.Add(tokenizer.GetNextToken());
+            if (field_a.size() >= 7)
+                result.m_cookie << field_a[5] << "=" << field_a[6] << "; ";
+        }
+        curl_slist_free_all(cookies);
+        result.m_is_session_new = true;
+    }
+    else {
+        result.m_msg = curl_easy_strerror(res);
+        wxLogDebug("mmQuote::renew_session: error = %s", result.m_msg);
+    }
+
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+    return res == CURLE_OK;
+}
+
+/*
+{
+    "finance":{
+        "result":null,
+        "error":{
+            "code":"Bad Request",
+            "description":"Missing required query parameter=symbols"
+        }
+    }
+}
+{"quoteResponse":{"result":[{"currency":"USD","regularMarketPrice":173.57,"shortName":"Apple Inc.","regularMarketTime":1683316804,"symbol":"AAPL"}],"error":null}}
+*/
+// Add the prices in json_data to price_m.
+// For e_fiat, prices are keyed by currency symbol ("EURUSD=X" and "BTC-USD"
+// are keyed by "EUR" and "BTC"); prices are not converted.
+bool mmQuote::parse_yahoo(
+    const wxString& json_data,
+    TYPE type,
+    std::map<wxString, double>& price_m,
+    wxString& msg
+) {
+    rapidjson::Document json_doc;
+    if (json_doc.Parse(json_data.utf8_str()).HasParseError() || !json_doc.IsObject()) {
+        msg = _t("JSON Parse Error");
+        return false;
+    }
+
+    if (json_doc.HasMember("finance") && json_doc["finance"].IsObject()) {
+        const rapidjson::Value& e = json_doc["finance"];
+        if (e.HasMember("error") && e["error"].IsObject()) {
+            const rapidjson::Value& err = e["error"];
+            if (err.HasMember("description") && err["description"].IsString()) {
+                msg = wxString::FromUTF8(err["description"].GetString());
+                return false;
+            }
+        }
+    }
+
+    if (!json_doc.HasMember("quoteResponse") || !json_doc["quoteResponse"].IsObject()) {
+        msg = _t("JSON Parse Error");
+        return false;
+    }
+    const rapidjson::Value& r = json_doc["quoteResponse"];
+    if (!r.HasMember("result") || !r["result"].IsArray()) {
+        msg = _t("JSON Parse Error");
+        return false;
+    }
+
+    for (const rapidjson::Value& v : r["result"].GetArray()) {
+        if (!v.IsObject())
+            continue;
+        if (!v.HasMember("symbol") || !v["symbol"].IsString())
+            continue;
+        if (!v.HasMember("regularMarketPrice") || !v["regularMarketPrice"].IsNumber())
+            continue;
+        wxString symbol = wxString::FromUTF8(v["symbol"].GetString());
+        double price = v["regularMarketPrice"].GetDouble();
+
+        if (type == e_fiat) {
+            // "EURUSD=X" or "BTC-USD"
+            if (symbol.length() == 8 && symbol.EndsWith("=X"))
+                symbol = symbol.Left(3);
+            else if (symbol.length() >= 7 && symbol[symbol.length() - 4] == '-')
+                symbol = symbol.Left(symbol.length() - 4);
+            price_m[symbol] = price;
+        }
+        else {
+            if (!v.HasMember("currency") || !v["currency"].IsString())
+                continue;
+            const wxString currency = wxString::FromUTF8(v["currency"].GetString());
+            double k = currency == "GBp" ? 100 : 1;
+            price_m[symbol] = price / k;
+        }
+    }
+
+    return true;
+}
+
+// Return the price in USD of the first asset in json_data (the response of a
+// coincap search) with symbol.
+bool mmQuote::parse_coincap_price(
+    const wxString& json_data,
+    const wxString& symbol,
+    double& price_usd
+) {
+    rapidjson::Document json_doc;
+    if (json_doc.Parse(json_data.utf8_str()).HasParseError() || !json_doc.IsObject())
+        return false;
+    if (!json_doc.HasMember("data") || !json_doc["data"].IsArray())
+        return false;
+
+    for (const rapidjson::Value& asset : json_doc["data"].GetArray()) {
+        if (!asset.IsObject() ||
+            !asset.HasMember("symbol") || !asset["symbol"].IsString()
+        )
+            continue;
+        if (wxString::FromUTF8(asset["symbol"].GetString()) != symbol)
+            continue;
+
+        price_usd = -1;
+        if (asset.HasMember("priceUsd") && asset["priceUsd"].IsString())
+            wxString::FromUTF8(asset["priceUsd"].GetString()).ToCDouble(&price_usd);
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,161 @@
+/*******************************************************
+ Copyright (C) 2026 George Ef (george.a.ef@gmail.com)
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <vector>
+#include <curl/curl.h>
+#include <wx/string.h>
+
+// Options of an HTTP session, copied from the settings on the GUI thread,
+// such that the session can run on a worker thread.
+struct mmHttpConfig
+{
+    wxString m_proxy;
+    wxString m_useragent;
+    long m_timeout = 10;         // seconds, per request
+    long m_connect_timeout = 5;  // seconds, per request
+    int  m_conn_max = 4;         // concurrent requests
+    int  m_retry_max = 2;        // retries after a failed request
+    long m_interval_msec = 200;  // minimum interval between two request starts
+
+    static auto from_settings() -> mmHttpConfig;
+};
+
+struct mmHttpResult
+{
+    CURLcode m_code = CURLE_OK;
+    long     m_status = 0;       // HTTP status code
+    wxString m_body;             // response body, or error message
+
+    bool is_ok() const { return m_code == CURLE_OK && m_status < 400; }
+};
+
+// Abort the transfers of curl when *abort_n becomes true (if abort_n is not
+// null), through CURLOPT_XFERINFOFUNCTION.
+void http_set_abort(CURL* curl, const std::atomic<bool>* abort_n);
+
+// Fetch all urls concurrently through a curl multi handle, and return the
+// result of each url (in the same order).
+// At most config.m_conn_max requests are in flight; a request which fails
+// with a transport error or with status 429/5xx is retried, with exponential
+// backoff, up to config.m_retry_max times.
+// When *abort_n becomes true, the transfers in flight are aborted and the
+// pending ones are not started; their code is CURLE_ABORTED_BY_CALLBACK.
+// This function does not use the models or the GUI; it can be called on a
+// worker thread.
+auto http_get_multi(
+    const std::vector<wxString>& url_a,
+    const mmHttpConfig& config,
+    const std::vector<wxString>& header_a = {},
+    const std::atomic<bool>* abort_n = nullptr
+) -> std::vector<mmHttpResult>;
+
+// mmQuote fetches the prices of shares and the rates of currencies.
+// A refresh has three steps:
+// - Config and the list of symbols are prepared on the GUI thread;
+// - fetch_*() downloads the quotes (symbols are split in chunks which are
+//   fetched concurrently) and parses them on a worker thread;
+// - the Result is written to the database on the GUI thread, in one batch.
+// All URLs are taken from Config, such that the pipeline can be pointed to a
+// local server with canned responses.
+class mmQuote
+{
+public:
+    enum TYPE { e_shares = 0, e_fiat };
+
+    struct Config
+    {
+        mmHttpConfig m_http;
+        std::size_t  m_chunk_size = 50;  // symbols per request
+
+        wxString m_quote_url;            // %s: comma-separated symbols
+        wxString m_cookie_url;
+        wxString m_consent_url;          // %s: session id
+        wxString m_crumb_url;
+        wxString m_coincap_search_url;   // %s: symbol
+
+        // Yahoo session; renewed by fetch_*() if it is empty or expired
+        wxString m_cookie;
+        wxString m_crumb;
+
+        // the requests are aborted when it becomes true (e.g., MMEX is closing)
+        const std::atomic<bool>* m_abort_n = nullptr;
+
+        static auto from_settings() -> Config;
+    };
+
+    struct Result
+    {
+        bool m_ok = false;
+        wxString m_msg;                      // error message if !m_ok
+        std::map<wxString, double> m_price_m;
+        // the Yahoo session, if it has been renewed
+        bool m_is_session_new = false;
+        wxString m_cookie;
+        wxString m_crumb;
+        long m_msec = 0;
+    };
+
+// -- methods
+
+public:
+    // worker thread
+    static auto fetch_shares(
+        const Config& config,
+        const std::vector<wxString>& symbol_a
+    ) -> Result;
+    // Rates are relative to base_symbol. Cryptocurrencies not found in Yahoo
+    // are looked up in coincap, if usd_rate (the rate of USD) is positive.
+    static auto fetch_rates(
+        const Config& config,
+        const std::vector<wxString>& symbol_a,
+        const wxString& base_symbol,
+        double usd_rate
+    ) -> Result;
+
+    // GUI thread
+    static void save_session(const Result& result);
+
+    static bool parse_yahoo(
+        const wxString& json_data,
+        TYPE type,
+        std::map<wxString, double>& price_m,
+        wxString& msg
+    );
+    static bool parse_coincap_price(
+        const wxString& json_data,
+        const wxString& symbol,
+        double& price_usd
+    );
+
+private:
+    static bool is_symbol(const wxString& symbol);
+    static bool fetch_yahoo(
+        const Config& config,
+        const std::vector<wxString>& query_a,
+        TYPE type,
+        Result& result
+    );
+    static bool renew_session(const Config& config, Result& result);
+    static bool is_aborted(const Config& config) {
+        return config.m_abort_n && config.m_abort_n->load();
+    }
+};
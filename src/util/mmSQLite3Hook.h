@@ -17,7 +17,14 @@
  ********************************************************/
 #pragma once
 
+#include <wx/app.h>
 #include "model/PrefModel.h"
+#include "table/_TableChange.h"
+
+// The hooks of the main connection feed TableChangeBus.
+// SQLite calls them while a statement is executing; they shall neither
+// query the database nor call subscribers. The committed changes are
+// published later, from the event loop.
 
 class CommitCallbackHook : public wxSQLite3Hook
 {
@@ -25,31 +32,37 @@ public:
     virtual bool CommitCallback()
     {
         PrefModel::instance().setDatabaseUpdated(true);
+        if (TableChangeBus::instance().commit() && wxTheApp)
+            wxTheApp->CallAfter([]() { TableChangeBus::instance().publish(); });
         return false;
     }
+
+    virtual void RollbackCallback()
+    {
+        TableChangeBus::instance().rollback();
+    }
 };
 
 class UpdateCallbackHook : public wxSQLite3Hook
 {
 public:
-    virtual void UpdateCallback (wxUpdateType type, [[maybe_unused]] const wxString& database, [[maybe_unused]] const wxString& table, [[maybe_unused]] wxLongLong rowid)
+    virtual void UpdateCallback (wxUpdateType type, [[maybe_unused]] const wxString& database, const wxString& table, wxLongLong rowid)
     {
         switch (type)
         {
         case SQLITE_DELETE:
-            wxLogDebug("SQLITE_DELETE");
+            TableChangeBus::instance().record(TableChange::e_delete, table, rowid);
             break;
         case SQLITE_INSERT:
-            wxLogDebug("SQLITE_INSERT");
+            TableChangeBus::instance().record(TableChange::e_insert, table, rowid);
             break;
         case SQLITE_UPDATE:
-            wxLogDebug("SQLITE_UPDATE");
+            TableChangeBus::instance().record(TableChange::e_update, table, rowid);
             break;
         default:
             wxLogDebug("UNKNOWN type");
             break;
         }
-        wxLogDebug("database: %s, table: %s, rowid: %lld", database, table, rowid);
 
         // TODO sync search index from full text search
     }
@@ -0,0 +1,84 @@
+/*******************************************************
+ Copyright (C) 2026 George Ef (george.a.ef@gmail.com)
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include <cwchar>
+
+#include "mmSortKey.h"
+
+std::unordered_map<wxString, std::wstring> mmSortKey::s_name_key_m;
+
+// Return the collation key of name, such that the order of the keys is the
+// order of std::wcscoll() on the lower-case names.
+// The returned reference remains valid until reset() is called.
+const std::wstring& mmSortKey::get_key(const wxString& name)
+{
+    auto it = s_name_key_m.find(name);
+    if (it != s_name_key_m.end())
+        return it->second;
+
+    const wxString lower = name.Lower();
+    const wchar_t* src = lower.wc_str();
+    std::wstring key;
+    std::size_t len = std::wcsxfrm(nullptr, src, 0);
+    if (len != static_cast<std::size_t>(-1)) {
+        key.resize(len + 1);
+        std::wcsxfrm(&key[0], src, len + 1);
+        key.resize(len);
+    }
+    else {
+        // the name cannot be transformed; fall back to code point order
+        key = src;
+    }
+
+    return s_name_key_m.emplace(name, std::move(key)).first->second;
+}
+
+std::vector<std::size_t> mmSortKey::get_rank_a(const std::vector<wxString>& name_a)
+{
+    // index of each distinct name
+    std::unordered_map<wxString, std::size_t> name_i_m;
+    std::vector<const std::wstring*> key_a;
+    std::vector<std::size_t> name_i_a;
+    name_i_a.reserve(name_a.size());
+    for (const wxString& name : name_a) {
+        auto [it, is_new] = name_i_m.emplace(name, key_a.size());
+        if (is_new)
+            key_a.push_back(&get_key(name));
+        name_i_a.push_back(it->second);
+    }
+
+    // sort the distinct names; names with equal keys get the same rank
+    std::vector<std::size_t> order_a(key_a.size());
+    std::iota(order_a.begin(), order_a.end(), 0);
+    std::sort(order_a.begin(), order_a.end(), [&key_a](std::size_t x, std::size_t y) {
+        return *key_a[x] < *key_a[y];
+    });
+    std::vector<std::size_t> name_rank_a(key_a.size());
+    std::size_t rank = 0;
+    for (std::size_t j = 0; j < order_a.size(); ++j) {
+        if (j > 0 && *key_a[order_a[j]] != *key_a[order_a[j - 1]])
+            ++rank;
+        name_rank_a[order_a[j]] = rank;
+    }
+
+    std::vector<std::size_t> rank_a;
+    rank_a.reserve(name_a.size());
+    for (std::size_t name_i : name_i_a)
+        rank_a.push_back(name_rank_a[name_i]);
+    return rank_a;
+}
@@ -0,0 +1,106 @@
+/*******************************************************
+ Copyright (C) 2026 George Ef (george.a.ef@gmail.com)
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+// mmSortKey sorts names in the order of the current locale, ignoring case
+// (the same order as CaseInsensitiveLocaleCmp).
+// The collation key of each distinct name is computed once with wcsxfrm(),
+// and it is kept until reset(), which is called when the language changes
+// and when the database is closed; comparing two keys is a plain comparison
+// of wide strings.
+// For large lists, sort_by_name() ranks the distinct names once, and then
+// sorts by integer rank. The sort is stable, such that a list can be sorted
+// by several columns, starting with the last one.
+// All methods shall be called from the main thread.
+class mmSortKey
+{
+public:
+    struct Less
+    {
+        bool operator()(const wxString& x, const wxString& y) const {
+            return get_key(x) < get_key(y);
+        }
+    };
+
+// -- state
+
+private:
+    static std::unordered_map<wxString, std::wstring> s_name_key_m;
+
+// -- methods
+
+public:
+    static auto get_key(const wxString& name) -> const std::wstring&;
+    static void reset() { s_name_key_m.clear(); }
+
+    // Return the rank of each name in name_a; equal names have equal rank.
+    static auto get_rank_a(const std::vector<wxString>& name_a) -> std::vector<std::size_t>;
+
+    template<typename T>
+    static void sort_by_rank(std::vector<T>& data_a, const std::vector<std::size_t>& rank_a, bool ascend);
+    template<typename T, typename NameFn>
+    static void sort_by_name(std::vector<T>& data_a, NameFn name_fn, bool ascend);
+};
+
+// Reorder data_a by rank_a (rank_a[i] is the rank of data_a[i]).
+// The descending order sorts the reversed range in ascending order, as
+// JournalList::sortBy() does, such that ties are ordered the same way by
+// both sorts.
+template<typename T>
+void mmSortKey::sort_by_rank(
+    std::vector<T>& data_a,
+    const std::vector<std::size_t>& rank_a,
+    bool ascend
+) {
+    std::vector<std::size_t> i_a(data_a.size());
+    std::iota(i_a.begin(), i_a.end(), 0);
+    auto less = [&rank_a](std::size_t x, std::size_t y) {
+        return rank_a[x] < rank_a[y];
+    };
+    if (ascend)
+        std::stable_sort(i_a.begin(), i_a.end(), less);
+    else
+        std::stable_sort(i_a.rbegin(), i_a.rend(), less);
+
+    // move the elements once, instead of swapping them during the sort
+    std::vector<T> sorted_a;
+    sorted_a.reserve(data_a.size());
+    for (std::size_t i : i_a)
+        sorted_a.push_back(std::move(data_a[i]));
+    data_a.swap(sorted_a);
+}
+
+// Sort data_a by the name returned by name_fn(const T&).
+template<typename T, typename NameFn>
+void mmSortKey::sort_by_name(std::vector<T>& data_a, NameFn name_fn, bool ascend)
+{
+    std::vector<wxString> name_a;
+    name_a.reserve(data_a.size());
+    for (const T& data : data_a)
+        name_a.push_back(name_fn(data));
+
+    sort_by_rank(data_a, get_rank_a(name_a), ascend);
+}
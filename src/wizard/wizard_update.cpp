@@ -319,11 +319,24 @@ struct Version
 //--------------
 void mmUpdate::checkUpdates(wxFrame *frame, bool bSilent)
 {
-    bool is_stable = mmex::version::isStable();
-    const auto url = is_stable ? mmex::weblink::Latest : mmex::weblink::Releases;
-
     wxString resp;
-    CURLcode err_code = http_get_data(url, resp);
+    CURLcode err_code = http_get_data(getUpdatesUrl(), resp);
+    checkUpdatesResponse(frame, bSilent, err_code, resp);
+}
+
+const wxString mmUpdate::getUpdatesUrl()
+{
+    return mmex::version::isStable() ? mmex::weblink::Latest : mmex::weblink::Releases;
+}
+
+void mmUpdate::checkUpdatesResponse(
+    wxFrame *frame,
+    bool bSilent,
+    CURLcode err_code,
+    const wxString& response
+) {
+    bool is_stable = mmex::version::isStable();
+    wxString resp = response;
     if (err_code != CURLE_OK) {
         if (!bSilent) {
             const wxString& msgStr = _t("Unable to check for updates!")
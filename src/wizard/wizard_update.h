@@ -22,6 +22,7 @@
 #include <wx/wizard.h>
 #include <wx/frame.h>
 #include <rapidjson/document.h>
+#include <curl/curl.h>
 
 #include "model/PrefModel.h"
 
@@ -31,6 +32,9 @@ class mmUpdate
 {
 public:
     static void checkUpdates(wxFrame *frame, bool bSilent);
+    // the two halves of checkUpdates(); the request can run on a worker thread
+    static const wxString getUpdatesUrl();
+    static void checkUpdatesResponse(wxFrame *frame, bool bSilent, CURLcode err_code, const wxString& response);
 };
 
 class mmUpdateWizard : public wxDialog